@@ -31,110 +31,16 @@
  #error "If you're building the audio plugin host, you probably want to enable VST and/or AU support"
 #endif
 
-class PluginScannerSubprocess : private ChildProcessWorker,
-                                private AsyncUpdater
+class PluginScannerSubprocess  : public PluginScannerWorker
 {
 public:
     PluginScannerSubprocess()
+        : PluginScannerWorker (formatManager)
     {
         formatManager.addDefaultFormats();
     }
 
-    using ChildProcessWorker::initialiseFromCommandLine;
-
 private:
-    void handleMessageFromCoordinator (const MemoryBlock& mb) override
-    {
-        if (mb.isEmpty())
-            return;
-
-        if (! doScan (mb))
-        {
-            {
-                const std::lock_guard<std::mutex> lock (mutex);
-                pendingBlocks.emplace (mb);
-            }
-
-            triggerAsyncUpdate();
-        }
-    }
-
-    void handleConnectionLost() override
-    {
-        JUCEApplicationBase::quit();
-    }
-
-    void handleAsyncUpdate() override
-    {
-        for (;;)
-        {
-            const auto block = [&]() -> MemoryBlock
-            {
-                const std::lock_guard<std::mutex> lock (mutex);
-
-                if (pendingBlocks.empty())
-                    return {};
-
-                auto out = std::move (pendingBlocks.front());
-                pendingBlocks.pop();
-                return out;
-            }();
-
-            if (block.isEmpty())
-                return;
-
-            doScan (block);
-        }
-    }
-
-    bool doScan (const MemoryBlock& block)
-    {
-        MemoryInputStream stream { block, false };
-        const auto formatName = stream.readString();
-        const auto identifier = stream.readString();
-
-        PluginDescription pd;
-        pd.fileOrIdentifier = identifier;
-        pd.uniqueId = pd.deprecatedUid = 0;
-
-        const auto matchingFormat = [&]() -> AudioPluginFormat*
-        {
-            for (auto* format : formatManager.getFormats())
-                if (format->getName() == formatName)
-                    return format;
-
-            return nullptr;
-        }();
-
-        if (matchingFormat == nullptr
-            || (! MessageManager::getInstance()->isThisTheMessageThread()
-                && ! matchingFormat->requiresUnblockedMessageThreadDuringCreation (pd)))
-        {
-            return false;
-        }
-
-        OwnedArray<PluginDescription> results;
-        matchingFormat->findAllTypesForFile (results, identifier);
-        sendPluginDescriptions (results);
-        return true;
-    }
-
-    void sendPluginDescriptions (const OwnedArray<PluginDescription>& results)
-    {
-        XmlElement xml ("LIST");
-
-        for (const auto& desc : results)
-            xml.addChildElement (desc->createXml().release());
-
-        const auto str = xml.toString();
-        sendMessageToCoordinator ({ str.toRawUTF8(), str.getNumBytesAsUTF8() });
-    }
-
-    std::mutex mutex;
-    std::queue<MemoryBlock> pendingBlocks;
-
-    // After construction, this will only be accessed by doScan so there's no need
-    // to worry about synchronisation.
     AudioPluginFormatManager formatManager;
 };
 
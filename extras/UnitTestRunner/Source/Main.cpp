@@ -88,9 +88,20 @@ int main (int argc, char **argv)
     }();
 
     if (args.containsOption ("--category"))
+    {
         runner.runTestsInCategory (args.getValueForOption ("--category"), seed);
+    }
     else
-        runner.runAllTests (seed);
+    {
+        // Benchmarks take a while and don't check anything, so they only run when asked for
+        Array<UnitTest*> tests;
+
+        for (auto* test : UnitTest::getAllTests())
+            if (test->getCategory() != UnitTestCategories::benchmarks)
+                tests.add (test);
+
+        runner.runTests (tests, seed);
+    }
 
     std::vector<String> failures;
 
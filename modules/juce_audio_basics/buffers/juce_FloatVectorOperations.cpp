@@ -25,9 +25,9 @@ namespace juce
 
 namespace FloatVectorHelpers
 {
-    #define JUCE_INCREMENT_SRC_DEST         dest += (16 / sizeof (*dest)); src += (16 / sizeof (*dest));
-    #define JUCE_INCREMENT_SRC1_SRC2_DEST   dest += (16 / sizeof (*dest)); src1 += (16 / sizeof (*dest)); src2 += (16 / sizeof (*dest));
-    #define JUCE_INCREMENT_DEST             dest += (16 / sizeof (*dest));
+    #define JUCE_INCREMENT_SRC_DEST         dest += Mode::numParallel; src += Mode::numParallel;
+    #define JUCE_INCREMENT_SRC1_SRC2_DEST   dest += Mode::numParallel; src1 += Mode::numParallel; src2 += Mode::numParallel;
+    #define JUCE_INCREMENT_DEST             dest += Mode::numParallel;
 
    #if JUCE_USE_SSE_INTRINSICS
     static bool isAligned (const void* p) noexcept
@@ -102,7 +102,7 @@ namespace FloatVectorHelpers
 
 
     #define JUCE_BEGIN_VEC_OP \
-        using Mode = FloatVectorHelpers::ModeType<sizeof(*dest)>::Mode; \
+        using Mode = typename ModeType<sizeof(*dest)>::Mode; \
         { \
             const auto numLongOps = num / Mode::numParallel;
 
@@ -115,21 +115,21 @@ namespace FloatVectorHelpers
     #define JUCE_PERFORM_VEC_OP_DEST(normalOp, vecOp, locals, setupOp) \
         JUCE_BEGIN_VEC_OP \
         setupOp \
-        if (FloatVectorHelpers::isAligned (dest))   JUCE_VEC_LOOP (vecOp, dummy, Mode::loadA, Mode::storeA, locals, JUCE_INCREMENT_DEST) \
+        if (isAligned (dest))   JUCE_VEC_LOOP (vecOp, dummy, Mode::loadA, Mode::storeA, locals, JUCE_INCREMENT_DEST) \
         else                                        JUCE_VEC_LOOP (vecOp, dummy, Mode::loadU, Mode::storeU, locals, JUCE_INCREMENT_DEST) \
         JUCE_FINISH_VEC_OP (normalOp)
 
     #define JUCE_PERFORM_VEC_OP_SRC_DEST(normalOp, vecOp, locals, increment, setupOp) \
         JUCE_BEGIN_VEC_OP \
         setupOp \
-        if (FloatVectorHelpers::isAligned (dest)) \
+        if (isAligned (dest)) \
         { \
-            if (FloatVectorHelpers::isAligned (src)) JUCE_VEC_LOOP (vecOp, Mode::loadA, Mode::loadA, Mode::storeA, locals, increment) \
+            if (isAligned (src)) JUCE_VEC_LOOP (vecOp, Mode::loadA, Mode::loadA, Mode::storeA, locals, increment) \
             else                                     JUCE_VEC_LOOP (vecOp, Mode::loadU, Mode::loadA, Mode::storeA, locals, increment) \
         }\
         else \
         { \
-            if (FloatVectorHelpers::isAligned (src)) JUCE_VEC_LOOP (vecOp, Mode::loadA, Mode::loadU, Mode::storeU, locals, increment) \
+            if (isAligned (src)) JUCE_VEC_LOOP (vecOp, Mode::loadA, Mode::loadU, Mode::storeU, locals, increment) \
             else                                     JUCE_VEC_LOOP (vecOp, Mode::loadU, Mode::loadU, Mode::storeU, locals, increment) \
         } \
         JUCE_FINISH_VEC_OP (normalOp)
@@ -137,29 +137,29 @@ namespace FloatVectorHelpers
     #define JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST(normalOp, vecOp, locals, increment, setupOp) \
         JUCE_BEGIN_VEC_OP \
         setupOp \
-        if (FloatVectorHelpers::isAligned (dest)) \
+        if (isAligned (dest)) \
         { \
-            if (FloatVectorHelpers::isAligned (src1)) \
+            if (isAligned (src1)) \
             { \
-                if (FloatVectorHelpers::isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadA, Mode::loadA, Mode::storeA, locals, increment) \
+                if (isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadA, Mode::loadA, Mode::storeA, locals, increment) \
                 else                                        JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadA, Mode::loadU, Mode::storeA, locals, increment) \
             } \
             else \
             { \
-                if (FloatVectorHelpers::isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadU, Mode::loadA, Mode::storeA, locals, increment) \
+                if (isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadU, Mode::loadA, Mode::storeA, locals, increment) \
                 else                                        JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadU, Mode::loadU, Mode::storeA, locals, increment) \
             } \
         } \
         else \
         { \
-            if (FloatVectorHelpers::isAligned (src1)) \
+            if (isAligned (src1)) \
             { \
-                if (FloatVectorHelpers::isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadA, Mode::loadA, Mode::storeU, locals, increment) \
+                if (isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadA, Mode::loadA, Mode::storeU, locals, increment) \
                 else                                        JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadA, Mode::loadU, Mode::storeU, locals, increment) \
             } \
             else \
             { \
-                if (FloatVectorHelpers::isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadU, Mode::loadA, Mode::storeU, locals, increment) \
+                if (isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadU, Mode::loadA, Mode::storeU, locals, increment) \
                 else                                        JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadU, Mode::loadU, Mode::storeU, locals, increment) \
             } \
         } \
@@ -168,29 +168,29 @@ namespace FloatVectorHelpers
     #define JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST(normalOp, vecOp, locals, increment, setupOp) \
         JUCE_BEGIN_VEC_OP \
         setupOp \
-        if (FloatVectorHelpers::isAligned (dest)) \
+        if (isAligned (dest)) \
         { \
-            if (FloatVectorHelpers::isAligned (src1)) \
+            if (isAligned (src1)) \
             { \
-                if (FloatVectorHelpers::isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadA, Mode::loadA, Mode::loadA, Mode::storeA, locals, increment) \
+                if (isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadA, Mode::loadA, Mode::loadA, Mode::storeA, locals, increment) \
                 else                                        JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadA, Mode::loadU, Mode::loadA, Mode::storeA, locals, increment) \
             } \
             else \
             { \
-                if (FloatVectorHelpers::isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadU, Mode::loadA, Mode::loadA, Mode::storeA, locals, increment) \
+                if (isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadU, Mode::loadA, Mode::loadA, Mode::storeA, locals, increment) \
                 else                                        JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadU, Mode::loadU, Mode::loadA, Mode::storeA, locals, increment) \
             } \
         } \
         else \
         { \
-            if (FloatVectorHelpers::isAligned (src1)) \
+            if (isAligned (src1)) \
             { \
-                if (FloatVectorHelpers::isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadA, Mode::loadA, Mode::loadU, Mode::storeU, locals, increment) \
+                if (isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadA, Mode::loadA, Mode::loadU, Mode::storeU, locals, increment) \
                 else                                        JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadA, Mode::loadU, Mode::loadU, Mode::storeU, locals, increment) \
             } \
             else \
             { \
-                if (FloatVectorHelpers::isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadU, Mode::loadA, Mode::loadU, Mode::storeU, locals, increment) \
+                if (isAligned (src2))   JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadU, Mode::loadA, Mode::loadU, Mode::storeU, locals, increment) \
                 else                                        JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadU, Mode::loadU, Mode::loadU, Mode::storeU, locals, increment) \
             } \
         } \
@@ -265,7 +265,7 @@ namespace FloatVectorHelpers
     };
 
     #define JUCE_BEGIN_VEC_OP \
-        using Mode = FloatVectorHelpers::ModeType<sizeof(*dest)>::Mode; \
+        using Mode = typename ModeType<sizeof(*dest)>::Mode; \
         if (Mode::numParallel > 1) \
         { \
             const auto numLongOps = num / Mode::numParallel;
@@ -343,11 +343,11 @@ namespace FloatVectorHelpers
         }
 
     #define JUCE_LOAD_NONE(srcLoad, dstLoad)
-    #define JUCE_LOAD_DEST(srcLoad, dstLoad)                        const Mode::ParallelType d = dstLoad (dest);
-    #define JUCE_LOAD_SRC(srcLoad, dstLoad)                         const Mode::ParallelType s = srcLoad (src);
-    #define JUCE_LOAD_SRC1_SRC2(src1Load, src2Load)                 const Mode::ParallelType s1 = src1Load (src1), s2 = src2Load (src2);
-    #define JUCE_LOAD_SRC1_SRC2_DEST(src1Load, src2Load, dstLoad)   const Mode::ParallelType d = dstLoad (dest), s1 = src1Load (src1), s2 = src2Load (src2);
-    #define JUCE_LOAD_SRC_DEST(srcLoad, dstLoad)                    const Mode::ParallelType d = dstLoad (dest), s = srcLoad (src);
+    #define JUCE_LOAD_DEST(srcLoad, dstLoad)                        const auto d = dstLoad (dest);
+    #define JUCE_LOAD_SRC(srcLoad, dstLoad)                         const auto s = srcLoad (src);
+    #define JUCE_LOAD_SRC1_SRC2(src1Load, src2Load)                 const auto s1 = src1Load (src1), s2 = src2Load (src2);
+    #define JUCE_LOAD_SRC1_SRC2_DEST(src1Load, src2Load, dstLoad)   const auto d = dstLoad (dest), s1 = src1Load (src1), s2 = src2Load (src2);
+    #define JUCE_LOAD_SRC_DEST(srcLoad, dstLoad)                    const auto d = dstLoad (dest), s = srcLoad (src);
 
     union signMask32 { float  f; uint32 i; };
     union signMask64 { double d; uint64 i; };
@@ -491,6 +491,366 @@ namespace FloatVectorHelpers
     };
    #endif
 
+    //==============================================================================
+   #if JUCE_USE_AVX_DISPATCH
+    /*  The AVX2 and AVX-512 versions of the most frequently used operations are
+        compiled with per-function target attributes, so that they can be included
+        in a build that only assumes SSE2, and are only called if SystemStats says
+        that both the CPU and the OS support them.
+    */
+    enum class WideInstructionSet
+    {
+        none,
+        avx2,
+        avx512
+    };
+
+    static std::atomic<WideInstructionSet>& getAvailableWideInstructionSet() noexcept
+    {
+        static std::atomic<WideInstructionSet> available { SystemStats::hasAVX512F() ? WideInstructionSet::avx512
+                                                         : SystemStats::hasAVX2()    ? WideInstructionSet::avx2
+                                                                                     : WideInstructionSet::none };
+        return available;
+    }
+
+    // Below this size, the SSE versions are just as quick
+    enum { minimumWideOpSize = 32 };
+
+    template <typename Size>
+    static forcedinline WideInstructionSet getWideInstructionSet (Size num) noexcept
+    {
+        if (num < (Size) minimumWideOpSize)
+            return WideInstructionSet::none;
+
+        return getAvailableWideInstructionSet().load (std::memory_order_relaxed);
+    }
+
+    #define JUCE_DISPATCH_WIDE_VEC_OP(call) \
+        switch (FloatVectorHelpers::getWideInstructionSet (num)) \
+        { \
+            case FloatVectorHelpers::WideInstructionSet::avx512:  { const FloatVectorHelpers::AVX2::ScopedUpperStateClear c; return FloatVectorHelpers::AVX512::call; } \
+            case FloatVectorHelpers::WideInstructionSet::avx2:    { const FloatVectorHelpers::AVX2::ScopedUpperStateClear c; return FloatVectorHelpers::AVX2::call; } \
+            case FloatVectorHelpers::WideInstructionSet::none:    break; \
+        }
+
+    #define JUCE_DEFINE_WIDE_VEC_OPS \
+        template <typename Type, typename Size> \
+        void copyWithMultiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier, Mode::mul (mult, s), JUCE_LOAD_SRC, \
+                                          JUCE_INCREMENT_SRC_DEST, const auto mult = Mode::load1 (multiplier);) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void add (Type* dest, Type amount, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_DEST (dest[i] += amount, Mode::add (d, amountToAdd), JUCE_LOAD_DEST, \
+                                      const auto amountToAdd = Mode::load1 (amount);) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void add (Type* dest, const Type* src, Type amount, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] + amount, Mode::add (am, s), JUCE_LOAD_SRC, \
+                                          JUCE_INCREMENT_SRC_DEST, const auto am = Mode::load1 (amount);) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void add (Type* dest, const Type* src, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i], Mode::add (d, s), JUCE_LOAD_SRC_DEST, \
+                                          JUCE_INCREMENT_SRC_DEST, ) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void add (Type* dest, const Type* src1, const Type* src2, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] + src2[i], Mode::add (s1, s2), JUCE_LOAD_SRC1_SRC2, \
+                                                JUCE_INCREMENT_SRC1_SRC2_DEST, ) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void subtract (Type* dest, const Type* src, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] -= src[i], Mode::sub (d, s), JUCE_LOAD_SRC_DEST, \
+                                          JUCE_INCREMENT_SRC_DEST, ) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void subtract (Type* dest, const Type* src1, const Type* src2, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] - src2[i], Mode::sub (s1, s2), JUCE_LOAD_SRC1_SRC2, \
+                                                JUCE_INCREMENT_SRC1_SRC2_DEST, ) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void addWithMultiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i] * multiplier, Mode::add (d, Mode::mul (mult, s)), JUCE_LOAD_SRC_DEST, \
+                                          JUCE_INCREMENT_SRC_DEST, const auto mult = Mode::load1 (multiplier);) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void addWithMultiply (Type* dest, const Type* src1, const Type* src2, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] += src1[i] * src2[i], Mode::add (d, Mode::mul (s1, s2)), \
+                                                     JUCE_LOAD_SRC1_SRC2_DEST, JUCE_INCREMENT_SRC1_SRC2_DEST, ) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void subtractWithMultiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] -= src[i] * multiplier, Mode::sub (d, Mode::mul (mult, s)), JUCE_LOAD_SRC_DEST, \
+                                          JUCE_INCREMENT_SRC_DEST, const auto mult = Mode::load1 (multiplier);) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void subtractWithMultiply (Type* dest, const Type* src1, const Type* src2, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] -= src1[i] * src2[i], Mode::sub (d, Mode::mul (s1, s2)), \
+                                                     JUCE_LOAD_SRC1_SRC2_DEST, JUCE_INCREMENT_SRC1_SRC2_DEST, ) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void multiply (Type* dest, const Type* src, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] *= src[i], Mode::mul (d, s), JUCE_LOAD_SRC_DEST, \
+                                          JUCE_INCREMENT_SRC_DEST, ) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void multiply (Type* dest, const Type* src1, const Type* src2, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] * src2[i], Mode::mul (s1, s2), JUCE_LOAD_SRC1_SRC2, \
+                                                JUCE_INCREMENT_SRC1_SRC2_DEST, ) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void multiply (Type* dest, Type multiplier, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_DEST (dest[i] *= multiplier, Mode::mul (d, mult), JUCE_LOAD_DEST, \
+                                      const auto mult = Mode::load1 (multiplier);) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        void multiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept \
+        { \
+            copyWithMultiply (dest, src, multiplier, num); \
+        } \
+        \
+        template <typename Size> \
+        void convertFixedToFloat (float* dest, const int* src, float multiplier, Size num) noexcept \
+        { \
+            JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = (float) src[i] * multiplier, Mode::mul (mult, Mode::loadIntegers (src)), \
+                                          JUCE_LOAD_NONE, JUCE_INCREMENT_SRC_DEST, const auto mult = Mode::load1 (multiplier);) \
+        } \
+        \
+        template <typename Type, typename Size> \
+        Range<Type> findMinAndMax (const Type* src, Size num) noexcept \
+        { \
+            using Mode = typename ModeType<sizeof (Type)>::Mode; \
+            const auto numLongOps = num / Mode::numParallel; \
+            auto mn = Mode::loadU (src), mx = mn; \
+            \
+            for (auto i = (decltype (numLongOps)) 1; i < numLongOps; ++i) \
+            { \
+                const auto v = Mode::loadU (src + i * Mode::numParallel); \
+                mn = Mode::min (mn, v); \
+                mx = Mode::max (mx, v); \
+            } \
+            \
+            Range<Type> result (Mode::min (mn), Mode::max (mx)); \
+            \
+            for (auto i = numLongOps * Mode::numParallel; i < num; ++i) \
+                result = result.getUnionWith (src[i]); \
+            \
+            return result; \
+        } \
+        \
+        template <typename Type, typename Size> \
+        Type findMinOrMax (const Type* src, Size num, bool isMinimum) noexcept \
+        { \
+            using Mode = typename ModeType<sizeof (Type)>::Mode; \
+            const auto numLongOps = num / Mode::numParallel; \
+            auto val = Mode::loadU (src); \
+            \
+            for (auto i = (decltype (numLongOps)) 1; i < numLongOps; ++i) \
+                val = isMinimum ? Mode::min (val, Mode::loadU (src + i * Mode::numParallel)) \
+                                : Mode::max (val, Mode::loadU (src + i * Mode::numParallel)); \
+            \
+            auto result = isMinimum ? Mode::min (val) : Mode::max (val); \
+            \
+            for (auto i = numLongOps * Mode::numParallel; i < num; ++i) \
+                result = isMinimum ? jmin (result, src[i]) : jmax (result, src[i]); \
+            \
+            return result; \
+        }
+
+   #if JUCE_GCC
+    #pragma GCC push_options
+    #pragma GCC target ("avx2")
+   #elif JUCE_CLANG
+    #pragma clang attribute push (__attribute__ ((target ("avx2"))), apply_to = function)
+   #endif
+
+    namespace AVX2
+    {
+        static forcedinline bool isAligned (const void* p) noexcept
+        {
+            return (((pointer_sized_int) p) & 31) == 0;
+        }
+
+        /*  Clears the upper halves of the vector registers when a wide operation returns.
+            Compilers only insert this automatically when optimising, and leaving them
+            dirty makes any SSE code that runs afterwards much slower.
+        */
+        struct ScopedUpperStateClear
+        {
+            ~ScopedUpperStateClear() noexcept   { _mm256_zeroupper(); }
+        };
+
+        struct BasicOps32
+        {
+            using Type = float;
+            using ParallelType = __m256;
+            enum { numParallel = 8 };
+
+            static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm256_set1_ps (v); }
+            static forcedinline ParallelType loadA (const Type* v) noexcept                 { return _mm256_load_ps (v); }
+            static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm256_loadu_ps (v); }
+            static forcedinline void storeA (Type* dest, ParallelType a) noexcept           { _mm256_store_ps (dest, a); }
+            static forcedinline void storeU (Type* dest, ParallelType a) noexcept           { _mm256_storeu_ps (dest, a); }
+
+            static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm256_add_ps (a, b); }
+            static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm256_sub_ps (a, b); }
+            static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm256_mul_ps (a, b); }
+            static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm256_max_ps (a, b); }
+            static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm256_min_ps (a, b); }
+
+            static forcedinline ParallelType loadIntegers (const int* v) noexcept
+            {
+                return _mm256_cvtepi32_ps (_mm256_loadu_si256 (reinterpret_cast<const __m256i*> (v)));
+            }
+
+            static forcedinline Type max (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmax (jmax (v[0], v[1], v[2], v[3]), jmax (v[4], v[5], v[6], v[7])); }
+            static forcedinline Type min (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmin (jmin (v[0], v[1], v[2], v[3]), jmin (v[4], v[5], v[6], v[7])); }
+        };
+
+        struct BasicOps64
+        {
+            using Type = double;
+            using ParallelType = __m256d;
+            enum { numParallel = 4 };
+
+            static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm256_set1_pd (v); }
+            static forcedinline ParallelType loadA (const Type* v) noexcept                 { return _mm256_load_pd (v); }
+            static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm256_loadu_pd (v); }
+            static forcedinline void storeA (Type* dest, ParallelType a) noexcept           { _mm256_store_pd (dest, a); }
+            static forcedinline void storeU (Type* dest, ParallelType a) noexcept           { _mm256_storeu_pd (dest, a); }
+
+            static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm256_add_pd (a, b); }
+            static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm256_sub_pd (a, b); }
+            static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm256_mul_pd (a, b); }
+            static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm256_max_pd (a, b); }
+            static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm256_min_pd (a, b); }
+
+            static forcedinline Type max (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return jmax (v[0], v[1], v[2], v[3]); }
+            static forcedinline Type min (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return jmin (v[0], v[1], v[2], v[3]); }
+        };
+
+        template <int typeSize> struct ModeType    { using Mode = BasicOps32; };
+        template <>             struct ModeType<8> { using Mode = BasicOps64; };
+
+        JUCE_DEFINE_WIDE_VEC_OPS
+    }
+
+   #if JUCE_GCC
+    #pragma GCC pop_options
+    #pragma GCC push_options
+    #pragma GCC target ("avx512f")
+   #elif JUCE_CLANG
+    #pragma clang attribute pop
+    #pragma clang attribute push (__attribute__ ((target ("avx512f"))), apply_to = function)
+   #endif
+
+    // GCC's AVX-512 headers start some intrinsics from _mm512_undefined_*(), which triggers
+    // spurious uninitialised-variable warnings wherever they're inlined
+    JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wmaybe-uninitialized", "-Wuninitialized")
+
+    namespace AVX512
+    {
+        static forcedinline bool isAligned (const void* p) noexcept
+        {
+            return (((pointer_sized_int) p) & 63) == 0;
+        }
+
+        struct BasicOps32
+        {
+            using Type = float;
+            using ParallelType = __m512;
+            enum { numParallel = 16 };
+
+            static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm512_set1_ps (v); }
+            static forcedinline ParallelType loadA (const Type* v) noexcept                 { return _mm512_load_ps (v); }
+            static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm512_loadu_ps (v); }
+            static forcedinline void storeA (Type* dest, ParallelType a) noexcept           { _mm512_store_ps (dest, a); }
+            static forcedinline void storeU (Type* dest, ParallelType a) noexcept           { _mm512_storeu_ps (dest, a); }
+
+            static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm512_add_ps (a, b); }
+            static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm512_sub_ps (a, b); }
+            static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm512_mul_ps (a, b); }
+            static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm512_max_ps (a, b); }
+            static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm512_min_ps (a, b); }
+
+            static forcedinline ParallelType loadIntegers (const int* v) noexcept
+            {
+                return _mm512_cvtepi32_ps (_mm512_loadu_si512 (v));
+            }
+
+            static forcedinline Type max (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return jmax (jmax (v[0], v[1], v[2], v[3]), jmax (v[4], v[5], v[6], v[7]), jmax (v[8], v[9], v[10], v[11]), jmax (v[12], v[13], v[14], v[15])); }
+            static forcedinline Type min (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return jmin (jmin (v[0], v[1], v[2], v[3]), jmin (v[4], v[5], v[6], v[7]), jmin (v[8], v[9], v[10], v[11]), jmin (v[12], v[13], v[14], v[15])); }
+        };
+
+        struct BasicOps64
+        {
+            using Type = double;
+            using ParallelType = __m512d;
+            enum { numParallel = 8 };
+
+            static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm512_set1_pd (v); }
+            static forcedinline ParallelType loadA (const Type* v) noexcept                 { return _mm512_load_pd (v); }
+            static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm512_loadu_pd (v); }
+            static forcedinline void storeA (Type* dest, ParallelType a) noexcept           { _mm512_store_pd (dest, a); }
+            static forcedinline void storeU (Type* dest, ParallelType a) noexcept           { _mm512_storeu_pd (dest, a); }
+
+            static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm512_add_pd (a, b); }
+            static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm512_sub_pd (a, b); }
+            static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm512_mul_pd (a, b); }
+            static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm512_max_pd (a, b); }
+            static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm512_min_pd (a, b); }
+
+            static forcedinline Type max (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return jmax (jmax (v[0], v[1], v[2], v[3]), jmax (v[4], v[5], v[6], v[7])); }
+            static forcedinline Type min (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return jmin (jmin (v[0], v[1], v[2], v[3]), jmin (v[4], v[5], v[6], v[7])); }
+        };
+
+        template <int typeSize> struct ModeType    { using Mode = BasicOps32; };
+        template <>             struct ModeType<8> { using Mode = BasicOps64; };
+
+        JUCE_DEFINE_WIDE_VEC_OPS
+    }
+
+    JUCE_END_IGNORE_WARNINGS_GCC_LIKE
+
+   #if JUCE_GCC
+    #pragma GCC pop_options
+   #elif JUCE_CLANG
+    #pragma clang attribute pop
+   #endif
+
+   #else
+    #define JUCE_DISPATCH_WIDE_VEC_OP(call)
+   #endif
+
 //==============================================================================
 namespace
 {
@@ -546,6 +906,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsmul (src, 1, &multiplier, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (copyWithMultiply (dest, src, multiplier, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier,
                                       Mode::mul (mult, s),
                                       JUCE_LOAD_SRC,
@@ -560,6 +921,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsmulD (src, 1, &multiplier, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (copyWithMultiply (dest, src, multiplier, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier,
                                       Mode::mul (mult, s),
                                       JUCE_LOAD_SRC,
@@ -574,6 +936,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsadd (dest, 1, &amount, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (add (dest, amount, num))
         JUCE_PERFORM_VEC_OP_DEST (dest[i] += amount,
                                   Mode::add (d, amountToAdd),
                                   JUCE_LOAD_DEST,
@@ -584,6 +947,7 @@ namespace
     template <typename Size>
     void add (double* dest, double amount, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (add (dest, amount, num))
         JUCE_PERFORM_VEC_OP_DEST (dest[i] += amount,
                                   Mode::add (d, amountToAdd),
                                   JUCE_LOAD_DEST,
@@ -596,6 +960,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsadd (src, 1, &amount, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (add (dest, src, amount, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] + amount,
                                       Mode::add (am, s),
                                       JUCE_LOAD_SRC,
@@ -610,6 +975,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsaddD (src, 1, &amount, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (add (dest, src, amount, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] + amount,
                                       Mode::add (am, s),
                                       JUCE_LOAD_SRC,
@@ -624,6 +990,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vadd (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (add (dest, src, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i],
                                       Mode::add (d, s),
                                       JUCE_LOAD_SRC_DEST,
@@ -637,6 +1004,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vaddD (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (add (dest, src, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i],
                                       Mode::add (d, s),
                                       JUCE_LOAD_SRC_DEST,
@@ -650,6 +1018,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vadd (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (add (dest, src1, src2, num))
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] + src2[i],
                                             Mode::add (s1, s2),
                                             JUCE_LOAD_SRC1_SRC2,
@@ -663,6 +1032,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vaddD (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (add (dest, src1, src2, num))
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] + src2[i],
                                             Mode::add (s1, s2),
                                             JUCE_LOAD_SRC1_SRC2,
@@ -676,6 +1046,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsub (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (subtract (dest, src, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] -= src[i],
                                       Mode::sub (d, s),
                                       JUCE_LOAD_SRC_DEST,
@@ -689,6 +1060,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsubD (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (subtract (dest, src, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] -= src[i],
                                       Mode::sub (d, s),
                                       JUCE_LOAD_SRC_DEST,
@@ -702,6 +1074,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsub (src2, 1, src1, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (subtract (dest, src1, src2, num))
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] - src2[i],
                                             Mode::sub (s1, s2),
                                             JUCE_LOAD_SRC1_SRC2,
@@ -715,6 +1088,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsubD (src2, 1, src1, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (subtract (dest, src1, src2, num))
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] - src2[i],
                                             Mode::sub (s1, s2),
                                             JUCE_LOAD_SRC1_SRC2,
@@ -728,6 +1102,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsma (src, 1, &multiplier, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (addWithMultiply (dest, src, multiplier, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i] * multiplier,
                                       Mode::add (d, Mode::mul (mult, s)),
                                       JUCE_LOAD_SRC_DEST,
@@ -742,6 +1117,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsmaD (src, 1, &multiplier, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (addWithMultiply (dest, src, multiplier, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i] * multiplier,
                                       Mode::add (d, Mode::mul (mult, s)),
                                       JUCE_LOAD_SRC_DEST,
@@ -756,6 +1132,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vma ((float*) src1, 1, (float*) src2, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (addWithMultiply (dest, src1, src2, num))
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] += src1[i] * src2[i],
                                                  Mode::add (d, Mode::mul (s1, s2)),
                                                  JUCE_LOAD_SRC1_SRC2_DEST,
@@ -769,6 +1146,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vmaD ((double*) src1, 1, (double*) src2, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (addWithMultiply (dest, src1, src2, num))
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] += src1[i] * src2[i],
                                                  Mode::add (d, Mode::mul (s1, s2)),
                                                  JUCE_LOAD_SRC1_SRC2_DEST,
@@ -779,6 +1157,7 @@ namespace
     template <typename Size>
     void subtractWithMultiply (float* dest, const float* src, float multiplier, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (subtractWithMultiply (dest, src, multiplier, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] -= src[i] * multiplier,
                                       Mode::sub (d, Mode::mul (mult, s)),
                                       JUCE_LOAD_SRC_DEST,
@@ -789,6 +1168,7 @@ namespace
     template <typename Size>
     void subtractWithMultiply (double* dest, const double* src, double multiplier, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (subtractWithMultiply (dest, src, multiplier, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] -= src[i] * multiplier,
                                       Mode::sub (d, Mode::mul (mult, s)),
                                       JUCE_LOAD_SRC_DEST,
@@ -799,6 +1179,7 @@ namespace
     template <typename Size>
     void subtractWithMultiply (float* dest, const float* src1, const float* src2, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (subtractWithMultiply (dest, src1, src2, num))
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] -= src1[i] * src2[i],
                                                  Mode::sub (d, Mode::mul (s1, s2)),
                                                  JUCE_LOAD_SRC1_SRC2_DEST,
@@ -808,6 +1189,7 @@ namespace
     template <typename Size>
     void subtractWithMultiply (double* dest, const double* src1, const double* src2, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (subtractWithMultiply (dest, src1, src2, num))
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] -= src1[i] * src2[i],
                                                  Mode::sub (d, Mode::mul (s1, s2)),
                                                  JUCE_LOAD_SRC1_SRC2_DEST,
@@ -820,6 +1202,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vmul (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (multiply (dest, src, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] *= src[i],
                                       Mode::mul (d, s),
                                       JUCE_LOAD_SRC_DEST,
@@ -833,6 +1216,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vmulD (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (multiply (dest, src, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] *= src[i],
                                       Mode::mul (d, s),
                                       JUCE_LOAD_SRC_DEST,
@@ -846,6 +1230,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vmul (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (multiply (dest, src1, src2, num))
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] * src2[i],
                                             Mode::mul (s1, s2),
                                             JUCE_LOAD_SRC1_SRC2,
@@ -859,6 +1244,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vmulD (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (multiply (dest, src1, src2, num))
         JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] * src2[i],
                                             Mode::mul (s1, s2),
                                             JUCE_LOAD_SRC1_SRC2,
@@ -872,6 +1258,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsmul (dest, 1, &multiplier, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (multiply (dest, multiplier, num))
         JUCE_PERFORM_VEC_OP_DEST (dest[i] *= multiplier,
                                   Mode::mul (d, mult),
                                   JUCE_LOAD_DEST,
@@ -885,6 +1272,7 @@ namespace
        #if JUCE_USE_VDSP_FRAMEWORK
         vDSP_vsmulD (dest, 1, &multiplier, dest, 1, (vDSP_Length) num);
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (multiply (dest, multiplier, num))
         JUCE_PERFORM_VEC_OP_DEST (dest[i] *= multiplier,
                                   Mode::mul (d, mult),
                                   JUCE_LOAD_DEST,
@@ -895,6 +1283,7 @@ namespace
     template <typename Size>
     void multiply (float* dest, const float* src, float multiplier, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (multiply (dest, src, multiplier, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier,
                                       Mode::mul (mult, s),
                                       JUCE_LOAD_SRC,
@@ -905,6 +1294,7 @@ namespace
     template <typename Size>
     void multiply (double* dest, const double* src, double multiplier, Size num) noexcept
     {
+        JUCE_DISPATCH_WIDE_VEC_OP (multiply (dest, src, multiplier, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier,
                                       Mode::mul (mult, s),
                                       JUCE_LOAD_SRC,
@@ -1099,6 +1489,7 @@ namespace
     Range<float> findMinAndMax (const float* src, Size num) noexcept
     {
        #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        JUCE_DISPATCH_WIDE_VEC_OP (findMinAndMax (src, num))
         return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinAndMax (src, num);
        #else
         return Range<float>::findMinAndMax (src, num);
@@ -1109,6 +1500,7 @@ namespace
     Range<double> findMinAndMax (const double* src, Size num) noexcept
     {
        #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        JUCE_DISPATCH_WIDE_VEC_OP (findMinAndMax (src, num))
         return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinAndMax (src, num);
        #else
         return Range<double>::findMinAndMax (src, num);
@@ -1119,6 +1511,7 @@ namespace
     float findMinimum (const float* src, Size num) noexcept
     {
        #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        JUCE_DISPATCH_WIDE_VEC_OP (findMinOrMax (src, num, true))
         return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinOrMax (src, num, true);
        #else
         return juce::findMinimum (src, num);
@@ -1129,6 +1522,7 @@ namespace
     double findMinimum (const double* src, Size num) noexcept
     {
        #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        JUCE_DISPATCH_WIDE_VEC_OP (findMinOrMax (src, num, true))
         return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinOrMax (src, num, true);
        #else
         return juce::findMinimum (src, num);
@@ -1139,6 +1533,7 @@ namespace
     float findMaximum (const float* src, Size num) noexcept
     {
        #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        JUCE_DISPATCH_WIDE_VEC_OP (findMinOrMax (src, num, false))
         return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinOrMax (src, num, false);
        #else
         return juce::findMaximum (src, num);
@@ -1149,6 +1544,7 @@ namespace
     double findMaximum (const double* src, Size num) noexcept
     {
        #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        JUCE_DISPATCH_WIDE_VEC_OP (findMinOrMax (src, num, false))
         return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinOrMax (src, num, false);
        #else
         return juce::findMaximum (src, num);
@@ -1164,6 +1560,7 @@ namespace
                                   JUCE_LOAD_NONE,
                                   JUCE_INCREMENT_SRC_DEST, )
        #else
+        JUCE_DISPATCH_WIDE_VEC_OP (convertFixedToFloat (dest, src, multiplier, num))
         JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = (float) src[i] * multiplier,
                                       Mode::mul (mult, _mm_cvtepi32_ps (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (src)))),
                                       JUCE_LOAD_NONE,
@@ -1702,11 +2099,191 @@ public:
             TestRunner<float>::runTest (*this, getRandom());
             TestRunner<double>::runTest (*this, getRandom());
         }
+
+       #if JUCE_USE_AVX_DISPATCH
+        using FloatVectorHelpers::WideInstructionSet;
+
+        auto& instructionSet = FloatVectorHelpers::getAvailableWideInstructionSet();
+        const auto best = instructionSet.load();
+
+        // Repeat the tests with each of the narrower instruction sets that this CPU can run
+        for (auto set : { WideInstructionSet::none, WideInstructionSet::avx2 })
+        {
+            if (set >= best)
+                continue;
+
+            beginTest (set == WideInstructionSet::avx2 ? "FloatVectorOperations (AVX2)" : "FloatVectorOperations (SSE)");
+
+            instructionSet = set;
+
+            for (int i = 1000; --i >= 0;)
+            {
+                TestRunner<float>::runTest (*this, getRandom());
+                TestRunner<double>::runTest (*this, getRandom());
+            }
+
+            instructionSet = best;
+        }
+
+        beginTest ("Wide instruction sets match SSE");
+        {
+            auto random = getRandom();
+
+            for (int i = 0; i < 100; ++i)
+            {
+                const auto num = random.nextInt ({ 1, 3000 });
+                compareWithSSE<float> (random, num, instructionSet);
+                compareWithSSE<double> (random, num, instructionSet);
+            }
+        }
+       #endif
+    }
+
+   #if JUCE_USE_AVX_DISPATCH
+    template <typename ValueType>
+    void compareWithSSE (Random& random, int num, std::atomic<FloatVectorHelpers::WideInstructionSet>& instructionSet)
+    {
+        const auto best = instructionSet.load();
+
+        HeapBlock<ValueType> src1 (num + 16), src2 (num + 16), wide (num + 16), narrow (num + 16);
+        HeapBlock<int> ints (num + 16);
+
+        const auto offset1 = random.nextInt (16), offset2 = random.nextInt (16), offset3 = random.nextInt (16);
+        auto* s1 = src1.get() + offset1;
+        auto* s2 = src2.get() + offset2;
+
+        for (int i = 0; i < num; ++i)
+        {
+            s1[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+            s2[i] = (ValueType) (random.nextDouble() * 2.0 - 1.0);
+            ints[i] = random.nextInt();
+        }
+
+        const auto compare = [&] (auto&& operation)
+        {
+            instructionSet = FloatVectorHelpers::WideInstructionSet::none;
+            FloatVectorOperations::copy (narrow.get() + offset3, s2, num);
+            operation (narrow.get() + offset3);
+
+            instructionSet = best;
+            FloatVectorOperations::copy (wide.get() + offset3, s2, num);
+            operation (wide.get() + offset3);
+
+            expect (std::equal (narrow.get() + offset3, narrow.get() + offset3 + num, wide.get() + offset3));
+        };
+
+        compare ([&] (ValueType* d) { FloatVectorOperations::add (d, s1, num); });
+        compare ([&] (ValueType* d) { FloatVectorOperations::add (d, (ValueType) 0.25, num); });
+        compare ([&] (ValueType* d) { FloatVectorOperations::subtract (d, s1, s2, num); });
+        compare ([&] (ValueType* d) { FloatVectorOperations::multiply (d, s1, num); });
+        compare ([&] (ValueType* d) { FloatVectorOperations::multiply (d, s1, (ValueType) 3, num); });
+        compare ([&] (ValueType* d) { FloatVectorOperations::addWithMultiply (d, s1, (ValueType) 0.5, num); });
+        compare ([&] (ValueType* d) { FloatVectorOperations::subtractWithMultiply (d, s1, s2, num); });
+        compare ([&] (ValueType* d) { FloatVectorOperations::copyWithMultiply (d, s1, (ValueType) -2, num); });
+
+        if (std::is_same<ValueType, float>::value)
+            compare ([&] (ValueType* d) { convertFixedToFloat (d, ints.get(), num); });
+
+        instructionSet = FloatVectorHelpers::WideInstructionSet::none;
+        const auto narrowRange = FloatVectorOperations::findMinAndMax (s1, num);
+        const auto narrowMax = FloatVectorOperations::findMaximum (s1, num);
+
+        instructionSet = best;
+        expect (narrowRange == FloatVectorOperations::findMinAndMax (s1, num));
+        expectEquals (FloatVectorOperations::findMaximum (s1, num), narrowMax);
     }
+
+    static void convertFixedToFloat (float* dest, const int* src, int num)   { FloatVectorOperations::convertFixedToFloat (dest, src, 1.0f / 0x7fffffff, num); }
+    static void convertFixedToFloat (double*, const int*, int)               {}
+   #endif
 };
 
 static FloatVectorOperationsTests vectorOpTests;
 
+//==============================================================================
+class FloatVectorOperationsBenchmarks  : public UnitTest
+{
+public:
+    FloatVectorOperationsBenchmarks()
+        : UnitTest ("FloatVectorOperations throughput", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+       #if JUCE_USE_AVX_DISPATCH
+        using FloatVectorHelpers::WideInstructionSet;
+
+        auto& instructionSet = FloatVectorHelpers::getAvailableWideInstructionSet();
+        const auto best = instructionSet.load();
+
+        for (auto set : { WideInstructionSet::none, WideInstructionSet::avx2, WideInstructionSet::avx512 })
+        {
+            if (set > best)
+                break;
+
+            instructionSet = set;
+            measure (set == WideInstructionSet::avx512 ? "AVX-512" : set == WideInstructionSet::avx2 ? "AVX2" : "SSE");
+        }
+
+        instructionSet = best;
+       #else
+        measure ("Default");
+       #endif
+    }
+
+private:
+    void measure (const String& instructionSetName)
+    {
+        beginTest (instructionSetName);
+
+        constexpr int maxSize = 16384, alignment = 64;
+        HeapBlock<char> memory ((maxSize + alignment) * sizeof (float) * 4 + alignment, true);
+        auto* base = reinterpret_cast<float*> ((reinterpret_cast<pointer_sized_int> (memory.get()) + alignment - 1) & ~(pointer_sized_int) (alignment - 1));
+
+        for (auto size : { 64, 256, 1024, 4096, maxSize })
+        {
+            // Offsetting by one float leaves every buffer misaligned for SSE and AVX
+            for (auto offset : { 0, 1 })
+            {
+                auto* dest = base + offset;
+                auto* src1 = dest + maxSize + alignment;
+                auto* src2 = src1 + maxSize + alignment;
+                auto* ints = reinterpret_cast<int*> (src2 + maxSize + alignment);
+
+                FloatVectorOperations::fill (src1, 0.5f, size);
+                FloatVectorOperations::fill (src2, 0.25f, size);
+
+                const auto numRepeats = jmax (64, (1 << 24) / size);
+
+                const auto time = [numRepeats, size] (auto&& operation)
+                {
+                    const auto start = Time::getHighResolutionTicks();
+
+                    for (int repeat = 0; repeat < numRepeats; ++repeat)
+                        operation();
+
+                    const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+                    return String (seconds * 1.0e9 / ((double) numRepeats * size), 3);
+                };
+
+                Range<float> range;
+
+                logMessage (String (size) + " samples, " + (offset == 0 ? "aligned" : "unaligned") + ", ns per sample:"
+                              + " add " + time ([&] { FloatVectorOperations::add (dest, src1, size); })
+                              + ", multiply " + time ([&] { FloatVectorOperations::multiply (dest, src1, src2, size); })
+                              + ", addWithMultiply " + time ([&] { FloatVectorOperations::addWithMultiply (dest, src1, 0.5f, size); })
+                              + ", copyWithMultiply " + time ([&] { FloatVectorOperations::copyWithMultiply (dest, src1, 0.5f, size); })
+                              + ", findMinAndMax " + time ([&] { range = range.getUnionWith (FloatVectorOperations::findMinAndMax (src1, size)); })
+                              + ", convertFixedToFloat " + time ([&] { FloatVectorOperations::convertFixedToFloat (dest, ints, 1.0f, size); }));
+
+                expect (! range.isEmpty() || range.getStart() == 0.0f);
+            }
+        }
+    }
+};
+
+static FloatVectorOperationsBenchmarks vectorOpBenchmarks;
+
 #endif
 
 } // namespace juce
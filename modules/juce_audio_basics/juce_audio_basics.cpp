@@ -39,6 +39,15 @@
  #include <emmintrin.h>
 #endif
 
+// The AVX kernels are built on the SSE ones
+#if JUCE_USE_AVX_DISPATCH && ! JUCE_USE_SSE_INTRINSICS
+ #undef JUCE_USE_AVX_DISPATCH
+#endif
+
+#if JUCE_USE_AVX_DISPATCH
+ #include <immintrin.h>
+#endif
+
 #ifndef JUCE_USE_VDSP_FRAMEWORK
  #define JUCE_USE_VDSP_FRAMEWORK 1
 #endif
@@ -61,6 +70,8 @@
 #include "utilities/juce_LagrangeInterpolator.cpp"
 #include "utilities/juce_WindowedSincInterpolator.cpp"
 #include "utilities/juce_Interpolators.cpp"
+#include "utilities/juce_PolyphaseResampler.cpp"
+#include "utilities/juce_FDNReverb.cpp"
 #include "utilities/juce_SmoothedValue.cpp"
 #include "midi/juce_MidiBuffer.cpp"
 #include "midi/juce_MidiFile.cpp"
@@ -68,6 +79,7 @@
 #include "midi/juce_MidiMessage.cpp"
 #include "midi/juce_MidiMessageSequence.cpp"
 #include "midi/juce_MidiRPN.cpp"
+#include "midi/juce_RealtimeMidiBuffer.cpp"
 #include "mpe/juce_MPEValue.cpp"
 #include "mpe/juce_MPENote.cpp"
 #include "mpe/juce_MPEZoneLayout.cpp"
@@ -82,6 +94,7 @@
 #include "sources/juce_IIRFilterAudioSource.cpp"
 #include "sources/juce_MemoryAudioSource.cpp"
 #include "sources/juce_MixerAudioSource.cpp"
+#include "sources/juce_PolyphaseResamplingAudioSource.cpp"
 #include "sources/juce_ResamplingAudioSource.cpp"
 #include "sources/juce_ReverbAudioSource.cpp"
 #include "sources/juce_ToneGeneratorAudioSource.cpp"
@@ -92,8 +105,13 @@
 #include "midi/ump/juce_UMPView.cpp"
 #include "midi/ump/juce_UMPSysEx7.cpp"
 #include "midi/ump/juce_UMPMidi1ToMidi2DefaultTranslator.cpp"
+#include "midi/juce_UMPBuffer.cpp"
 
 #if JUCE_UNIT_TESTS
  #include "utilities/juce_ADSR_test.cpp"
+ #include "utilities/juce_PolyphaseResampler_test.cpp"
+ #include "utilities/juce_FDNReverb_test.cpp"
+ #include "midi/juce_RealtimeMidiBuffer_test.cpp"
+ #include "midi/juce_UMPBuffer_test.cpp"
  #include "midi/ump/juce_UMP_test.cpp"
 #endif
@@ -70,7 +70,8 @@ namespace MidiBufferHelpers
         return 0;
     }
 
-    static uint8* findEventAfter (uint8* d, uint8* endData, int samplePosition) noexcept
+    template <typename Ptr>
+    static Ptr findEventAfter (Ptr d, Ptr endData, int samplePosition) noexcept
     {
         while (d < endData && getEventTime (d) <= samplePosition)
             d += getEventTotalSize (d);
@@ -155,14 +156,51 @@ bool MidiBuffer::addEvent (const void* newData, int maxBytes, int sampleNumber)
 void MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
                             int startSample, int numSamples, int sampleDeltaToAdd)
 {
-    for (auto i = otherBuffer.findNextSamplePosition (startSample); i != otherBuffer.cend(); ++i)
+    if (&otherBuffer == this)
     {
-        const auto metadata = *i;
+        const auto copy = otherBuffer;
+        addEvents (copy, startSample, numSamples, sampleDeltaToAdd);
+        return;
+    }
+
+    using namespace MidiBufferHelpers;
+
+    const auto* otherEnd = otherBuffer.data.end();
+    const auto* source = findEventAfter (otherBuffer.data.begin(), otherEnd, startSample - 1);
+    const auto* sourceEnd = numSamples >= 0 ? findEventAfter (source, otherEnd, startSample + numSamples - 1)
+                                            : otherEnd;
+
+    const auto numBytesToAdd = (int) (sourceEnd - source);
+
+    if (numBytesToAdd == 0)
+        return;
+
+    // Rather than inserting each event separately, move the existing events up
+    // and merge the two sorted lists into the space at the start. The write
+    // position can never overtake the read position, so this is done in place.
+    data.insertMultiple (0, 0, numBytesToAdd);
 
-        if (metadata.samplePosition >= startSample + numSamples && numSamples >= 0)
-            break;
+    auto* dest = data.begin();
+    auto* existing = dest + numBytesToAdd;
+    const auto* existingEnd = data.end();
+
+    while (source < sourceEnd)
+    {
+        const auto time = getEventTime (source) + sampleDeltaToAdd;
+
+        while (existing < existingEnd && getEventTime (existing) <= time)
+        {
+            const auto size = getEventTotalSize (existing);
+            memmove (dest, existing, size);
+            dest += size;
+            existing += size;
+        }
 
-        addEvent (metadata.data, metadata.numBytes, metadata.samplePosition + sampleDeltaToAdd);
+        const auto size = getEventTotalSize (source);
+        writeUnaligned<int32> (dest, time);
+        memcpy (dest + sizeof (int32), source + sizeof (int32), size - sizeof (int32));
+        dest += size;
+        source += size;
     }
 }
 
@@ -214,6 +214,9 @@ public:
 
     /** Adds some events from another buffer to this one.
 
+        The two sorted lists of events are merged in place, so this takes time
+        proportional to the total size of both buffers.
+
         @param otherBuffer          the buffer containing the events you want to add
         @param startSample          the lowest sample number in the source buffer for which
                                     events should be added. Any source events whose timestamp is
@@ -0,0 +1,416 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+namespace RealtimeMidiBufferHelpers
+{
+    // SysEx and meta-events are stored in the pool, preceded by their size
+    constexpr int sysExHeaderSize = (int) sizeof (uint32);
+
+    inline bool isStoredInPool (uint8 statusByte) noexcept
+    {
+        return statusByte == 0xf0 || statusByte == 0xf7 || statusByte == 0xff;
+    }
+
+    template <typename Type>
+    inline void moveRange (Type* data, int source, int destination, int num) noexcept
+    {
+        if (num > 0)
+            memmove (data + destination, data + source, (size_t) num * sizeof (Type));
+    }
+
+    struct MidiBufferSource
+    {
+        const uint8* data;
+
+        MidiMessageMetadata operator*() const noexcept     { return *MidiBufferIterator (data); }
+        void operator++() noexcept                          { data += MidiBufferHelpers::getEventTotalSize (data); }
+        bool operator!= (const MidiBufferSource& other) const noexcept  { return data != other.data; }
+    };
+}
+
+//==============================================================================
+RealtimeMidiBuffer::RealtimeMidiBuffer (int maxNumEvents, int maxNumSysExBytes)
+{
+    setCapacity (maxNumEvents, maxNumSysExBytes);
+}
+
+RealtimeMidiBuffer::RealtimeMidiBuffer (const RealtimeMidiBuffer& other)
+{
+    *this = other;
+}
+
+RealtimeMidiBuffer& RealtimeMidiBuffer::operator= (const RealtimeMidiBuffer& other)
+{
+    if (this != &other)
+    {
+        if (other.capacity > capacity || other.sysExUsed > sysExCapacity)
+            allocate (jmax (capacity, other.capacity), jmax (sysExCapacity, other.sysExUsed));
+
+        numEvents = other.numEvents;
+        sysExUsed = other.sysExUsed;
+
+        if (numEvents > 0)
+        {
+            memcpy (timestamps,   other.timestamps,   (size_t) numEvents * sizeof (int32));
+            memcpy (statusBytes,  other.statusBytes,  (size_t) numEvents);
+            memcpy (messageBytes, other.messageBytes, (size_t) numEvents * 4);
+        }
+
+        if (sysExUsed > 0)
+            memcpy (sysExData, other.sysExData, (size_t) sysExUsed);
+    }
+
+    return *this;
+}
+
+RealtimeMidiBuffer::RealtimeMidiBuffer (RealtimeMidiBuffer&& other) noexcept
+{
+    *this = std::move (other);
+}
+
+RealtimeMidiBuffer& RealtimeMidiBuffer::operator= (RealtimeMidiBuffer&& other) noexcept
+{
+    timestamps.swapWith (other.timestamps);
+    statusBytes.swapWith (other.statusBytes);
+    messageBytes.swapWith (other.messageBytes);
+    sysExData.swapWith (other.sysExData);
+    std::swap (numEvents, other.numEvents);
+    std::swap (capacity, other.capacity);
+    std::swap (sysExCapacity, other.sysExCapacity);
+    std::swap (sysExUsed, other.sysExUsed);
+    return *this;
+}
+
+RealtimeMidiBuffer::~RealtimeMidiBuffer() = default;
+
+//==============================================================================
+void RealtimeMidiBuffer::setCapacity (int maxNumEvents, int maxNumSysExBytes)
+{
+    allocate (maxNumEvents, maxNumSysExBytes);
+    clear();
+}
+
+void RealtimeMidiBuffer::allocate (int maxNumEvents, int maxNumSysExBytes)
+{
+    jassert (maxNumEvents >= 0 && maxNumSysExBytes >= 0);
+
+    capacity = jmax (0, maxNumEvents);
+    sysExCapacity = jmax (0, maxNumSysExBytes);
+
+    timestamps.realloc ((size_t) jmax (1, capacity));
+    statusBytes.realloc ((size_t) jmax (1, capacity));
+    messageBytes.realloc ((size_t) jmax (1, capacity) * 4);
+    sysExData.realloc ((size_t) jmax (1, sysExCapacity));
+}
+
+void RealtimeMidiBuffer::clear() noexcept
+{
+    numEvents = 0;
+    sysExUsed = 0;
+}
+
+void RealtimeMidiBuffer::clear (int startSample, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    const auto first = findNextSamplePosition (startSample);
+    const auto last  = findNextSamplePosition (startSample + numSamples);
+    const auto numToMove = numEvents - last;
+
+    RealtimeMidiBufferHelpers::moveRange (timestamps.get(),   last,     first,     numToMove);
+    RealtimeMidiBufferHelpers::moveRange (statusBytes.get(),  last,     first,     numToMove);
+    RealtimeMidiBufferHelpers::moveRange (messageBytes.get(), last * 4, first * 4, numToMove * 4);
+
+    numEvents -= last - first;
+}
+
+int RealtimeMidiBuffer::findNextSamplePosition (int samplePosition) const noexcept
+{
+    return (int) (std::lower_bound (timestamps.get(), timestamps + numEvents, samplePosition) - timestamps.get());
+}
+
+MidiMessageMetadata RealtimeMidiBuffer::getEvent (int index) const noexcept
+{
+    jassert (isPositiveAndBelow (index, numEvents));
+
+    const auto* slot = messageBytes + 4 * index;
+
+    if (RealtimeMidiBufferHelpers::isStoredInPool (statusBytes[index]))
+    {
+        const auto* entry = sysExData + readUnaligned<uint32> (slot);
+        return { entry + RealtimeMidiBufferHelpers::sysExHeaderSize, (int) readUnaligned<uint32> (entry), timestamps[index] };
+    }
+
+    return { slot, MidiMessage::getMessageLengthFromFirstByte (statusBytes[index]), timestamps[index] };
+}
+
+//==============================================================================
+bool RealtimeMidiBuffer::addEvent (const MidiMessage& m, int sampleNumber) noexcept
+{
+    return addEvent (m.getRawData(), m.getRawDataSize(), sampleNumber);
+}
+
+bool RealtimeMidiBuffer::addEvent (const void* newData, int maxBytes, int sampleNumber) noexcept
+{
+    const auto* bytes = static_cast<const uint8*> (newData);
+    const auto numBytes = MidiBufferHelpers::findActualEventLength (bytes, maxBytes);
+
+    if (numBytes <= 0)
+        return true;
+
+    // Like MidiBuffer, this only supports messages smaller than (1 << 16) bytes
+    if (numEvents >= capacity || std::numeric_limits<uint16>::max() < numBytes)
+        return false;
+
+    if (RealtimeMidiBufferHelpers::isStoredInPool (bytes[0])
+         && sysExUsed + RealtimeMidiBufferHelpers::sysExHeaderSize + numBytes > sysExCapacity)
+        return false;
+
+    // Adding events in time order is the common case, so avoid the search if possible
+    const auto index = (numEvents == 0 || sampleNumber >= timestamps[numEvents - 1])
+                          ? numEvents
+                          : (int) (std::upper_bound (timestamps.get(), timestamps + numEvents, sampleNumber) - timestamps.get());
+
+    const auto numToMove = numEvents - index;
+
+    RealtimeMidiBufferHelpers::moveRange (timestamps.get(),   index,     index + 1,       numToMove);
+    RealtimeMidiBufferHelpers::moveRange (statusBytes.get(),  index,     index + 1,       numToMove);
+    RealtimeMidiBufferHelpers::moveRange (messageBytes.get(), index * 4, (index + 1) * 4, numToMove * 4);
+
+    ++numEvents;
+    storeEvent (index, bytes, numBytes, sampleNumber);
+    return true;
+}
+
+void RealtimeMidiBuffer::storeEvent (int index, const uint8* data, int numBytes, int sampleNumber) noexcept
+{
+    timestamps[index] = sampleNumber;
+    statusBytes[index] = data[0];
+
+    auto* slot = messageBytes + 4 * index;
+
+    if (RealtimeMidiBufferHelpers::isStoredInPool (data[0]))
+    {
+        jassert (sysExUsed + RealtimeMidiBufferHelpers::sysExHeaderSize + numBytes <= sysExCapacity);
+
+        writeUnaligned<uint32> (slot, (uint32) sysExUsed);
+        writeUnaligned<uint32> (sysExData + sysExUsed, (uint32) numBytes);
+        memcpy (sysExData + sysExUsed + RealtimeMidiBufferHelpers::sysExHeaderSize, data, (size_t) numBytes);
+        sysExUsed += RealtimeMidiBufferHelpers::sysExHeaderSize + numBytes;
+    }
+    else
+    {
+        jassert (numBytes <= 3);
+
+        writeUnaligned<uint32> (slot, 0);
+        memcpy (slot, data, (size_t) jmin (3, numBytes));
+    }
+}
+
+void RealtimeMidiBuffer::moveEvent (int source, int destination) noexcept
+{
+    timestamps[destination] = timestamps[source];
+    statusBytes[destination] = statusBytes[source];
+    memcpy (messageBytes + 4 * destination, messageBytes + 4 * source, 4);
+}
+
+//==============================================================================
+template <typename SourceIterator>
+bool RealtimeMidiBuffer::mergeEvents (SourceIterator first, SourceIterator last,
+                                      int startSample, int numSamples, int sampleDeltaToAdd) noexcept
+{
+    using namespace RealtimeMidiBufferHelpers;
+
+    // First, find the events that are in range, and how many of them will fit
+    while (first != last && (*first).samplePosition < startSample)
+        ++first;
+
+    auto end = first;
+    int numToAdd = 0, sysExBytesNeeded = 0;
+    bool allAdded = true;
+
+    for (; end != last; ++end)
+    {
+        const auto metadata = *end;
+
+        if (numSamples >= 0 && metadata.samplePosition >= startSample + numSamples)
+            break;
+
+        const auto sysExBytes = isStoredInPool (metadata.data[0]) ? sysExHeaderSize + metadata.numBytes : 0;
+
+        if (numEvents + numToAdd >= capacity || sysExUsed + sysExBytesNeeded + sysExBytes > sysExCapacity)
+        {
+            allAdded = false;
+            break;
+        }
+
+        sysExBytesNeeded += sysExBytes;
+        ++numToAdd;
+    }
+
+    if (numToAdd == 0)
+        return allAdded;
+
+    // Then move the existing events up to make space, and merge the two lists forwards
+    // into the space at the start. The write position can never overtake the read position.
+    moveRange (timestamps.get(),   0, numToAdd,     numEvents);
+    moveRange (statusBytes.get(),  0, numToAdd,     numEvents);
+    moveRange (messageBytes.get(), 0, numToAdd * 4, numEvents * 4);
+
+    auto readIndex = numToAdd;
+    const auto readEnd = numToAdd + numEvents;
+    int writeIndex = 0;
+
+    for (auto source = first; source != end; ++source)
+    {
+        const auto metadata = *source;
+        const auto time = metadata.samplePosition + sampleDeltaToAdd;
+
+        while (readIndex < readEnd && timestamps[readIndex] <= time)
+            moveEvent (readIndex++, writeIndex++);
+
+        storeEvent (writeIndex++, metadata.data, metadata.numBytes, time);
+    }
+
+    numEvents += numToAdd;
+    return allAdded;
+}
+
+bool RealtimeMidiBuffer::addEvents (const RealtimeMidiBuffer& otherBuffer,
+                                    int startSample, int numSamples, int sampleDeltaToAdd) noexcept
+{
+    // You can't merge a buffer into itself!
+    jassert (&otherBuffer != this);
+
+    if (&otherBuffer == this)
+        return false;
+
+    using namespace RealtimeMidiBufferHelpers;
+
+    // This does the same as mergeEvents(), but can use the other buffer's arrays directly
+    const auto first = otherBuffer.findNextSamplePosition (startSample);
+    auto last = numSamples >= 0 ? otherBuffer.findNextSamplePosition (startSample + numSamples)
+                                : otherBuffer.numEvents;
+
+    bool allAdded = true;
+
+    if (last - first > capacity - numEvents)
+    {
+        last = first + capacity - numEvents;
+        allAdded = false;
+    }
+
+    if (otherBuffer.sysExUsed > 0)
+    {
+        int sysExBytesNeeded = 0;
+
+        for (int i = first; i < last; ++i)
+        {
+            if (isStoredInPool (otherBuffer.statusBytes[i]))
+            {
+                sysExBytesNeeded += sysExHeaderSize + otherBuffer.getEvent (i).numBytes;
+
+                if (sysExUsed + sysExBytesNeeded > sysExCapacity)
+                {
+                    last = i;
+                    allAdded = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    const auto numToAdd = last - first;
+
+    if (numToAdd <= 0)
+        return allAdded;
+
+    moveRange (timestamps.get(),   0, numToAdd,     numEvents);
+    moveRange (statusBytes.get(),  0, numToAdd,     numEvents);
+    moveRange (messageBytes.get(), 0, numToAdd * 4, numEvents * 4);
+
+    auto readIndex = numToAdd;
+    const auto readEnd = numToAdd + numEvents;
+    int writeIndex = 0;
+
+    for (int i = first; i < last; ++i)
+    {
+        const auto time = otherBuffer.timestamps[i] + sampleDeltaToAdd;
+
+        while (readIndex < readEnd && timestamps[readIndex] <= time)
+            moveEvent (readIndex++, writeIndex++);
+
+        if (isStoredInPool (otherBuffer.statusBytes[i]))
+        {
+            const auto event = otherBuffer.getEvent (i);
+            storeEvent (writeIndex++, event.data, event.numBytes, time);
+        }
+        else
+        {
+            timestamps[writeIndex] = time;
+            statusBytes[writeIndex] = otherBuffer.statusBytes[i];
+            memcpy (messageBytes + 4 * writeIndex, otherBuffer.messageBytes + 4 * i, 4);
+            ++writeIndex;
+        }
+    }
+
+    numEvents += numToAdd;
+    return allAdded;
+}
+
+bool RealtimeMidiBuffer::addEvents (const MidiBuffer& otherBuffer,
+                                    int startSample, int numSamples, int sampleDeltaToAdd) noexcept
+{
+    using Source = RealtimeMidiBufferHelpers::MidiBufferSource;
+    return mergeEvents (Source { otherBuffer.data.begin() }, Source { otherBuffer.data.end() },
+                        startSample, numSamples, sampleDeltaToAdd);
+}
+
+void RealtimeMidiBuffer::copyTo (MidiBuffer& destination) const
+{
+    constexpr auto headerSize = (int) (sizeof (int32) + sizeof (uint16));
+
+    int totalSize = 0;
+
+    for (const auto metadata : *this)
+        totalSize += headerSize + metadata.numBytes;
+
+    destination.data.clearQuick();
+    destination.data.resize (totalSize);
+
+    auto* d = destination.data.begin();
+
+    for (const auto metadata : *this)
+    {
+        writeUnaligned<int32>  (d, metadata.samplePosition);
+        writeUnaligned<uint16> (d + sizeof (int32), (uint16) metadata.numBytes);
+        memcpy (d + headerSize, metadata.data, (size_t) metadata.numBytes);
+        d += headerSize + metadata.numBytes;
+    }
+}
+
+} // namespace juce
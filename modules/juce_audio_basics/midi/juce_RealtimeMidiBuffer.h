@@ -0,0 +1,284 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A fixed-capacity, sorted list of time-stamped MIDI events, which never allocates
+    memory once it has been given a capacity.
+
+    This provides much the same functionality as a MidiBuffer, but is designed for use
+    in busy realtime code:
+
+    - All the storage is allocated by setCapacity(), so adding events on the audio
+      thread will never allocate. Events that don't fit are dropped, and the add
+      methods return false.
+    - Appending an event in time order is constant-time, and merging another sorted
+      buffer with addEvents() takes linear time, rather than inserting each event
+      separately.
+    - The events are stored as a structure-of-arrays, so code that filters or counts
+      events can scan the timestamps and status bytes as contiguous arrays, which the
+      compiler can vectorise, instead of walking a packed byte stream.
+
+    Messages of up to three bytes are stored inline. SysEx and meta-events are copied
+    into a separate pool, whose space is reclaimed only when the whole buffer is cleared.
+
+    @code
+    void processBlock (AudioBuffer<float>&, MidiBuffer& midi) override
+    {
+        events.clear();
+        events.addEvents (midi, 0, -1, 0);
+        events.addEvents (generatedEvents, 0, -1, 0);
+
+        // Count the note-ons using the status byte array
+        const auto* status = events.getStatusBytes();
+        int numNoteOns = 0;
+
+        for (int i = 0; i < events.getNumEvents(); ++i)
+            numNoteOns += (status[i] & 0xf0) == 0x90 ? 1 : 0;
+
+        for (const auto metadata : events)
+            handleMessage (metadata.data, metadata.numBytes, metadata.samplePosition);
+    }
+    @endcode
+
+    @see MidiBuffer
+    @tags{Audio}
+*/
+class JUCE_API  RealtimeMidiBuffer
+{
+public:
+    //==============================================================================
+    /** Creates an empty buffer with no capacity. Call setCapacity() before using it. */
+    RealtimeMidiBuffer() noexcept = default;
+
+    /** Creates an empty buffer with the given capacity.
+        @see setCapacity
+    */
+    explicit RealtimeMidiBuffer (int maxNumEvents, int maxNumSysExBytes = 2048);
+
+    /** Creates a copy of another buffer, with the same capacity. */
+    RealtimeMidiBuffer (const RealtimeMidiBuffer&);
+
+    /** Replaces the contents of this buffer with a copy of another one.
+        This will only allocate if the other buffer has a larger capacity than this one.
+    */
+    RealtimeMidiBuffer& operator= (const RealtimeMidiBuffer&);
+
+    RealtimeMidiBuffer (RealtimeMidiBuffer&&) noexcept;
+    RealtimeMidiBuffer& operator= (RealtimeMidiBuffer&&) noexcept;
+
+    /** Destructor. */
+    ~RealtimeMidiBuffer();
+
+    //==============================================================================
+    /** Allocates space for a number of events, and clears the buffer.
+
+        This is the only method that allocates memory, so call it before the buffer is
+        used on the audio thread, e.g. in prepareToPlay().
+
+        @param maxNumEvents       the maximum number of events that the buffer can hold
+        @param maxNumSysExBytes   the total number of bytes of SysEx and meta-event data that
+                                  the buffer can hold between calls to clear()
+    */
+    void setCapacity (int maxNumEvents, int maxNumSysExBytes = 2048);
+
+    /** Returns the maximum number of events that the buffer can hold. */
+    int getCapacity() const noexcept                    { return capacity; }
+
+    //==============================================================================
+    /** Removes all events from the buffer. */
+    void clear() noexcept;
+
+    /** Removes all events between two times from the buffer.
+        All events for which (start <= event position < start + numSamples) will
+        be removed.
+    */
+    void clear (int start, int numSamples) noexcept;
+
+    /** Returns true if the buffer is empty. */
+    bool isEmpty() const noexcept                       { return numEvents == 0; }
+
+    /** Returns the number of events in the buffer.
+        Unlike MidiBuffer::getNumEvents(), this is a constant-time operation.
+    */
+    int getNumEvents() const noexcept                   { return numEvents; }
+
+    /** Returns the sample number of the first event in the buffer, or 0 if it's empty. */
+    int getFirstEventTime() const noexcept              { return numEvents > 0 ? timestamps[0] : 0; }
+
+    /** Returns the sample number of the last event in the buffer, or 0 if it's empty. */
+    int getLastEventTime() const noexcept               { return numEvents > 0 ? timestamps[numEvents - 1] : 0; }
+
+    //==============================================================================
+    /** Adds an event to the buffer.
+
+        If an event is added whose sample position is the same as one or more events
+        already in the buffer, the new event will be placed after the existing ones.
+        Adding an event at or after the last event in the buffer is a constant-time
+        operation.
+
+        Returns false if there wasn't enough space left for the event.
+    */
+    bool addEvent (const MidiMessage& midiMessage, int sampleNumber) noexcept;
+
+    /** Adds an event to the buffer from raw midi data.
+
+        The event data will be inspected in the same way as MidiBuffer::addEvent() does, to
+        calculate the number of bytes that the event actually uses.
+
+        Returns false if there wasn't enough space left for the event.
+    */
+    bool addEvent (const void* rawMidiData, int maxBytesOfMidiData, int sampleNumber) noexcept;
+
+    /** Merges some events from another buffer into this one.
+
+        This takes time proportional to the total number of events in both buffers.
+        Events from the other buffer are placed after any events in this buffer with the
+        same sample position. The parameters have the same meaning as in
+        MidiBuffer::addEvents().
+
+        Returns false if some of the events were dropped because this buffer was full.
+    */
+    bool addEvents (const RealtimeMidiBuffer& otherBuffer,
+                    int startSample,
+                    int numSamples,
+                    int sampleDeltaToAdd) noexcept;
+
+    /** Merges some events from a MidiBuffer into this one.
+
+        This takes time proportional to the total number of events in both buffers.
+
+        Returns false if some of the events were dropped because this buffer was full.
+    */
+    bool addEvents (const MidiBuffer& otherBuffer,
+                    int startSample,
+                    int numSamples,
+                    int sampleDeltaToAdd) noexcept;
+
+    /** Replaces the contents of a MidiBuffer with the events in this buffer.
+
+        This takes time proportional to the number of events, and won't allocate if the
+        MidiBuffer already has enough space, e.g. after a call to MidiBuffer::ensureSize().
+    */
+    void copyTo (MidiBuffer& destination) const;
+
+    //==============================================================================
+    /** Removes all the events for which the predicate returns true, keeping the order of
+        the others.
+
+        The predicate is called with the index of each event, so it can examine the
+        arrays returned by getTimestamps(), getStatusBytes() and getMessageBytes().
+    */
+    template <typename Predicate>
+    void removeIf (Predicate&& shouldRemove)
+    {
+        int numKept = 0;
+
+        for (int i = 0; i < numEvents; ++i)
+            if (! shouldRemove (i))
+                moveEvent (i, numKept++);
+
+        numEvents = numKept;
+    }
+
+    //==============================================================================
+    /** Returns the sample positions of the events, in ascending order.
+        The array has getNumEvents() elements.
+    */
+    const int32* getTimestamps() const noexcept         { return timestamps; }
+
+    /** Returns the status bytes of the events.
+        The array has getNumEvents() elements. SysEx and meta-events have status bytes of
+        0xf0, 0xf7 or 0xff.
+    */
+    const uint8* getStatusBytes() const noexcept        { return statusBytes; }
+
+    /** Returns the data of the events that are up to three bytes long, as four bytes per event.
+
+        For event i, the message's bytes begin at getMessageBytes()[4 * i], starting with
+        the status byte, and are padded with zeros. For SysEx and meta-events, these four
+        bytes are used internally, so call getEvent() to get their data.
+    */
+    const uint8* getMessageBytes() const noexcept       { return messageBytes; }
+
+    /** Returns a description of an event, which refers to the data inside this buffer. */
+    MidiMessageMetadata getEvent (int index) const noexcept;
+
+    //==============================================================================
+    /** Iterates over the events in a RealtimeMidiBuffer, giving a MidiMessageMetadata for each. */
+    class Iterator
+    {
+    public:
+        using difference_type   = int;
+        using value_type        = MidiMessageMetadata;
+        using reference         = MidiMessageMetadata;
+        using pointer           = void;
+        using iterator_category = std::input_iterator_tag;
+
+        Iterator (const RealtimeMidiBuffer& b, int i) noexcept : buffer (&b), index (i) {}
+
+        Iterator& operator++() noexcept                             { ++index; return *this; }
+        Iterator operator++ (int) noexcept                          { auto copy = *this; ++index; return copy; }
+        bool operator== (const Iterator& other) const noexcept      { return index == other.index; }
+        bool operator!= (const Iterator& other) const noexcept      { return index != other.index; }
+        reference operator*() const noexcept                        { return buffer->getEvent (index); }
+
+        /** Returns the index of the event that this iterator refers to. */
+        int getIndex() const noexcept                               { return index; }
+
+    private:
+        const RealtimeMidiBuffer* buffer;
+        int index;
+    };
+
+    /** Get a read-only iterator pointing to the beginning of this buffer. */
+    Iterator begin() const noexcept                     { return { *this, 0 }; }
+
+    /** Get a read-only iterator pointing one past the end of this buffer. */
+    Iterator end() const noexcept                       { return { *this, numEvents }; }
+
+    /** Returns the index of the first event with a timestamp greater-than or equal-to
+        `samplePosition`, using a binary search.
+    */
+    int findNextSamplePosition (int samplePosition) const noexcept;
+
+private:
+    //==============================================================================
+    void allocate (int maxNumEvents, int maxNumSysExBytes);
+    void storeEvent (int index, const uint8* data, int numBytes, int sampleNumber) noexcept;
+    void moveEvent (int source, int destination) noexcept;
+
+    template <typename SourceIterator>
+    bool mergeEvents (SourceIterator begin, SourceIterator end, int startSample, int numSamples, int sampleDeltaToAdd) noexcept;
+
+    HeapBlock<int32> timestamps;
+    HeapBlock<uint8> statusBytes, messageBytes, sysExData;
+    int numEvents = 0, capacity = 0, sysExCapacity = 0, sysExUsed = 0;
+
+    JUCE_LEAK_DETECTOR (RealtimeMidiBuffer)
+};
+
+} // namespace juce
@@ -0,0 +1,335 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+class RealtimeMidiBufferTests  : public UnitTest
+{
+public:
+    RealtimeMidiBufferTests()
+        : UnitTest ("RealtimeMidiBuffer", UnitTestCategories::midi)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Events are kept in order, with later additions after existing events at the same time");
+        {
+            RealtimeMidiBuffer buffer (16);
+
+            expect (buffer.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 10));
+            expect (buffer.addEvent (MidiMessage::noteOn (1, 61, (uint8) 100), 5));
+            expect (buffer.addEvent (MidiMessage::noteOn (1, 62, (uint8) 100), 10));
+            expect (buffer.addEvent (MidiMessage::noteOff (1, 63), 0));
+
+            MidiBuffer reference;
+            reference.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 10);
+            reference.addEvent (MidiMessage::noteOn (1, 61, (uint8) 100), 5);
+            reference.addEvent (MidiMessage::noteOn (1, 62, (uint8) 100), 10);
+            reference.addEvent (MidiMessage::noteOff (1, 63), 0);
+
+            expect (matches (buffer, reference));
+            expectEquals (buffer.getNumEvents(), 4);
+            expectEquals (buffer.getFirstEventTime(), 0);
+            expectEquals (buffer.getLastEventTime(), 10);
+            expectEquals (buffer.findNextSamplePosition (6), 2);
+        }
+
+        beginTest ("The structure-of-arrays view describes the events");
+        {
+            RealtimeMidiBuffer buffer (16);
+            buffer.addEvent (MidiMessage::controllerEvent (3, 7, 99), 2);
+            buffer.addEvent (MidiMessage::programChange (2, 5), 4);
+
+            expectEquals ((int) buffer.getTimestamps()[0], 2);
+            expectEquals ((int) buffer.getStatusBytes()[0], 0xb2);
+            expectEquals ((int) buffer.getMessageBytes()[1], 7);
+            expectEquals ((int) buffer.getMessageBytes()[2], 99);
+
+            expectEquals ((int) buffer.getTimestamps()[1], 4);
+            expectEquals ((int) buffer.getStatusBytes()[1], 0xc1);
+            expectEquals ((int) buffer.getMessageBytes()[5], 5);
+            expectEquals (buffer.getEvent (1).numBytes, 2);
+        }
+
+        beginTest ("SysEx messages are stored in the pool");
+        {
+            RealtimeMidiBuffer buffer (8, 32);
+            const uint8 sysEx[] = { 0xf0, 1, 2, 3, 4, 5, 0xf7 };
+
+            expect (buffer.addEvent (sysEx, (int) sizeof (sysEx), 3));
+            expect (buffer.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 1));
+
+            const auto event = buffer.getEvent (1);
+            expectEquals (event.numBytes, (int) sizeof (sysEx));
+            expectEquals (event.samplePosition, 3);
+            expect (std::equal (sysEx, sysEx + sizeof (sysEx), event.data));
+
+            expect (buffer.addEvent (sysEx, (int) sizeof (sysEx), 4));
+            expect (! buffer.addEvent (sysEx, (int) sizeof (sysEx), 5));
+            expectEquals (buffer.getNumEvents(), 3);
+
+            buffer.clear();
+            expect (buffer.addEvent (sysEx, (int) sizeof (sysEx), 5));
+        }
+
+        beginTest ("Events that don't fit are dropped");
+        {
+            RealtimeMidiBuffer buffer (3);
+
+            for (int i = 0; i < 3; ++i)
+                expect (buffer.addEvent (MidiMessage::noteOn (1, 60 + i, (uint8) 100), i));
+
+            expect (! buffer.addEvent (MidiMessage::noteOn (1, 70, (uint8) 100), 0));
+            expectEquals (buffer.getNumEvents(), 3);
+            expectEquals ((int) buffer.getEvent (0).data[1], 60);
+
+            RealtimeMidiBuffer other (4);
+            other.addEvent (MidiMessage::noteOff (1, 80), 0);
+
+            expect (! buffer.addEvents (other, 0, -1, 0));
+            expectEquals (buffer.getNumEvents(), 3);
+        }
+
+        beginTest ("Merging gives the same results as MidiBuffer");
+        {
+            auto random = getRandom();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                const auto a = createRandomBuffer (random, random.nextInt (200));
+                const auto b = createRandomBuffer (random, random.nextInt (200));
+                const auto startSample = random.nextInt (200) - 50;
+                const auto numSamples = random.nextInt (300) - 20;
+                const auto delta = random.nextInt (40) - 20;
+
+                MidiBuffer reference (a);
+
+                for (const auto metadata : b)
+                    if (metadata.samplePosition >= startSample && (numSamples < 0 || metadata.samplePosition < startSample + numSamples))
+                        reference.addEvent (metadata.data, metadata.numBytes, metadata.samplePosition + delta);
+
+                RealtimeMidiBuffer fromMidiBuffer (1000, 10000), fromRealtimeBuffer (1000, 10000), source (1000, 10000);
+                fromMidiBuffer.addEvents (a, 0, -1, 0);
+                fromRealtimeBuffer = fromMidiBuffer;
+                source.addEvents (b, 0, -1, 0);
+
+                expect (fromMidiBuffer.addEvents (b, startSample, numSamples, delta));
+                expect (fromRealtimeBuffer.addEvents (source, startSample, numSamples, delta));
+
+                expect (matches (fromMidiBuffer, reference));
+                expect (matches (fromRealtimeBuffer, reference));
+
+                MidiBuffer merged (a);
+                merged.addEvents (b, startSample, numSamples, delta);
+                expect (merged.data == reference.data);
+
+                MidiBuffer copied;
+                fromRealtimeBuffer.copyTo (copied);
+                expect (copied.data == reference.data);
+            }
+        }
+
+        beginTest ("Clearing a range and filtering keep the other events");
+        {
+            auto random = getRandom();
+            const auto reference = createRandomBuffer (random, 300);
+
+            RealtimeMidiBuffer buffer (300, 10000);
+            buffer.addEvents (reference, 0, -1, 0);
+
+            auto cleared = reference;
+            cleared.clear (40, 60);
+            buffer.clear (40, 60);
+            expect (matches (buffer, cleared));
+
+            MidiBuffer filtered;
+
+            for (const auto metadata : cleared)
+                if ((metadata.data[0] & 0xf0) != 0x90)
+                    filtered.addEvent (metadata.data, metadata.numBytes, metadata.samplePosition);
+
+            const auto* status = buffer.getStatusBytes();
+            buffer.removeIf ([status] (int i) { return (status[i] & 0xf0) == 0x90; });
+            expect (matches (buffer, filtered));
+        }
+    }
+
+    static MidiBuffer createRandomBuffer (Random& random, int numEvents)
+    {
+        MidiBuffer buffer;
+
+        for (int i = 0; i < numEvents; ++i)
+        {
+            const auto time = random.nextInt (256);
+
+            switch (random.nextInt (5))
+            {
+                case 0:
+                {
+                    uint8 sysEx[10] = { 0xf0 };
+
+                    for (int j = 1; j < 9; ++j)
+                        sysEx[j] = (uint8) random.nextInt (128);
+
+                    sysEx[9] = 0xf7;
+                    buffer.addEvent (sysEx, (int) sizeof (sysEx), time);
+                    break;
+                }
+
+                case 1:     buffer.addEvent (MidiMessage::channelPressureChange (1 + random.nextInt (16), random.nextInt (128)), time); break;
+                case 2:     buffer.addEvent (MidiMessage::noteOff (1 + random.nextInt (16), random.nextInt (128)), time); break;
+                default:    buffer.addEvent (MidiMessage::noteOn (1 + random.nextInt (16), random.nextInt (128), (uint8) 100), time); break;
+            }
+        }
+
+        return buffer;
+    }
+
+    static bool matches (const RealtimeMidiBuffer& buffer, const MidiBuffer& reference)
+    {
+        auto it = buffer.begin();
+
+        for (const auto expected : reference)
+        {
+            if (it == buffer.end())
+                return false;
+
+            const auto actual = *it++;
+
+            if (actual.samplePosition != expected.samplePosition
+                 || actual.numBytes != expected.numBytes
+                 || ! std::equal (expected.data, expected.data + expected.numBytes, actual.data))
+                return false;
+        }
+
+        return it == buffer.end();
+    }
+};
+
+static RealtimeMidiBufferTests realtimeMidiBufferTests;
+
+//==============================================================================
+class RealtimeMidiBufferBenchmarks  : public UnitTest
+{
+public:
+    RealtimeMidiBufferBenchmarks()
+        : UnitTest ("RealtimeMidiBuffer throughput", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Merging and iterating 10000 events per block");
+
+        constexpr int numEventsPerSource = 5000, numSources = 2, blockSize = 512, numBlocks = 50;
+        auto random = getRandom();
+
+        std::vector<MidiBuffer> sources;
+        std::vector<RealtimeMidiBuffer> realtimeSources;
+
+        for (int i = 0; i < numSources; ++i)
+        {
+            MidiBuffer source;
+
+            for (int n = 0; n < numEventsPerSource; ++n)
+                source.addEvent (MidiMessage::noteOn (1 + random.nextInt (16), random.nextInt (128), (uint8) 100),
+                                 n * blockSize / numEventsPerSource);
+
+            sources.push_back (source);
+            realtimeSources.emplace_back (numEventsPerSource);
+            realtimeSources.back().addEvents (source, 0, -1, 0);
+        }
+
+        const auto time = [] (int numIterations, auto&& fn)
+        {
+            const auto start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numIterations; ++i)
+                fn();
+
+            return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6 / numIterations;
+        };
+
+        MidiBuffer midiBuffer;
+        midiBuffer.ensureSize ((size_t) (numSources * numEventsPerSource * 10));
+        RealtimeMidiBuffer realtimeBuffer (numSources * numEventsPerSource);
+
+        const auto addEventTime = time (2, [&]
+        {
+            midiBuffer.clear();
+
+            for (auto& source : sources)
+                for (const auto metadata : source)
+                    midiBuffer.addEvent (metadata.data, metadata.numBytes, metadata.samplePosition);
+        });
+
+        const auto midiBufferMergeTime = time (numBlocks, [&]
+        {
+            midiBuffer.clear();
+
+            for (auto& source : sources)
+                midiBuffer.addEvents (source, 0, -1, 0);
+        });
+
+        const auto realtimeMergeTime = time (numBlocks, [&]
+        {
+            realtimeBuffer.clear();
+
+            for (auto& source : realtimeSources)
+                realtimeBuffer.addEvents (source, 0, -1, 0);
+        });
+
+        int numNoteOns = 0;
+
+        const auto midiBufferIterationTime = time (numBlocks, [&]
+        {
+            for (const auto metadata : midiBuffer)
+                numNoteOns += (metadata.data[0] & 0xf0) == 0x90 ? 1 : 0;
+        });
+
+        const auto realtimeIterationTime = time (numBlocks, [&]
+        {
+            const auto* status = realtimeBuffer.getStatusBytes();
+            const auto numEvents = realtimeBuffer.getNumEvents();
+            int count = 0;
+
+            for (int i = 0; i < numEvents; ++i)
+                count += (status[i] & 0xf0) == 0x90 ? 1 : 0;
+
+            numNoteOns += count;
+        });
+
+        logMessage ("Merge, microseconds per block: MidiBuffer::addEvent " + String (addEventTime, 1)
+                      + ", MidiBuffer::addEvents " + String (midiBufferMergeTime, 1)
+                      + ", RealtimeMidiBuffer::addEvents " + String (realtimeMergeTime, 1));
+
+        logMessage ("Counting note-ons, microseconds per block: MidiBuffer " + String (midiBufferIterationTime, 2)
+                      + ", RealtimeMidiBuffer " + String (realtimeIterationTime, 2));
+
+        expectEquals (numNoteOns, 2 * numBlocks * numSources * numEventsPerSource);
+    }
+};
+
+static RealtimeMidiBufferBenchmarks realtimeMidiBufferBenchmarks;
+
+} // namespace juce
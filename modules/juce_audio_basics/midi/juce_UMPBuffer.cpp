@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace UMPBufferHelpers
+{
+    inline int getEventTotalSize (const uint32* d) noexcept
+    {
+        return 1 + UMPBuffer::getNumWordsForPacket (d[1]);
+    }
+
+    template <typename Ptr>
+    static Ptr findEventAfter (Ptr d, Ptr endData, int samplePosition) noexcept
+    {
+        while (d < endData && (int) *d <= samplePosition)
+            d += getEventTotalSize (d);
+
+        return d;
+    }
+
+    // Appends a message to a MidiBuffer whose last event is no later than sampleNumber,
+    // without searching for the insertion point.
+    static void appendEvent (MidiBuffer& buffer, const uint8* message, int numBytes, int sampleNumber)
+    {
+        constexpr auto headerSize = (int) (sizeof (int32) + sizeof (uint16));
+
+        const auto offset = buffer.data.size();
+        buffer.data.resize (offset + headerSize + numBytes);
+
+        auto* d = buffer.data.begin() + offset;
+        writeUnaligned<int32>  (d, sampleNumber);
+        writeUnaligned<uint16> (d + sizeof (int32), (uint16) numBytes);
+        memcpy (d + headerSize, message, (size_t) numBytes);
+    }
+}
+
+//==============================================================================
+void UMPBuffer::clear() noexcept                            { data.clearQuick(); }
+void UMPBuffer::ensureSize (size_t minimumNumWords)         { data.ensureStorageAllocated ((int) minimumNumWords); }
+
+void UMPBuffer::swapWith (UMPBuffer& other) noexcept
+{
+    data.swapWith (other.data);
+    std::swap (lastEventTime, other.lastEventTime);
+}
+
+void UMPBuffer::clear (int startSample, int numSamples)
+{
+    using namespace UMPBufferHelpers;
+
+    auto start = findEventAfter (data.begin(), data.end(), startSample - 1);
+    auto end   = findEventAfter (start,        data.end(), startSample + numSamples - 1);
+
+    data.removeRange ((int) (start - data.begin()), (int) (end - start));
+    updateLastEventTime();
+}
+
+int UMPBuffer::getNumEvents() const noexcept
+{
+    return (int) std::distance (begin(), end());
+}
+
+void UMPBuffer::updateLastEventTime() noexcept
+{
+    for (auto* d = data.begin(); d < data.end(); d += UMPBufferHelpers::getEventTotalSize (d))
+        lastEventTime = (int) *d;
+}
+
+void UMPBuffer::addEvent (const uint32* packet, int sampleNumber)
+{
+    const auto numWords = getNumWordsForPacket (packet[0]);
+
+    const auto offset = (data.isEmpty() || sampleNumber >= lastEventTime)
+                            ? data.size()
+                            : (int) (UMPBufferHelpers::findEventAfter (data.begin(), data.end(), sampleNumber) - data.begin());
+
+    data.insertMultiple (offset, 0, 1 + numWords);
+
+    auto* d = data.begin() + offset;
+    d[0] = (uint32) sampleNumber;
+    std::copy (packet, packet + numWords, d + 1);
+
+    if (offset + 1 + numWords == data.size())
+        lastEventTime = sampleNumber;
+}
+
+void UMPBuffer::addEvents (const UMPBuffer& otherBuffer,
+                           int startSample, int numSamples, int sampleDeltaToAdd)
+{
+    if (&otherBuffer == this)
+    {
+        const auto copy = otherBuffer;
+        addEvents (copy, startSample, numSamples, sampleDeltaToAdd);
+        return;
+    }
+
+    using namespace UMPBufferHelpers;
+
+    const auto* otherEnd = otherBuffer.data.end();
+    const auto* source = findEventAfter (otherBuffer.data.begin(), otherEnd, startSample - 1);
+    const auto* sourceEnd = numSamples >= 0 ? findEventAfter (source, otherEnd, startSample + numSamples - 1)
+                                            : otherEnd;
+
+    const auto numWordsToAdd = (int) (sourceEnd - source);
+
+    if (numWordsToAdd == 0)
+        return;
+
+    const auto wasEmpty = data.isEmpty();
+
+    // As in MidiBuffer::addEvents(), the existing events are moved up and the two
+    // sorted lists are merged into the space at the start.
+    data.insertMultiple (0, 0, numWordsToAdd);
+
+    auto* dest = data.begin();
+    auto* existing = dest + numWordsToAdd;
+    const auto* existingEnd = data.end();
+    int time = 0;
+
+    while (source < sourceEnd)
+    {
+        time = (int) *source + sampleDeltaToAdd;
+
+        while (existing < existingEnd && (int) *existing <= time)
+        {
+            const auto size = getEventTotalSize (existing);
+            std::copy (existing, existing + size, dest);
+            dest += size;
+            existing += size;
+        }
+
+        const auto size = getEventTotalSize (source);
+        dest[0] = (uint32) time;
+        std::copy (source + 1, source + size, dest + 1);
+        dest += size;
+        source += size;
+    }
+
+    if (wasEmpty || time >= lastEventTime)
+        lastEventTime = time;
+}
+
+UMPBuffer::Iterator UMPBuffer::findNextSamplePosition (int samplePosition) const noexcept
+{
+    return Iterator (UMPBufferHelpers::findEventAfter (data.begin(), data.end(), samplePosition - 1));
+}
+
+//==============================================================================
+struct UMPBufferConverter::Impl
+{
+    universal_midi_packets::Midi1ToMidi2DefaultTranslator toMidi2;
+    universal_midi_packets::Midi1ToBytestreamTranslator toBytestream { 256 };
+
+    UMPBuffer scratchPackets;
+    MidiBuffer scratchMessages;
+};
+
+UMPBufferConverter::UMPBufferConverter (Protocol protocolToCreate)
+    : impl (std::make_unique<Impl>()),
+      protocol (protocolToCreate)
+{
+    impl->scratchPackets.ensureSize (512);
+    impl->scratchMessages.ensureSize (512);
+}
+
+UMPBufferConverter::~UMPBufferConverter() = default;
+
+void UMPBufferConverter::reset()
+{
+    impl->toMidi2 = {};
+    impl->toBytestream.reset();
+}
+
+void UMPBufferConverter::convert (const MidiBuffer& source, UMPBuffer& destination)
+{
+    namespace ump = universal_midi_packets;
+
+    // The converted packets are in time order, so they can be appended directly to an
+    // empty buffer, and otherwise are merged in from the scratch buffer.
+    auto& target = destination.isEmpty() ? destination : impl->scratchPackets;
+    impl->scratchPackets.clear();
+
+    for (const auto metadata : source)
+    {
+        const auto time = metadata.samplePosition;
+
+        ump::Conversion::toMidi1 (metadata.getMessage(), [&] (const ump::View& midi1)
+        {
+            if (protocol == Protocol::midi1)
+                target.addEvent (midi1.data(), time);
+            else
+                impl->toMidi2.dispatch (midi1, [&] (const ump::View& midi2) { target.addEvent (midi2.data(), time); });
+        });
+    }
+
+    if (&target != &destination)
+        destination.addEvents (target, 0, -1, 0);
+}
+
+void UMPBufferConverter::convert (const UMPBuffer& source, MidiBuffer& destination)
+{
+    namespace ump = universal_midi_packets;
+
+    auto& target = destination.isEmpty() ? destination : impl->scratchMessages;
+    impl->scratchMessages.clear();
+
+    for (const auto event : source)
+    {
+        const auto time = event.samplePosition;
+
+        ump::Conversion::midi2ToMidi1DefaultTranslation (ump::View (event.data), [&] (const ump::View& midi1)
+        {
+            impl->toBytestream.dispatch (midi1, (double) time, [&] (const MidiMessage& message)
+            {
+                UMPBufferHelpers::appendEvent (target, message.getRawData(), message.getRawDataSize(), time);
+            });
+        });
+    }
+
+    if (&target != &destination)
+        destination.addEvents (target, 0, -1, 0);
+}
+
+} // namespace juce
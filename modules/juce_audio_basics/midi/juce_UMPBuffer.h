@@ -0,0 +1,280 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A sorted list of time-stamped Universal MIDI Packets.
+
+    This is the UMP equivalent of a MidiBuffer. Each event is a single packet of one
+    to four 32-bit words, as defined by the MIDI 2.0 specification, so a buffer can hold
+    MIDI 2.0 channel voice messages with their full resolution, as well as MIDI 1.0
+    protocol packets, SysEx7 packets and any other message types. A message that spans
+    several packets, such as a long SysEx, is stored as a series of events with the
+    same timestamp.
+
+    An AudioProcessor that overrides AudioProcessor::processBlockUMP() will be
+    passed one of these by an AudioProcessorGraph, without the packets being converted
+    to and from MIDI 1.0 at each connection. Use UMPBufferConverter to translate between
+    a UMPBuffer and a MidiBuffer where the two formats meet.
+
+    @code
+    for (const auto event : packets)
+    {
+        const auto firstWord = event.data[0];
+
+        if ((firstWord >> 28) == 0x4 && ((firstWord >> 20) & 0xf) == 0x9)
+        {
+            const auto note = (int) ((firstWord >> 8) & 0x7f);
+            const auto velocity = (uint16) (event.data[1] >> 16);   // 16-bit velocity
+            startNote (note, velocity, event.samplePosition);
+        }
+    }
+    @endcode
+
+    @see MidiBuffer, UMPBufferConverter
+    @tags{Audio}
+*/
+class JUCE_API  UMPBuffer
+{
+public:
+    //==============================================================================
+    /** Creates an empty UMPBuffer. */
+    UMPBuffer() noexcept = default;
+
+    //==============================================================================
+    /** Describes an event in a UMPBuffer. The data points into the buffer, so it is only
+        valid until the buffer is next modified.
+    */
+    struct Event
+    {
+        /** The words of the packet. */
+        const uint32* data;
+
+        /** The number of words in the packet, between 1 and 4. */
+        int numWords;
+
+        /** The event's position in the block. */
+        int samplePosition;
+    };
+
+    /** Returns the number of 32-bit words in a Universal MIDI Packet, given its first word.
+        The size is determined by the packet's message type, in the top four bits.
+    */
+    static constexpr int getNumWordsForPacket (uint32 firstWord) noexcept
+    {
+        switch (firstWord >> 28)
+        {
+            case 0x3: case 0x4: case 0x8: case 0x9: case 0xa:   return 2;
+            case 0xb: case 0xc:                                 return 3;
+            case 0x5: case 0xd: case 0xe: case 0xf:             return 4;
+            default:                                            return 1;
+        }
+    }
+
+    //==============================================================================
+    /** Removes all events from the buffer. */
+    void clear() noexcept;
+
+    /** Removes all events between two times from the buffer.
+        All events for which (start <= event position < start + numSamples) will
+        be removed.
+    */
+    void clear (int start, int numSamples);
+
+    /** Returns true if the buffer is empty. */
+    bool isEmpty() const noexcept                       { return data.isEmpty(); }
+
+    /** Counts the number of events in the buffer.
+        This is actually quite a slow operation, as it has to iterate through all
+        the events, so you might prefer to call isEmpty() if that's all you need
+        to know.
+    */
+    int getNumEvents() const noexcept;
+
+    /** Returns the sample number of the first event in the buffer, or 0 if it's empty. */
+    int getFirstEventTime() const noexcept              { return data.isEmpty() ? 0 : (int) data.getUnchecked (0); }
+
+    /** Returns the sample number of the last event in the buffer, or 0 if it's empty. */
+    int getLastEventTime() const noexcept               { return data.isEmpty() ? 0 : lastEventTime; }
+
+    //==============================================================================
+    /** Adds a packet to the buffer.
+
+        The number of words that are copied is determined from the packet's message type.
+        If an event is added whose sample position is the same as one or more events
+        already in the buffer, the new event will be placed after the existing ones.
+        Adding an event at or after the last event in the buffer is a constant-time
+        operation.
+    */
+    void addEvent (const uint32* packet, int sampleNumber);
+
+    /** Merges some events from another buffer into this one.
+
+        This takes time proportional to the total number of events in both buffers.
+        The parameters have the same meaning as in MidiBuffer::addEvents().
+
+        @param otherBuffer      the buffer containing the events you want to add
+        @param startSample      the lowest sample number in the source buffer for which
+                                events should be added. Any source events whose timestamp is
+                                less than this will be ignored
+        @param numSamples       the valid range of samples from the source buffer for which
+                                events should be added - i.e. events in the source buffer whose
+                                timestamp is greater than or equal to (startSample + numSamples)
+                                will be ignored. If this value is less than 0, all events after
+                                startSample will be taken.
+        @param sampleDeltaToAdd a value which will be added to the source timestamps of the events
+                                that are added to this buffer
+    */
+    void addEvents (const UMPBuffer& otherBuffer,
+                    int startSample,
+                    int numSamples,
+                    int sampleDeltaToAdd);
+
+    /** Preallocates some memory for the buffer to use.
+        This helps to avoid needing to reallocate space when the buffer has events
+        added to it. Each event takes up one word for its timestamp, plus the words
+        of its packet.
+    */
+    void ensureSize (size_t minimumNumWords);
+
+    /** Exchanges the contents of this buffer with another one.
+        This is a quick operation, because no memory allocating or copying is done, it
+        just swaps the internal state of the two buffers.
+    */
+    void swapWith (UMPBuffer&) noexcept;
+
+    //==============================================================================
+    /** Iterates over the events in a UMPBuffer, giving an Event for each. */
+    class Iterator
+    {
+    public:
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = Event;
+        using reference         = Event;
+        using pointer           = void;
+        using iterator_category = std::input_iterator_tag;
+
+        explicit Iterator (const uint32* d) noexcept : data (d) {}
+
+        Iterator& operator++() noexcept                             { data += 1 + getNumWordsForPacket (data[1]); return *this; }
+        Iterator operator++ (int) noexcept                          { auto copy = *this; ++(*this); return copy; }
+        bool operator== (const Iterator& other) const noexcept      { return data == other.data; }
+        bool operator!= (const Iterator& other) const noexcept      { return data != other.data; }
+        reference operator*() const noexcept                        { return { data + 1, getNumWordsForPacket (data[1]), (int) data[0] }; }
+
+    private:
+        const uint32* data;
+    };
+
+    /** Get a read-only iterator pointing to the beginning of this buffer. */
+    Iterator begin() const noexcept                     { return Iterator (data.begin()); }
+
+    /** Get a read-only iterator pointing one past the end of this buffer. */
+    Iterator end() const noexcept                       { return Iterator (data.end()); }
+
+    /** Get an iterator pointing to the first event with a timestamp greater-than or
+        equal-to `samplePosition`.
+    */
+    Iterator findNextSamplePosition (int samplePosition) const noexcept;
+
+private:
+    //==============================================================================
+    // Each event is stored as its timestamp, followed by the words of its packet
+    Array<uint32> data;
+    int lastEventTime = 0;
+
+    void updateLastEventTime() noexcept;
+
+    JUCE_LEAK_DETECTOR (UMPBuffer)
+};
+
+//==============================================================================
+/**
+    Translates the events in a MidiBuffer to Universal MIDI Packets, and back.
+
+    The translation to the MIDI 2.0 protocol keeps track of bank selects and
+    RPN/NRPN sequences, and the translation to MIDI 1.0 reassembles SysEx messages
+    that have been split over several packets, so use a separate converter for each
+    stream of events, and keep it for as long as the stream is running.
+
+    Once it has been constructed, a converter won't allocate memory unless it is asked
+    to convert a SysEx message larger than any it has seen before, or its destination
+    buffers need to grow.
+
+    @see UMPBuffer
+    @tags{Audio}
+*/
+class JUCE_API  UMPBufferConverter
+{
+public:
+    //==============================================================================
+    /** The protocol used for the channel voice messages that are created when
+        converting a MidiBuffer to Universal MIDI Packets.
+    */
+    enum class Protocol
+    {
+        midi1,  /**< MIDI 1.0 protocol packets, which hold the original bytes. */
+        midi2   /**< MIDI 2.0 protocol packets, with values scaled up to their full resolution. */
+    };
+
+    /** Creates a converter. */
+    explicit UMPBufferConverter (Protocol protocolToCreate = Protocol::midi2);
+
+    /** Destructor. */
+    ~UMPBufferConverter();
+
+    //==============================================================================
+    /** Returns the protocol used when converting to Universal MIDI Packets. */
+    Protocol getProtocol() const noexcept               { return protocol; }
+
+    /** Clears any partial SysEx messages and controller sequences. */
+    void reset();
+
+    //==============================================================================
+    /** Converts the events in a MidiBuffer to packets, and merges them into a UMPBuffer.
+        The packets are placed in group 0.
+    */
+    void convert (const MidiBuffer& source, UMPBuffer& destination);
+
+    /** Converts the packets in a UMPBuffer to MIDI 1.0 messages, and merges them into a
+        MidiBuffer.
+
+        MIDI 2.0 channel voice messages are translated to their nearest MIDI 1.0
+        equivalents. Packets that have no MIDI 1.0 equivalent, such as utility messages
+        and MIDI 2.0 per-note controllers, are dropped. The group of each packet is ignored.
+    */
+    void convert (const UMPBuffer& source, MidiBuffer& destination);
+
+private:
+    //==============================================================================
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+    const Protocol protocol;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UMPBufferConverter)
+};
+
+} // namespace juce
@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+class UMPBufferTests  : public UnitTest
+{
+public:
+    UMPBufferTests()
+        : UnitTest ("UMPBuffer", UnitTestCategories::midi)
+    {}
+
+    void runTest() override
+    {
+        namespace ump = universal_midi_packets;
+
+        beginTest ("Events are kept in order, with later additions after existing events at the same time");
+        {
+            UMPBuffer buffer;
+
+            const auto a = ump::Factory::makeNoteOnV2 (0, 0, 60, ump::Factory::NoteAttributeKind::none, 0x8000, 0);
+            const auto b = ump::Factory::makeNoteOnV2 (0, 0, 61, ump::Factory::NoteAttributeKind::none, 0x8000, 0);
+            const auto c = ump::Factory::makeNoteOffV2 (0, 0, 62, ump::Factory::NoteAttributeKind::none, 0, 0);
+            const auto d = ump::Factory::makeProgramChangeV1 (0, 0, 5);
+
+            buffer.addEvent (a.data(), 10);
+            buffer.addEvent (b.data(), 5);
+            buffer.addEvent (c.data(), 10);
+            buffer.addEvent (d.data(), 0);
+
+            expect (times (buffer) == std::vector<int> { 0, 5, 10, 10 });
+            expect (firstWords (buffer) == std::vector<uint32> { d.front(), b.front(), a.front(), c.front() });
+            expectEquals (buffer.getNumEvents(), 4);
+            expectEquals (buffer.getFirstEventTime(), 0);
+            expectEquals (buffer.getLastEventTime(), 10);
+
+            const auto sizes = [&]
+            {
+                std::vector<int> result;
+
+                for (const auto event : buffer)
+                    result.push_back (event.numWords);
+
+                return result;
+            }();
+
+            expect (sizes == std::vector<int> { 1, 2, 2, 2 });
+            expectEquals ((*buffer.findNextSamplePosition (6)).samplePosition, 10);
+            expect (buffer.findNextSamplePosition (11) == buffer.end());
+        }
+
+        beginTest ("Packet sizes are derived from the message type");
+        {
+            for (uint32 type = 0; type < 16; ++type)
+                expectEquals (UMPBuffer::getNumWordsForPacket (type << 28),
+                              (int) ump::Utils::getNumWordsForMessageType (type << 28));
+        }
+
+        beginTest ("addEvents merges in linear time and matches adding each event");
+        {
+            auto random = getRandom();
+
+            for (int iteration = 0; iteration < 50; ++iteration)
+            {
+                UMPBuffer a, b, expected;
+
+                const auto fill = [&] (UMPBuffer& buffer, int numEvents)
+                {
+                    for (int i = 0; i < numEvents; ++i)
+                    {
+                        const auto note = (uint8) random.nextInt (128);
+                        const auto time = random.nextInt (200);
+
+                        if (random.nextBool())
+                            buffer.addEvent (ump::Factory::makeNoteOnV2 (0, 0, note, ump::Factory::NoteAttributeKind::none, 0x1234, 0).data(), time);
+                        else
+                            buffer.addEvent (ump::Factory::makeNoteOffV1 (0, 0, note, 0).data(), time);
+                    }
+                };
+
+                fill (a, random.nextInt (40));
+                fill (b, random.nextInt (40));
+
+                const auto startSample = random.nextInt (50), numSamples = random.nextInt (200) - 20, delta = random.nextInt (30) - 10;
+
+                expected = a;
+
+                for (const auto event : b)
+                    if (event.samplePosition >= startSample && (numSamples < 0 || event.samplePosition < startSample + numSamples))
+                        expected.addEvent (event.data, event.samplePosition + delta);
+
+                a.addEvents (b, startSample, numSamples, delta);
+
+                expect (times (a) == times (expected));
+                expect (firstWords (a) == firstWords (expected));
+                expectEquals (a.getLastEventTime(), lastTimeByIteration (expected));
+            }
+        }
+
+        beginTest ("clear removes a range of events");
+        {
+            UMPBuffer buffer;
+
+            for (int i = 0; i < 10; ++i)
+                buffer.addEvent (ump::Factory::makeNoteOnV2 (0, 0, (uint8) i, ump::Factory::NoteAttributeKind::none, 0xffff, 0).data(), i * 10);
+
+            buffer.clear (20, 50);
+            expect (times (buffer) == std::vector<int> { 0, 10, 70, 80, 90 });
+
+            buffer.clear (60, 100);
+            expect (times (buffer) == std::vector<int> { 0, 10 });
+            expectEquals (buffer.getLastEventTime(), 10);
+
+            buffer.clear();
+            expect (buffer.isEmpty());
+        }
+
+        beginTest ("MIDI 1.0 messages survive a round trip through MIDI 2.0 packets");
+        {
+            MidiBuffer source;
+            source.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 0);
+            source.addEvent (MidiMessage::controllerEvent (2, 7, 64), 3);
+            source.addEvent (MidiMessage::pitchWheel (3, 0x1234), 4);
+            source.addEvent (MidiMessage::channelPressureChange (4, 90), 5);
+            source.addEvent (MidiMessage::programChange (5, 17), 6);
+            source.addEvent (MidiMessage::noteOff (1, 60, (uint8) 0), 20);
+
+            const uint8 sysex[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+            source.addEvent (MidiMessage::createSysExMessage (sysex, (int) sizeof (sysex)), 12);
+
+            for (auto protocol : { UMPBufferConverter::Protocol::midi1, UMPBufferConverter::Protocol::midi2 })
+            {
+                UMPBufferConverter toPackets (protocol), toMessages;
+
+                UMPBuffer packets;
+                toPackets.convert (source, packets);
+
+                const auto expectedType = protocol == UMPBufferConverter::Protocol::midi2 ? 0x4 : 0x2;
+                expectEquals ((int) ((*packets.begin()).data[0] >> 28), expectedType);
+
+                MidiBuffer result;
+                toMessages.convert (packets, result);
+
+                expect (messagesMatch (result, source));
+            }
+        }
+
+        beginTest ("Converting merges into buffers that already hold events");
+        {
+            MidiBuffer source;
+            source.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 5);
+            source.addEvent (MidiMessage::noteOn (1, 61, (uint8) 100), 15);
+
+            UMPBufferConverter converter;
+
+            UMPBuffer packets;
+            packets.addEvent (ump::Factory::makeNoteOnV2 (0, 0, 62, ump::Factory::NoteAttributeKind::none, 0x8000, 0).data(), 10);
+            converter.convert (source, packets);
+
+            expect (times (packets) == std::vector<int> { 5, 10, 15 });
+
+            MidiBuffer messages;
+            messages.addEvent (MidiMessage::noteOff (2, 40), 7);
+            converter.convert (packets, messages);
+
+            std::vector<int> messageTimes;
+
+            for (const auto metadata : messages)
+                messageTimes.push_back (metadata.samplePosition);
+
+            expect (messageTimes == std::vector<int> { 5, 7, 10, 15 });
+        }
+
+        beginTest ("MIDI 2.0 values keep their full resolution until they are converted");
+        {
+            MidiBuffer source;
+            source.addEvent (MidiMessage::noteOn (1, 60, (uint8) 127), 0);
+
+            UMPBuffer packets;
+            UMPBufferConverter().convert (source, packets);
+
+            const auto event = *packets.begin();
+            expectEquals (event.numWords, 2);
+            expectEquals ((int) (event.data[1] >> 16), 0xffff);
+        }
+    }
+
+private:
+    static std::vector<int> times (const UMPBuffer& buffer)
+    {
+        std::vector<int> result;
+
+        for (const auto event : buffer)
+            result.push_back (event.samplePosition);
+
+        return result;
+    }
+
+    static std::vector<uint32> firstWords (const UMPBuffer& buffer)
+    {
+        std::vector<uint32> result;
+
+        for (const auto event : buffer)
+            result.push_back (event.data[0]);
+
+        return result;
+    }
+
+    static int lastTimeByIteration (const UMPBuffer& buffer)
+    {
+        const auto t = times (buffer);
+        return t.empty() ? 0 : t.back();
+    }
+
+    static bool messagesMatch (const MidiBuffer& a, const MidiBuffer& b)
+    {
+        std::vector<std::pair<int, std::vector<uint8>>> eventsA, eventsB;
+
+        for (const auto metadata : a)
+            eventsA.emplace_back (metadata.samplePosition, std::vector<uint8> (metadata.data, metadata.data + metadata.numBytes));
+
+        for (const auto metadata : b)
+            eventsB.emplace_back (metadata.samplePosition, std::vector<uint8> (metadata.data, metadata.data + metadata.numBytes));
+
+        return eventsA == eventsB;
+    }
+};
+
+static UMPBufferTests umpBufferTests;
+
+} // namespace juce
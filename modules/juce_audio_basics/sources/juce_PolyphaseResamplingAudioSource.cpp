@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+PolyphaseResamplingAudioSource::PolyphaseResamplingAudioSource (AudioSource* inputSource,
+                                                                bool deleteInputWhenDeleted,
+                                                                int channels,
+                                                                PolyphaseResampler::Quality quality)
+    : input (inputSource, deleteInputWhenDeleted),
+      numChannels (channels),
+      resampler (channels, quality)
+{
+    jassert (input != nullptr);
+}
+
+PolyphaseResamplingAudioSource::~PolyphaseResamplingAudioSource() {}
+
+void PolyphaseResamplingAudioSource::setResamplingRatio (double samplesInPerOutputSample)
+{
+    jassert (samplesInPerOutputSample > 0);
+    ratio = samplesInPerOutputSample;
+}
+
+double PolyphaseResamplingAudioSource::getResamplingRatio() const noexcept
+{
+    return ratio;
+}
+
+void PolyphaseResamplingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    const ScopedLock sl (callbackLock);
+
+    const auto localRatio = ratio.load();
+    const auto scaledBlockSize = roundToInt (samplesPerBlockExpected * localRatio);
+    input->prepareToPlay (scaledBlockSize, sampleRate * localRatio);
+
+    resampler.prepare (localRatio, scaledBlockSize + 32);
+
+    // The first block also has to fill the filter's look-ahead
+    inputBuffer.setSize (numChannels, scaledBlockSize + resampler.getNumTaps() + 32);
+    spareChannels.setSize (numChannels, samplesPerBlockExpected);
+    destBuffers.calloc (numChannels);
+
+    lastRatio = localRatio;
+    flushBuffers();
+}
+
+void PolyphaseResamplingAudioSource::flushBuffers()
+{
+    const ScopedLock sl (callbackLock);
+    resampler.reset();
+}
+
+void PolyphaseResamplingAudioSource::releaseResources()
+{
+    input->releaseResources();
+    inputBuffer.setSize (numChannels, 0);
+    spareChannels.setSize (numChannels, 0);
+}
+
+void PolyphaseResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    const ScopedLock sl (callbackLock);
+
+    const auto localRatio = ratio.load();
+    auto numInputNeeded = resampler.getNumInputSamplesNeeded (info.numSamples, lastRatio, localRatio);
+
+    while (numInputNeeded > 0)
+    {
+        const auto numThisTime = jmin (numInputNeeded, inputBuffer.getNumSamples());
+
+        if (numThisTime <= 0)
+        {
+            inputBuffer.setSize (numChannels, numInputNeeded);
+            continue;
+        }
+
+        AudioSourceChannelInfo readInfo (&inputBuffer, 0, numThisTime);
+        input->getNextAudioBlock (readInfo);
+
+        resampler.pushSamples (inputBuffer.getArrayOfReadPointers(), numThisTime);
+        numInputNeeded -= numThisTime;
+    }
+
+    // Channels that the destination buffer doesn't have are still resampled, to
+    // keep them in step, but the results go into a spare buffer
+    if (spareChannels.getNumSamples() < info.numSamples)
+        spareChannels.setSize (numChannels, info.numSamples);
+
+    const auto numDestChannels = info.buffer->getNumChannels();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        destBuffers[channel] = channel < numDestChannels ? info.buffer->getWritePointer (channel, info.startSample)
+                                                         : spareChannels.getWritePointer (channel);
+
+    const auto numDone = resampler.pullSamples (destBuffers, info.numSamples, lastRatio, localRatio);
+    jassertquiet (numDone == info.numSamples);
+
+    for (int channel = numChannels; channel < numDestChannels; ++channel)
+        info.buffer->clear (channel, info.startSample, info.numSamples);
+
+    lastRatio = localRatio;
+}
+
+} // namespace juce
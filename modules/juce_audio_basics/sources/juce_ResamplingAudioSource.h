@@ -27,7 +27,7 @@ namespace juce
 /**
     A type of AudioSource that takes an input source and changes its sample rate.
 
-    @see AudioSource, LagrangeInterpolator, CatmullRomInterpolator
+    @see AudioSource, PolyphaseResamplingAudioSource, LagrangeInterpolator, CatmullRomInterpolator
 
     @tags{Audio}
 */
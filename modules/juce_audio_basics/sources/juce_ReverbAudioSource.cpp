@@ -23,8 +23,10 @@
 namespace juce
 {
 
-ReverbAudioSource::ReverbAudioSource (AudioSource* const inputSource, const bool deleteInputWhenDeleted)
+ReverbAudioSource::ReverbAudioSource (AudioSource* const inputSource, const bool deleteInputWhenDeleted,
+                                      const Algorithm algorithmToUse)
    : input (inputSource, deleteInputWhenDeleted),
+     algorithm (algorithmToUse),
      bypass (false)
 {
     jassert (inputSource != nullptr);
@@ -37,6 +39,7 @@ void ReverbAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampl
     const ScopedLock sl (lock);
     input->prepareToPlay (samplesPerBlockExpected, sampleRate);
     reverb.setSampleRate (sampleRate);
+    fdnReverb.setSampleRate (sampleRate);
 }
 
 void ReverbAudioSource::releaseResources() {}
@@ -51,16 +54,24 @@ void ReverbAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& bufferT
     {
         float* const firstChannel = bufferToFill.buffer->getWritePointer (0, bufferToFill.startSample);
 
-        if (bufferToFill.buffer->getNumChannels() > 1)
+        const auto process = [&] (auto& reverbToUse)
         {
-            reverb.processStereo (firstChannel,
-                                  bufferToFill.buffer->getWritePointer (1, bufferToFill.startSample),
-                                  bufferToFill.numSamples);
-        }
+            if (bufferToFill.buffer->getNumChannels() > 1)
+            {
+                reverbToUse.processStereo (firstChannel,
+                                           bufferToFill.buffer->getWritePointer (1, bufferToFill.startSample),
+                                           bufferToFill.numSamples);
+            }
+            else
+            {
+                reverbToUse.processMono (firstChannel, bufferToFill.numSamples);
+            }
+        };
+
+        if (algorithm == Algorithm::feedbackDelayNetwork)
+            process (fdnReverb);
         else
-        {
-            reverb.processMono (firstChannel, bufferToFill.numSamples);
-        }
+            process (reverb);
     }
 }
 
@@ -70,6 +81,23 @@ void ReverbAudioSource::setParameters (const Reverb::Parameters& newParams)
     reverb.setParameters (newParams);
 }
 
+void ReverbAudioSource::setFDNParameters (const FDNReverb::Parameters& newParams)
+{
+    const ScopedLock sl (lock);
+    fdnReverb.setParameters (newParams);
+}
+
+void ReverbAudioSource::setAlgorithm (Algorithm newAlgorithm)
+{
+    if (algorithm != newAlgorithm)
+    {
+        const ScopedLock sl (lock);
+        algorithm = newAlgorithm;
+        reverb.reset();
+        fdnReverb.reset();
+    }
+}
+
 void ReverbAudioSource::setBypassed (bool b) noexcept
 {
     if (bypass != b)
@@ -77,6 +105,7 @@ void ReverbAudioSource::setBypassed (bool b) noexcept
         const ScopedLock sl (lock);
         bypass = b;
         reverb.reset();
+        fdnReverb.reset();
     }
 }
 
@@ -25,34 +25,56 @@ namespace juce
 
 //==============================================================================
 /**
-    An AudioSource that uses the Reverb class to apply a reverb to another AudioSource.
+    An AudioSource that uses the Reverb or FDNReverb class to apply a reverb to
+    another AudioSource.
 
-    @see Reverb
+    @see Reverb, FDNReverb
 
     @tags{Audio}
 */
 class JUCE_API  ReverbAudioSource   : public AudioSource
 {
 public:
+    /** The reverb algorithms that a ReverbAudioSource can use. */
+    enum class Algorithm
+    {
+        freeverb,               /**< Uses the Reverb class. */
+        feedbackDelayNetwork    /**< Uses the FDNReverb class. */
+    };
+
     /** Creates a ReverbAudioSource to process a given input source.
 
         @param inputSource              the input source to read from - this must not be null
         @param deleteInputWhenDeleted   if true, the input source will be deleted when
                                         this object is deleted
+        @param algorithm                the reverb algorithm to use
     */
     ReverbAudioSource (AudioSource* inputSource,
-                       bool deleteInputWhenDeleted);
+                       bool deleteInputWhenDeleted,
+                       Algorithm algorithm = Algorithm::freeverb);
 
     /** Destructor. */
     ~ReverbAudioSource() override;
 
     //==============================================================================
-    /** Returns the parameters from the reverb. */
+    /** Returns the parameters used by the Algorithm::freeverb reverb. */
     const Reverb::Parameters& getParameters() const noexcept    { return reverb.getParameters(); }
 
-    /** Changes the reverb's parameters. */
+    /** Changes the parameters used by the Algorithm::freeverb reverb. */
     void setParameters (const Reverb::Parameters& newParams);
 
+    /** Returns the parameters used by the Algorithm::feedbackDelayNetwork reverb. */
+    const FDNReverb::Parameters& getFDNParameters() const noexcept     { return fdnReverb.getParameters(); }
+
+    /** Changes the parameters used by the Algorithm::feedbackDelayNetwork reverb. */
+    void setFDNParameters (const FDNReverb::Parameters& newParams);
+
+    /** Changes the reverb algorithm, clearing the tail of the new one. */
+    void setAlgorithm (Algorithm newAlgorithm);
+
+    /** Returns the reverb algorithm being used. */
+    Algorithm getAlgorithm() const noexcept                     { return algorithm; }
+
     void setBypassed (bool isBypassed) noexcept;
     bool isBypassed() const noexcept                            { return bypass; }
 
@@ -66,6 +88,8 @@ private:
     CriticalSection lock;
     OptionalScopedPointer<AudioSource> input;
     Reverb reverb;
+    FDNReverb fdnReverb;
+    std::atomic<Algorithm> algorithm;
     std::atomic<bool> bypass;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReverbAudioSource)
@@ -72,6 +72,270 @@ void SynthesiserVoice::renderNextBlock (AudioBuffer<double>& outputBuffer,
     subBuffer.makeCopyOf (tempBuffer, true);
 }
 
+// The events passed to voices are all channel messages, so the channel can be read straight from the status byte
+static int getEventChannel (const MidiMessageMetadata& metadata) noexcept
+{
+    return (metadata.data[0] & 0x0f) + 1;
+}
+
+template <typename FloatType>
+static void renderVoiceBetweenEvents (SynthesiserVoice& voice, AudioBuffer<FloatType>& outputBuffer,
+                                      int startSample, int numSamples,
+                                      MidiBufferIterator firstEvent, MidiBufferIterator lastEvent)
+{
+    const auto endSample = startSample + numSamples;
+
+    for (auto it = firstEvent; it != lastEvent; ++it)
+    {
+        const auto metadata = *it;
+
+        // No need to split the block at events that can't affect this voice
+        if (! voice.isPlayingChannel (getEventChannel (metadata)))
+            continue;
+
+        const auto position = jlimit (startSample, endSample, metadata.samplePosition);
+
+        if (position > startSample)
+        {
+            voice.renderNextBlock (outputBuffer, startSample, position - startSample);
+            startSample = position;
+        }
+
+        voice.applyEvent (metadata.getMessage());
+    }
+
+    if (endSample > startSample)
+        voice.renderNextBlock (outputBuffer, startSample, endSample - startSample);
+}
+
+void SynthesiserVoice::renderNextBlockWithEvents (AudioBuffer<float>& outputBuffer, int startSample, int numSamples,
+                                                  MidiBufferIterator firstEvent, MidiBufferIterator lastEvent)
+{
+    renderVoiceBetweenEvents (*this, outputBuffer, startSample, numSamples, firstEvent, lastEvent);
+}
+
+void SynthesiserVoice::renderNextBlockWithEvents (AudioBuffer<double>& outputBuffer, int startSample, int numSamples,
+                                                  MidiBufferIterator firstEvent, MidiBufferIterator lastEvent)
+{
+    renderVoiceBetweenEvents (*this, outputBuffer, startSample, numSamples, firstEvent, lastEvent);
+}
+
+void SynthesiserVoice::applyEvent (const MidiMessage& m)
+{
+    if (! isPlayingChannel (m.getChannel()))
+        return;
+
+    if (m.isPitchWheel())
+        pitchWheelMoved (m.getPitchWheelValue());
+    else if (m.isAftertouch())
+    {
+        if (m.getNoteNumber() == getCurrentlyPlayingNote())
+            aftertouchChanged (m.getAfterTouchValue());
+    }
+    else if (m.isChannelPressure())
+        channelPressureChanged (m.getChannelPressureValue());
+    else if (m.isController())
+        controllerMoved (m.getControllerNumber(), m.getControllerValue());
+}
+
+void SynthesiserVoice::renderBatch (SynthesiserVoice* const* voicesInBatch, int numVoicesInBatch,
+                                    AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    for (int i = 0; i < numVoicesInBatch; ++i)
+        voicesInBatch[i]->renderNextBlock (outputBuffer, startSample, numSamples);
+}
+
+void SynthesiserVoice::renderBatch (SynthesiserVoice* const* voicesInBatch, int numVoicesInBatch,
+                                    AudioBuffer<double>& outputBuffer, int startSample, int numSamples)
+{
+    for (int i = 0; i < numVoicesInBatch; ++i)
+        voicesInBatch[i]->renderNextBlock (outputBuffer, startSample, numSamples);
+}
+
+//==============================================================================
+class Synthesiser::ParallelRenderer
+{
+public:
+    ParallelRenderer (int numWorkerThreads, int maxBlockSize, int maxNumChannels)
+        : maximumBlockSize (maxBlockSize), maximumNumChannels (maxNumChannels)
+    {
+        for (int i = 0; i < numWorkerThreads; ++i)
+            workers.add (new WorkerThread (*this, i, maxBlockSize, maxNumChannels))->startThread (Thread::realtimeAudioPriority);
+    }
+
+    ~ParallelRenderer()
+    {
+        for (auto* w : workers)
+            w->signalThreadShouldExit();
+
+        for (auto* w : workers)
+            w->notify();
+
+        workers.clear();
+    }
+
+    int getNumWorkerThreads() const noexcept    { return workers.size(); }
+
+    /** Renders the synth's current render items on the calling thread and the worker threads.
+        Returns false without rendering anything if the buffer is too big for the workers.
+    */
+    template <typename FloatType>
+    bool render (Synthesiser& synth, AudioBuffer<FloatType>& output, int startSample, int numSamples,
+                 const EventRange* events) noexcept
+    {
+        if (startSample + numSamples > maximumBlockSize || output.getNumChannels() > maximumNumChannels)
+            return false;
+
+        RenderJob<FloatType> job (synth, output, startSample, numSamples, events);
+        currentJob = &job;
+
+        for (auto* w : workers)
+            w->notify();
+
+        job.perform (nullptr);
+
+        currentJob = nullptr;
+
+        while (numActiveWorkers.load() > 0)
+            Thread::yield();
+
+        for (auto* w : workers)
+        {
+            if (w->usedInCurrentJob)
+            {
+                auto& workerBuffer = w->getBuffer<FloatType>();
+
+                for (int channel = 0; channel < output.getNumChannels(); ++channel)
+                    output.addFrom (channel, startSample, workerBuffer, channel, startSample, numSamples);
+
+                w->usedInCurrentJob = false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    struct WorkerThread;
+
+    struct Job
+    {
+        virtual ~Job() = default;
+
+        /** Called concurrently on the audio thread, with a nullptr, and every worker thread. This
+            should return once there's no work left to pick up.
+        */
+        virtual void perform (WorkerThread*) noexcept = 0;
+    };
+
+    template <typename FloatType>
+    struct RenderJob  : public Job
+    {
+        RenderJob (Synthesiser& s, AudioBuffer<FloatType>& o, int start, int num, const EventRange* e)
+            : synth (s), output (o), startSample (start), numSamples (num), events (e)
+        {}
+
+        void perform (WorkerThread* worker) noexcept override
+        {
+            const auto numChannels = output.getNumChannels();
+            const auto numItems = synth.renderItems.size();
+
+            // The audio thread renders straight into the output, and the workers each add into the
+            // same region of their own buffer, which the audio thread sums afterwards
+            AudioBuffer<FloatType> workerBuffer;
+
+            for (;;)
+            {
+                const auto index = nextItem.fetch_add (1);
+
+                if (index >= numItems)
+                    break;
+
+                const auto& item = synth.renderItems.getReference (index);
+
+                if (worker == nullptr)
+                {
+                    synth.renderItem (item, output, startSample, numSamples, events);
+                    continue;
+                }
+
+                if (! worker->usedInCurrentJob)
+                {
+                    auto& buffer = worker->getBuffer<FloatType>();
+                    workerBuffer.setDataToReferTo (buffer.getArrayOfWritePointers(), numChannels, startSample + numSamples);
+                    workerBuffer.clear (startSample, numSamples);
+                    worker->usedInCurrentJob = true;
+                }
+
+                synth.renderItem (item, workerBuffer, startSample, numSamples, events);
+            }
+        }
+
+        Synthesiser& synth;
+        AudioBuffer<FloatType>& output;
+        const int startSample, numSamples;
+        const EventRange* events;
+        std::atomic<int> nextItem { 0 };
+    };
+
+    struct WorkerThread  : public Thread
+    {
+        WorkerThread (ParallelRenderer& r, int index, int maxBlockSize, int maxNumChannels)
+            : Thread ("Synthesiser render thread " + String (index + 1)),
+              renderer (r),
+              floatBuffer (maxNumChannels, maxBlockSize),
+              doubleBuffer (maxNumChannels, maxBlockSize)
+        {
+        }
+
+        ~WorkerThread() override
+        {
+            stopThread (1000);
+        }
+
+        template <typename FloatType>
+        AudioBuffer<FloatType>& getBuffer() noexcept
+        {
+            if constexpr (std::is_same_v<FloatType, float>)
+                return floatBuffer;
+            else
+                return doubleBuffer;
+        }
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                wait (-1);
+
+                ++renderer.numActiveWorkers;
+
+                if (auto* job = renderer.currentJob.load())
+                {
+                    const ScopedNoDenormals noDenormals;
+                    job->perform (this);
+                }
+
+                --renderer.numActiveWorkers;
+            }
+        }
+
+        ParallelRenderer& renderer;
+        AudioBuffer<float> floatBuffer;
+        AudioBuffer<double> doubleBuffer;
+        bool usedInCurrentJob = false;
+
+        JUCE_DECLARE_NON_COPYABLE (WorkerThread)
+    };
+
+    const int maximumBlockSize, maximumNumChannels;
+    OwnedArray<WorkerThread> workers;
+    std::atomic<Job*> currentJob { nullptr };
+    std::atomic<int> numActiveWorkers { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelRenderer)
+};
+
 //==============================================================================
 Synthesiser::Synthesiser()
 {
@@ -81,6 +345,7 @@ Synthesiser::Synthesiser()
 
 Synthesiser::~Synthesiser()
 {
+    parallelRenderer.reset();
 }
 
 //==============================================================================
@@ -94,19 +359,33 @@ void Synthesiser::clearVoices()
 {
     const ScopedLock sl (lock);
     voices.clear();
+    voicesChanged();
 }
 
 SynthesiserVoice* Synthesiser::addVoice (SynthesiserVoice* const newVoice)
 {
     const ScopedLock sl (lock);
     newVoice->setCurrentPlaybackSampleRate (sampleRate);
-    return voices.add (newVoice);
+    voices.add (newVoice);
+    voicesChanged();
+    return newVoice;
 }
 
 void Synthesiser::removeVoice (const int index)
 {
     const ScopedLock sl (lock);
     voices.remove (index);
+    voicesChanged();
+}
+
+void Synthesiser::voicesChanged()
+{
+    // Make sure that building the render items won't need to allocate on the audio thread
+    voicesInRenderOrder.ensureStorageAllocated (voices.size());
+    renderItems.ensureStorageAllocated (voices.size());
+
+    anyVoiceSupportsBatching = std::any_of (voices.begin(), voices.end(),
+                                            [] (const SynthesiserVoice* v) { return v->supportsBatchRendering(); });
 }
 
 void Synthesiser::clearSounds()
@@ -139,6 +418,31 @@ void Synthesiser::setMinimumRenderingSubdivisionSize (int numSamples, bool shoul
     subBlockSubdivisionIsStrict = shouldBeStrict;
 }
 
+void Synthesiser::setNumParallelRenderThreads (int numWorkerThreads, int maximumBlockSize, int maximumNumChannels)
+{
+    jassert (numWorkerThreads >= 0 && maximumBlockSize >= 0 && maximumNumChannels >= 0);
+
+    std::unique_ptr<ParallelRenderer> newRenderer;
+
+    if (numWorkerThreads > 0)
+        newRenderer = std::make_unique<ParallelRenderer> (numWorkerThreads, maximumBlockSize, maximumNumChannels);
+
+    {
+        const ScopedLock sl (lock);
+        std::swap (parallelRenderer, newRenderer);
+    }
+}
+
+int Synthesiser::getNumParallelRenderThreads() const noexcept
+{
+    return parallelRenderer != nullptr ? parallelRenderer->getNumWorkerThreads() : 0;
+}
+
+void Synthesiser::setTimestampedEventRenderingEnabled (bool shouldBeEnabled) noexcept
+{
+    timestampedEventRendering = shouldBeEnabled;
+}
+
 //==============================================================================
 void Synthesiser::setCurrentPlaybackSampleRate (const double newRate)
 {
@@ -161,6 +465,13 @@ void Synthesiser::processNextBlock (AudioBuffer<floatType>& outputAudio,
 {
     // must set the sample rate before using this!
     jassert (sampleRate != 0);
+
+    if (timestampedEventRendering)
+    {
+        processNextBlockWithTimestampedEvents (outputAudio, midiData, startSample, numSamples);
+        return;
+    }
+
     const int targetChannels = outputAudio.getNumChannels();
 
     auto midiIterator = midiData.findNextSamplePosition (startSample);
@@ -212,6 +523,110 @@ void Synthesiser::processNextBlock (AudioBuffer<floatType>& outputAudio,
                    [&] (const MidiMessageMetadata& meta) { handleMidiEvent (meta.getMessage()); });
 }
 
+// Events which can start or stop voices, and so have to be handled by the synth between rendering calls
+static bool eventSplitsRenderingBlock (const MidiMessageMetadata& metadata) noexcept
+{
+    switch (metadata.data[0] & 0xf0)
+    {
+        case 0xa0:  // aftertouch
+        case 0xd0:  // channel pressure
+        case 0xe0:  // pitch-wheel
+            return false;
+
+        case 0xb0:
+        {
+            // pedals, all-sound-off and all-notes-off
+            const auto controller = metadata.data[1];
+            return controller == 0x40 || controller == 0x42 || controller == 0x43
+                    || controller == 120 || controller == 123;
+        }
+
+        default:
+            return true;
+    }
+}
+
+template <typename floatType>
+void Synthesiser::processNextBlockWithTimestampedEvents (AudioBuffer<floatType>& outputAudio,
+                                                         const MidiBuffer& midiData,
+                                                         int startSample,
+                                                         int numSamples)
+{
+    const int targetChannels = outputAudio.getNumChannels();
+
+    auto midiIterator = midiData.findNextSamplePosition (startSample);
+    const auto midiEnd = midiData.cend();
+
+    bool firstEvent = true;
+
+    const ScopedLock sl (lock);
+
+    const auto render = [&] (int numToRender, MidiBufferIterator first, MidiBufferIterator last)
+    {
+        if (targetChannels > 0)
+        {
+            if (first == last)
+                renderVoices (outputAudio, startSample, numToRender);
+            else
+                renderVoicesWithEvents (outputAudio, startSample, numToRender, first, last);
+        }
+        else
+        {
+            std::for_each (first, last, [&] (const MidiMessageMetadata& meta) { handleMidiEvent (meta.getMessage()); });
+        }
+
+        // The voices have dealt with these, but the synth still needs to keep track of the wheel positions
+        for (auto it = first; it != last; ++it)
+        {
+            const auto metadata = *it;
+
+            if ((metadata.data[0] & 0xf0) == 0xe0)
+                lastPitchWheelValues[getEventChannel (metadata) - 1] = metadata.data[1] | (metadata.data[2] << 7);
+        }
+    };
+
+    while (numSamples > 0)
+    {
+        const auto firstInSubBlock = midiIterator;
+        const auto endSample = startSample + numSamples;
+
+        while (midiIterator != midiEnd
+                && (*midiIterator).samplePosition < endSample
+                && ! eventSplitsRenderingBlock (*midiIterator))
+            ++midiIterator;
+
+        if (midiIterator == midiEnd || (*midiIterator).samplePosition >= endSample)
+        {
+            render (numSamples, firstInSubBlock, midiIterator);
+            break;
+        }
+
+        const auto metadata = *midiIterator;
+        const int samplesToNextMidiMessage = metadata.samplePosition - startSample;
+
+        if (samplesToNextMidiMessage < ((firstEvent && ! subBlockSubdivisionIsStrict) ? 1 : minimumSubBlockSize))
+        {
+            std::for_each (firstInSubBlock, midiIterator, [&] (const MidiMessageMetadata& meta) { handleMidiEvent (meta.getMessage()); });
+            handleMidiEvent (metadata.getMessage());
+            ++midiIterator;
+            continue;
+        }
+
+        firstEvent = false;
+
+        render (samplesToNextMidiMessage, firstInSubBlock, midiIterator);
+
+        handleMidiEvent (metadata.getMessage());
+        ++midiIterator;
+        startSample += samplesToNextMidiMessage;
+        numSamples  -= samplesToNextMidiMessage;
+    }
+
+    std::for_each (midiIterator,
+                   midiEnd,
+                   [&] (const MidiMessageMetadata& meta) { handleMidiEvent (meta.getMessage()); });
+}
+
 // explicit template instantiation
 template void Synthesiser::processNextBlock<float>  (AudioBuffer<float>&,  const MidiBuffer&, int, int);
 template void Synthesiser::processNextBlock<double> (AudioBuffer<double>&, const MidiBuffer&, int, int);
@@ -230,14 +645,153 @@ void Synthesiser::renderNextBlock (AudioBuffer<double>& outputAudio, const MidiB
 
 void Synthesiser::renderVoices (AudioBuffer<float>& buffer, int startSample, int numSamples)
 {
-    for (auto* voice : voices)
-        voice->renderNextBlock (buffer, startSample, numSamples);
+    renderVoicesInItems (buffer, startSample, numSamples, nullptr);
 }
 
 void Synthesiser::renderVoices (AudioBuffer<double>& buffer, int startSample, int numSamples)
 {
+    renderVoicesInItems (buffer, startSample, numSamples, nullptr);
+}
+
+void Synthesiser::renderVoicesWithEvents (AudioBuffer<float>& buffer, int startSample, int numSamples,
+                                          MidiBufferIterator firstEvent, MidiBufferIterator lastEvent)
+{
+    const EventRange events { firstEvent, lastEvent };
+    renderVoicesInItems (buffer, startSample, numSamples, &events);
+}
+
+void Synthesiser::renderVoicesWithEvents (AudioBuffer<double>& buffer, int startSample, int numSamples,
+                                          MidiBufferIterator firstEvent, MidiBufferIterator lastEvent)
+{
+    const EventRange events { firstEvent, lastEvent };
+    renderVoicesInItems (buffer, startSample, numSamples, &events);
+}
+
+template <typename floatType>
+void Synthesiser::renderVoicesInItems (AudioBuffer<floatType>& buffer, int startSample, int numSamples,
+                                       const EventRange* events)
+{
+    if (parallelRenderer == nullptr && ! anyVoiceSupportsBatching)
+    {
+        for (auto* voice : voices)
+        {
+            if (events != nullptr)
+                voice->renderNextBlockWithEvents (buffer, startSample, numSamples, events->first, events->last);
+            else
+                voice->renderNextBlock (buffer, startSample, numSamples);
+        }
+
+        return;
+    }
+
+    updateRenderItems();
+
+    if (parallelRenderer != nullptr && renderItems.size() > 1
+         && parallelRenderer->render (*this, buffer, startSample, numSamples, events))
+        return;
+
+    for (const auto& item : renderItems)
+        renderItem (item, buffer, startSample, numSamples, events);
+}
+
+template <typename floatType>
+void Synthesiser::renderItem (const RenderItem& item, AudioBuffer<floatType>& buffer, int startSample, int numSamples,
+                              const EventRange* events)
+{
+    auto* const* itemVoices = voicesInRenderOrder.begin() + item.firstVoice;
+
+    if (! item.isBatch)
+    {
+        if (events != nullptr)
+            (*itemVoices)->renderNextBlockWithEvents (buffer, startSample, numSamples, events->first, events->last);
+        else
+            (*itemVoices)->renderNextBlock (buffer, startSample, numSamples);
+
+        return;
+    }
+
+    if (events == nullptr)
+    {
+        (*itemVoices)->renderBatch (itemVoices, item.numVoices, buffer, startSample, numSamples);
+        return;
+    }
+
+    // A batch is rendered in pieces between the events, so that its voices can stay together
+    const auto endSample = startSample + numSamples;
+
+    for (auto it = events->first; it != events->last; ++it)
+    {
+        const auto metadata = *it;
+        const auto position = jlimit (startSample, endSample, metadata.samplePosition);
+
+        if (position > startSample)
+        {
+            (*itemVoices)->renderBatch (itemVoices, item.numVoices, buffer, startSample, position - startSample);
+            startSample = position;
+        }
+
+        const auto message = metadata.getMessage();
+
+        for (int i = 0; i < item.numVoices; ++i)
+            itemVoices[i]->applyEvent (message);
+    }
+
+    if (endSample > startSample)
+        (*itemVoices)->renderBatch (itemVoices, item.numVoices, buffer, startSample, endSample - startSample);
+}
+
+void Synthesiser::updateRenderItems()
+{
+    voicesInRenderOrder.clearQuick();
+    renderItems.clearQuick();
+
+    const auto canBeBatched = [this] (const SynthesiserVoice* voice)
+    {
+        return anyVoiceSupportsBatching && voice->supportsBatchRendering() && voice->isVoiceActive();
+    };
+
+    for (auto* voice : voices)
+    {
+        if (! canBeBatched (voice))
+        {
+            renderItems.add ({ voicesInRenderOrder.size(), 1, false });
+            voicesInRenderOrder.add (voice);
+        }
+    }
+
+    if (! anyVoiceSupportsBatching)
+        return;
+
+    // Active voices playing the same sound are gathered into a single batch, by sorting
+    // them on their sound so that each batch occupies a contiguous range
+    const auto firstBatchedVoice = voicesInRenderOrder.size();
+
     for (auto* voice : voices)
-        voice->renderNextBlock (buffer, startSample, numSamples);
+        if (canBeBatched (voice))
+            voicesInRenderOrder.add (voice);
+
+    const auto batchedBegin = voicesInRenderOrder.begin() + firstBatchedVoice;
+    const auto batchedEnd = voicesInRenderOrder.end();
+
+    std::sort (batchedBegin, batchedEnd, [] (const SynthesiserVoice* a, const SynthesiserVoice* b)
+    {
+        const auto* soundA = a->currentlyPlayingSound.get();
+        const auto* soundB = b->currentlyPlayingSound.get();
+        return soundA != soundB ? std::less<const SynthesiserSound*>() (soundA, soundB)
+                                : std::less<const SynthesiserVoice*>() (a, b);
+    });
+
+    for (auto it = batchedBegin; it != batchedEnd;)
+    {
+        const auto* sound = (*it)->currentlyPlayingSound.get();
+        const auto groupEnd = std::find_if (it, batchedEnd, [sound] (const SynthesiserVoice* v)
+        {
+            return v->currentlyPlayingSound.get() != sound;
+        });
+
+        renderItems.add ({ (int) (it - voicesInRenderOrder.begin()), (int) (groupEnd - it), true });
+        it = groupEnd;
+    }
 }
 
 void Synthesiser::handleMidiEvent (const MidiMessage& m)
@@ -582,4 +1136,463 @@ SynthesiserVoice* Synthesiser::findVoiceToSteal (SynthesiserSound* soundToPlay,
     return low;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+namespace
+{
+    class SynthesiserTests  : public UnitTest
+    {
+    public:
+        SynthesiserTests()
+            : UnitTest ("Synthesiser", UnitTestCategories::audio)
+        {}
+
+        void runTest() override
+        {
+            beginTest ("Parallel rendering matches serial rendering");
+            {
+                for (auto numThreads : { 1, 3 })
+                {
+                    expect (rendersIdentically<float, SineVoice>  ({}, parallel (numThreads)));
+                    expect (rendersIdentically<double, SineVoice> ({}, parallel (numThreads)));
+                }
+            }
+
+            beginTest ("Batched voices match individual voices");
+            {
+                expect (rendersIdentically<float, SineVoice, BatchedSineVoice>  ({}, {}));
+                expect (rendersIdentically<double, SineVoice, BatchedSineVoice> ({}, {}));
+            }
+
+            beginTest ("Batches contain the active voices for each sound");
+            {
+                TestSynth<BatchedSineVoice> synth (8);
+                synth.addSound (new TestSound (0, 59));
+                synth.addSound (new TestSound (60, 127));
+                synth.setCurrentPlaybackSampleRate (44100.0);
+
+                AudioBuffer<float> buffer (2, 64);
+                buffer.clear();
+
+                for (auto note : { 36, 40, 64, 67, 71 })
+                    synth.noteOn (1, note, 0.5f);
+
+                synth.renderNextBlock (buffer, {}, 0, buffer.getNumSamples());
+
+                std::vector<int> sizes;
+
+                for (int i = 0; i < synth.getNumVoices(); ++i)
+                    if (auto size = static_cast<BatchedSineVoice*> (synth.getVoice (i))->lastBatchSize)
+                        sizes.push_back (size);
+
+                std::sort (sizes.begin(), sizes.end());
+                expect (sizes == std::vector<int> { 2, 2, 3, 3, 3 });
+            }
+
+            beginTest ("Parallel batched rendering matches serial rendering");
+            {
+                expect (rendersIdentically<float, SineVoice, BatchedSineVoice> ({}, parallel (2)));
+            }
+
+            beginTest ("Blocks larger than the parallel buffers are rendered serially");
+            {
+                expect (rendersIdentically<float, SineVoice> ({}, [] (Synthesiser& s) { s.setNumParallelRenderThreads (2, blockSize / 2, 2); }));
+            }
+
+            beginTest ("Timestamped events match sample-accurate rendering");
+            {
+                const auto sampleAccurate = [] (Synthesiser& s) { s.setMinimumRenderingSubdivisionSize (1); };
+
+                const auto timestamped = [] (Synthesiser& s)
+                {
+                    s.setMinimumRenderingSubdivisionSize (1);
+                    s.setTimestampedEventRenderingEnabled (true);
+                };
+
+                const auto timestampedParallel = [timestamped] (Synthesiser& s)
+                {
+                    timestamped (s);
+                    s.setNumParallelRenderThreads (2, blockSize, 2);
+                };
+
+                expect (rendersIdentically<float, SineVoice>  (sampleAccurate, timestamped));
+                expect (rendersIdentically<double, SineVoice> (sampleAccurate, timestamped));
+                expect (rendersIdentically<float, SineVoice, TimestampedSineVoice>  (sampleAccurate, timestamped));
+                expect (rendersIdentically<double, SineVoice, TimestampedSineVoice> (sampleAccurate, timestamped));
+                expect (rendersIdentically<float, SineVoice, BatchedSineVoice> (sampleAccurate, timestamped));
+                expect (rendersIdentically<float, SineVoice, TimestampedSineVoice> (sampleAccurate, timestampedParallel));
+            }
+
+            beginTest ("Timestamped events don't split the block");
+            {
+                CountingSynth synth;
+                synth.addSound (new TestSound (0, 127));
+                synth.setCurrentPlaybackSampleRate (44100.0);
+                synth.setMinimumRenderingSubdivisionSize (1);
+
+                AudioBuffer<float> buffer (2, blockSize);
+                MidiBuffer midi;
+                midi.addEvent (MidiMessage::noteOn (1, 60, 1.0f), 0);
+
+                for (int i = 1; i < blockSize; i += 4)
+                    midi.addEvent (MidiMessage::pitchWheel (1, 8192 + i), i);
+
+                midi.addEvent (MidiMessage::noteOn (1, 64, 1.0f), blockSize / 2);
+
+                synth.renderNextBlock (buffer, midi, 0, blockSize);
+                expect (synth.numRenderCalls > blockSize / 4);
+
+                synth.numRenderCalls = 0;
+                synth.setTimestampedEventRenderingEnabled (true);
+                synth.renderNextBlock (buffer, midi, 0, blockSize);
+                expectEquals (synth.numRenderCalls, 2);
+            }
+        }
+
+    private:
+        static constexpr int blockSize = 256;
+
+        //==============================================================================
+        struct TestSound  : public SynthesiserSound
+        {
+            TestSound (int lowest, int highest) : range (lowest, highest + 1) {}
+
+            bool appliesToNote (int note) override      { return range.contains (note); }
+            bool appliesToChannel (int) override        { return true; }
+
+            Range<int> range;
+        };
+
+        struct SineVoice  : public SynthesiserVoice
+        {
+            bool canPlaySound (SynthesiserSound*) override { return true; }
+
+            void startNote (int note, float velocity, SynthesiserSound*, int pitchWheelPosition) override
+            {
+                phase = 0.0f;
+                baseIncrement = (float) (MathConstants<double>::twoPi * MidiMessage::getMidiNoteInHertz (note) / getSampleRate());
+                velocityLevel = velocity * 0.1f;
+                samplesRemaining = 3000 + note * 50;
+
+                pitchWheelMoved (pitchWheelPosition);
+                channelPressureChanged (0);
+            }
+
+            void stopNote (float, bool) override                { clearCurrentNote(); }
+            void controllerMoved (int, int) override            {}
+
+            void pitchWheelMoved (int value) override
+            {
+                increment = baseIncrement * std::pow (2.0f, (float) (value - 8192) / (8192.0f * 6.0f));
+            }
+
+            void channelPressureChanged (int value) override
+            {
+                level = velocityLevel * (1.0f + (float) value / 127.0f);
+            }
+
+            template <typename FloatType>
+            void render (AudioBuffer<FloatType>& buffer, int startSample, int numSamples)
+            {
+                if (! isVoiceActive())
+                    return;
+
+                const auto numToRender = jmin (numSamples, samplesRemaining);
+
+                for (int i = 0; i < numToRender; ++i)
+                {
+                    const auto value = (FloatType) (std::sin (phase) * level);
+                    phase += increment;
+
+                    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                        buffer.addSample (channel, startSample + i, value);
+                }
+
+                samplesRemaining -= numToRender;
+
+                if (samplesRemaining == 0)
+                    clearCurrentNote();
+            }
+
+            void renderNextBlock (AudioBuffer<float>& b, int start, int num) override    { render (b, start, num); }
+            void renderNextBlock (AudioBuffer<double>& b, int start, int num) override   { render (b, start, num); }
+
+            float phase = 0.0f, baseIncrement = 0.0f, increment = 0.0f, velocityLevel = 0.0f, level = 0.0f;
+            int samplesRemaining = 0;
+        };
+
+        // Renders a batch of voices in structure-of-arrays form, one sample at a time
+        struct BatchedSineVoice  : public SineVoice
+        {
+            bool supportsBatchRendering() const override     { return true; }
+
+            template <typename FloatType>
+            static void renderVoices (SynthesiserVoice* const* voices, int numVoices,
+                                      AudioBuffer<FloatType>& buffer, int startSample, int numSamples)
+            {
+                std::vector<float> phases, increments, levels;
+                std::vector<int> remaining;
+
+                for (int v = 0; v < numVoices; ++v)
+                {
+                    auto& voice = *static_cast<BatchedSineVoice*> (voices[v]);
+                    voice.lastBatchSize = numVoices;
+                    phases.push_back (voice.phase);
+                    increments.push_back (voice.increment);
+                    levels.push_back (voice.samplesRemaining > 0 ? voice.level : 0.0f);
+                    remaining.push_back (voice.samplesRemaining);
+                }
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    FloatType sum = 0;
+
+                    for (size_t v = 0; v < phases.size(); ++v)
+                    {
+                        if (i < remaining[v])
+                        {
+                            sum += (FloatType) (std::sin (phases[v]) * levels[v]);
+                            phases[v] += increments[v];
+                        }
+                    }
+
+                    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                        buffer.addSample (channel, startSample + i, sum);
+                }
+
+                for (int v = 0; v < numVoices; ++v)
+                {
+                    auto& voice = *static_cast<BatchedSineVoice*> (voices[v]);
+                    voice.phase = phases[(size_t) v];
+                    voice.samplesRemaining = jmax (0, voice.samplesRemaining - numSamples);
+
+                    if (voice.samplesRemaining == 0)
+                        voice.clearCurrentNote();
+                }
+            }
+
+            void renderBatch (SynthesiserVoice* const* voices, int numVoices,
+                              AudioBuffer<float>& b, int start, int num) override     { renderVoices (voices, numVoices, b, start, num); }
+            void renderBatch (SynthesiserVoice* const* voices, int numVoices,
+                              AudioBuffer<double>& b, int start, int num) override    { renderVoices (voices, numVoices, b, start, num); }
+
+            // Only touched by whichever thread renders this voice's batch
+            int lastBatchSize = 0;
+        };
+
+    public:
+        // Applies its own events, and only splits its rendering at the ones meant for it
+        struct TimestampedSineVoice  : public SineVoice
+        {
+            template <typename FloatType>
+            void renderWithEvents (AudioBuffer<FloatType>& buffer, int startSample, int numSamples,
+                                   MidiBufferIterator firstEvent, MidiBufferIterator lastEvent)
+            {
+                const auto endSample = startSample + numSamples;
+
+                for (auto it = firstEvent; it != lastEvent; ++it)
+                {
+                    const auto metadata = *it;
+
+                    if (! isPlayingChannel ((metadata.data[0] & 0x0f) + 1))
+                        continue;
+
+                    render (buffer, startSample, metadata.samplePosition - startSample);
+                    startSample = metadata.samplePosition;
+                    applyEvent (metadata.getMessage());
+                }
+
+                render (buffer, startSample, endSample - startSample);
+            }
+
+            void renderNextBlockWithEvents (AudioBuffer<float>& b, int start, int num,
+                                            MidiBufferIterator first, MidiBufferIterator last) override   { renderWithEvents (b, start, num, first, last); }
+            void renderNextBlockWithEvents (AudioBuffer<double>& b, int start, int num,
+                                            MidiBufferIterator first, MidiBufferIterator last) override  { renderWithEvents (b, start, num, first, last); }
+        };
+
+        template <typename VoiceType>
+        struct TestSynth  : public Synthesiser
+        {
+            explicit TestSynth (int numVoices)
+            {
+                for (int i = 0; i < numVoices; ++i)
+                    addVoice (new VoiceType());
+            }
+        };
+
+    private:
+        struct CountingSynth  : public TestSynth<SineVoice>
+        {
+            CountingSynth() : TestSynth<SineVoice> (4) {}
+
+            void renderVoices (AudioBuffer<float>& b, int start, int num) override
+            {
+                ++numRenderCalls;
+                Synthesiser::renderVoices (b, start, num);
+            }
+
+            void renderVoicesWithEvents (AudioBuffer<float>& b, int start, int num,
+                                         MidiBufferIterator first, MidiBufferIterator last) override
+            {
+                ++numRenderCalls;
+                Synthesiser::renderVoicesWithEvents (b, start, num, first, last);
+            }
+
+            using Synthesiser::renderVoices;
+            using Synthesiser::renderVoicesWithEvents;
+
+            int numRenderCalls = 0;
+        };
+
+        //==============================================================================
+        static std::function<void (Synthesiser&)> parallel (int numThreads)
+        {
+            return [numThreads] (Synthesiser& s) { s.setNumParallelRenderThreads (numThreads, blockSize, 2); };
+        }
+
+        template <typename FloatType, typename VoiceType>
+        static AudioBuffer<FloatType> render (const std::function<void (Synthesiser&)>& configure)
+        {
+            constexpr int numBlocks = 40;
+
+            TestSynth<VoiceType> synth (64);
+            synth.addSound (new TestSound (0, 63));
+            synth.addSound (new TestSound (64, 127));
+            synth.setCurrentPlaybackSampleRate (44100.0);
+
+            if (configure != nullptr)
+                configure (synth);
+
+            AudioBuffer<FloatType> output (2, blockSize * numBlocks);
+            output.clear();
+
+            Random random (123);
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                MidiBuffer midi;
+
+                for (int i = 0; i < 6; ++i)
+                    midi.addEvent (MidiMessage::noteOn (1 + random.nextInt (2), 24 + random.nextInt (80), 0.2f + 0.8f * random.nextFloat()),
+                                   random.nextInt (blockSize));
+
+                for (int i = 0; i < blockSize; i += 8)
+                {
+                    midi.addEvent (MidiMessage::pitchWheel (1 + random.nextInt (2), random.nextInt (16384)), i + random.nextInt (8));
+                    midi.addEvent (MidiMessage::channelPressureChange (1 + random.nextInt (2), random.nextInt (128)), i + random.nextInt (8));
+                }
+
+                if (block % 7 == 6)
+                    midi.addEvent (MidiMessage::allNotesOff (1), blockSize / 2);
+
+                AudioBuffer<FloatType> sub (output.getArrayOfWritePointers(), 2, block * blockSize, blockSize);
+                synth.renderNextBlock (sub, midi, 0, blockSize);
+            }
+
+            return output;
+        }
+
+        template <typename FloatType, typename ReferenceVoice, typename VoiceType = ReferenceVoice>
+        static bool rendersIdentically (const std::function<void (Synthesiser&)>& configureReference,
+                                        const std::function<void (Synthesiser&)>& configure)
+        {
+            const auto reference = render<FloatType, ReferenceVoice> (configureReference);
+            const auto result = render<FloatType, VoiceType> (configure);
+
+            if (reference.getMagnitude (0, reference.getNumSamples()) < (FloatType) 0.1)
+                return false;
+
+            for (int channel = 0; channel < reference.getNumChannels(); ++channel)
+                for (int i = 0; i < reference.getNumSamples(); ++i)
+                    if (std::abs (reference.getSample (channel, i) - result.getSample (channel, i)) > (FloatType) 1.0e-4)
+                        return false;
+
+            return true;
+        }
+    };
+
+    SynthesiserTests synthesiserTests;
+
+    //==============================================================================
+    class SynthesiserBenchmarks  : public UnitTest
+    {
+    public:
+        SynthesiserBenchmarks()
+            : UnitTest ("Synthesiser MPE rendering", UnitTestCategories::benchmarks)
+        {}
+
+        void runTest() override
+        {
+            constexpr int blockSize = 512, numBlocks = 400, numChannels = 15;
+
+            // One note per channel, each with pressure and pitch-bend data every 4 samples
+            std::vector<MidiBuffer> blocks (numBlocks);
+
+            for (auto& midi : blocks)
+            {
+                for (int channel = 2; channel <= numChannels + 1; ++channel)
+                {
+                    for (int i = channel % 4; i < blockSize; i += 4)
+                    {
+                        midi.addEvent (MidiMessage::pitchWheel (channel, 8192 + 20 * (i % 64)), i);
+                        midi.addEvent (MidiMessage::channelPressureChange (channel, i % 128), i);
+                    }
+                }
+            }
+
+            const auto measure = [&] (const String& testName, auto voiceTag, auto&& configure)
+            {
+                using VoiceType = typename decltype (voiceTag)::type;
+
+                beginTest (testName);
+
+                SynthesiserTests::TestSynth<VoiceType> synth (numChannels);
+                synth.addSound (new Sound());
+                synth.setCurrentPlaybackSampleRate (48000.0);
+                configure (synth);
+
+                for (int channel = 2; channel <= numChannels + 1; ++channel)
+                    synth.noteOn (channel, 40 + channel * 2, 0.8f);
+
+                AudioBuffer<float> buffer (2, blockSize);
+
+                const auto start = Time::getHighResolutionTicks();
+
+                for (const auto& midi : blocks)
+                {
+                    buffer.clear();
+                    synth.renderNextBlock (buffer, midi, 0, blockSize);
+                }
+
+                const auto elapsed = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+                logMessage (String (elapsed * 1.0e6 / numBlocks, 1) + " us per block");
+                expect (elapsed > 0.0);
+            };
+
+            measure ("Split every 32 samples (default)", Tag<SynthesiserTests::TimestampedSineVoice>(), [] (Synthesiser&) {});
+            measure ("Split at every event", Tag<SynthesiserTests::TimestampedSineVoice>(),
+                     [] (Synthesiser& s) { s.setMinimumRenderingSubdivisionSize (1); });
+            measure ("Timestamped events", Tag<SynthesiserTests::TimestampedSineVoice>(),
+                     [] (Synthesiser& s) { s.setTimestampedEventRenderingEnabled (true); });
+        }
+
+    private:
+        template <typename T>
+        struct Tag { using type = T; };
+
+        struct Sound  : public SynthesiserSound
+        {
+            bool appliesToNote (int) override       { return true; }
+            bool appliesToChannel (int) override    { return true; }
+        };
+    };
+
+    SynthesiserBenchmarks synthesiserBenchmarks;
+}
+
+#endif
+
 } // namespace juce
@@ -192,6 +192,41 @@ public:
                                   int startSample,
                                   int numSamples);
 
+    /** Renders the next block of data for this voice, applying some events part-way through it.
+
+        This is called instead of renderNextBlock() when the Synthesiser has timestamped event
+        rendering enabled, and some events fall inside the block. The events are pitch-wheel,
+        controller, aftertouch and channel pressure messages, and their sample positions use the
+        same coordinates as startSample. They haven't been filtered, so they may include messages
+        for other channels or notes, which applyEvent() will ignore.
+
+        Overriding this lets a voice render the whole block in one go, applying parameter changes
+        at the right sample offsets itself, rather than having its block split at every event.
+
+        The default implementation renders the pieces of the block between the events with
+        renderNextBlock(), calling applyEvent() for each event in turn.
+
+        @see Synthesiser::setTimestampedEventRenderingEnabled
+    */
+    virtual void renderNextBlockWithEvents (AudioBuffer<float>& outputBuffer,
+                                            int startSample,
+                                            int numSamples,
+                                            MidiBufferIterator firstEvent,
+                                            MidiBufferIterator lastEvent);
+
+    /** A double-precision version of renderNextBlockWithEvents() */
+    virtual void renderNextBlockWithEvents (AudioBuffer<double>& outputBuffer,
+                                            int startSample,
+                                            int numSamples,
+                                            MidiBufferIterator firstEvent,
+                                            MidiBufferIterator lastEvent);
+
+    /** Passes a pitch-wheel, controller, aftertouch or channel pressure message on to
+        pitchWheelMoved(), controllerMoved(), aftertouchChanged() or channelPressureChanged(),
+        if it applies to the note that this voice is playing.
+    */
+    void applyEvent (const MidiMessage& message);
+
     /** Changes the voice's reference sample rate.
 
         The rate is set so that subclasses know the output rate and can set their pitch
@@ -246,6 +281,43 @@ public:
     /** Returns true if this voice started playing its current note before the other voice did. */
     bool wasStartedBefore (const SynthesiserVoice& other) const noexcept;
 
+    //==============================================================================
+    /** Voice classes which can render several notes at once more efficiently than one
+        at a time should override this to return true.
+
+        When this returns true, the Synthesiser will gather up all the active voices that
+        are playing the same SynthesiserSound and pass them to renderBatch() together,
+        instead of calling renderNextBlock() on each one. This lets a voice keep its
+        per-note state in structure-of-arrays form, and vectorise its per-sample work
+        across the notes in the batch.
+
+        Only return true if all the voices which can play a given sound are of the same
+        class, as a batch may contain any of them.
+    */
+    virtual bool supportsBatchRendering() const                 { return false; }
+
+    /** Renders the next block of data for a batch of voices playing the same sound.
+
+        This is only called if supportsBatchRendering() returns true. It's called on the
+        first voice in the batch, and the voices array includes this voice. Each voice must
+        add its output to the buffer in the same way as renderNextBlock(), and must call
+        clearCurrentNote() if it finishes during the block.
+
+        The default implementation just calls renderNextBlock() on each voice in turn.
+    */
+    virtual void renderBatch (SynthesiserVoice* const* voicesInBatch,
+                              int numVoicesInBatch,
+                              AudioBuffer<float>& outputBuffer,
+                              int startSample,
+                              int numSamples);
+
+    /** A double-precision version of renderBatch() */
+    virtual void renderBatch (SynthesiserVoice* const* voicesInBatch,
+                              int numVoicesInBatch,
+                              AudioBuffer<double>& outputBuffer,
+                              int startSample,
+                              int numSamples);
+
 protected:
     /** Resets the state of this voice after a sound has finished playing.
 
@@ -557,6 +629,55 @@ public:
     */
     void setMinimumRenderingSubdivisionSize (int numSamples, bool shouldBeStrict = false) noexcept;
 
+    //==============================================================================
+    /** Allows the voices to be rendered concurrently on several threads.
+
+        When numWorkerThreads is non-zero, the synth starts that many realtime worker
+        threads, which help the audio thread to render the voices. Each thread renders
+        its share of the voices into its own buffer, and these are then summed into the
+        output, so no locks are needed while rendering. Batches of voices created for
+        SynthesiserVoice::supportsBatchRendering() are always rendered on a single thread.
+
+        The voices' renderNextBlock() methods will be called on the worker threads, so
+        they mustn't modify any state that is shared with other voices.
+
+        maximumBlockSize and maximumNumChannels are used to allocate the worker threads'
+        buffers. The voices will be rendered serially for any block where startSample +
+        numSamples is greater than maximumBlockSize.
+
+        The default is 0, which renders every voice in turn on the audio thread.
+    */
+    void setNumParallelRenderThreads (int numWorkerThreads,
+                                      int maximumBlockSize,
+                                      int maximumNumChannels);
+
+    /** Returns the number of worker threads set with setNumParallelRenderThreads(). */
+    int getNumParallelRenderThreads() const noexcept;
+
+    //==============================================================================
+    /** Lets voices apply continuous controller data at sample offsets within a block.
+
+        Normally the synth splits each block at every incoming midi event (down to the limit set
+        with setMinimumRenderingSubdivisionSize()), and passes each event to the voices between
+        the pieces. Dense controller data, such as MPE pressure or high-resolution CCs, can then
+        break a block into lots of tiny pieces.
+
+        When this is enabled, only the events that can start or stop voices will split the block.
+        These are notes, the sustain, sostenuto and soft pedals, all-notes-off and program changes.
+        Pitch-wheel, controller, aftertouch and channel pressure messages are instead passed to
+        SynthesiserVoice::renderNextBlockWithEvents() along with the rest of the block, so that
+        voices can apply them at the correct sample.
+
+        Note that in this mode, those events aren't passed to handleMidiEvent(), handlePitchWheel(),
+        handleController(), handleAftertouch() or handleChannelPressure().
+    */
+    void setTimestampedEventRenderingEnabled (bool shouldBeEnabled) noexcept;
+
+    /** Returns true if timestamped event rendering is enabled.
+        @see setTimestampedEventRenderingEnabled
+    */
+    bool isTimestampedEventRenderingEnabled() const noexcept        { return timestampedEventRendering; }
+
 protected:
     //==============================================================================
     /** This is used to control access to the rendering callback and the note trigger methods. */
@@ -577,6 +698,21 @@ protected:
     virtual void renderVoices (AudioBuffer<double>& outputAudio,
                                int startSample, int numSamples);
 
+    /** Renders the voices for the given range, passing them the events which fall inside it.
+
+        This is used instead of renderVoices() when timestamped event rendering is enabled and
+        there are pitch-wheel, controller or pressure events in the range. By default it calls
+        SynthesiserVoice::renderNextBlockWithEvents() on each voice.
+
+        @see setTimestampedEventRenderingEnabled
+    */
+    virtual void renderVoicesWithEvents (AudioBuffer<float>& outputAudio,
+                                         int startSample, int numSamples,
+                                         MidiBufferIterator firstEvent, MidiBufferIterator lastEvent);
+    virtual void renderVoicesWithEvents (AudioBuffer<double>& outputAudio,
+                                         int startSample, int numSamples,
+                                         MidiBufferIterator firstEvent, MidiBufferIterator lastEvent);
+
     /** Searches through the voices to find one that's not currently playing, and
         which can play the given sound.
 
@@ -626,11 +762,42 @@ private:
     int minimumSubBlockSize = 32;
     bool subBlockSubdivisionIsStrict = false;
     bool shouldStealNotes = true;
+    bool timestampedEventRendering = false;
     BigInteger sustainPedalsDown;
 
+    struct EventRange
+    {
+        MidiBufferIterator first, last;
+    };
+
+    struct RenderItem
+    {
+        int firstVoice, numVoices;
+        bool isBatch;
+    };
+
+    Array<SynthesiserVoice*> voicesInRenderOrder;
+    Array<RenderItem> renderItems;
+    bool anyVoiceSupportsBatching = false;
+
+    class ParallelRenderer;
+    std::unique_ptr<ParallelRenderer> parallelRenderer;
+
     template <typename floatType>
     void processNextBlock (AudioBuffer<floatType>&, const MidiBuffer&, int startSample, int numSamples);
 
+    template <typename floatType>
+    void processNextBlockWithTimestampedEvents (AudioBuffer<floatType>&, const MidiBuffer&, int startSample, int numSamples);
+
+    template <typename floatType>
+    void renderVoicesInItems (AudioBuffer<floatType>&, int startSample, int numSamples, const EventRange*);
+
+    template <typename floatType>
+    void renderItem (const RenderItem&, AudioBuffer<floatType>&, int startSample, int numSamples, const EventRange*);
+
+    void updateRenderItems();
+    void voicesChanged();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Synthesiser)
 };
 
@@ -0,0 +1,489 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace FDNReverbHelpers
+{
+    // The delay times in milliseconds at the largest room size. The first eight are
+    // spread across the whole range, so that the low quality setting still sounds even.
+    static const float lineTimes[] = { 29.3f, 34.4f, 40.3f, 47.3f, 55.5f, 65.1f, 76.3f, 89.5f,
+                                       31.7f, 37.2f, 43.7f, 51.2f, 60.1f, 70.5f, 82.7f, 97.0f };
+
+    // The signs used to feed the input into the lines and take the outputs from them,
+    // chosen so that the left and right outputs are decorrelated.
+    static const float inputSigns[]  = { 1, -1,  1,  1, -1,  1, -1, -1,  1,  1, -1,  1, -1, -1,  1, -1 };
+    static const float leftSigns[]   = { 1,  1, -1,  1, -1, -1,  1, -1, -1,  1,  1, -1,  1, -1, -1,  1 };
+    static const float rightSigns[]  = { -1, 1,  1, -1,  1, -1,  1,  1, -1, -1,  1,  1, -1,  1, -1,  1 };
+
+    static const float diffuserTimes[] = { 4.77f, 3.59f, 2.73f, 1.93f };
+    constexpr float diffuserGain = 0.6f, diffuserStereoSpread = 1.07f;
+    constexpr float wetScaleFactor = 1.5f, dryScaleFactor = 2.0f;
+
+    alignas (16) static const float pairSigns[] = { 1.0f, -1.0f,  1.0f, -1.0f };
+    alignas (16) static const float halfSigns[] = { 1.0f,  1.0f, -1.0f, -1.0f };
+
+    //==============================================================================
+    // A minimal four-lane vector, which is all that the network needs
+   #if JUCE_USE_SSE_INTRINSICS
+    struct Vec4
+    {
+        static Vec4 load (const float* p) noexcept      { return { _mm_load_ps (p) }; }
+        static Vec4 expand (float s) noexcept           { return { _mm_set1_ps (s) }; }
+        static Vec4 fromValues (float a, float b, float c, float d) noexcept   { return { _mm_setr_ps (a, b, c, d) }; }
+        void store (float* p) const noexcept            { _mm_store_ps (p, value); }
+
+        Vec4 operator+ (Vec4 other) const noexcept      { return { _mm_add_ps (value, other.value) }; }
+        Vec4 operator- (Vec4 other) const noexcept      { return { _mm_sub_ps (value, other.value) }; }
+        Vec4 operator* (Vec4 other) const noexcept      { return { _mm_mul_ps (value, other.value) }; }
+
+        Vec4 swapPairs() const noexcept                 { return { _mm_shuffle_ps (value, value, _MM_SHUFFLE (2, 3, 0, 1)) }; }
+        Vec4 swapHalves() const noexcept                { return { _mm_shuffle_ps (value, value, _MM_SHUFFLE (1, 0, 3, 2)) }; }
+
+        float sum() const noexcept
+        {
+            auto s = _mm_add_ps (value, _mm_movehl_ps (value, value));
+            return _mm_cvtss_f32 (_mm_add_ss (s, _mm_shuffle_ps (s, s, 1)));
+        }
+
+        __m128 value;
+    };
+   #elif JUCE_USE_ARM_NEON
+    struct Vec4
+    {
+        static Vec4 load (const float* p) noexcept      { return { vld1q_f32 (p) }; }
+        static Vec4 expand (float s) noexcept           { return { vdupq_n_f32 (s) }; }
+
+        static Vec4 fromValues (float a, float b, float c, float d) noexcept
+        {
+            alignas (16) const float values[] = { a, b, c, d };
+            return load (values);
+        }
+        void store (float* p) const noexcept            { vst1q_f32 (p, value); }
+
+        Vec4 operator+ (Vec4 other) const noexcept      { return { vaddq_f32 (value, other.value) }; }
+        Vec4 operator- (Vec4 other) const noexcept      { return { vsubq_f32 (value, other.value) }; }
+        Vec4 operator* (Vec4 other) const noexcept      { return { vmulq_f32 (value, other.value) }; }
+
+        Vec4 swapPairs() const noexcept                 { return { vrev64q_f32 (value) }; }
+        Vec4 swapHalves() const noexcept                { return { vcombine_f32 (vget_high_f32 (value), vget_low_f32 (value)) }; }
+
+        float sum() const noexcept
+        {
+            auto s = vadd_f32 (vget_low_f32 (value), vget_high_f32 (value));
+            return vget_lane_f32 (vpadd_f32 (s, s), 0);
+        }
+
+        float32x4_t value;
+    };
+   #else
+    struct Vec4
+    {
+        static Vec4 load (const float* p) noexcept      { return { { p[0], p[1], p[2], p[3] } }; }
+        static Vec4 expand (float s) noexcept           { return { { s, s, s, s } }; }
+        static Vec4 fromValues (float a, float b, float c, float d) noexcept   { return { { a, b, c, d } }; }
+        void store (float* p) const noexcept            { std::copy (value, value + 4, p); }
+
+        Vec4 operator+ (Vec4 o) const noexcept          { return { { value[0] + o.value[0], value[1] + o.value[1], value[2] + o.value[2], value[3] + o.value[3] } }; }
+        Vec4 operator- (Vec4 o) const noexcept          { return { { value[0] - o.value[0], value[1] - o.value[1], value[2] - o.value[2], value[3] - o.value[3] } }; }
+        Vec4 operator* (Vec4 o) const noexcept          { return { { value[0] * o.value[0], value[1] * o.value[1], value[2] * o.value[2], value[3] * o.value[3] } }; }
+
+        Vec4 swapPairs() const noexcept                 { return { { value[1], value[0], value[3], value[2] } }; }
+        Vec4 swapHalves() const noexcept                { return { { value[2], value[3], value[0], value[1] } }; }
+
+        float sum() const noexcept                      { return (value[0] + value[1]) + (value[2] + value[3]); }
+
+        float value[4];
+    };
+   #endif
+
+    // An unnormalised 4x4 Hadamard transform of the lanes of a vector
+    static inline Vec4 hadamard (Vec4 v) noexcept
+    {
+        v = v.swapPairs() + v * Vec4::load (pairSigns);
+        return v.swapHalves() + v * Vec4::load (halfSigns);
+    }
+}
+
+//==============================================================================
+void FDNReverb::Diffuser::setSize (int newSize)
+{
+    if (newSize != size)
+    {
+        buffer.malloc (newSize);
+        size = newSize;
+        position = 0;
+    }
+
+    clear();
+}
+
+void FDNReverb::Diffuser::clear() noexcept
+{
+    buffer.clear ((size_t) size);
+}
+
+float FDNReverb::Diffuser::process (float input) noexcept
+{
+    using namespace FDNReverbHelpers;
+
+    const auto delayed = buffer[position];
+    const auto stored = input + diffuserGain * delayed;
+    buffer[position] = stored;
+
+    if (++position == size)
+        position = 0;
+
+    return delayed - diffuserGain * stored;
+}
+
+//==============================================================================
+FDNReverb::FDNReverb()
+{
+    setSampleRate (44100.0);
+}
+
+FDNReverb::~FDNReverb() = default;
+
+//==============================================================================
+void FDNReverb::setParameters (const Parameters& newParams)
+{
+    const auto oldNumLines = numLines;
+    const auto roomSizeChanged = newParams.roomSize != parameters.roomSize;
+    const auto diffusionStarted = newParams.quality == Quality::high && parameters.quality != Quality::high;
+
+    parameters = newParams;
+    numLines = getNumLinesFor (parameters.quality);
+
+    // Lines that are being brought back into use may still hold an old tail
+    if (numLines > oldNumLines)
+        clearLines (oldNumLines, numLines);
+
+    if (diffusionStarted)
+        for (auto& channel : diffusers)
+            for (auto& diffuser : channel)
+                diffuser.clear();
+
+    if (roomSizeChanged)
+        updateLineLengths();
+
+    updateCoefficients();
+}
+
+void FDNReverb::setSampleRate (double sampleRate)
+{
+    using namespace FDNReverbHelpers;
+
+    jassert (sampleRate > 0);
+    currentSampleRate = sampleRate;
+
+    size_t totalLength = 0;
+
+    for (int i = 0; i < maxNumLines; ++i)
+    {
+        maxLineLength[i] = (int) std::ceil (lineTimes[i] * 0.001 * sampleRate) + 1;
+        totalLength += (size_t) maxLineLength[i];
+    }
+
+    lineMemory.malloc (totalLength);
+    auto* data = lineMemory.get();
+
+    for (int i = 0; i < maxNumLines; ++i)
+    {
+        lineData[i] = data;
+        data += maxLineLength[i];
+    }
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        for (int i = 0; i < numDiffusers; ++i)
+        {
+            const auto time = diffuserTimes[i] * (channel == 0 ? 1.0f : diffuserStereoSpread);
+            diffusers[channel][i].setSize (jmax (1, roundToInt (time * 0.001 * sampleRate)));
+        }
+    }
+
+    const double smoothTime = 0.01;
+    dryGain .reset (sampleRate, smoothTime);
+    wetGain1.reset (sampleRate, smoothTime);
+    wetGain2.reset (sampleRate, smoothTime);
+
+    numLines = getNumLinesFor (parameters.quality);
+    updateLineLengths();
+    updateCoefficients();
+    reset();
+}
+
+void FDNReverb::reset()
+{
+    clearLines (0, maxNumLines);
+
+    for (auto& channel : diffusers)
+        for (auto& diffuser : channel)
+            diffuser.clear();
+}
+
+void FDNReverb::clearLines (int firstLine, int lastLine) noexcept
+{
+    for (int i = firstLine; i < lastLine; ++i)
+    {
+        FloatVectorOperations::clear (lineData[i], maxLineLength[i]);
+        lines.lowState[i] = 0;
+        lines.highState[i] = 0;
+    }
+}
+
+//==============================================================================
+void FDNReverb::updateLineLengths() noexcept
+{
+    using namespace FDNReverbHelpers;
+
+    const auto scale = 0.25 + 0.75 * jlimit (0.0, 1.0, (double) parameters.roomSize);
+
+    for (int i = 0; i < maxNumLines; ++i)
+    {
+        // Odd lengths avoid most of the common factors between the lines
+        lineLength[i] = jlimit (1, maxLineLength[i], (int) (lineTimes[i] * 0.001 * scale * currentSampleRate) | 1);
+
+        if (linePosition[i] >= lineLength[i])
+            linePosition[i] = 0;
+    }
+}
+
+void FDNReverb::updateCoefficients() noexcept
+{
+    using namespace FDNReverbHelpers;
+
+    const auto sampleRate = currentSampleRate;
+    const auto frozen = isFrozen (parameters.freezeMode);
+
+    const auto maxCrossover = 0.45 * sampleRate;
+    const auto lowCrossover  = jlimit (10.0, maxCrossover, (double) parameters.lowCrossover);
+    const auto highCrossover = jlimit (lowCrossover, maxCrossover, (double) parameters.highCrossover);
+
+    lowCoefficient  = (float) (1.0 - std::exp (-MathConstants<double>::twoPi * lowCrossover  / sampleRate));
+    highCoefficient = (float) (1.0 - std::exp (-MathConstants<double>::twoPi * highCrossover / sampleRate));
+
+    const auto matrixScale = 1.0 / std::sqrt ((double) numLines);
+    inputGain = frozen ? 0.0f : (float) std::sqrt (2.0 / numLines);
+
+    const auto midTime = jmax (0.01, (double) parameters.decayTime);
+
+    for (int i = 0; i < maxNumLines; ++i)
+    {
+        double lowGain = 1.0, midGain = 1.0, highGain = 1.0;
+
+        if (! frozen)
+        {
+            const auto getGain = [&] (double decayTime)
+            {
+                return std::pow (10.0, -3.0 * lineLength[i] / (jmax (0.01, decayTime) * sampleRate));
+            };
+
+            lowGain  = getGain (midTime * parameters.lowDecayRatio);
+            midGain  = getGain (midTime);
+            highGain = getGain (midTime * parameters.highDecayRatio);
+        }
+
+        // The filter's output is highGain + (midGain - highGain) * lowpass (highCrossover)
+        // + (lowGain - midGain) * lowpass (lowCrossover), so this is the most its gain can
+        // reach. When the bands don't fall in order, that can be more than the largest of
+        // the three gains, and the whole filter is scaled down to keep the loop stable.
+        const auto largestGain = jmax (lowGain, midGain, highGain);
+        const auto peakGain = highGain + std::abs (midGain - highGain) + std::abs (lowGain - midGain);
+        const auto scale = matrixScale * (peakGain > largestGain ? largestGain / peakGain : 1.0);
+
+        const auto isUsed = i < numLines;
+
+        lines.lowStateWeight[i]  = isUsed ? (float) ((lowGain - midGain) * scale) : 0.0f;
+        lines.highStateWeight[i] = isUsed ? (float) ((midGain - highGain) * scale) : 0.0f;
+        lines.directWeight[i]    = isUsed ? (float) (highGain * scale) : 0.0f;
+
+        lines.inputLeft[i]   = isUsed && (i & 1) == 0 ? inputSigns[i] * inputGain : 0.0f;
+        lines.inputRight[i]  = isUsed && (i & 1) != 0 ? inputSigns[i] * inputGain : 0.0f;
+        lines.outputLeft[i]  = isUsed ? leftSigns[i]  * (float) matrixScale : 0.0f;
+        lines.outputRight[i] = isUsed ? rightSigns[i] * (float) matrixScale : 0.0f;
+    }
+
+    const auto wet = parameters.wetLevel * wetScaleFactor;
+    dryGain .setTargetValue (parameters.dryLevel * dryScaleFactor);
+    wetGain1.setTargetValue (0.5f * wet * (1.0f + parameters.width));
+    wetGain2.setTargetValue (0.5f * wet * (1.0f - parameters.width));
+}
+
+//==============================================================================
+void FDNReverb::processStereo (float* left, float* right, int numSamples) noexcept
+{
+    jassert (left != nullptr && right != nullptr);
+    process (left, right, left, right, numSamples);
+}
+
+void FDNReverb::processMono (float* samples, int numSamples) noexcept
+{
+    jassert (samples != nullptr);
+    process (samples, samples, samples, nullptr, numSamples);
+}
+
+void FDNReverb::process (const float* inLeft, const float* inRight, float* outLeft, float* outRight, int numSamples) noexcept
+{
+    const ScopedNoDenormals noDenormals;
+
+    if (outRight != nullptr)
+    {
+        if (numLines == 8)  processLines<8, true>  (inLeft, inRight, outLeft, outRight, numSamples);
+        else                processLines<16, true> (inLeft, inRight, outLeft, outRight, numSamples);
+    }
+    else
+    {
+        if (numLines == 8)  processLines<8, false>  (inLeft, inRight, outLeft, outRight, numSamples);
+        else                processLines<16, false> (inLeft, inRight, outLeft, outRight, numSamples);
+    }
+}
+
+template <int numLinesToUse, bool isStereo>
+void FDNReverb::processLines (const float* inLeft, const float* inRight, float* outLeft, float* outRight, int numSamples) noexcept
+{
+    using namespace FDNReverbHelpers;
+
+    constexpr int numGroups = numLinesToUse / 4;
+
+    const auto lowCoeff  = Vec4::expand (lowCoefficient);
+    const auto highCoeff = Vec4::expand (highCoefficient);
+    const auto diffuse = parameters.quality == Quality::high;
+
+    Vec4 lowState[(size_t) numGroups], highState[(size_t) numGroups];
+
+    for (int g = 0; g < numGroups; ++g)
+    {
+        lowState[g]  = Vec4::load (lines.lowState  + 4 * g);
+        highState[g] = Vec4::load (lines.highState + 4 * g);
+    }
+
+    for (int start = 0; start < numSamples;)
+    {
+        // Process as far as the next point where one of the lines wraps around
+        auto numThisTime = numSamples - start;
+        float* linePointers[(size_t) numLinesToUse];
+
+        for (int i = 0; i < numLinesToUse; ++i)
+        {
+            numThisTime = jmin (numThisTime, lineLength[i] - linePosition[i]);
+            linePointers[i] = lineData[i] + linePosition[i];
+        }
+
+        for (int n = 0; n < numThisTime; ++n)
+        {
+            const auto index = start + n;
+            const auto inL = inLeft[index];
+            const auto inR = inRight[index];
+            auto feedL = inL, feedR = inR;
+
+            if (diffuse)
+            {
+                for (auto& diffuser : diffusers[0])  feedL = diffuser.process (feedL);
+                for (auto& diffuser : diffusers[1])  feedR = diffuser.process (feedR);
+            }
+
+            Vec4 mixed[(size_t) numGroups];
+            auto wetL = Vec4::expand (0.0f), wetR = Vec4::expand (0.0f);
+
+            for (int g = 0; g < numGroups; ++g)
+            {
+                // Building the vector from the separate values avoids a store-forwarding
+                // stall that would happen when loading it from a temporary array
+                const auto* p = linePointers + 4 * g;
+                const auto x = Vec4::fromValues (p[0][n], p[1][n], p[2][n], p[3][n]);
+
+                lowState[g]  = lowState[g]  + lowCoeff  * (x - lowState[g]);
+                highState[g] = highState[g] + highCoeff * (x - highState[g]);
+
+                const auto filtered = lowState[g]  * Vec4::load (lines.lowStateWeight  + 4 * g)
+                                    + highState[g] * Vec4::load (lines.highStateWeight + 4 * g)
+                                    + x            * Vec4::load (lines.directWeight    + 4 * g);
+
+                wetL = wetL + filtered * Vec4::load (lines.outputLeft  + 4 * g);
+                wetR = wetR + filtered * Vec4::load (lines.outputRight + 4 * g);
+
+                mixed[g] = hadamard (filtered);
+            }
+
+            // Completes the Hadamard transform across the groups of four lines
+            for (int stride = 1; stride < numGroups; stride *= 2)
+            {
+                for (int g = 0; g < numGroups; g += 2 * stride)
+                {
+                    for (int k = g; k < g + stride; ++k)
+                    {
+                        const auto a = mixed[k], b = mixed[k + stride];
+                        mixed[k] = a + b;
+                        mixed[k + stride] = a - b;
+                    }
+                }
+            }
+
+            const auto vFeedL = Vec4::expand (feedL), vFeedR = Vec4::expand (feedR);
+            alignas (16) float lineValues[(size_t) numLinesToUse];
+
+            for (int g = 0; g < numGroups; ++g)
+                (mixed[g] + vFeedL * Vec4::load (lines.inputLeft  + 4 * g)
+                          + vFeedR * Vec4::load (lines.inputRight + 4 * g)).store (lineValues + 4 * g);
+
+            for (int i = 0; i < numLinesToUse; ++i)
+                linePointers[i][n] = lineValues[i];
+
+            const auto outL = wetL.sum();
+            const auto dry  = dryGain.getNextValue();
+            const auto wet1 = wetGain1.getNextValue();
+            const auto wet2 = wetGain2.getNextValue();
+
+            if (isStereo)
+            {
+                const auto outR = wetR.sum();
+                outLeft[index]  = outL * wet1 + outR * wet2 + inL * dry;
+                outRight[index] = outR * wet1 + outL * wet2 + inR * dry;
+            }
+            else
+            {
+                outLeft[index] = outL * wet1 + inL * dry;
+            }
+        }
+
+        for (int i = 0; i < numLinesToUse; ++i)
+        {
+            linePosition[i] += numThisTime;
+
+            if (linePosition[i] == lineLength[i])
+                linePosition[i] = 0;
+        }
+
+        start += numThisTime;
+    }
+
+    for (int g = 0; g < numGroups; ++g)
+    {
+        lowState[g] .store (lines.lowState  + 4 * g);
+        highState[g].store (lines.highState + 4 * g);
+    }
+}
+
+} // namespace juce
@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A stereo reverb built from a feedback delay network.
+
+    The input is fed into a set of parallel delay lines whose outputs are mixed
+    back into their inputs through an orthogonal Hadamard matrix, so that every
+    echo is spread across all the lines and the echo density builds up quickly.
+    Each line has a three-band filter in its feedback path, which sets separate
+    decay times for the low, mid and high frequencies.
+
+    All the lines are processed together using SIMD instructions where they're
+    available, so this is considerably cheaper than the Reverb class while giving
+    a denser, smoother tail. The Quality setting chooses how many lines are used.
+
+    Use setSampleRate() to prepare it, and then call processStereo() or processMono()
+    to apply the reverb to your audio data.
+
+    @see Reverb, ReverbAudioSource
+
+    @tags{Audio}
+*/
+class JUCE_API  FDNReverb
+{
+public:
+    //==============================================================================
+    /** The quality settings, which trade echo density against CPU usage. */
+    enum class Quality
+    {
+        low,        /**< 8 delay lines. */
+        medium,     /**< 16 delay lines. */
+        high        /**< 16 delay lines, with a chain of all-pass diffusers on the input. */
+    };
+
+    /** Holds the parameters being used by an FDNReverb object. */
+    struct Parameters
+    {
+        float roomSize       = 0.5f;      /**< Room size, 0 to 1.0, which scales the lengths of the delay lines. */
+        float decayTime      = 2.0f;      /**< The time in seconds that the mid frequencies take to decay by 60dB. */
+        float lowDecayRatio  = 1.2f;      /**< The decay time of the low frequencies, as a multiple of decayTime. */
+        float highDecayRatio = 0.4f;      /**< The decay time of the high frequencies, as a multiple of decayTime. */
+        float lowCrossover   = 250.0f;    /**< The frequency in Hz that divides the low and mid bands. */
+        float highCrossover  = 4000.0f;   /**< The frequency in Hz that divides the mid and high bands. */
+        float wetLevel       = 0.33f;     /**< Wet level, 0 to 1.0 */
+        float dryLevel       = 0.4f;      /**< Dry level, 0 to 1.0 */
+        float width          = 1.0f;      /**< Reverb width, 0 to 1.0, where 1.0 is very wide. */
+        float freezeMode     = 0.0f;      /**< Freeze mode - values < 0.5 are "normal" mode, values > 0.5
+                                               put the reverb into a continuous feedback loop. */
+        Quality quality      = Quality::medium;   /**< The number of delay lines to use. */
+    };
+
+    //==============================================================================
+    /** Creates a reverb with the default parameters, prepared for 44.1kHz. */
+    FDNReverb();
+
+    /** Destructor. */
+    ~FDNReverb();
+
+    //==============================================================================
+    /** Returns the reverb's current parameters. */
+    const Parameters& getParameters() const noexcept    { return parameters; }
+
+    /** Applies a new set of parameters to the reverb.
+
+        This doesn't allocate, so it can be called from the audio thread, but it
+        doesn't attempt to lock the reverb either, so if you call it in parallel with
+        the process methods you may get artifacts. Changing the room size or the
+        quality will also cause a discontinuity in the tail.
+    */
+    void setParameters (const Parameters& newParams);
+
+    /** Sets the sample rate that will be used for the reverb.
+        You must call this before the process methods, in order to tell it the correct sample rate.
+        This allocates the delay lines, so you should never call it from the audio thread.
+    */
+    void setSampleRate (double sampleRate);
+
+    /** Clears the reverb's buffers. */
+    void reset();
+
+    //==============================================================================
+    /** Applies the reverb to two stereo channels of audio data. */
+    void processStereo (float* left, float* right, int numSamples) noexcept;
+
+    /** Applies the reverb to a single mono channel of audio data. */
+    void processMono (float* samples, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    enum { maxNumLines = 16, numDiffusers = 4 };
+
+    struct Diffuser
+    {
+        void setSize (int newSize);
+        void clear() noexcept;
+        float process (float input) noexcept;
+
+        HeapBlock<float> buffer;
+        int size = 0, position = 0;
+    };
+
+    // The per-line values, laid out so that groups of four lines can be loaded into a vector
+    struct alignas (16) LineState
+    {
+        float lowState[maxNumLines], highState[maxNumLines];
+        float lowStateWeight[maxNumLines], highStateWeight[maxNumLines], directWeight[maxNumLines];
+        float inputLeft[maxNumLines], inputRight[maxNumLines];
+        float outputLeft[maxNumLines], outputRight[maxNumLines];
+    };
+
+    static bool isFrozen (float freezeMode) noexcept    { return freezeMode >= 0.5f; }
+    static int getNumLinesFor (Quality q) noexcept      { return q == Quality::low ? 8 : 16; }
+
+    void updateLineLengths() noexcept;
+    void updateCoefficients() noexcept;
+    void clearLines (int firstLine, int lastLine) noexcept;
+
+    template <int numLinesToUse, bool isStereo>
+    void processLines (const float* inLeft, const float* inRight, float* outLeft, float* outRight, int numSamples) noexcept;
+
+    void process (const float* inLeft, const float* inRight, float* outLeft, float* outRight, int numSamples) noexcept;
+
+    //==============================================================================
+    Parameters parameters;
+    double currentSampleRate = 44100.0;
+    int numLines = 16;
+
+    HeapBlock<float> lineMemory;
+    float* lineData[maxNumLines] = {};
+    int lineLength[maxNumLines] = {}, linePosition[maxNumLines] = {}, maxLineLength[maxNumLines] = {};
+
+    LineState lines;
+    float lowCoefficient = 0, highCoefficient = 0, inputGain = 0;
+
+    Diffuser diffusers[2][numDiffusers];
+
+    SmoothedValue<float> dryGain, wetGain1, wetGain2;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FDNReverb)
+};
+
+} // namespace juce
@@ -0,0 +1,335 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class FDNReverbTests  : public UnitTest
+{
+public:
+    FDNReverbTests()
+        : UnitTest ("FDNReverb", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("The tail decays at the requested rate");
+        {
+            for (auto quality : { FDNReverb::Quality::low, FDNReverb::Quality::medium, FDNReverb::Quality::high })
+            {
+                for (auto decayTime : { 0.5f, 1.5f })
+                {
+                    auto params = getWetParameters (quality, decayTime);
+                    params.lowDecayRatio = params.highDecayRatio = 1.0f;
+
+                    const auto response = getImpulseResponse (params, 3.0 * decayTime);
+                    const auto measured = measureDecayTime (response.getReadPointer (0), response.getNumSamples());
+
+                    expectWithinAbsoluteError (measured, (double) decayTime, 0.15 * decayTime);
+                }
+            }
+        }
+
+        beginTest ("Each band decays at its own rate");
+        {
+            auto params = getWetParameters (FDNReverb::Quality::medium, 1.0f);
+            params.lowDecayRatio = 2.0f;
+            params.highDecayRatio = 0.25f;
+
+            auto response = getImpulseResponse (params, 3.0);
+            AudioBuffer<float> low (response), high (response);
+
+            IIRFilter lowPass1, lowPass2, highPass1, highPass2;
+            lowPass1 .setCoefficients (IIRCoefficients::makeLowPass  (sampleRate, 80.0));
+            lowPass2 .setCoefficients (IIRCoefficients::makeLowPass  (sampleRate, 80.0));
+            highPass1.setCoefficients (IIRCoefficients::makeHighPass (sampleRate, 12000.0));
+            highPass2.setCoefficients (IIRCoefficients::makeHighPass (sampleRate, 12000.0));
+
+            for (auto* filter : { &lowPass1, &lowPass2 })
+                filter->processSamples (low.getWritePointer (0), low.getNumSamples());
+
+            for (auto* filter : { &highPass1, &highPass2 })
+                filter->processSamples (high.getWritePointer (0), high.getNumSamples());
+
+            const auto lowDecay  = measureDecayTime (low.getReadPointer (0),  low.getNumSamples());
+            const auto highDecay = measureDecayTime (high.getReadPointer (0), high.getNumSamples());
+
+            expectWithinAbsoluteError (lowDecay,  2.0,  0.4);
+            expectWithinAbsoluteError (highDecay, 0.25, 0.1);
+        }
+
+        beginTest ("Freeze mode holds the tail and ignores new input");
+        {
+            FDNReverb reverb;
+            reverb.setSampleRate (sampleRate);
+            auto params = getWetParameters (FDNReverb::Quality::medium, 1.0f);
+            reverb.setParameters (params);
+
+            auto random = getRandom();
+            AudioBuffer<float> buffer (2, (int) sampleRate / 2);
+            fillRandom (random, buffer);
+            reverb.processStereo (buffer.getWritePointer (0), buffer.getWritePointer (1), buffer.getNumSamples());
+
+            params.freezeMode = 1.0f;
+            reverb.setParameters (params);
+
+            const auto getFrozenLevel = [&] (bool withInput)
+            {
+                if (withInput)
+                    fillRandom (random, buffer);
+                else
+                    buffer.clear();
+
+                reverb.processStereo (buffer.getWritePointer (0), buffer.getWritePointer (1), buffer.getNumSamples());
+                return buffer.getRMSLevel (0, 0, buffer.getNumSamples());
+            };
+
+            const auto first  = getFrozenLevel (false);
+            const auto second = getFrozenLevel (true);
+            const auto third  = getFrozenLevel (false);
+
+            expectGreaterThan (first, 0.01f);
+            expectWithinAbsoluteError (Decibels::gainToDecibels (second / first), 0.0f, 1.0f);
+            expectWithinAbsoluteError (Decibels::gainToDecibels (third  / first), 0.0f, 1.0f);
+        }
+
+        beginTest ("Extreme parameters stay stable");
+        {
+            auto random = getRandom();
+            FDNReverb reverb;
+            reverb.setSampleRate (sampleRate);
+            AudioBuffer<float> buffer (2, 4096);
+
+            for (int i = 0; i < 30; ++i)
+            {
+                FDNReverb::Parameters params;
+                params.roomSize       = random.nextFloat();
+                params.decayTime      = 0.05f + 20.0f * random.nextFloat();
+                params.lowDecayRatio  = 0.1f + 4.0f * random.nextFloat();
+                params.highDecayRatio = 0.1f + 4.0f * random.nextFloat();
+                params.lowCrossover   = 20.0f + 2000.0f * random.nextFloat();
+                params.highCrossover  = 500.0f + 30000.0f * random.nextFloat();
+                params.quality        = (FDNReverb::Quality) random.nextInt (3);
+                reverb.setParameters (params);
+
+                for (int j = 0; j < 20; ++j)
+                {
+                    fillRandom (random, buffer);
+                    reverb.processStereo (buffer.getWritePointer (0), buffer.getWritePointer (1), buffer.getNumSamples());
+                }
+
+                const auto range = buffer.findMinMax (0, 0, buffer.getNumSamples());
+                expect (std::isfinite (range.getStart()) && std::isfinite (range.getEnd()));
+                expectLessThan (buffer.getMagnitude (0, buffer.getNumSamples()), 100.0f);
+            }
+        }
+
+        beginTest ("Wet level of zero passes the dry signal through");
+        {
+            FDNReverb reverb;
+            reverb.setSampleRate (sampleRate);
+            FDNReverb::Parameters params;
+            params.wetLevel = 0.0f;
+            params.dryLevel = 0.5f;
+            reverb.setParameters (params);
+
+            auto random = getRandom();
+            AudioBuffer<float> buffer (1, 4096);
+            fillRandom (random, buffer);
+            AudioBuffer<float> original (buffer);
+
+            reverb.processMono (buffer.getWritePointer (0), buffer.getNumSamples());
+
+            const int settled = (int) sampleRate / 50;
+            buffer.addFrom (0, 0, original, 0, 0, buffer.getNumSamples(), -1.0f);
+            expectLessThan (buffer.getMagnitude (0, settled, buffer.getNumSamples() - settled), 1.0e-5f);
+        }
+
+        beginTest ("ReverbAudioSource can use the FDN algorithm");
+        {
+            auto params = getWetParameters (FDNReverb::Quality::high, 1.0f);
+
+            auto random = getRandom();
+            AudioBuffer<float> source (2, 2048);
+            fillRandom (random, source);
+
+            MemoryAudioSource memorySource (source, false);
+            ReverbAudioSource reverbSource (&memorySource, false, ReverbAudioSource::Algorithm::feedbackDelayNetwork);
+            reverbSource.setFDNParameters (params);
+            reverbSource.prepareToPlay (512, sampleRate);
+
+            AudioBuffer<float> output (2, 2048);
+
+            for (int start = 0; start < output.getNumSamples(); start += 512)
+                reverbSource.getNextAudioBlock (AudioSourceChannelInfo (&output, start, 512));
+
+            FDNReverb reverb;
+            reverb.setParameters (params);
+            reverb.setSampleRate (sampleRate);
+            reverb.processStereo (source.getWritePointer (0), source.getWritePointer (1), source.getNumSamples());
+
+            for (int channel = 0; channel < 2; ++channel)
+                output.addFrom (channel, 0, source, channel, 0, output.getNumSamples(), -1.0f);
+
+            expectEquals (output.getMagnitude (0, output.getNumSamples()), 0.0f);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+
+    static void fillRandom (Random& random, AudioBuffer<float>& buffer)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    static FDNReverb::Parameters getWetParameters (FDNReverb::Quality quality, float decayTime)
+    {
+        FDNReverb::Parameters params;
+        params.quality = quality;
+        params.decayTime = decayTime;
+        params.wetLevel = 0.5f;
+        params.dryLevel = 0.0f;
+        return params;
+    }
+
+    static AudioBuffer<float> getImpulseResponse (const FDNReverb::Parameters& params, double lengthSeconds)
+    {
+        // Setting the sample rate last means that the gains start at their target values
+        FDNReverb reverb;
+        reverb.setParameters (params);
+        reverb.setSampleRate (sampleRate);
+
+        AudioBuffer<float> buffer (2, (int) (lengthSeconds * sampleRate));
+        buffer.clear();
+        buffer.setSample (0, 0, 1.0f);
+        buffer.setSample (1, 0, 1.0f);
+
+        reverb.processStereo (buffer.getWritePointer (0), buffer.getWritePointer (1), buffer.getNumSamples());
+        return buffer;
+    }
+
+    // Works out the time to decay by 60dB from the slope of the energy decay curve
+    // between -5dB and -25dB
+    static double measureDecayTime (const float* samples, int numSamples)
+    {
+        std::vector<double> energy ((size_t) numSamples + 1, 0.0);
+
+        for (int i = numSamples; --i >= 0;)
+            energy[(size_t) i] = energy[(size_t) i + 1] + (double) samples[i] * (double) samples[i];
+
+        const auto findTime = [&] (double decibels)
+        {
+            const auto threshold = energy[0] * std::pow (10.0, decibels / 10.0);
+
+            for (size_t i = 0; i < energy.size(); ++i)
+                if (energy[i] < threshold)
+                    return (double) i / sampleRate;
+
+            return (double) numSamples / sampleRate;
+        };
+
+        return 3.0 * (findTime (-25.0) - findTime (-5.0));
+    }
+};
+
+static FDNReverbTests fdnReverbTests;
+
+//==============================================================================
+class FDNReverbBenchmarks  : public UnitTest
+{
+public:
+    FDNReverbBenchmarks()
+        : UnitTest ("FDNReverb throughput", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("FDNReverb vs Reverb");
+
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512, numBlocks = 1000;
+
+        AudioBuffer<float> source (2, blockSize), buffer (2, blockSize);
+        auto random = getRandom();
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < blockSize; ++i)
+                source.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+        const auto time = [&] (auto& reverb)
+        {
+            reverb.setSampleRate (sampleRate);
+
+            const auto start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                buffer.makeCopyOf (source, true);
+                reverb.processStereo (buffer.getWritePointer (0), buffer.getWritePointer (1), blockSize);
+            }
+
+            const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+            return seconds * 1.0e9 / ((double) numBlocks * blockSize);
+        };
+
+        Reverb reverb;
+        const auto reverbTime = time (reverb);
+
+        String message ("ns per stereo sample: Reverb " + String (reverbTime, 2));
+
+        for (auto quality : { FDNReverb::Quality::low, FDNReverb::Quality::medium, FDNReverb::Quality::high })
+        {
+            FDNReverb fdnReverb;
+            FDNReverb::Parameters params;
+            params.quality = quality;
+            fdnReverb.setParameters (params);
+
+            const auto fdnTime = time (fdnReverb);
+            message << ", FDNReverb (" << getQualityName (quality) << ") " << String (fdnTime, 2)
+                    << " (" << String (reverbTime / fdnTime, 2) << "x)";
+
+            expect (fdnTime > 0.0);
+        }
+
+        logMessage (message);
+    }
+
+private:
+    static String getQualityName (FDNReverb::Quality quality)
+    {
+        switch (quality)
+        {
+            case FDNReverb::Quality::low:     return "low";
+            case FDNReverb::Quality::medium:  return "medium";
+            case FDNReverb::Quality::high:    return "high";
+        }
+
+        return {};
+    }
+};
+
+static FDNReverbBenchmarks fdnReverbBenchmarks;
+
+} // namespace juce
@@ -0,0 +1,439 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace PolyphaseResamplerHelpers
+{
+    // The filters are padded to a multiple of this many taps, so that the inner
+    // loops never need to deal with a remainder. When down-sampling, the filter for
+    // a ratio between two of the prepared ones has its cutoff lowered by at most an
+    // eighth of an octave.
+    enum { tapMultiple = 8, alignment = 16, filterStepsPerOctave = 8 };
+
+    static double besselI0 (double x) noexcept
+    {
+        const auto halfX = x * 0.5;
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 100 && term > sum * 1.0e-15; ++k)
+        {
+            const auto t = halfX / k;
+            term *= t * t;
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    static double getKaiserBeta (double attenuationDb) noexcept
+    {
+        if (attenuationDb > 50.0)
+            return 0.1102 * (attenuationDb - 8.7);
+
+        if (attenuationDb > 21.0)
+            return 0.5842 * std::pow (attenuationDb - 21.0, 0.4) + 0.07886 * (attenuationDb - 21.0);
+
+        return 0.0;
+    }
+
+    static double sinc (double x) noexcept
+    {
+        if (std::abs (x) < 1.0e-9)
+            return 1.0;
+
+        const auto px = MathConstants<double>::pi * x;
+        return std::sin (px) / px;
+    }
+
+    /*  Returns the sum of the products of a block of samples with a filter. The filter
+        must be aligned, and num must be a multiple of tapMultiple.
+    */
+    static float dotProduct (const float* samples, const float* filter, int num) noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        auto sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+
+        for (int i = 0; i < num; i += 8)
+        {
+            sum0 = _mm_add_ps (sum0, _mm_mul_ps (_mm_loadu_ps (samples + i),     _mm_load_ps (filter + i)));
+            sum1 = _mm_add_ps (sum1, _mm_mul_ps (_mm_loadu_ps (samples + i + 4), _mm_load_ps (filter + i + 4)));
+        }
+
+        auto sum = _mm_add_ps (sum0, sum1);
+        sum = _mm_add_ps (sum, _mm_movehl_ps (sum, sum));
+        sum = _mm_add_ss (sum, _mm_shuffle_ps (sum, sum, 1));
+        return _mm_cvtss_f32 (sum);
+       #elif JUCE_USE_ARM_NEON
+        auto sum0 = vdupq_n_f32 (0.0f), sum1 = vdupq_n_f32 (0.0f);
+
+        for (int i = 0; i < num; i += 8)
+        {
+            sum0 = vmlaq_f32 (sum0, vld1q_f32 (samples + i),     vld1q_f32 (filter + i));
+            sum1 = vmlaq_f32 (sum1, vld1q_f32 (samples + i + 4), vld1q_f32 (filter + i + 4));
+        }
+
+        const auto sum = vaddq_f32 (sum0, sum1);
+        const auto pair = vadd_f32 (vget_low_f32 (sum), vget_high_f32 (sum));
+        return vget_lane_f32 (vpadd_f32 (pair, pair), 0);
+       #else
+        float sum = 0.0f;
+
+        for (int i = 0; i < num; ++i)
+            sum += samples[i] * filter[i];
+
+        return sum;
+       #endif
+    }
+
+    /*  Interpolates between two adjacent phases of the filter table. */
+    static void interpolatePhases (float* dest, const float* phase0, const float* phase1, float proportion, int num) noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto p = _mm_set1_ps (proportion);
+
+        for (int i = 0; i < num; i += 4)
+        {
+            const auto a = _mm_load_ps (phase0 + i);
+            _mm_store_ps (dest + i, _mm_add_ps (a, _mm_mul_ps (p, _mm_sub_ps (_mm_load_ps (phase1 + i), a))));
+        }
+       #elif JUCE_USE_ARM_NEON
+        const auto p = vdupq_n_f32 (proportion);
+
+        for (int i = 0; i < num; i += 4)
+        {
+            const auto a = vld1q_f32 (phase0 + i);
+            vst1q_f32 (dest + i, vmlaq_f32 (a, p, vsubq_f32 (vld1q_f32 (phase1 + i), a)));
+        }
+       #else
+        for (int i = 0; i < num; ++i)
+            dest[i] = phase0[i] + proportion * (phase1[i] - phase0[i]);
+       #endif
+    }
+}
+
+//==============================================================================
+struct PolyphaseResampler::Design
+{
+    int numTaps, numPhases;
+    double attenuationDb;
+
+    static Design forQuality (Quality q) noexcept
+    {
+        switch (q)
+        {
+            case Quality::low:       return { 16,  64,  50.0 };
+            case Quality::medium:    return { 32,  128, 80.0 };
+            case Quality::high:      return { 64,  256, 100.0 };
+            case Quality::veryHigh:  return { 160, 512, 120.0 };
+            default:                 break;
+        }
+
+        jassertfalse;
+        return { 64, 256, 100.0 };
+    }
+
+    /*  When down-sampling, the filter's cutoff is lowered by the ratio, so it needs
+        proportionally more taps to keep the same transition band and attenuation.
+    */
+    int getNumTaps (double filterRatio) const noexcept
+    {
+        using namespace PolyphaseResamplerHelpers;
+        const auto taps = (int) std::ceil (numTaps * filterRatio);
+        return ((taps + tapMultiple - 1) / tapMultiple) * tapMultiple;
+    }
+
+    /*  The width of the transition band, as a proportion of the input sample rate,
+        for a Kaiser window with this many taps and this much attenuation.
+    */
+    double getTransitionWidth() const noexcept
+    {
+        return (attenuationDb - 7.95) / (14.36 * numTaps);
+    }
+
+    /*  Fills a table with numPhases + 1 rows of filter coefficients for a given ratio. */
+    void fillTable (float* table, int tableNumTaps, double filterRatio) const noexcept
+    {
+        using namespace PolyphaseResamplerHelpers;
+
+        // The -6dB point is placed so that the stopband begins at the lower of the two Nyquist frequencies
+        const auto cutoff = (0.5 - getTransitionWidth() * 0.5) / filterRatio;
+        // The window's small pedestal is removed, so that it reaches zero at the ends.
+        // Otherwise, the last phase wouldn't quite match the first phase of the next sample.
+        const auto beta = getKaiserBeta (attenuationDb);
+        const auto windowScale = 1.0 / (besselI0 (beta) - 1.0);
+        const auto halfLength = tableNumTaps * 0.5;
+
+        for (int phase = 0; phase <= numPhases; ++phase)
+        {
+            auto* row = table + phase * tableNumTaps;
+            const auto offset = (double) phase / numPhases;
+            double sum = 0.0;
+
+            for (int tap = 0; tap < tableNumTaps; ++tap)
+            {
+                const auto t = (tap - (tableNumTaps / 2 - 1)) - offset;
+                const auto x = t / halfLength;
+                const auto window = std::abs (x) < 1.0 ? (besselI0 (beta * std::sqrt (1.0 - x * x)) - 1.0) * windowScale : 0.0;
+                const auto value = 2.0 * cutoff * sinc (2.0 * cutoff * t) * window;
+
+                row[tap] = (float) value;
+                sum += value;
+            }
+
+            // Normalise each phase so that DC passes through with unity gain
+            FloatVectorOperations::multiply (row, (float) (1.0 / sum), tableNumTaps);
+        }
+    }
+};
+
+//==============================================================================
+PolyphaseResampler::PolyphaseResampler (int channels, Quality q)
+    : numChannels (channels), quality (q)
+{
+    jassert (numChannels > 0);
+
+    prepare (1.0, 0);
+}
+
+PolyphaseResampler::~PolyphaseResampler() = default;
+
+void PolyphaseResampler::prepare (double maximumRatio, int maximumInputBlockSize)
+{
+    jassert (maximumRatio > 0.0);
+
+    designFilters (jmax (1.0, maximumRatio));
+
+    // Enough for the history and look-ahead of the longest filter, plus a block
+    inputBuffer.setSize (numChannels, maximumInputBlockSize + maxNumTaps * 2);
+    reset();
+}
+
+void PolyphaseResampler::reset() noexcept
+{
+    // The first input sample is preceded by enough silence to fill the longest filter.
+    // prepare() always leaves room for this, so nothing needs to be allocated here.
+    const auto historyLength = maxNumTaps / 2 - 1;
+    jassert (historyLength <= inputBuffer.getNumSamples());
+
+    inputBuffer.clear (0, historyLength);
+    numBuffered = historyLength;
+    position = (double) historyLength;
+
+    const auto& filter = filterTables.front();
+    table = filter.coefficients;
+    numTaps = filter.numTaps;
+}
+
+//==============================================================================
+void PolyphaseResampler::designFilters (double maximumRatio)
+{
+    using namespace PolyphaseResamplerHelpers;
+
+    const auto design = Design::forQuality (quality);
+    numPhases = design.numPhases;
+
+    // The largest ratio gets its own filter, and the others are spaced below it down to 1.0
+    const auto stepsPerOctave = (double) filterStepsPerOctave;
+    const auto numSmallerRatios = (int) std::ceil (std::log2 (maximumRatio) * stepsPerOctave - 1.0e-9);
+
+    filterTables.clear();
+    size_t totalSize = alignment;
+
+    for (int i = numSmallerRatios; i >= 0; --i)
+    {
+        const auto filterRatio = jmax (1.0, maximumRatio * std::exp2 (-i / stepsPerOctave));
+        const auto taps = design.getNumTaps (filterRatio);
+        filterTables.push_back ({ filterRatio, taps, nullptr });
+        totalSize += (size_t) ((numPhases + 1) * taps);
+    }
+
+    maxNumTaps = filterTables.back().numTaps;
+    tableMemory.malloc (totalSize);
+    kernelMemory.malloc ((size_t) (maxNumTaps + alignment));
+    kernel = snapPointerToAlignment (kernelMemory.get(), (size_t) alignment);
+
+    // Every table is a multiple of tapMultiple long, so they all stay aligned
+    auto* nextTable = snapPointerToAlignment (tableMemory.get(), (size_t) alignment);
+
+    for (auto& filter : filterTables)
+    {
+        filter.coefficients = nextTable;
+        design.fillTable (nextTable, filter.numTaps, filter.filterRatio);
+        nextTable += (numPhases + 1) * filter.numTaps;
+    }
+}
+
+const PolyphaseResampler::FilterTable& PolyphaseResampler::getFilterTableFor (double startRatio, double endRatio) const noexcept
+{
+    jassert (startRatio > 0.0 && endRatio > 0.0);
+
+    const auto required = jmax (startRatio, endRatio);
+
+    // Allow for rounding errors, so that the exact ratio passed to prepare() finds its own filter
+    for (auto& filter : filterTables)
+        if (filter.filterRatio >= required * (1.0 - 1.0e-9))
+            return filter;
+
+    return filterTables.back();
+}
+
+//==============================================================================
+void PolyphaseResampler::ensureInputCapacity (int numSamplesToAdd)
+{
+    if (numBuffered + numSamplesToAdd > inputBuffer.getNumSamples())
+    {
+        discardUsedInput();
+
+        if (numBuffered + numSamplesToAdd > inputBuffer.getNumSamples())
+            inputBuffer.setSize (numChannels, numBuffered + numSamplesToAdd + maxNumTaps, true, false, true);
+    }
+}
+
+void PolyphaseResampler::discardUsedInput() noexcept
+{
+    // Keep enough history for the longest filter that has been used
+    const auto numToDiscard = jlimit (0, numBuffered, (int) position - (maxNumTaps / 2 - 1));
+
+    if (numToDiscard > 0)
+    {
+        const auto numToKeep = numBuffered - numToDiscard;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = inputBuffer.getWritePointer (channel);
+            memmove (data, data + numToDiscard, (size_t) numToKeep * sizeof (float));
+        }
+
+        numBuffered = numToKeep;
+        position -= numToDiscard;
+    }
+}
+
+void PolyphaseResampler::pushSamples (const float* const* inputChannels, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    ensureInputCapacity (numSamples);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        inputBuffer.copyFrom (channel, numBuffered, inputChannels[channel], numSamples);
+
+    numBuffered += numSamples;
+}
+
+//==============================================================================
+int PolyphaseResampler::getNumInputSamplesNeeded (int numOutputSamples, double startRatio, double endRatio) const noexcept
+{
+    if (numOutputSamples <= 0)
+        return 0;
+
+    const auto halfTaps = getFilterTableFor (startRatio, endRatio).numTaps / 2;
+    const auto ratioStep = (endRatio - startRatio) / numOutputSamples;
+    auto lastPosition = position;
+
+    // This must follow exactly the same steps as pullSamples()
+    for (int i = 0; i < numOutputSamples - 1; ++i)
+        lastPosition += startRatio + ratioStep * i;
+
+    return jmax (0, (int) lastPosition + halfTaps + 1 - numBuffered);
+}
+
+int PolyphaseResampler::pullSamples (float* const* outputChannels, int numSamples, double startRatio, double endRatio)
+{
+    using namespace PolyphaseResamplerHelpers;
+
+    // Switching filters only changes which precomputed table is read from. There's always
+    // enough history for the longest one, because that's what discardUsedInput() keeps.
+    const auto& filter = getFilterTableFor (startRatio, endRatio);
+    table = filter.coefficients;
+    numTaps = filter.numTaps;
+
+    const auto halfTaps = numTaps / 2;
+    jassert ((int) position >= halfTaps - 1);
+
+    const auto ratioStep = (endRatio - startRatio) / jmax (1, numSamples);
+    int numDone = 0;
+
+    for (; numDone < numSamples; ++numDone)
+    {
+        const auto index = (int) position;
+
+        if (index + halfTaps >= numBuffered)
+            break;
+
+        const auto phase = (position - index) * numPhases;
+        const auto phaseIndex = jmin ((int) phase, numPhases - 1);
+        const auto* phase0 = table + phaseIndex * numTaps;
+
+        interpolatePhases (kernel, phase0, phase0 + numTaps, (float) (phase - phaseIndex), numTaps);
+
+        const auto firstSample = index - (halfTaps - 1);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            outputChannels[channel][numDone] = dotProduct (inputBuffer.getReadPointer (channel, firstSample), kernel, numTaps);
+
+        position += startRatio + ratioStep * numDone;
+    }
+
+    discardUsedInput();
+    return numDone;
+}
+
+//==============================================================================
+AudioBuffer<float> PolyphaseResampler::resample (const AudioBuffer<float>& source,
+                                                 double samplesInPerOutputSample,
+                                                 Quality qualityToUse)
+{
+    jassert (samplesInPerOutputSample > 0.0);
+
+    const auto numChannels = source.getNumChannels();
+    const auto numInputSamples = source.getNumSamples();
+
+    // The small tolerance stops rounding errors in the ratio adding an extra sample
+    const auto numOutputSamples = (int) std::ceil (numInputSamples / samplesInPerOutputSample - 1.0e-7);
+
+    AudioBuffer<float> result (numChannels, jmax (0, numOutputSamples));
+
+    if (numChannels == 0 || numOutputSamples <= 0)
+        return result;
+
+    PolyphaseResampler resampler (numChannels, qualityToUse);
+    resampler.prepare (samplesInPerOutputSample, numInputSamples);
+    resampler.pushSamples (source.getArrayOfReadPointers(), numInputSamples);
+
+    // Pad the end with silence, so that the filter can reach the last samples
+    AudioBuffer<float> silence (numChannels, resampler.getNumInputSamplesNeeded (numOutputSamples,
+                                                                                 samplesInPerOutputSample,
+                                                                                 samplesInPerOutputSample));
+    silence.clear();
+    resampler.pushSamples (silence.getArrayOfReadPointers(), silence.getNumSamples());
+
+    const auto numDone = resampler.pullSamples (result.getArrayOfWritePointers(), numOutputSamples, samplesInPerOutputSample);
+    jassertquiet (numDone == numOutputSamples);
+
+    return result;
+}
+
+} // namespace juce
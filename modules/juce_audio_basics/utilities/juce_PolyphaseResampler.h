@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A multichannel sample-rate converter that uses a precomputed table of
+    windowed-sinc filters.
+
+    The table holds a Kaiser-windowed sinc filter for a number of fractional
+    positions (phases). Each output sample is calculated by interpolating between
+    the two nearest phases and then convolving the result with the input, so any
+    ratio can be used, and the ratio can change smoothly during a block. When
+    down-sampling, the filter's cutoff is lowered and its length increased, so
+    that the output is free of aliasing.
+
+    The filter kernel is only worked out once for each output sample and is then
+    shared by all the channels, and the convolutions use SIMD instructions where
+    they're available.
+
+    Input is pushed into the resampler as it becomes available, and output is
+    pulled from it. The output isn't delayed: the first output sample lines up
+    with the first input sample, and the resampler simply waits for enough input
+    to be pushed to fill its filter before it can produce each output sample.
+
+    For converting a whole buffer in one go, use the static resample() method.
+
+    @see PolyphaseResamplingAudioSource, WindowedSincInterpolator
+
+    @tags{Audio}
+*/
+class JUCE_API  PolyphaseResampler
+{
+public:
+    //==============================================================================
+    /** The quality settings, which trade the length of the filters against the
+        accuracy of the result.
+    */
+    enum class Quality
+    {
+        low,        /**< 16 taps, about 50dB of stopband attenuation. */
+        medium,     /**< 32 taps, about 80dB of stopband attenuation. */
+        high,       /**< 64 taps, about 100dB of stopband attenuation. */
+        veryHigh    /**< 160 taps, about 120dB of stopband attenuation. */
+    };
+
+    //==============================================================================
+    /** Creates a resampler for a number of channels. */
+    explicit PolyphaseResampler (int numChannels, Quality quality = Quality::high);
+
+    /** Destructor. */
+    ~PolyphaseResampler();
+
+    //==============================================================================
+    /** Returns the number of channels that this resampler was created with. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the quality setting that this resampler was created with. */
+    Quality getQuality() const noexcept                 { return quality; }
+
+    /** Returns the number of taps in the filter that is currently being used. */
+    int getNumTaps() const noexcept                     { return numTaps; }
+
+    //==============================================================================
+    /** Designs the filters for ratios up to a given maximum, and allocates space for
+        input blocks up to a given size, so that nothing is allocated or recalculated
+        while processing, and then resets the resampler.
+
+        Filters are made for the maximum ratio and for a set of smaller ratios an eighth
+        of an octave apart, and each block uses the filter for the nearest ratio at or
+        above the one that it needs. Processing with a larger ratio than this will use
+        the filter for the maximum ratio, so may alias. Pushing more samples than this
+        will still work, but may need to allocate memory.
+
+        Until this is called, the resampler is prepared for a maximum ratio of 1.0.
+    */
+    void prepare (double maximumSamplesInPerOutputSample, int maximumInputBlockSize);
+
+    /** Clears any buffered input, ready to start a new stream. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Adds some input to the resampler.
+
+        @param inputChannels    an array of getNumChannels() channel pointers
+        @param numSamples       the number of samples to read from each channel
+    */
+    void pushSamples (const float* const* inputChannels, int numSamples);
+
+    /** Returns the number of samples that must be pushed before a given number of
+        output samples can be pulled with the same ratios.
+    */
+    int getNumInputSamplesNeeded (int numOutputSamples,
+                                  double startSamplesInPerOutputSample,
+                                  double endSamplesInPerOutputSample) const noexcept;
+
+    /** Produces some output from the input that has been pushed.
+
+        The ratio of input to output samples moves smoothly from the start ratio
+        to the end ratio across the output block. A ratio greater than 1.0 reduces
+        the sample rate, and less than 1.0 increases it.
+
+        @param outputChannels   an array of getNumChannels() channel pointers
+        @param numSamples       the number of output samples to produce
+        @returns                the number of samples written, which will be less
+                                than numSamples if not enough input has been pushed
+    */
+    int pullSamples (float* const* outputChannels, int numSamples,
+                     double startSamplesInPerOutputSample,
+                     double endSamplesInPerOutputSample);
+
+    /** Produces some output using a fixed ratio.
+        @see pullSamples
+    */
+    int pullSamples (float* const* outputChannels, int numSamples, double samplesInPerOutputSample)
+    {
+        return pullSamples (outputChannels, numSamples, samplesInPerOutputSample, samplesInPerOutputSample);
+    }
+
+    //==============================================================================
+    /** Converts a whole buffer to a new sample rate.
+
+        The result will contain ceil (source.getNumSamples() / samplesInPerOutputSample)
+        samples, with the same number of channels as the source.
+    */
+    static AudioBuffer<float> resample (const AudioBuffer<float>& source,
+                                        double samplesInPerOutputSample,
+                                        Quality quality = Quality::high);
+
+private:
+    //==============================================================================
+    struct Design;
+
+    struct FilterTable
+    {
+        double filterRatio;
+        int numTaps;
+        float* coefficients;
+    };
+
+    void designFilters (double maximumRatio);
+    const FilterTable& getFilterTableFor (double startRatio, double endRatio) const noexcept;
+    void ensureInputCapacity (int numSamplesToAdd);
+    void discardUsedInput() noexcept;
+
+    //==============================================================================
+    const int numChannels;
+    const Quality quality;
+
+    std::vector<FilterTable> filterTables;
+    HeapBlock<float> tableMemory, kernelMemory;
+    const float* table = nullptr;
+    float* kernel = nullptr;
+    int numTaps = 0, numPhases = 0, maxNumTaps = 0;
+
+    AudioBuffer<float> inputBuffer;
+    int numBuffered = 0;
+    double position = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolyphaseResampler)
+};
+
+} // namespace juce
@@ -0,0 +1,340 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class PolyphaseResamplerTests  : public UnitTest
+{
+public:
+    PolyphaseResamplerTests()
+        : UnitTest ("PolyphaseResampler", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        using Quality = PolyphaseResampler::Quality;
+
+        beginTest ("Resampled sines have a high signal-to-noise ratio");
+        {
+            struct Case { Quality quality; double frequency, minimumSnrDb; };
+
+            for (auto c : { Case { Quality::low,      1000.0, 60.0 },
+                            Case { Quality::medium,   1000.0, 80.0 },
+                            Case { Quality::high,     1000.0, 110.0 },
+                            Case { Quality::high,    15000.0, 95.0 },
+                            Case { Quality::veryHigh, 1000.0, 130.0 },
+                            Case { Quality::veryHigh, 19000.0, 105.0 } })
+            {
+                for (auto rates : { std::make_pair (44100.0, 48000.0),
+                                    std::make_pair (48000.0, 44100.0),
+                                    std::make_pair (44100.0, 96000.0),
+                                    std::make_pair (96000.0, 48000.0) })
+                {
+                    const auto snr = measureSineSnr (c.quality, c.frequency, rates.first, rates.second);
+
+                    expectGreaterThan (snr, c.minimumSnrDb,
+                                       String (c.frequency) + "Hz, " + String (rates.first) + " -> " + String (rates.second));
+                }
+            }
+        }
+
+        beginTest ("Frequencies above the output's Nyquist are removed when down-sampling");
+        {
+            struct Case { Quality quality; double maximumAliasDb; };
+
+            for (auto c : { Case { Quality::low,      -50.0 },
+                            Case { Quality::medium,   -80.0 },
+                            Case { Quality::high,     -110.0 },
+                            Case { Quality::veryHigh, -130.0 } })
+            {
+                // 30kHz and 40kHz are above the output's 24kHz Nyquist frequency
+                for (auto frequency : { 30000.0, 40000.0 })
+                {
+                    const auto source = makeSine (frequency, 96000.0, 1 << 15);
+                    const auto result = PolyphaseResampler::resample (source, 2.0, c.quality);
+                    const auto margin = 512;
+                    const auto aliasDb = Decibels::gainToDecibels ((double) result.getRMSLevel (0, margin, result.getNumSamples() - margin * 2)
+                                                                     / std::sqrt (0.5), -200.0);
+
+                    expectLessThan (aliasDb, c.maximumAliasDb, String (frequency) + "Hz");
+                }
+            }
+        }
+
+        beginTest ("Streaming in blocks of random sizes matches resample()");
+        {
+            auto random = getRandom();
+            const auto source = makeNoise (random, 2, 20000);
+
+            for (auto ratio : { 0.5, 0.91875, 1.0, 1.0884353741, 3.1 })
+            {
+                const auto expected = PolyphaseResampler::resample (source, ratio, Quality::medium);
+
+                PolyphaseResampler resampler (2, Quality::medium);
+                resampler.prepare (ratio, 700);
+                AudioBuffer<float> output (2, expected.getNumSamples());
+                int numRead = 0, numWritten = 0;
+
+                for (;;)
+                {
+                    const auto numToPush = jmin (random.nextInt (700), source.getNumSamples() - numRead);
+                    const float* inputs[] = { source.getReadPointer (0) + numRead, source.getReadPointer (1) + numRead };
+                    resampler.pushSamples (inputs, numToPush);
+                    numRead += numToPush;
+
+                    const auto numToPull = jmin (random.nextInt (500), output.getNumSamples() - numWritten);
+                    float* outputs[] = { output.getWritePointer (0) + numWritten, output.getWritePointer (1) + numWritten };
+                    const auto numPulled = resampler.pullSamples (outputs, numToPull, ratio);
+                    numWritten += numPulled;
+
+                    if (numWritten == output.getNumSamples() || (numRead == source.getNumSamples() && numPulled < numToPull))
+                        break;
+                }
+
+                // Only the end, where resample() pads the input with silence, is missing
+                expectGreaterOrEqual (numWritten, output.getNumSamples() - resampler.getNumTaps());
+                expectLessOrEqual (maxDifference (output, expected, numWritten), 1.0e-5f, "ratio " + String (ratio));
+            }
+        }
+
+        beginTest ("The input needed for a block is always enough, even when the ratio is changing");
+        {
+            auto random = getRandom();
+            PolyphaseResampler resampler (1, Quality::high);
+            resampler.prepare (4.0, 4096);
+
+            AudioBuffer<float> input (1, 10000), output (1, 1024);
+            double ratio = 1.0;
+            float peak = 0.0f;
+
+            for (int block = 0; block < 200; ++block)
+            {
+                const auto newRatio = jlimit (0.25, 4.0, ratio * (0.8 + random.nextDouble() * 0.4));
+                const auto numOutput = 1 + random.nextInt (1024);
+                const auto numInput = resampler.getNumInputSamplesNeeded (numOutput, ratio, newRatio);
+
+                for (int i = 0; i < numInput; ++i)
+                    input.setSample (0, i, std::sin ((float) i * 0.01f));
+
+                resampler.pushSamples (input.getArrayOfReadPointers(), numInput);
+                const auto numDone = resampler.pullSamples (output.getArrayOfWritePointers(), numOutput, ratio, newRatio);
+
+                expectEquals (numDone, numOutput);
+                peak = jmax (peak, output.getMagnitude (0, 0, numDone));
+                ratio = newRatio;
+            }
+
+            expectLessThan (peak, 1.2f);
+        }
+
+        beginTest ("Changing the ratio picks one of the filters made by prepare()");
+        {
+            PolyphaseResampler resampler (1, Quality::high);
+            resampler.prepare (4.0, 512);
+
+            AudioBuffer<float> input (1, 4096), output (1, 16);
+            input.clear();
+
+            const auto getNumTapsUsedFor = [&] (double ratio)
+            {
+                resampler.pushSamples (input.getArrayOfReadPointers(), resampler.getNumInputSamplesNeeded (16, ratio, ratio));
+                resampler.pullSamples (output.getArrayOfWritePointers(), 16, ratio);
+                return resampler.getNumTaps();
+            };
+
+            // The high quality filters have 64 taps at a ratio of 1.0, and more in proportion to the ratio
+            expectEquals (getNumTapsUsedFor (0.5), 64);
+            expectEquals (getNumTapsUsedFor (1.0), 64);
+            expectEquals (getNumTapsUsedFor (4.0), 256);
+            expectEquals (getNumTapsUsedFor (6.0), 256);
+
+            for (auto ratio : { 1.01, 1.5, 2.0, 3.3 })
+            {
+                const auto numTaps = getNumTapsUsedFor (ratio);
+                expectGreaterOrEqual ((double) numTaps, 64 * ratio);
+                expectLessOrEqual ((double) numTaps, 64 * ratio * std::exp2 (1.0 / 8.0) + 8);
+            }
+        }
+
+        beginTest ("PolyphaseResamplingAudioSource matches resample()");
+        {
+            auto random = getRandom();
+            auto source = makeNoise (random, 2, 10000);
+
+            for (auto ratio : { 0.75, 1.6 })
+            {
+                const auto expected = PolyphaseResampler::resample (source, ratio, Quality::high);
+
+                PolyphaseResamplingAudioSource resamplingSource (new MemoryAudioSource (source, true), true, 2);
+                resamplingSource.setResamplingRatio (ratio);
+                resamplingSource.prepareToPlay (512, 44100.0);
+
+                AudioBuffer<float> output (2, expected.getNumSamples());
+
+                for (int start = 0; start < output.getNumSamples(); start += 512)
+                    resamplingSource.getNextAudioBlock ({ &output, start, jmin (512, output.getNumSamples() - start) });
+
+                expectLessOrEqual (maxDifference (output, expected, output.getNumSamples()), 1.0e-5f, "ratio " + String (ratio));
+            }
+        }
+    }
+
+private:
+    static AudioBuffer<float> makeSine (double frequency, double sampleRate, int numSamples, double phase = 0.0)
+    {
+        AudioBuffer<float> buffer (1, numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample (0, i, (float) std::sin (MathConstants<double>::twoPi * frequency * i / sampleRate + phase));
+
+        return buffer;
+    }
+
+    static AudioBuffer<float> makeNoise (Random& random, int numChannels, int numSamples)
+    {
+        AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (channel, i, random.nextFloat() - 0.5f);
+
+        return buffer;
+    }
+
+    static float maxDifference (const AudioBuffer<float>& a, const AudioBuffer<float>& b, int numSamples)
+    {
+        float result = 0.0f;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                result = jmax (result, std::abs (a.getSample (channel, i) - b.getSample (channel, i)));
+
+        return result;
+    }
+
+    /*  Resamples a sine, and compares the result with a sine generated at the output
+        rate, ignoring the edges where the filter reaches outside the input.
+    */
+    static double measureSineSnr (PolyphaseResampler::Quality quality, double frequency,
+                                  double sourceRate, double destRate)
+    {
+        const auto source = makeSine (frequency, sourceRate, 1 << 15);
+        const auto result = PolyphaseResampler::resample (source, sourceRate / destRate, quality);
+        const auto ideal = makeSine (frequency, destRate, result.getNumSamples());
+
+        const auto margin = 1024;
+        double signal = 0.0, noise = 0.0;
+
+        for (int i = margin; i < result.getNumSamples() - margin; ++i)
+        {
+            const auto expected = (double) ideal.getSample (0, i);
+            const auto error = (double) result.getSample (0, i) - expected;
+            signal += expected * expected;
+            noise += error * error;
+        }
+
+        return 10.0 * std::log10 (signal / jmax (noise, 1.0e-30));
+    }
+};
+
+static PolyphaseResamplerTests polyphaseResamplerTests;
+
+//==============================================================================
+class PolyphaseResamplerBenchmarks  : public UnitTest
+{
+public:
+    PolyphaseResamplerBenchmarks()
+        : UnitTest ("PolyphaseResampler throughput", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        constexpr int numChannels = 2, numSeconds = 10;
+        constexpr int blockSize = 512;
+
+        for (auto rates : { std::make_pair (44100.0, 48000.0), std::make_pair (96000.0, 44100.0) })
+        {
+            beginTest (String (rates.first) + " -> " + String (rates.second));
+
+            const auto ratio = rates.first / rates.second;
+            auto random = getRandom();
+            AudioBuffer<float> source (numChannels, (int) rates.first * numSeconds);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < source.getNumSamples(); ++i)
+                    source.setSample (channel, i, random.nextFloat() - 0.5f);
+
+            const auto report = [&] (const String& processName, double seconds)
+            {
+                logMessage (processName + ": " + String (seconds * 1000.0, 1) + "ms, "
+                              + String (roundToInt (numSeconds / seconds)) + "x realtime");
+                expect (seconds > 0.0);
+            };
+
+            const auto time = [] (auto&& function)
+            {
+                const auto start = Time::getHighResolutionTicks();
+                function();
+                return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+            };
+
+            report ("ResamplingAudioSource", time ([&]
+            {
+                ResamplingAudioSource resamplingSource (new MemoryAudioSource (source, false), true, numChannels);
+                resamplingSource.setResamplingRatio (ratio);
+                resamplingSource.prepareToPlay (blockSize, rates.second);
+                AudioBuffer<float> output (numChannels, blockSize);
+
+                for (auto remaining = (int) (source.getNumSamples() / ratio); remaining > 0; remaining -= blockSize)
+                    resamplingSource.getNextAudioBlock ({ &output, 0, jmin (blockSize, remaining) });
+            }));
+
+            report ("LagrangeInterpolator", time ([&]
+            {
+                AudioBuffer<float> output (numChannels, (int) (source.getNumSamples() / ratio));
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    LagrangeInterpolator interpolator;
+                    interpolator.process (ratio, source.getReadPointer (channel), output.getWritePointer (channel),
+                                          output.getNumSamples() - 8);
+                }
+            }));
+
+            for (auto quality : { std::make_pair (PolyphaseResampler::Quality::low,      "low"),
+                                  std::make_pair (PolyphaseResampler::Quality::medium,   "medium"),
+                                  std::make_pair (PolyphaseResampler::Quality::high,     "high"),
+                                  std::make_pair (PolyphaseResampler::Quality::veryHigh, "veryHigh") })
+            {
+                report (String ("PolyphaseResampler, ") + quality.second + " quality", time ([&]
+                {
+                    PolyphaseResampler::resample (source, ratio, quality.first);
+                }));
+            }
+        }
+    }
+};
+
+static PolyphaseResamplerBenchmarks polyphaseResamplerBenchmarks;
+
+} // namespace juce
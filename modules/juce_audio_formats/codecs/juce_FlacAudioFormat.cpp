@@ -175,7 +175,8 @@ auto emptyRange (Item item) { return Range<Item>::emptyRange (item); }
 class FlacReader  : public AudioFormatReader
 {
 public:
-    FlacReader (InputStream* in)  : AudioFormatReader (in, flacFormatName)
+    FlacReader (InputStream* in, const FlacAudioFormat::SeekIndex* index = nullptr)
+        : AudioFormatReader (in, flacFormatName)
     {
         lengthInSamples = 0;
         decoder = FlacNamespace::FLAC__stream_decoder_new();
@@ -202,6 +203,13 @@ public:
                 FLAC__stream_decoder_process_until_end_of_metadata (decoder);
                 lengthInSamples = tempLength;
             }
+
+            // An index from a different version of the file would send us to the wrong frames
+            if (index != nullptr
+                 && index->frames != nullptr
+                 && index->lengthInSamples == lengthInSamples
+                 && index->streamLength == input->getTotalLength())
+                seekFrames = index->frames;
         }
     }
 
@@ -220,6 +228,38 @@ public:
         reservoir.setSize ((int) numChannels, 2 * (int) info.max_blocksize, false, false, true);
     }
 
+    //==============================================================================
+    FlacAudioFormat::SeekIndex createSeekIndex()
+    {
+        FlacAudioFormat::SeekIndex index;
+
+        if (! ok)
+            return index;
+
+        auto frames = std::make_shared<std::vector<FlacAudioFormat::SeekIndex::Frame>>();
+        const ScopedValueSetter<bool> svs (buildingIndex, true);
+
+        for (;;)
+        {
+            FlacNamespace::FLAC__uint64 frameStart = 0;
+
+            if (! FLAC__stream_decoder_get_decode_position (decoder, &frameStart))
+                return index;
+
+            lastFrameStart = -1;
+
+            if (! FLAC__stream_decoder_process_single (decoder) || lastFrameStart < 0)
+                break;
+
+            frames->push_back ({ lastFrameStart, (int64) frameStart });
+        }
+
+        index.frames = std::move (frames);
+        index.lengthInSamples = lengthInSamples;
+        index.streamLength = input->getTotalLength();
+        return index;
+    }
+
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples) override
     {
@@ -255,6 +295,9 @@ public:
             if (requestedStart < bufferedRange.getStart()
                 || jmax (bufferedRange.getEnd(), bufferedRange.getStart() + (int64) 511) < requestedStart)
             {
+                if (seekToFrameContaining (requestedStart))
+                    return;
+
                 // had some problems with flac crashing if the read pos is aligned more
                 // accurately than this. Probably fixed in newer versions of the library, though.
                 bufferedRange = emptyRange (requestedStart & ~511);
@@ -280,13 +323,36 @@ public:
         return true;
     }
 
+    // Decodes the whole frame holding the given sample, starting from its position in the index
+    bool seekToFrameContaining (int64 sample)
+    {
+        if (seekFrames == nullptr)
+            return false;
+
+        const auto& frames = *seekFrames;
+        auto frame = std::upper_bound (frames.begin(), frames.end(), sample,
+                                       [] (int64 s, const FlacAudioFormat::SeekIndex::Frame& f) { return s < f.startSample; });
+
+        if (frame == frames.begin())
+            return false;
+
+        --frame;
+
+        if (! input->setPosition (frame->byteOffset) || ! FLAC__stream_decoder_flush (decoder))
+            return false;
+
+        bufferedRange = emptyRange (frame->startSample);
+        FLAC__stream_decoder_process_single (decoder);
+        return true;
+    }
+
     void useSamples (const FlacNamespace::FLAC__int32* const buffer[], int numSamples)
     {
         if (scanningForLength)
         {
             lengthInSamples += numSamples;
         }
-        else
+        else if (! buildingIndex)
         {
             if (numSamples > reservoir.getNumSamples())
                 reservoir.setSize ((int) numChannels, numSamples, false, false, true);
@@ -323,7 +389,7 @@ public:
 
     static FlacNamespace::FLAC__StreamDecoderSeekStatus seekCallback_ (const FlacNamespace::FLAC__StreamDecoder*, FlacNamespace::FLAC__uint64 absolute_byte_offset, void* client_data)
     {
-        static_cast<const FlacReader*> (client_data)->input->setPosition ((int) absolute_byte_offset);
+        static_cast<const FlacReader*> (client_data)->input->setPosition ((int64) absolute_byte_offset);
         return FlacNamespace::FLAC__STREAM_DECODER_SEEK_STATUS_OK;
     }
 
@@ -349,7 +415,9 @@ public:
                                                                          const FlacNamespace::FLAC__int32* const buffer[],
                                                                          void* client_data)
     {
-        static_cast<FlacReader*> (client_data)->useSamples (buffer, (int) frame->header.blocksize);
+        auto* reader = static_cast<FlacReader*> (client_data);
+        reader->lastFrameStart = (int64) frame->header.number.sample_number;
+        reader->useSamples (buffer, (int) frame->header.blocksize);
         return FlacNamespace::FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
     }
 
@@ -368,7 +436,9 @@ private:
     FlacNamespace::FLAC__StreamDecoder* decoder;
     AudioBuffer<float> reservoir;
     Range<int64> bufferedRange;
-    bool ok = false, scanningForLength = false;
+    std::shared_ptr<const std::vector<FlacAudioFormat::SeekIndex::Frame>> seekFrames;
+    int64 lastFrameStart = -1;
+    bool ok = false, scanningForLength = false, buildingIndex = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacReader)
 };
@@ -560,7 +630,13 @@ bool FlacAudioFormat::isCompressed()    { return true; }
 
 AudioFormatReader* FlacAudioFormat::createReaderFor (InputStream* in, const bool deleteStreamIfOpeningFails)
 {
-    std::unique_ptr<FlacReader> r (new FlacReader (in));
+    return createReaderFor (in, {}, deleteStreamIfOpeningFails);
+}
+
+AudioFormatReader* FlacAudioFormat::createReaderFor (InputStream* in, const SeekIndex& seekIndex,
+                                                     const bool deleteStreamIfOpeningFails)
+{
+    std::unique_ptr<FlacReader> r (new FlacReader (in, &seekIndex));
 
     if (r->sampleRate > 0)
         return r.release();
@@ -571,6 +647,94 @@ AudioFormatReader* FlacAudioFormat::createReaderFor (InputStream* in, const bool
     return nullptr;
 }
 
+AudioFormatReader* FlacAudioFormat::createReaderForMappedFile (const File& file)
+{
+    return createReaderForMappedFile (file, {});
+}
+
+AudioFormatReader* FlacAudioFormat::createReaderForMappedFile (const File& file, const SeekIndex& seekIndex)
+{
+    if (auto stream = MappedFileInputStream::open (file))
+        return createReaderFor (stream.release(), seekIndex, true);
+
+    return nullptr;
+}
+
+FlacAudioFormat::SeekIndex FlacAudioFormat::createSeekIndex (InputStream& flacStream)
+{
+    FlacReader reader (&flacStream);
+    auto index = reader.createSeekIndex();
+    reader.input = nullptr;
+    return index;
+}
+
+//==============================================================================
+// The frames are stored as the differences between the positions of neighbouring
+// frames, which keeps the index small.
+static constexpr int flacSeekIndexMagic = 0x78697366; // "fsix"
+
+void FlacAudioFormat::SeekIndex::writeToStream (OutputStream& out) const
+{
+    out.writeInt (flacSeekIndexMagic);
+    out.writeInt64 (lengthInSamples);
+    out.writeInt64 (streamLength);
+    out.writeInt (getNumFrames());
+
+    Frame previous { 0, 0 };
+
+    if (frames != nullptr)
+    {
+        for (auto& frame : *frames)
+        {
+            out.writeCompressedInt ((int) (frame.startSample - previous.startSample));
+            out.writeCompressedInt ((int) (frame.byteOffset - previous.byteOffset));
+            previous = frame;
+        }
+    }
+}
+
+bool FlacAudioFormat::SeekIndex::readFromStream (InputStream& in)
+{
+    *this = {};
+
+    if (in.readInt() != flacSeekIndexMagic)
+        return false;
+
+    const auto length = in.readInt64();
+    const auto totalBytes = in.readInt64();
+    const auto numFrames = in.readInt();
+
+    if (numFrames < 0 || length < 0 || totalBytes < 0)
+        return false;
+
+    auto newFrames = std::make_shared<std::vector<Frame>>();
+    newFrames->reserve ((size_t) jmin (numFrames, 1 << 20));
+
+    Frame frame { 0, 0 };
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        if (in.isExhausted())
+            return false;
+
+        frame.startSample += in.readCompressedInt();
+        frame.byteOffset  += in.readCompressedInt();
+
+        const auto isInOrder = newFrames->empty() || (frame.startSample > newFrames->back().startSample
+                                                        && frame.byteOffset > newFrames->back().byteOffset);
+
+        if (! isInOrder || frame.startSample >= length || frame.byteOffset >= totalBytes)
+            return false;
+
+        newFrames->push_back (frame);
+    }
+
+    frames = std::move (newFrames);
+    lengthInSamples = length;
+    streamLength = totalBytes;
+    return true;
+}
+
 AudioFormatWriter* FlacAudioFormat::createWriterFor (OutputStream* out,
                                                      double sampleRate,
                                                      unsigned int numberOfChannels,
@@ -594,6 +758,214 @@ StringArray FlacAudioFormat::getQualityOptions()
     return { "0 (Fastest)", "1", "2", "3", "4", "5 (Default)","6", "7", "8 (Highest quality)" };
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FlacSeekIndexTests  : public UnitTest
+{
+public:
+    FlacSeekIndexTests()  : UnitTest ("FlacAudioFormat::SeekIndex", UnitTestCategories::audio)  {}
+
+    void runTest() override
+    {
+        FlacAudioFormat format;
+        auto random = getRandom();
+
+        const auto flacData = createFlacData (format, random, 2, 200000);
+        const auto expected = decode (format, flacData);
+
+        beginTest ("An index has an entry for every frame");
+        {
+            MemoryInputStream stream (flacData, false);
+            const auto index = format.createSeekIndex (stream);
+
+            expectEquals (index.getNumFrames(), (200000 + 4095) / 4096);
+        }
+
+        beginTest ("Random reads through an index match a sequential decode");
+        {
+            MemoryInputStream stream (flacData, false);
+            const auto index = format.createSeekIndex (stream);
+
+            std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new MemoryInputStream (flacData, false), index, true));
+            expect (reader != nullptr);
+            expect (readsMatch (*reader, expected, random));
+        }
+
+        beginTest ("An index survives being saved and loaded");
+        {
+            MemoryInputStream stream (flacData, false);
+            const auto index = format.createSeekIndex (stream);
+
+            MemoryOutputStream saved;
+            index.writeToStream (saved);
+
+            FlacAudioFormat::SeekIndex loaded;
+            MemoryInputStream savedStream (saved.getData(), saved.getDataSize(), false);
+            expect (loaded.readFromStream (savedStream));
+            expectEquals (loaded.getNumFrames(), index.getNumFrames());
+
+            std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new MemoryInputStream (flacData, false), loaded, true));
+            expect (readsMatch (*reader, expected, random));
+
+            MemoryOutputStream truncated;
+            truncated.write (saved.getData(), saved.getDataSize() / 2);
+            MemoryInputStream truncatedStream (truncated.getData(), truncated.getDataSize(), false);
+            expect (! loaded.readFromStream (truncatedStream));
+            expect (loaded.isEmpty());
+        }
+
+        beginTest ("An index from a different stream is ignored");
+        {
+            const auto otherData = createFlacData (format, random, 2, 150000);
+            MemoryInputStream otherStream (otherData, false);
+            const auto otherIndex = format.createSeekIndex (otherStream);
+
+            std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new MemoryInputStream (flacData, false), otherIndex, true));
+            expect (readsMatch (*reader, expected, random));
+        }
+
+        beginTest ("Memory-mapped files can be read through a shared block cache");
+        {
+            TemporaryFile temp (".flac");
+            expect (temp.getFile().replaceWithData (flacData.getData(), flacData.getSize()));
+
+            MemoryInputStream stream (flacData, false);
+            const auto index = format.createSeekIndex (stream);
+
+            CachingAudioFormatReader::BlockCache cache (1 << 22);
+            const auto hash = temp.getFile().hashCode64();
+
+            for (int i = 0; i < 2; ++i)
+            {
+                std::unique_ptr<AudioFormatReader> mapped (format.createReaderForMappedFile (temp.getFile(), index));
+                expect (mapped != nullptr);
+
+                CachingAudioFormatReader cached (mapped.release(), cache, hash, 4096);
+                expect (readsMatch (cached, expected, random));
+            }
+        }
+    }
+
+private:
+    static MemoryBlock createFlacData (FlacAudioFormat& format, Random& random, int numChannels, int numSamples)
+    {
+        AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (channel, i, 0.5f * std::sin ((float) i * 0.01f * (float) (channel + 1))
+                                                + 0.1f * (random.nextFloat() - 0.5f));
+
+        MemoryBlock data;
+
+        {
+            std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (data, false),
+                                                                               44100.0, (unsigned int) numChannels, 16, {}, 5));
+            writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+        }
+
+        return data;
+    }
+
+    static AudioBuffer<float> decode (FlacAudioFormat& format, const MemoryBlock& data)
+    {
+        std::unique_ptr<AudioFormatReader> reader (format.createReaderFor (new MemoryInputStream (data, false), true));
+        AudioBuffer<float> result ((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read (&result, 0, result.getNumSamples(), 0, true, true);
+        return result;
+    }
+
+    static bool readsMatch (AudioFormatReader& reader, const AudioBuffer<float>& expected, Random& random)
+    {
+        if (reader.lengthInSamples != expected.getNumSamples())
+            return false;
+
+        for (int i = 0; i < 100; ++i)
+        {
+            const auto start = random.nextInt (expected.getNumSamples());
+            const auto length = jmin (1 + random.nextInt (10000), expected.getNumSamples() - start);
+
+            AudioBuffer<float> result (expected.getNumChannels(), length);
+            reader.read (&result, 0, length, start, true, true);
+
+            for (int channel = 0; channel < expected.getNumChannels(); ++channel)
+                for (int j = 0; j < length; ++j)
+                    if (result.getSample (channel, j) != expected.getSample (channel, start + j))
+                        return false;
+        }
+
+        return true;
+    }
+};
+
+static FlacSeekIndexTests flacSeekIndexTests;
+
+//==============================================================================
+class FlacSeekIndexBenchmarks  : public UnitTest
+{
+public:
+    FlacSeekIndexBenchmarks()  : UnitTest ("FlacAudioFormat::SeekIndex random reads", UnitTestCategories::benchmarks)  {}
+
+    void runTest() override
+    {
+        beginTest ("Random reads with and without an index");
+
+        FlacAudioFormat format;
+        auto random = getRandom();
+
+        constexpr int numSamples = 44100 * 60 * 5, numReads = 500, readLength = 512;
+        AudioBuffer<float> buffer (2, numSamples);
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (channel, i, 0.1f * (random.nextFloat() - 0.5f));
+
+        MemoryBlock data;
+
+        {
+            std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (data, false), 44100.0, 2, 16, {}, 5));
+            writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+        }
+
+        MemoryInputStream stream (data, false);
+        const auto index = format.createSeekIndex (stream);
+
+        std::vector<int64> positions;
+
+        for (int i = 0; i < numReads; ++i)
+            positions.push_back (random.nextInt (numSamples - readLength));
+
+        const auto time = [&] (AudioFormatReader& reader)
+        {
+            AudioBuffer<float> result (2, readLength);
+            const auto start = Time::getHighResolutionTicks();
+
+            for (auto position : positions)
+                reader.read (&result, 0, readLength, position, true, true);
+
+            return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6 / numReads;
+        };
+
+        std::unique_ptr<AudioFormatReader> plain (format.createReaderFor (new MemoryInputStream (data, false), true));
+        std::unique_ptr<AudioFormatReader> indexed (format.createReaderFor (new MemoryInputStream (data, false), index, true));
+
+        const auto plainTime = time (*plain);
+        const auto indexedTime = time (*indexed);
+
+        logMessage ("Microseconds per random read of " + String (readLength) + " samples: without index "
+                      + String (plainTime, 1) + ", with index " + String (indexedTime, 1)
+                      + " (" + String (plainTime / indexedTime, 2) + "x)");
+
+        expect (plainTime > 0.0 && indexedTime > 0.0);
+    }
+};
+
+static FlacSeekIndexBenchmarks flacSeekIndexBenchmarks;
+
+#endif
+
 #endif
 
 } // namespace juce
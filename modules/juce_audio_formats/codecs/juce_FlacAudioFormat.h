@@ -53,10 +53,84 @@ public:
     bool isCompressed() override;
     StringArray getQualityOptions() override;
 
+    //==============================================================================
+    /**
+        A table of the position of each frame in a FLAC stream.
+
+        A reader that's given one of these can jump straight to the frame that holds
+        the sample it needs, so a random read only has to decode that frame, instead of
+        searching the stream for it. Building an index means decoding the whole stream
+        once, so it's worth saving it alongside the file with writeToStream(), and loading
+        it with readFromStream() the next time the file is opened.
+
+        Copies of an index share their data, so they're cheap to pass around.
+
+        @see createSeekIndex
+    */
+    class JUCE_API  SeekIndex
+    {
+    public:
+        /** Creates an empty index. */
+        SeekIndex() = default;
+
+        /** Returns true if the index holds no frames. */
+        bool isEmpty() const noexcept               { return getNumFrames() == 0; }
+
+        /** Returns the number of frames in the index. */
+        int getNumFrames() const noexcept           { return frames != nullptr ? (int) frames->size() : 0; }
+
+        /** Writes the index to a stream. */
+        void writeToStream (OutputStream&) const;
+
+        /** Replaces the index with one that was written by writeToStream().
+            Returns false, and leaves the index empty, if the data isn't valid.
+        */
+        bool readFromStream (InputStream&);
+
+    private:
+        friend class FlacReader;
+
+        struct Frame
+        {
+            int64 startSample, byteOffset;
+        };
+
+        std::shared_ptr<const std::vector<Frame>> frames;
+        int64 lengthInSamples = 0, streamLength = 0;
+    };
+
+    /** Decodes a FLAC stream from start to finish, and returns an index of its frames.
+        The stream's position is left at an arbitrary point. If the stream can't be
+        decoded, the index will be empty.
+    */
+    SeekIndex createSeekIndex (InputStream& flacStream);
+
     //==============================================================================
     AudioFormatReader* createReaderFor (InputStream* sourceStream,
                                         bool deleteStreamIfOpeningFails) override;
 
+    /** Creates a reader which uses a SeekIndex to jump straight to the frame that
+        holds the first sample of each read.
+
+        The index must have been created from the same stream. If the length of the
+        stream or the number of samples in it don't match the index, the index is
+        ignored, and the reader will seek in the normal way.
+    */
+    AudioFormatReader* createReaderFor (InputStream* sourceStream,
+                                        const SeekIndex& seekIndex,
+                                        bool deleteStreamIfOpeningFails);
+
+    /** Creates a reader which memory-maps a file and decodes it directly from memory.
+        Returns nullptr if the file can't be mapped or isn't a FLAC file.
+    */
+    AudioFormatReader* createReaderForMappedFile (const File& file);
+
+    /** Creates a reader which memory-maps a file and decodes it directly from memory,
+        using a SeekIndex that was created from the file.
+        Returns nullptr if the file can't be mapped or isn't a FLAC file.
+    */
+    AudioFormatReader* createReaderForMappedFile (const File& file, const SeekIndex& seekIndex);
+
     AudioFormatWriter* createWriterFor (OutputStream* streamToWriteTo,
                                         double sampleRateToUse,
                                         unsigned int numberOfChannels,
@@ -450,6 +450,14 @@ AudioFormatReader* OggVorbisAudioFormat::createReaderFor (InputStream* in, bool
     return nullptr;
 }
 
+AudioFormatReader* OggVorbisAudioFormat::createReaderForMappedFile (const File& file)
+{
+    if (auto stream = MappedFileInputStream::open (file))
+        return createReaderFor (stream.release(), true);
+
+    return nullptr;
+}
+
 AudioFormatWriter* OggVorbisAudioFormat::createWriterFor (OutputStream* out,
                                                           double sampleRate,
                                                           unsigned int numChannels,
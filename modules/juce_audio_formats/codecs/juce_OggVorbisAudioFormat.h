@@ -84,6 +84,11 @@ public:
     AudioFormatReader* createReaderFor (InputStream* sourceStream,
                                         bool deleteStreamIfOpeningFails) override;
 
+    /** Creates a reader which memory-maps a file and decodes it directly from memory.
+        Returns nullptr if the file can't be mapped or isn't an Ogg-Vorbis file.
+    */
+    AudioFormatReader* createReaderForMappedFile (const File& file);
+
     AudioFormatWriter* createWriterFor (OutputStream* streamToWriteTo,
                                         double sampleRateToUse,
                                         unsigned int numberOfChannels,
@@ -65,6 +65,36 @@ MemoryMappedAudioFormatReader* AudioFormat::createMemoryMappedReader (FileInputS
     return nullptr;
 }
 
+//==============================================================================
+// A stream that reads from a memory-mapped file, and keeps the file mapped for as
+// long as the stream exists. This lets compressed formats decode straight from
+// the mapped pages.
+struct MappedFileHolder
+{
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+};
+
+class MappedFileInputStream  : private MappedFileHolder,
+                               public MemoryInputStream
+{
+public:
+    static std::unique_ptr<InputStream> open (const File& file)
+    {
+        auto mapped = std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly);
+
+        if (mapped->getData() == nullptr)
+            return {};
+
+        return std::unique_ptr<InputStream> (new MappedFileInputStream (std::move (mapped)));
+    }
+
+private:
+    explicit MappedFileInputStream (std::unique_ptr<MemoryMappedFile> mapped)
+        : MappedFileHolder { std::move (mapped) },
+          MemoryInputStream (mappedFile->getData(), mappedFile->getSize(), false)
+    {}
+};
+
 bool AudioFormat::isChannelLayoutSupported (const AudioChannelSet& channelSet)
 {
     if (channelSet == AudioChannelSet::mono())      return canDoMono();
@@ -0,0 +1,331 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+CachingAudioFormatReader::BlockCache::BlockCache (size_t maxSizeInBytes)
+    : maxSize (maxSizeInBytes)
+{
+}
+
+CachingAudioFormatReader::BlockCache::~BlockCache()
+{
+    clear();
+}
+
+void CachingAudioFormatReader::BlockCache::clear()
+{
+    const ScopedLock sl (lock);
+    blocks.clear();
+    blocksByKey.clear();
+    currentSize = 0;
+}
+
+void CachingAudioFormatReader::BlockCache::setMaximumSize (size_t maxSizeInBytes)
+{
+    const ScopedLock sl (lock);
+    maxSize = maxSizeInBytes;
+
+    while (currentSize > maxSize && ! blocks.empty())
+        removeLeastRecentlyUsed();
+}
+
+size_t CachingAudioFormatReader::BlockCache::getSizeInBytes() const
+{
+    const ScopedLock sl (lock);
+    return currentSize;
+}
+
+int CachingAudioFormatReader::BlockCache::getNumBlocks() const
+{
+    const ScopedLock sl (lock);
+    return (int) blocks.size();
+}
+
+CachingAudioFormatReader::BlockCache::BlockPtr CachingAudioFormatReader::BlockCache::find (const Key& key)
+{
+    const ScopedLock sl (lock);
+
+    const auto found = blocksByKey.find (key);
+
+    if (found == blocksByKey.end())
+        return {};
+
+    blocks.splice (blocks.begin(), blocks, found->second);
+    return found->second->second;
+}
+
+void CachingAudioFormatReader::BlockCache::add (const Key& key, BlockPtr block)
+{
+    const ScopedLock sl (lock);
+
+    // Another reader with the same source may have got here first
+    if (blocksByKey.find (key) != blocksByKey.end())
+        return;
+
+    currentSize += block->getSizeInBytes();
+    blocks.emplace_front (key, std::move (block));
+    blocksByKey[key] = blocks.begin();
+
+    // The newest block is always kept, even if it's bigger than the whole cache
+    while (currentSize > maxSize && blocks.size() > 1)
+        removeLeastRecentlyUsed();
+}
+
+void CachingAudioFormatReader::BlockCache::removeLeastRecentlyUsed()
+{
+    auto& oldest = blocks.back();
+    currentSize -= oldest.second->getSizeInBytes();
+    blocksByKey.erase (oldest.first);
+    blocks.pop_back();
+}
+
+void CachingAudioFormatReader::BlockCache::removeSource (int64 sourceToRemove)
+{
+    const ScopedLock sl (lock);
+
+    for (auto i = blocks.begin(); i != blocks.end();)
+    {
+        if (std::get<0> (i->first) == sourceToRemove)
+        {
+            currentSize -= i->second->getSizeInBytes();
+            blocksByKey.erase (i->first);
+            i = blocks.erase (i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+//==============================================================================
+CachingAudioFormatReader::CachingAudioFormatReader (AudioFormatReader* sourceReader,
+                                                    BlockCache& blockCache,
+                                                    int64 sourceHashCode,
+                                                    int samplesPerBlock)
+    : AudioFormatReader (nullptr, sourceReader->getFormatName()),
+      source (sourceReader),
+      cache (blockCache),
+      sourceID (sourceHashCode != 0 ? sourceHashCode : (int64) (pointer_sized_int) this),
+      blockSize (jmax (1, samplesPerBlock)),
+      ownsBlocks (sourceHashCode == 0)
+{
+    sampleRate            = source->sampleRate;
+    lengthInSamples       = source->lengthInSamples;
+    numChannels           = source->numChannels;
+    metadataValues        = source->metadataValues;
+    bitsPerSample         = 32;
+    usesFloatingPointData = true;
+}
+
+CachingAudioFormatReader::~CachingAudioFormatReader()
+{
+    if (ownsBlocks)
+        cache.removeSource (sourceID);
+}
+
+CachingAudioFormatReader::BlockCache::BlockPtr CachingAudioFormatReader::getBlock (int64 blockIndex)
+{
+    const BlockCache::Key key { sourceID, blockSize, blockIndex };
+
+    if (auto block = cache.find (key))
+        return block;
+
+    auto block = std::make_shared<BlockCache::Block>();
+    const auto start = blockIndex * blockSize;
+    block->range = { start, jmin (lengthInSamples, start + blockSize) };
+    block->buffer.setSize ((int) numChannels, (int) block->range.getLength());
+    block->allSamplesRead = source->read (&block->buffer, 0, block->buffer.getNumSamples(), start, true, true);
+
+    cache.add (key, block);
+    return block;
+}
+
+bool CachingAudioFormatReader::readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                                            int64 startSampleInFile, int numSamples)
+{
+    clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                       startSampleInFile, numSamples, lengthInSamples);
+
+    bool allSamplesRead = true;
+
+    while (numSamples > 0)
+    {
+        const auto block = getBlock (startSampleInFile / blockSize);
+
+        auto offset = (int) (startSampleInFile - block->range.getStart());
+        auto numToDo = jmin (numSamples, (int) (block->range.getEnd() - startSampleInFile));
+
+        if (numToDo <= 0)
+            break;
+
+        for (int j = 0; j < numDestChannels; ++j)
+        {
+            if (auto* dest = (float*) destSamples[j])
+            {
+                dest += startOffsetInDestBuffer;
+
+                if (j < (int) numChannels)
+                    FloatVectorOperations::copy (dest, block->buffer.getReadPointer (j, offset), numToDo);
+                else
+                    FloatVectorOperations::clear (dest, numToDo);
+            }
+        }
+
+        startOffsetInDestBuffer += numToDo;
+        startSampleInFile += numToDo;
+        numSamples -= numToDo;
+
+        allSamplesRead = allSamplesRead && block->allSamplesRead;
+    }
+
+    return allSamplesRead;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class CachingAudioFormatReaderTests  : public UnitTest
+{
+public:
+    CachingAudioFormatReaderTests()  : UnitTest ("CachingAudioFormatReader", UnitTestCategories::audio)  {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        AudioBuffer<float> source (2, 20000);
+
+        for (int channel = 0; channel < source.getNumChannels(); ++channel)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+        beginTest ("Random reads match the source");
+        {
+            CachingAudioFormatReader::BlockCache cache (1 << 20);
+            CachingAudioFormatReader reader (new TestAudioFormatReader (source), cache, 0, 1000);
+
+            for (int i = 0; i < 200; ++i)
+            {
+                const auto start = random.nextInt (source.getNumSamples() + 500) - 200;
+                const auto length = 1 + random.nextInt (3000);
+
+                AudioBuffer<float> result (2, length), expected (2, length);
+                reader.read (&result, 0, length, start, true, true);
+
+                expected.clear();
+
+                for (int channel = 0; channel < 2; ++channel)
+                    for (int j = 0; j < length; ++j)
+                        if (isPositiveAndBelow (start + j, source.getNumSamples()))
+                            expected.setSample (channel, j, source.getSample (channel, start + j));
+
+                expect (result == expected);
+            }
+        }
+
+        beginTest ("Readers with the same hash code share their blocks");
+        {
+            CachingAudioFormatReader::BlockCache cache (1 << 20);
+
+            auto* firstSource = new CountingReader (source);
+            CachingAudioFormatReader first (firstSource, cache, 1234, 4096);
+
+            AudioBuffer<float> result (2, source.getNumSamples());
+            first.read (&result, 0, result.getNumSamples(), 0, true, true);
+            expect (result == source);
+            expectEquals (firstSource->numReads, 5);
+
+            auto* secondSource = new CountingReader (source);
+            CachingAudioFormatReader second (secondSource, cache, 1234, 4096);
+
+            result.clear();
+            second.read (&result, 0, result.getNumSamples(), 0, true, true);
+            expect (result == source);
+            expectEquals (secondSource->numReads, 0);
+
+            auto* privateSource = new CountingReader (source);
+            CachingAudioFormatReader privateReader (privateSource, cache, 0, 4096);
+            privateReader.read (&result, 0, result.getNumSamples(), 0, true, true);
+            expectEquals (privateSource->numReads, 5);
+        }
+
+        beginTest ("The least recently used blocks are discarded");
+        {
+            constexpr int blockSize = 1000;
+            const auto bytesPerBlock = (size_t) (2 * blockSize) * sizeof (float);
+
+            CachingAudioFormatReader::BlockCache cache (3 * bytesPerBlock);
+
+            {
+                auto* countingSource = new CountingReader (source);
+                CachingAudioFormatReader reader (countingSource, cache, 0, blockSize);
+                AudioBuffer<float> result (2, blockSize);
+
+                for (auto block : { 0, 1, 2, 0, 3 })
+                    reader.read (&result, 0, blockSize, block * blockSize, true, true);
+
+                expectEquals (cache.getNumBlocks(), 3);
+                expect (cache.getSizeInBytes() <= 3 * bytesPerBlock);
+                expectEquals (countingSource->numReads, 4);
+
+                // Block 0 was used more recently than block 1, so it should still be there
+                reader.read (&result, 0, blockSize, 0, true, true);
+                expectEquals (countingSource->numReads, 4);
+
+                reader.read (&result, 0, blockSize, blockSize, true, true);
+                expectEquals (countingSource->numReads, 5);
+            }
+
+            expectEquals (cache.getNumBlocks(), 0);
+            expectEquals ((int) cache.getSizeInBytes(), 0);
+        }
+    }
+
+private:
+    struct CountingReader  : public TestAudioFormatReader
+    {
+        using TestAudioFormatReader::TestAudioFormatReader;
+
+        bool readSamples (int** destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                          int64 startSampleInFile, int numSamples) override
+        {
+            ++numReads;
+            return TestAudioFormatReader::readSamples (destChannels, numDestChannels, startOffsetInDestBuffer,
+                                                       startSampleInFile, numSamples);
+        }
+
+        int numReads = 0;
+    };
+};
+
+static CachingAudioFormatReaderTests cachingAudioFormatReaderTests;
+
+#endif
+
+} // namespace juce
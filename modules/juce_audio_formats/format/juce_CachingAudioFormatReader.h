@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An AudioFormatReader that reads another reader in fixed-size blocks, and keeps
+    the decoded blocks in a BlockCache that can be shared between many readers.
+
+    This is useful for compressed formats, where jumping around a file means
+    decoding the same regions over and over again - for example when drawing
+    waveforms at different zoom levels, or when several sampler voices play the
+    same file. Readers that are given the same hash code share their blocks, so
+    a block that one of them has decoded can be used by all the others.
+
+    The blocks are stored as floating point data, so this reader always returns
+    floats.
+
+    @see BufferingAudioReader, AudioFormatReader
+
+    @tags{Audio}
+*/
+class JUCE_API  CachingAudioFormatReader  : public AudioFormatReader
+{
+public:
+    //==============================================================================
+    /**
+        A least-recently-used cache of decoded blocks of audio, which may be shared
+        between any number of CachingAudioFormatReaders on any number of threads.
+
+        When the total size of the blocks goes over the limit, the blocks that were
+        used least recently are discarded.
+    */
+    class JUCE_API  BlockCache
+    {
+    public:
+        /** Creates a cache which will hold up to the given number of bytes of audio. */
+        explicit BlockCache (size_t maxSizeInBytes);
+
+        /** Destructor.
+            The cache must outlive all of the readers that use it.
+        */
+        ~BlockCache();
+
+        /** Removes all the blocks from the cache. */
+        void clear();
+
+        /** Changes the maximum size of the cache, discarding blocks if necessary. */
+        void setMaximumSize (size_t maxSizeInBytes);
+
+        /** Returns the total size of the blocks that are currently being held. */
+        size_t getSizeInBytes() const;
+
+        /** Returns the number of blocks that are currently being held. */
+        int getNumBlocks() const;
+
+    private:
+        friend class CachingAudioFormatReader;
+
+        struct Block
+        {
+            Range<int64> range;
+            AudioBuffer<float> buffer;
+            bool allSamplesRead = false;
+
+            size_t getSizeInBytes() const noexcept  { return (size_t) buffer.getNumChannels() * (size_t) buffer.getNumSamples() * sizeof (float); }
+        };
+
+        using BlockPtr = std::shared_ptr<const Block>;
+        using Key = std::tuple<int64, int, int64>;   // source, block size, block index
+
+        BlockPtr find (const Key&);
+        void add (const Key&, BlockPtr);
+        void removeSource (int64 sourceID);
+        void removeLeastRecentlyUsed();
+
+        mutable CriticalSection lock;
+        std::list<std::pair<Key, BlockPtr>> blocks;   // most recently used first
+        std::map<Key, std::list<std::pair<Key, BlockPtr>>::iterator> blocksByKey;
+        size_t maxSize, currentSize = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BlockCache)
+    };
+
+    //==============================================================================
+    /** Creates a reader.
+
+        @param sourceReader     the source reader to wrap. This CachingAudioFormatReader
+                                takes ownership of this object and will delete it later
+                                when no longer needed
+        @param cache            the cache to keep the decoded blocks in. This must outlive
+                                the reader
+        @param sourceHashCode   a value that identifies the source, such as a hash of the file's
+                                path and modification time. Readers with the same hash code
+                                share the blocks in the cache, so this must be different for
+                                each different source. If it's 0, the blocks are private to
+                                this reader, and are removed from the cache when it's deleted
+        @param samplesPerBlock  the number of samples in each block
+    */
+    CachingAudioFormatReader (AudioFormatReader* sourceReader,
+                              BlockCache& cache,
+                              int64 sourceHashCode = 0,
+                              int samplesPerBlock = 8192);
+
+    /** Destructor. */
+    ~CachingAudioFormatReader() override;
+
+    //==============================================================================
+    bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      int64 startSampleInFile, int numSamples) override;
+
+private:
+    BlockCache::BlockPtr getBlock (int64 blockIndex);
+
+    std::unique_ptr<AudioFormatReader> source;
+    BlockCache& cache;
+    const int64 sourceID;
+    const int blockSize;
+    const bool ownsBlocks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachingAudioFormatReader)
+};
+
+} // namespace juce
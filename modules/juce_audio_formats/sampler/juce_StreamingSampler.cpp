@@ -0,0 +1,827 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+// The number of samples per channel in each of the streamer's cache blocks
+static constexpr int streamingSamplerBlockSize = 4096;
+
+// The number of samples after the end of a sound that the interpolator may touch
+static constexpr int numStreamingSamplerPaddingSamples = 2;
+
+//==============================================================================
+/*  What a voice shares with the streamer's thread.
+
+    The audio thread asks for a new sound to be streamed by pushing it onto a small
+    fifo, having added a reference to it. Only the streamer's thread ever releases
+    those references, and the audio thread won't look at the cached blocks again
+    until the streamer's thread has acknowledged its latest request.
+
+    Each slot holds the number of one of the blocks of the sound that follow the
+    playback position, together with the cache block that it has been read into.
+    The streamer's thread only clears or reuses a slot once the playback position
+    published by the audio thread has moved past the block it holds.
+*/
+class SamplerDiskStreamer::Stream
+{
+public:
+    explicit Stream (int readAheadSamples)
+        : numSlots (jmax (2, (readAheadSamples + streamingSamplerBlockSize - 1) / streamingSamplerBlockSize)),
+          slots ((size_t) numSlots)
+    {
+        for (auto& slot : slots)
+            slot.store (emptySlot);
+    }
+
+    //==============================================================================
+    // Called on the audio thread
+
+    void start (StreamingSamplerSound* soundToStream) noexcept
+    {
+        playbackPosition.store (0);
+
+        int start1, size1, start2, size2;
+        requestFifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+        {
+            // The streamer's thread has fallen so far behind that it hasn't picked up
+            // this voice's last few requests, so the voice will only be able to play
+            // the preloaded part of this sound.
+            playbackGeneration = -1;
+            return;
+        }
+
+        if (soundToStream != nullptr)
+            soundToStream->incReferenceCount();
+
+        requests[start1] = soundToStream;
+        requestFifo.finishedWrite (1);
+        playbackGeneration = ++requestedGeneration;
+    }
+
+    void stop() noexcept
+    {
+        start (nullptr);
+    }
+
+    // Tells the streamer's thread that nothing before this sample will be read again
+    void setPlaybackPosition (int64 position) noexcept
+    {
+        playbackPosition.store (position, std::memory_order_release);
+    }
+
+    bool isReady() const noexcept
+    {
+        return acknowledgedGeneration.load (std::memory_order_acquire) == playbackGeneration;
+    }
+
+    //==============================================================================
+    // Returns the cache block that holds the given block of the sound, or -1 if it
+    // hasn't been read yet.
+    int getCacheBlock (int64 blockNumber) const noexcept
+    {
+        auto slot = getSlot (blockNumber).load (std::memory_order_acquire);
+        return slot != emptySlot && (slot >> 32) == blockNumber ? (int) (slot & 0xffffffff) : -1;
+    }
+
+    std::atomic<int64>& getSlot (int64 blockNumber) noexcept
+    {
+        return slots[(size_t) (blockNumber % numSlots)];
+    }
+
+    const std::atomic<int64>& getSlot (int64 blockNumber) const noexcept
+    {
+        return slots[(size_t) (blockNumber % numSlots)];
+    }
+
+    static int64 makeSlot (int64 blockNumber, int cacheBlock) noexcept
+    {
+        return (blockNumber << 32) | (int64) cacheBlock;
+    }
+
+    using SoundPtr = ReferenceCountedObjectPtr<StreamingSamplerSound>;
+
+    static constexpr int64 emptySlot = -1;
+    static constexpr int maxPendingRequests = 16;
+
+    const int numSlots;
+    std::vector<std::atomic<int64>> slots;
+
+    AbstractFifo requestFifo { maxPendingRequests };
+    StreamingSamplerSound* requests[maxPendingRequests] = {};
+    std::atomic<int> acknowledgedGeneration { 0 };
+    std::atomic<int64> playbackPosition { 0 };
+
+    // only used by the audio thread
+    int requestedGeneration = 0, playbackGeneration = 0;
+
+    // only used by the streamer's thread
+    SoundPtr sound;
+    int handledGeneration = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (Stream)
+};
+
+//==============================================================================
+SamplerDiskStreamer::SamplerDiskStreamer (int cacheSizeInSamples, int threadPriority)
+    : cache (2, jmax (1, (cacheSizeInSamples + streamingSamplerBlockSize - 1) / streamingSamplerBlockSize)
+                  * streamingSamplerBlockSize),
+      blocks ((size_t) (cache.getNumSamples() / streamingSamplerBlockSize))
+{
+    cache.clear();
+    thread.addTimeSliceClient (this);
+    thread.startThread (threadPriority);
+}
+
+SamplerDiskStreamer::~SamplerDiskStreamer()
+{
+    // All the voices must be deleted before the streamer that serves them!
+    jassert (streams.isEmpty());
+
+    thread.removeTimeSliceClient (this);
+    thread.stopThread (2000);
+}
+
+SamplerDiskStreamer::Statistics SamplerDiskStreamer::getStatistics() const noexcept
+{
+    Statistics s;
+    s.numUnderruns       = numUnderruns.load();
+    s.numSamplesDropped  = numSamplesDropped.load();
+    s.numSamplesStreamed = numSamplesStreamed.load();
+    s.cacheSizeBytes     = (int64) cache.getNumChannels() * cache.getNumSamples() * (int64) sizeof (float);
+    return s;
+}
+
+void SamplerDiskStreamer::resetStatistics() noexcept
+{
+    numUnderruns = 0;
+    numSamplesDropped = 0;
+    numSamplesStreamed = 0;
+}
+
+void SamplerDiskStreamer::addStream (Stream& stream)
+{
+    const ScopedLock sl (streamLock);
+    streams.add (&stream);
+}
+
+void SamplerDiskStreamer::removeStream (Stream& stream)
+{
+    const ScopedLock sl (streamLock);
+    streams.removeFirstMatchingValue (&stream);
+
+    handleRequests (stream);
+    releaseBlocks (stream, std::numeric_limits<int64>::max());
+    stream.sound = nullptr;
+}
+
+// Picks up the sounds that the audio thread has asked a stream to play, taking
+// over the references it added to them.
+void SamplerDiskStreamer::handleRequests (Stream& stream)
+{
+    const auto numRequests = stream.requestFifo.getNumReady();
+
+    if (numRequests == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    stream.requestFifo.prepareToRead (numRequests, start1, size1, start2, size2);
+
+    auto takeRequest = [&stream] (int index)
+    {
+        auto* requested = stream.requests[index];
+        Stream::SoundPtr newSound (requested);
+
+        if (requested != nullptr)
+            requested->decReferenceCount();
+
+        stream.sound = std::move (newSound);
+    };
+
+    for (int i = 0; i < size1; ++i)
+        takeRequest (start1 + i);
+
+    for (int i = 0; i < size2; ++i)
+        takeRequest (start2 + i);
+
+    stream.requestFifo.finishedRead (size1 + size2);
+
+    releaseBlocks (stream, std::numeric_limits<int64>::max());
+    stream.handledGeneration += size1 + size2;
+    stream.acknowledgedGeneration.store (stream.handledGeneration, std::memory_order_release);
+}
+
+// Empties the stream's slots that hold blocks before the given one, leaving the
+// blocks in the cache in case they're needed again.
+void SamplerDiskStreamer::releaseBlocks (Stream& stream, int64 firstBlockNeeded)
+{
+    for (auto& slot : stream.slots)
+    {
+        const auto value = slot.load (std::memory_order_relaxed);
+
+        if (value != Stream::emptySlot && (value >> 32) < firstBlockNeeded)
+        {
+            slot.store (Stream::emptySlot, std::memory_order_relaxed);
+
+            auto& block = blocks[(size_t) (value & 0xffffffff)];
+            --block.numUsers;
+            block.lastUsed = ++useCounter;
+        }
+    }
+}
+
+// Returns the cache block holding the given part of a sound, reading it into the
+// least recently used free block if it isn't already there, or -1 if every block
+// is in use.
+int SamplerDiskStreamer::fetchBlock (StreamingSamplerSound& sound, int64 blockNumber)
+{
+    int blockToReuse = -1;
+
+    for (int i = 0; i < (int) blocks.size(); ++i)
+    {
+        auto& block = blocks[(size_t) i];
+
+        if (block.soundId == sound.soundId && block.blockNumber == blockNumber)
+        {
+            ++block.numUsers;
+            return i;
+        }
+
+        if (block.numUsers == 0
+             && (blockToReuse < 0 || block.lastUsed < blocks[(size_t) blockToReuse].lastUsed))
+            blockToReuse = i;
+    }
+
+    if (blockToReuse < 0)
+        return -1;
+
+    const auto startSample = blockNumber * streamingSamplerBlockSize;
+    sound.reader->read (&cache, blockToReuse * streamingSamplerBlockSize, streamingSamplerBlockSize, startSample, true, true);
+    numSamplesStreamed += jmin ((int64) streamingSamplerBlockSize, sound.length - startSample);
+
+    auto& block = blocks[(size_t) blockToReuse];
+    block.soundId = sound.soundId;
+    block.blockNumber = blockNumber;
+    block.numUsers = 1;
+    return blockToReuse;
+}
+
+int SamplerDiskStreamer::useTimeSlice()
+{
+    static constexpr int idleIntervalMs = 2;
+
+    const ScopedLock sl (streamLock);
+
+    Stream* streamToFill = nullptr;
+    int64 blockToRead = 0, shortestLead = std::numeric_limits<int64>::max();
+
+    for (auto* stream : streams)
+    {
+        handleRequests (*stream);
+
+        auto* sound = stream->sound.get();
+
+        if (sound == nullptr)
+            continue;
+
+        const auto position = stream->playbackPosition.load (std::memory_order_acquire);
+        const auto firstSampleNeeded = jmax (position, (int64) sound->numPreloadedSamples + numStreamingSamplerPaddingSamples);
+        const auto endOfSound = sound->length + numStreamingSamplerPaddingSamples;
+        const auto firstBlock = firstSampleNeeded / streamingSamplerBlockSize;
+
+        releaseBlocks (*stream, firstBlock);
+
+        if (firstSampleNeeded >= endOfSound)
+            continue;
+
+        const auto endBlock = jmin (firstBlock + stream->numSlots,
+                                    (endOfSound - 1) / streamingSamplerBlockSize + 1);
+
+        // Of all the blocks that the voices are missing, read the one that'll be
+        // played soonest first
+        for (auto blockNumber = firstBlock; blockNumber < endBlock; ++blockNumber)
+        {
+            if (stream->getCacheBlock (blockNumber) < 0)
+            {
+                const auto lead = blockNumber * streamingSamplerBlockSize - position;
+
+                if (lead < shortestLead)
+                {
+                    streamToFill = stream;
+                    blockToRead = blockNumber;
+                    shortestLead = lead;
+                }
+
+                break;
+            }
+        }
+    }
+
+    if (streamToFill == nullptr)
+        return idleIntervalMs;
+
+    const auto cacheBlock = fetchBlock (*streamToFill->sound, blockToRead);
+
+    if (cacheBlock < 0)
+        return idleIntervalMs;
+
+    streamToFill->getSlot (blockToRead).store (Stream::makeSlot (blockToRead, cacheBlock), std::memory_order_release);
+    return 0;
+}
+
+//==============================================================================
+static int64 getNextStreamingSamplerSoundId()
+{
+    static std::atomic<int64> lastId { 0 };
+    return ++lastId;
+}
+
+
+StreamingSamplerSound::StreamingSamplerSound (const String& soundName,
+                                              std::unique_ptr<AudioFormatReader> source,
+                                              const BigInteger& notes,
+                                              int midiNoteForNormalPitch,
+                                              double attackTimeSecs,
+                                              double releaseTimeSecs,
+                                              double preloadTimeSecs)
+    : name (soundName),
+      soundId (getNextStreamingSamplerSoundId()),
+      reader (std::move (source)),
+      midiNotes (notes),
+      midiRootNote (midiNoteForNormalPitch)
+{
+    if (reader != nullptr)
+        sourceSampleRate = reader->sampleRate;
+
+    if (sourceSampleRate > 0 && reader->lengthInSamples > 0)
+    {
+        if (auto* mapped = dynamic_cast<MemoryMappedAudioFormatReader*> (reader.get()))
+            if (mapped->getMappedSection().isEmpty())
+                mapped->mapEntireFile();
+
+        length = reader->lengthInSamples;
+        numPreloadedSamples = (int) jmin (length, (int64) (preloadTimeSecs * sourceSampleRate));
+
+        preloaded.setSize (jmin (2, (int) reader->numChannels), numPreloadedSamples + numStreamingSamplerPaddingSamples);
+        reader->read (&preloaded, 0, preloaded.getNumSamples(), 0, true, true);
+
+        params.attack  = static_cast<float> (attackTimeSecs);
+        params.release = static_cast<float> (releaseTimeSecs);
+    }
+}
+
+StreamingSamplerSound::~StreamingSamplerSound()
+{
+}
+
+bool StreamingSamplerSound::appliesToNote (int midiNoteNumber)
+{
+    return midiNotes[midiNoteNumber];
+}
+
+bool StreamingSamplerSound::appliesToChannel (int /*midiChannel*/)
+{
+    return true;
+}
+
+//==============================================================================
+StreamingSamplerVoice::StreamingSamplerVoice (SamplerDiskStreamer& s, int readAheadSamples)
+    : streamer (s),
+      stream (std::make_unique<SamplerDiskStreamer::Stream> (readAheadSamples))
+{
+    streamer.addStream (*stream);
+}
+
+StreamingSamplerVoice::~StreamingSamplerVoice()
+{
+    streamer.removeStream (*stream);
+}
+
+bool StreamingSamplerVoice::canPlaySound (SynthesiserSound* sound)
+{
+    return dynamic_cast<const StreamingSamplerSound*> (sound) != nullptr;
+}
+
+void StreamingSamplerVoice::startNote (int midiNoteNumber, float velocity, SynthesiserSound* s, int /*currentPitchWheelPosition*/)
+{
+    if (auto* sound = dynamic_cast<StreamingSamplerSound*> (s))
+    {
+        pitchRatio = std::pow (2.0, (midiNoteNumber - sound->midiRootNote) / 12.0)
+                        * sound->sourceSampleRate / getSampleRate();
+
+        sourceSamplePosition = 0.0;
+        lgain = velocity;
+        rgain = velocity;
+
+        adsr.setSampleRate (getSampleRate());
+        adsr.setParameters (sound->params);
+
+        adsr.noteOn();
+
+        stream->start (sound);
+    }
+    else
+    {
+        jassertfalse; // this object can only play StreamingSamplerSounds!
+    }
+}
+
+void StreamingSamplerVoice::stopNote (float /*velocity*/, bool allowTailOff)
+{
+    if (allowTailOff)
+    {
+        adsr.noteOff();
+    }
+    else
+    {
+        clearCurrentNote();
+        adsr.reset();
+        stream->stop();
+    }
+}
+
+void StreamingSamplerVoice::pitchWheelMoved (int /*newValue*/) {}
+void StreamingSamplerVoice::controllerMoved (int /*controllerNumber*/, int /*newValue*/) {}
+
+//==============================================================================
+void StreamingSamplerVoice::renderNextBlock (AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    if (auto* playingSound = static_cast<StreamingSamplerSound*> (getCurrentlyPlayingSound().get()))
+    {
+        auto& preloaded = playingSound->preloaded;
+        const float* const inL = preloaded.getReadPointer (0);
+        const float* const inR = preloaded.getNumChannels() > 1 ? preloaded.getReadPointer (1) : nullptr;
+        const auto numPreloaded = (int64) preloaded.getNumSamples();
+
+        stream->setPlaybackPosition ((int64) sourceSamplePosition);
+
+        const auto isStreaming = stream->isReady();
+        const float* const cacheL = streamer.cache.getReadPointer (0);
+        const float* const cacheR = streamer.cache.getReadPointer (1);
+        int64 currentBlock = -1;
+        int currentBlockStart = -1;
+
+        auto getSample = [&] (int64 index, float& l, float& r)
+        {
+            if (index < numPreloaded)
+            {
+                l = inL[index];
+                r = inR != nullptr ? inR[index] : l;
+                return true;
+            }
+
+            if (isStreaming)
+            {
+                const auto blockNumber = index / streamingSamplerBlockSize;
+
+                if (blockNumber != currentBlock)
+                {
+                    currentBlock = blockNumber;
+                    currentBlockStart = stream->getCacheBlock (blockNumber) * streamingSamplerBlockSize;
+                }
+
+                if (currentBlockStart >= 0)
+                {
+                    const auto i = currentBlockStart + (int) (index - blockNumber * streamingSamplerBlockSize);
+                    l = cacheL[i];
+                    r = cacheR[i];
+                    return true;
+                }
+            }
+
+            l = r = 0.0f;
+            return false;
+        };
+
+        float* outL = outputBuffer.getWritePointer (0, startSample);
+        float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer (1, startSample) : nullptr;
+
+        int64 numDropped = 0;
+
+        while (--numSamples >= 0)
+        {
+            auto pos = (int64) sourceSamplePosition;
+            auto alpha = (float) (sourceSamplePosition - (double) pos);
+            auto invAlpha = 1.0f - alpha;
+
+            float l0, r0, l1, r1;
+            const auto gotFirst  = getSample (pos, l0, r0);
+            const auto gotSecond = getSample (pos + 1, l1, r1);
+
+            if (! (gotFirst && gotSecond))
+                ++numDropped;
+
+            float l = (l0 * invAlpha + l1 * alpha);
+            float r = (inR != nullptr) ? (r0 * invAlpha + r1 * alpha)
+                                       : l;
+
+            auto envelopeValue = adsr.getNextSample();
+
+            l *= lgain * envelopeValue;
+            r *= rgain * envelopeValue;
+
+            if (outR != nullptr)
+            {
+                *outL++ += l;
+                *outR++ += r;
+            }
+            else
+            {
+                *outL++ += (l + r) * 0.5f;
+            }
+
+            sourceSamplePosition += pitchRatio;
+
+            if (sourceSamplePosition > (double) playingSound->length || ! adsr.isActive())
+            {
+                stopNote (0.0f, false);
+                break;
+            }
+        }
+
+        if (numDropped > 0)
+        {
+            ++streamer.numUnderruns;
+            streamer.numSamplesDropped += numDropped;
+        }
+    }
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+namespace
+{
+    struct StreamingSamplerTestReader  : public AudioFormatReader
+    {
+        explicit StreamingSamplerTestReader (const AudioBuffer<float>& b)
+            : AudioFormatReader (nullptr, {}),
+              buffer (b)
+        {
+            sampleRate            = 44100.0;
+            bitsPerSample         = 32;
+            usesFloatingPointData = true;
+            lengthInSamples       = buffer.getNumSamples();
+            numChannels           = (unsigned int) buffer.getNumChannels();
+        }
+
+        bool readSamples (int** destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                          int64 startSampleInFile, int numSamples) override
+        {
+            clearSamplesBeyondAvailableLength (destChannels, numDestChannels, startOffsetInDestBuffer,
+                                               startSampleInFile, numSamples, lengthInSamples);
+
+            for (int j = 0; j < numDestChannels; ++j)
+            {
+                if (auto* dest = reinterpret_cast<float*> (destChannels[j]))
+                {
+                    dest += startOffsetInDestBuffer;
+
+                    if (j < (int) numChannels && numSamples > 0)
+                        FloatVectorOperations::copy (dest, buffer.getReadPointer (j, (int) startSampleInFile), numSamples);
+                    else if (j >= (int) numChannels)
+                        FloatVectorOperations::clear (dest, numSamples);
+                }
+            }
+
+            return true;
+        }
+
+        const AudioBuffer<float>& buffer;
+    };
+}
+
+class StreamingSamplerTests  : public UnitTest
+{
+public:
+    StreamingSamplerTests()  : UnitTest ("StreamingSampler", UnitTestCategories::audio)  {}
+
+    void runTest() override
+    {
+        beginTest ("Streamed playback matches in-memory playback");
+        {
+            for (auto numChannels : { 1, 2 })
+            {
+                const auto source = generateTestBuffer (numChannels, 60000);
+
+                for (auto note : { 60, 67, 53 })
+                {
+                    StreamingSamplerTestReader memoryReader (source);
+
+                    Synthesiser reference;
+                    reference.addVoice (new SamplerVoice());
+                    reference.addSound (new SamplerSound ("reference", memoryReader, allNotes(), 60, 0.01, 0.1, 10.0));
+
+                    SamplerDiskStreamer streamer;
+                    stopReaderThread (streamer);
+
+                    Synthesiser streaming;
+                    streaming.addVoice (new StreamingSamplerVoice (streamer, 4096));
+
+                    auto* sound = new StreamingSamplerSound ("streamed", std::make_unique<StreamingSamplerTestReader> (source),
+                                                             allNotes(), 60, 0.01, 0.1, 0.25);
+                    streaming.addSound (sound);
+
+                    expectEquals (sound->getLengthInSamples(), (int64) source.getNumSamples());
+                    expect (sound->getPreloadedData().getNumSamples() < source.getNumSamples() / 4);
+
+                    auto mismatches = render (reference, streaming, streamer, note, 60000);
+
+                    expectEquals (mismatches, 0);
+                    expectEquals (streamer.getStatistics().numUnderruns, (int64) 0);
+                    expect (streamer.getStatistics().numSamplesStreamed > 0);
+                }
+            }
+        }
+
+        beginTest ("The cache size doesn't depend on the number of voices");
+        {
+            SamplerDiskStreamer streamer (64 * 4096);
+            const auto cacheSizeBytes = (int64) (2 * 64 * 4096 * sizeof (float));
+
+            expectEquals (streamer.getStatistics().cacheSizeBytes, cacheSizeBytes);
+
+            {
+                Synthesiser synth;
+
+                for (int i = 0; i < 8; ++i)
+                    synth.addVoice (new StreamingSamplerVoice (streamer, 8192));
+
+                expectEquals (streamer.getStatistics().cacheSizeBytes, cacheSizeBytes);
+            }
+
+            expectEquals (streamer.getStatistics().cacheSizeBytes, cacheSizeBytes);
+        }
+
+        beginTest ("Voices playing the same part of a sound share cached blocks");
+        {
+            const auto source = generateTestBuffer (2, 44100);
+
+            SamplerDiskStreamer streamer;
+            stopReaderThread (streamer);
+
+            Synthesiser synth;
+            synth.addVoice (new StreamingSamplerVoice (streamer, 8192));
+            synth.addVoice (new StreamingSamplerVoice (streamer, 8192));
+            synth.addSound (new StreamingSamplerSound ("shared", std::make_unique<StreamingSamplerTestReader> (source),
+                                                       allNotes(), 60, 0.0, 0.1, 0.1));
+            synth.setCurrentPlaybackSampleRate (44100.0);
+
+            MidiBuffer midi;
+            midi.addEvent (MidiMessage::noteOn (1, 60, 1.0f), 0);
+            midi.addEvent (MidiMessage::noteOn (2, 60, 1.0f), 0);
+
+            AudioBuffer<float> output (2, 512);
+
+            for (int pos = 0; pos < source.getNumSamples(); pos += output.getNumSamples())
+            {
+                output.clear();
+                synth.renderNextBlock (output, midi, 0, output.getNumSamples());
+                midi.clear();
+                pumpReaderThread (streamer);
+            }
+
+            const auto stats = streamer.getStatistics();
+            expectEquals (stats.numUnderruns, (int64) 0);
+            expect (stats.numSamplesStreamed > 0);
+            expect (stats.numSamplesStreamed <= source.getNumSamples());
+        }
+
+        beginTest ("Underruns are counted");
+        {
+            const auto source = generateTestBuffer (2, 44100);
+
+            SamplerDiskStreamer streamer;
+            stopReaderThread (streamer);
+
+            Synthesiser synth;
+            synth.addVoice (new StreamingSamplerVoice (streamer, 4096));
+            synth.addSound (new StreamingSamplerSound ("unread", std::make_unique<StreamingSamplerTestReader> (source),
+                                                       allNotes(), 60, 0.0, 0.1, 0.001));
+            synth.setCurrentPlaybackSampleRate (44100.0);
+
+            MidiBuffer midi;
+            midi.addEvent (MidiMessage::noteOn (1, 60, 1.0f), 0);
+
+            AudioBuffer<float> output (2, 512);
+            output.clear();
+            synth.renderNextBlock (output, midi, 0, output.getNumSamples());
+
+            const auto stats = streamer.getStatistics();
+            expectEquals (stats.numUnderruns, (int64) 1);
+            expect (stats.numSamplesDropped > 400);
+            expect (output.getMagnitude (0, 0, 40) > 0.0f);
+            expectEquals (output.getMagnitude (0, 100, 412), 0.0f);
+
+            streamer.resetStatistics();
+            expectEquals (streamer.getStatistics().numUnderruns, (int64) 0);
+        }
+    }
+
+private:
+    static BigInteger allNotes()
+    {
+        BigInteger notes;
+        notes.setRange (0, 128, true);
+        return notes;
+    }
+
+    AudioBuffer<float> generateTestBuffer (int numChannels, int numSamples)
+    {
+        auto random = getRandom();
+
+        AudioBuffer<float> buffer (numChannels, numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int sample = 0; sample < numSamples; ++sample)
+                buffer.setSample (channel, sample, random.nextFloat() * 2.0f - 1.0f);
+
+        return buffer;
+    }
+
+    // Lets the test decide when the streamer reads from disk, by stopping its
+    // thread and calling pumpReaderThread() instead.
+    static void stopReaderThread (SamplerDiskStreamer& streamer)
+    {
+        streamer.getTimeSliceThread().stopThread (2000);
+    }
+
+    // Reads until the voices have all the blocks they want to read ahead.
+    static void pumpReaderThread (SamplerDiskStreamer& streamer)
+    {
+        auto& thread = streamer.getTimeSliceThread();
+        jassert (! thread.isThreadRunning());
+
+        if (auto* client = thread.getClient (0))
+            while (client->useTimeSlice() == 0)
+            {}
+    }
+
+    // Renders both synths block by block, letting the streamer fill its voices'
+    // read-ahead after each one, and returns the number of output samples that differ.
+    static int render (Synthesiser& reference, Synthesiser& streaming, SamplerDiskStreamer& streamer,
+                       int note, int numSamples)
+    {
+        constexpr int blockSize = 512;
+
+        reference.setCurrentPlaybackSampleRate (44100.0);
+        streaming.setCurrentPlaybackSampleRate (44100.0);
+
+        MidiBuffer midi;
+        midi.addEvent (MidiMessage::noteOn (1, note, 0.8f), 0);
+
+        AudioBuffer<float> expected (2, blockSize), actual (2, blockSize);
+        int mismatches = 0;
+
+        for (int pos = 0; pos < numSamples; pos += blockSize)
+        {
+            expected.clear();
+            actual.clear();
+
+            reference.renderNextBlock (expected, midi, 0, blockSize);
+            streaming.renderNextBlock (actual, midi, 0, blockSize);
+            midi.clear();
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    if (expected.getSample (ch, i) != actual.getSample (ch, i))
+                        ++mismatches;
+
+            pumpReaderThread (streamer);
+        }
+
+        return mismatches;
+    }
+};
+
+static StreamingSamplerTests streamingSamplerTests;
+
+#endif
+
+} // namespace juce
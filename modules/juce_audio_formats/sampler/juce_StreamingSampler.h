@@ -0,0 +1,283 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class StreamingSamplerSound;
+
+//==============================================================================
+/**
+    Owns the background thread that reads audio from disk on behalf of a set of
+    StreamingSamplerVoice objects, the cache that it reads into, and keeps count of
+    how often the voices ran dry.
+
+    The cache is a fixed number of blocks which is allocated when the streamer is
+    created, and which all the voices share. The thread reads ahead of each voice's
+    playback position, starting with the block that is needed soonest, and voices
+    that are playing the same part of a sound use the same cached blocks. Blocks
+    that no voice needs any more stay in the cache until their space is needed, so
+    a sound that is played again soon afterwards may not have to be read again.
+
+    Create one of these, pass it to each StreamingSamplerVoice that you add to
+    your Synthesiser, and make sure it outlives all of those voices.
+
+    @see StreamingSamplerVoice, StreamingSamplerSound
+
+    @tags{Audio}
+*/
+class JUCE_API  SamplerDiskStreamer  : private TimeSliceClient
+{
+public:
+    //==============================================================================
+    /** Creates a streamer and starts its reader thread.
+
+        @param cacheSizeInSamples   the number of samples per channel that the cache can
+                                    hold, which is rounded up to a whole number of blocks.
+                                    This should be at least the total read-ahead of all the
+                                    voices that can play at once, otherwise some of them
+                                    won't be able to read ahead as far as they've asked to
+        @param threadPriority       the priority of the reader thread
+    */
+    explicit SamplerDiskStreamer (int cacheSizeInSamples = 1 << 20,
+                                  int threadPriority = 7);
+
+    /** Destructor.
+        All the voices using this streamer must have been deleted before it is.
+    */
+    ~SamplerDiskStreamer() override;
+
+    //==============================================================================
+    /** Counters describing the streaming performance of the voices using this object. */
+    struct Statistics
+    {
+        /** The number of times a voice had to render a block without all the
+            samples it needed having been read from disk.
+        */
+        int64 numUnderruns = 0;
+
+        /** The total number of output samples that were rendered as silence
+            because the audio they needed hadn't been read in time.
+        */
+        int64 numSamplesDropped = 0;
+
+        /** The total number of samples read from disk by the background thread.
+            Samples which were already in the cache when a voice needed them
+            aren't counted.
+        */
+        int64 numSamplesStreamed = 0;
+
+        /** The memory used by the cache, in bytes.
+            This is fixed when the streamer is created, and doesn't depend on the
+            number of voices or the number and length of the sounds being played.
+        */
+        int64 cacheSizeBytes = 0;
+    };
+
+    /** Returns a snapshot of the current counters.
+        This can be called from any thread.
+    */
+    Statistics getStatistics() const noexcept;
+
+    /** Sets the underrun and streamed-sample counters back to zero. */
+    void resetStatistics() noexcept;
+
+    /** Returns the thread that performs the background reading. */
+    TimeSliceThread& getTimeSliceThread() noexcept      { return thread; }
+
+private:
+    //==============================================================================
+    friend class StreamingSamplerVoice;
+    class Stream;
+
+    struct CacheBlock
+    {
+        int64 soundId = -1, blockNumber = -1, lastUsed = 0;
+        int numUsers = 0;
+    };
+
+    TimeSliceThread thread { "Sampler Disk Streamer" };
+    AudioBuffer<float> cache;
+    std::vector<CacheBlock> blocks;
+    int64 useCounter = 0;
+
+    CriticalSection streamLock;
+    Array<Stream*> streams;
+
+    std::atomic<int64> numUnderruns { 0 }, numSamplesDropped { 0 }, numSamplesStreamed { 0 };
+
+    void addStream (Stream&);
+    void removeStream (Stream&);
+    void handleRequests (Stream&);
+    void releaseBlocks (Stream&, int64 firstBlockNeeded);
+    int fetchBlock (StreamingSamplerSound&, int64 blockNumber);
+    int useTimeSlice() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplerDiskStreamer)
+};
+
+//==============================================================================
+/**
+    A SynthesiserSound that plays an audio file which is too large to keep in memory.
+
+    Only the first few moments of the file are loaded when the sound is created;
+    the rest is read on demand by the SamplerDiskStreamer used by the
+    StreamingSamplerVoice that is playing it. The preloaded section must be long
+    enough to cover the time the background thread takes to start reading, so
+    a sample library with many sounds only costs its preloaded heads in RAM.
+
+    If the reader is a MemoryMappedAudioFormatReader that hasn't been mapped yet,
+    the whole file will be mapped, so that the background thread can read from it
+    without any file-system calls.
+
+    @see StreamingSamplerVoice, SamplerDiskStreamer, SamplerSound
+
+    @tags{Audio}
+*/
+class JUCE_API  StreamingSamplerSound    : public SynthesiserSound
+{
+public:
+    //==============================================================================
+    /** Creates a streamed sound from an audio reader.
+
+        @param name         a name for the sample
+        @param source       the reader to stream the audio from. This object takes
+                            ownership of it, and it will only ever be used by the thread
+                            that creates the sound and by the SamplerDiskStreamer thread
+        @param midiNotes    the set of midi keys that this sound should be played on
+        @param midiNoteForNormalPitch   the midi note at which the sample should be played
+                                        with its natural rate
+        @param attackTimeSecs   the attack (fade-in) time, in seconds
+        @param releaseTimeSecs  the decay (fade-out) time, in seconds
+        @param preloadTimeSecs  how much of the start of the sample to keep in memory, in
+                                seconds. Playback reads from this section while the
+                                background thread begins reading the rest
+    */
+    StreamingSamplerSound (const String& name,
+                           std::unique_ptr<AudioFormatReader> source,
+                           const BigInteger& midiNotes,
+                           int midiNoteForNormalPitch,
+                           double attackTimeSecs,
+                           double releaseTimeSecs,
+                           double preloadTimeSecs);
+
+    /** Destructor. */
+    ~StreamingSamplerSound() override;
+
+    //==============================================================================
+    /** Returns the sample's name */
+    const String& getName() const noexcept                  { return name; }
+
+    /** Returns the total length of the sample, in source samples. */
+    int64 getLengthInSamples() const noexcept               { return length; }
+
+    /** Returns the section of the sample that is kept in memory. */
+    const AudioBuffer<float>& getPreloadedData() const noexcept     { return preloaded; }
+
+    //==============================================================================
+    /** Changes the parameters of the ADSR envelope which will be applied to the sample. */
+    void setEnvelopeParameters (ADSR::Parameters parametersToUse)    { params = parametersToUse; }
+
+    //==============================================================================
+    bool appliesToNote (int midiNoteNumber) override;
+    bool appliesToChannel (int midiChannel) override;
+
+private:
+    //==============================================================================
+    friend class SamplerDiskStreamer;
+    friend class StreamingSamplerVoice;
+
+    String name;
+    const int64 soundId;
+    std::unique_ptr<AudioFormatReader> reader;
+    AudioBuffer<float> preloaded;
+    double sourceSampleRate = 0;
+    BigInteger midiNotes;
+    int64 length = 0;
+    int numPreloadedSamples = 0, midiRootNote = 0;
+
+    ADSR::Parameters params;
+
+    JUCE_LEAK_DETECTOR (StreamingSamplerSound)
+};
+
+//==============================================================================
+/**
+    A SynthesiserVoice that can play a StreamingSamplerSound.
+
+    The SamplerDiskStreamer's thread reads the sound into the streamer's cache ahead
+    of each voice's playback position, so the memory needed for streaming depends
+    only on the size of that cache. If the background thread falls behind, the
+    missing samples are rendered as silence and counted in the streamer's Statistics.
+
+    @see StreamingSamplerSound, SamplerDiskStreamer, SamplerVoice
+
+    @tags{Audio}
+*/
+class JUCE_API  StreamingSamplerVoice    : public SynthesiserVoice
+{
+public:
+    //==============================================================================
+    /** Creates a voice.
+
+        @param streamer             the object whose thread will read audio for this voice.
+                                    It must outlive the voice
+        @param readAheadSamples     the number of samples to read ahead of the playback
+                                    position, which is rounded up to a whole number of the
+                                    streamer's cache blocks
+    */
+    explicit StreamingSamplerVoice (SamplerDiskStreamer& streamer,
+                                    int readAheadSamples = 32768);
+
+    /** Destructor. */
+    ~StreamingSamplerVoice() override;
+
+    //==============================================================================
+    bool canPlaySound (SynthesiserSound*) override;
+
+    void startNote (int midiNoteNumber, float velocity, SynthesiserSound*, int pitchWheel) override;
+    void stopNote (float velocity, bool allowTailOff) override;
+
+    void pitchWheelMoved (int newValue) override;
+    void controllerMoved (int controllerNumber, int newValue) override;
+
+    void renderNextBlock (AudioBuffer<float>&, int startSample, int numSamples) override;
+    using SynthesiserVoice::renderNextBlock;
+
+private:
+    //==============================================================================
+    SamplerDiskStreamer& streamer;
+    std::unique_ptr<SamplerDiskStreamer::Stream> stream;
+
+    double pitchRatio = 0;
+    double sourceSamplePosition = 0;
+    float lgain = 0, rgain = 0;
+
+    ADSR adsr;
+
+    JUCE_LEAK_DETECTOR (StreamingSamplerVoice)
+};
+
+} // namespace juce
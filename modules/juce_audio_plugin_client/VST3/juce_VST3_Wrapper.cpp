@@ -3359,11 +3359,19 @@ public:
                    #endif
                     {
                         if (auto* param = comPluginInstance->getParamForVSTParamID (vstParamID))
+                        {
+                            if (automationHandler != nullptr)
+                                automationPoints.add (*paramQueue, param->getParameterIndex());
+
                             setValueAndNotifyIfChanged (*param, (float) value);
+                        }
                     }
                 }
             }
         }
+
+        if (automationHandler != nullptr)
+            automationPoints.sort();
     }
 
     void addParameterChangeToMidiBuffer (const Steinberg::int32 offsetSamples, const Vst::ParamID id, const double value)
@@ -3410,6 +3418,7 @@ public:
         }
 
         midiBuffer.clear();
+        automationPoints.clear();
 
         if (data.inputParameterChanges != nullptr)
             processParameterChanges (*data.inputParameterChanges);
@@ -3531,6 +3540,9 @@ private:
             }
             else
             {
+                if (automationHandler != nullptr)
+                    automationHandler->handleParameterAutomation (automationPoints.data(), automationPoints.size());
+
                 // processBlockBypassed should only ever be called if the AudioProcessor doesn't
                 // return a valid parameter from getBypassParameter
                 if (pluginInstance->getBypassParameter() == nullptr && comPluginInstance->getBypassParameter()->getValue() >= 0.5f)
@@ -3587,6 +3599,17 @@ private:
         midiBuffer.ensureSize (2048);
         midiBuffer.clear();
 
+        automationHandler = nullptr;
+
+        if (auto* extensions = dynamic_cast<VST3ClientExtensions*> (&p))
+        {
+            if (extensions->wantsSampleAccurateParameterAutomation())
+            {
+                automationHandler = extensions;
+                automationPoints.reserve ((size_t) jmax (2048, 16 * p.getParameters().size()));
+            }
+        }
+
         bufferMapper.updateFromProcessor (p);
         bufferMapper.prepare (bufferSize);
     }
@@ -3667,6 +3690,9 @@ private:
     MidiBuffer midiBuffer;
     ClientBufferMapper bufferMapper;
 
+    VST3ClientExtensions* automationHandler = nullptr;
+    ParameterAutomationPoints automationPoints;
+
     bool active = false;
 
    #if JucePlugin_WantsMidiInput
@@ -1578,6 +1578,56 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiEventList)
 };
 
+//==============================================================================
+/*  Collects every point from the parameter queues that the host sends for a block, for
+    processors that use VST3ClientExtensions::handleParameterAutomation().
+
+    Space for the points is reserved up front, so adding them never allocates. If the host
+    sends more points than will fit, the extra ones are dropped.
+*/
+class ParameterAutomationPoints
+{
+public:
+    using Point = VST3ClientExtensions::ParameterAutomationPoint;
+
+    void reserve (size_t maxNumPoints)      { points.reserve (maxNumPoints); }
+    void clear() noexcept                   { points.clear(); }
+
+    void add (Steinberg::Vst::IParamValueQueue& queue, int parameterIndex)
+    {
+        // The wrapper's own bypass parameter isn't one of the processor's parameters
+        if (parameterIndex < 0)
+            return;
+
+        const auto numPoints = queue.getPointCount();
+
+        for (Steinberg::int32 i = 0; i < numPoints && points.size() < points.capacity(); ++i)
+        {
+            Steinberg::int32 offsetSamples = 0;
+            Steinberg::Vst::ParamValue value = 0.0;
+
+            if (queue.getPoint (i, offsetSamples, value) == Steinberg::kResultTrue)
+                points.push_back ({ (int) offsetSamples, parameterIndex, (float) value });
+        }
+    }
+
+    /*  Sorts the points by sample offset, and then by parameter index. */
+    void sort()
+    {
+        std::sort (points.begin(), points.end(), [] (const Point& a, const Point& b)
+        {
+            return a.sampleOffset != b.sampleOffset ? a.sampleOffset < b.sampleOffset
+                                                    : a.parameterIndex < b.parameterIndex;
+        });
+    }
+
+    const Point* data() const noexcept      { return points.data(); }
+    int size() const noexcept               { return (int) points.size(); }
+
+private:
+    std::vector<Point> points;
+};
+
 //==============================================================================
 /*  Provides very quick polling of all parameter states.
 
@@ -550,9 +550,112 @@ public:
                 expect (clientBuffers[3].channelBuffers64[0] == nullptr);
             }
         }
+
+        beginTest ("ParameterAutomationPoints gathers the points from every queue in order");
+        {
+            PointQueue gain { { 0, 0.0 }, { 64, 0.5 }, { 200, 1.0 } };
+            PointQueue pan { { 32, 0.25 }, { 200, 0.75 } };
+            PointQueue bypass { { 100, 1.0 } };
+
+            ParameterAutomationPoints points;
+            points.reserve (16);
+            points.add (pan, 1);
+            points.add (gain, 0);
+            points.add (bypass, -1);
+            points.sort();
+
+            expect (points.size() == 5);
+
+            const auto matches = [&] (int index, int sampleOffset, int parameterIndex, float value)
+            {
+                const auto& point = points.data()[index];
+                return point.sampleOffset == sampleOffset && point.parameterIndex == parameterIndex && approximatelyEqual (point.value, value);
+            };
+
+            expect (matches (0, 0,   0, 0.0f));
+            expect (matches (1, 32,  1, 0.25f));
+            expect (matches (2, 64,  0, 0.5f));
+            expect (matches (3, 200, 0, 1.0f));
+            expect (matches (4, 200, 1, 0.75f));
+
+            // A processor splitting a block at each change would render these sub-blocks
+            std::vector<Range<int>> subBlocks;
+            auto subBlockStart = 0;
+
+            for (int i = 0; i < points.size(); ++i)
+            {
+                const auto offset = points.data()[i].sampleOffset;
+
+                if (offset > subBlockStart)
+                {
+                    subBlocks.push_back ({ subBlockStart, offset });
+                    subBlockStart = offset;
+                }
+            }
+
+            const auto numSamples = 256;
+            subBlocks.push_back ({ subBlockStart, numSamples });
+
+            expect (subBlocks == std::vector<Range<int>> { { 0, 32 }, { 32, 64 }, { 64, 200 }, { 200, numSamples } });
+
+            points.clear();
+            expect (points.size() == 0);
+        }
+
+        beginTest ("ParameterAutomationPoints drops points that don't fit, instead of allocating");
+        {
+            PointQueue gain { { 0, 0.0 }, { 64, 0.5 }, { 128, 0.75 }, { 200, 1.0 } };
+
+            ParameterAutomationPoints points;
+            points.reserve (3);
+            const auto* storage = points.data();
+
+            points.add (gain, 0);
+
+            expect (points.size() == 3);
+            expect (points.data() == storage);
+            expect (points.data()[2].sampleOffset == 128);
+        }
     }
 
 private:
+    //==============================================================================
+    /*  A parameter queue which holds a fixed list of points, as a host might send. */
+    class PointQueue  : public Steinberg::Vst::IParamValueQueue
+    {
+    public:
+        PointQueue (std::initializer_list<std::pair<Steinberg::int32, Steinberg::Vst::ParamValue>> pointsIn)
+            : points (pointsIn) {}
+
+        virtual ~PointQueue() = default;
+
+        JUCE_DECLARE_VST3_COM_REF_METHODS
+        JUCE_DECLARE_VST3_COM_QUERY_METHODS
+
+        Steinberg::Vst::ParamID PLUGIN_API getParameterId() override    { return 0; }
+        Steinberg::int32 PLUGIN_API getPointCount() override            { return (Steinberg::int32) points.size(); }
+
+        Steinberg::tresult PLUGIN_API getPoint (Steinberg::int32 index,
+                                                Steinberg::int32& sampleOffset,
+                                                Steinberg::Vst::ParamValue& value) override
+        {
+            if (! isPositiveAndBelow (index, getPointCount()))
+                return Steinberg::kResultFalse;
+
+            std::tie (sampleOffset, value) = points[(size_t) index];
+            return Steinberg::kResultTrue;
+        }
+
+        Steinberg::tresult PLUGIN_API addPoint (Steinberg::int32, Steinberg::Vst::ParamValue, Steinberg::int32&) override
+        {
+            return Steinberg::kNotImplemented;
+        }
+
+    private:
+        std::vector<std::pair<Steinberg::int32, Steinberg::Vst::ParamValue>> points;
+        Atomic<int> refCount;
+    };
+
     //==============================================================================
     struct Config
     {
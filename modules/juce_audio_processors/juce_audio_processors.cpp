@@ -208,6 +208,7 @@ private:
 #include "format_types/juce_ARAHosting.cpp"
 #include "scanning/juce_KnownPluginList.cpp"
 #include "scanning/juce_PluginDirectoryScanner.cpp"
+#include "scanning/juce_OutOfProcessPluginScanner.cpp"
 #include "scanning/juce_PluginListComponent.cpp"
 #include "processors/juce_AudioProcessorParameterGroup.cpp"
 #include "utilities/juce_AudioProcessorParameterWithID.cpp"
@@ -225,6 +226,9 @@ private:
 #include "format_types/juce_LV2PluginFormat.cpp"
 
 #if JUCE_UNIT_TESTS
+ #include "processors/juce_AudioProcessorGraph_test.cpp"
+ #include "scanning/juce_KnownPluginList_test.cpp"
+
  #if JUCE_PLUGINHOST_VST3
   #include "format_types/juce_VST3PluginFormat_test.cpp"
  #endif
@@ -33,6 +33,17 @@ void JUCE_CALLTYPE AudioProcessor::setTypeOfNextNewPlugin (AudioProcessor::Wrapp
     wrapperTypeBeingCreated = type;
 }
 
+struct AudioProcessor::UMPConversionState
+{
+    UMPConversionState()
+    {
+        messages.ensureSize (2048);
+    }
+
+    UMPBufferConverter converter;
+    MidiBuffer messages;
+};
+
 AudioProcessor::AudioProcessor()
     : AudioProcessor (BusesProperties().withInput  ("Input",  AudioChannelSet::stereo(), false)
                                        .withOutput ("Output", AudioChannelSet::stereo(), false))
@@ -40,7 +51,8 @@ AudioProcessor::AudioProcessor()
 }
 
 AudioProcessor::AudioProcessor (const BusesProperties& ioConfig)
-    : wrapperType (wrapperTypeBeingCreated.get())
+    : wrapperType (wrapperTypeBeingCreated.get()),
+      umpConversionState (std::make_unique<UMPConversionState>())
 {
     for (auto& layout : ioConfig.inputLayouts)   createBus (true,  layout);
     for (auto& layout : ioConfig.outputLayouts)  createBus (false, layout);
@@ -581,8 +593,8 @@ void AudioProcessor::suspendProcessing (const bool shouldBeSuspended)
 
 void AudioProcessor::reset() {}
 
-template <typename floatType>
-void AudioProcessor::processBypassed (AudioBuffer<floatType>& buffer, MidiBuffer&)
+template <typename floatType, typename MidiBufferType>
+void AudioProcessor::processBypassed (AudioBuffer<floatType>& buffer, MidiBufferType&)
 {
     // If you hit this assertion then your plug-in is reporting that it introduces
     // some latency, but you haven't overridden processBlockBypassed to produce
@@ -614,6 +626,33 @@ bool AudioProcessor::supportsDoublePrecisionProcessing() const
     return false;
 }
 
+//==============================================================================
+template <typename floatType>
+void AudioProcessor::processBlockWithConvertedMidi (AudioBuffer<floatType>& buffer, UMPBuffer& packets)
+{
+    // The state is created and its buffer reserved up front, so that a host passing
+    // packets to a processor that can't handle them won't allocate on the audio thread.
+    auto& state = *umpConversionState;
+
+    state.messages.clear();
+    state.converter.convert (packets, state.messages);
+
+    processBlock (buffer, state.messages);
+
+    packets.clear();
+    state.converter.convert (state.messages, packets);
+}
+
+void AudioProcessor::processBlockUMP (AudioBuffer<float>&  buffer, UMPBuffer& midi)             { processBlockWithConvertedMidi (buffer, midi); }
+void AudioProcessor::processBlockUMP (AudioBuffer<double>& buffer, UMPBuffer& midi)             { processBlockWithConvertedMidi (buffer, midi); }
+void AudioProcessor::processBlockBypassedUMP (AudioBuffer<float>&  buffer, UMPBuffer& midi)     { processBypassed (buffer, midi); }
+void AudioProcessor::processBlockBypassedUMP (AudioBuffer<double>& buffer, UMPBuffer& midi)     { processBypassed (buffer, midi); }
+
+bool AudioProcessor::supportsUniversalMidiPackets() const
+{
+    return false;
+}
+
 void AudioProcessor::setProcessingPrecision (ProcessingPrecision precision) noexcept
 {
     // If you hit this assertion then you're trying to use double precision
@@ -302,6 +302,59 @@ public:
     virtual void processBlockBypassed (AudioBuffer<double>& buffer,
                                        MidiBuffer& midiMessages);
 
+    //==============================================================================
+    /** Renders the next block, with its MIDI events as Universal MIDI Packets.
+
+        Override this, and return true from supportsUniversalMidiPackets(), if your
+        processor can handle MIDI 2.0 messages directly. An AudioProcessorGraph will then
+        pass the packets coming from other nodes straight to this method, rather than
+        converting them to MIDI 1.0 and back at each connection. The audio buffer is used
+        in the same way as in the MidiBuffer version of processBlock(), and the packets
+        left in the UMPBuffer when this returns are the processor's MIDI output.
+
+        This has a different name from processBlock(), so that overriding it doesn't hide
+        the other processBlock() overloads.
+
+        The default implementation converts the packets to a MidiBuffer, calls the
+        MidiBuffer version of processBlock(), and converts the result back to MIDI 2.0
+        protocol packets. The state it needs for this is allocated on the first call.
+
+        @see supportsUniversalMidiPackets, processBlockBypassedUMP, UMPBuffer
+    */
+    virtual void processBlockUMP (AudioBuffer<float>& buffer,
+                                  UMPBuffer& midiMessages);
+
+    /** Renders the next block in double precision, with its MIDI events as Universal MIDI
+        Packets.
+
+        @see supportsUniversalMidiPackets, supportsDoublePrecisionProcessing
+    */
+    virtual void processBlockUMP (AudioBuffer<double>& buffer,
+                                  UMPBuffer& midiMessages);
+
+    /** Renders the next block when the processor is being bypassed, with its MIDI events
+        as Universal MIDI Packets.
+
+        Like the MidiBuffer version, the default implementation passes through any incoming
+        audio, and leaves the MIDI events unchanged.
+    */
+    virtual void processBlockBypassedUMP (AudioBuffer<float>& buffer,
+                                          UMPBuffer& midiMessages);
+
+    /** Renders the next block in double precision when the processor is being bypassed,
+        with its MIDI events as Universal MIDI Packets.
+    */
+    virtual void processBlockBypassedUMP (AudioBuffer<double>& buffer,
+                                          UMPBuffer& midiMessages);
+
+    /** Returns true if the processor handles Universal MIDI Packets itself.
+
+        The default implementation returns false. If you return true here, you must
+        override processBlockUMP(), which an AudioProcessorGraph will call instead of
+        processBlock().
+    */
+    virtual bool supportsUniversalMidiPackets() const;
+
 
     //==============================================================================
     /**
@@ -1531,8 +1584,14 @@ private:
     void audioIOChanged (bool busNumberChanged, bool channelNumChanged);
     void getNextBestLayout (const BusesLayout&, BusesLayout&) const;
 
+    template <typename floatType, typename MidiBufferType>
+    void processBypassed (AudioBuffer<floatType>&, MidiBufferType&);
+
+    struct UMPConversionState;
+    std::unique_ptr<UMPConversionState> umpConversionState;
+
     template <typename floatType>
-    void processBypassed (AudioBuffer<floatType>&, MidiBuffer&);
+    void processBlockWithConvertedMidi (AudioBuffer<floatType>&, UMPBuffer&);
 
     friend class AudioProcessorParameter;
     friend class LADSPAPluginInstance;
@@ -34,18 +34,404 @@ static void updateOnMessageThread (AsyncUpdater& updater)
         updater.triggerAsyncUpdate();
 }
 
+//==============================================================================
+/*  Splits a render sequence into steps (the ops that prepare a node's inputs,
+    followed by the node's process op) and works out which steps depend on each
+    other by looking at the buffers that each one reads and writes.
+
+    At render time, steps whose dependencies have all completed are pushed onto
+    a fixed-size ready queue, from which any number of threads can pull work.
+    Nothing in the render-time path allocates or takes a lock.
+*/
+class GraphRenderSteps
+{
+public:
+    enum class Resource { audioBuffer, midiBuffer, graphIO };
+
+    //==============================================================================
+    void addAccess (Resource type, int index, bool isWrite)
+    {
+        // The first buffer of each type is a shared block of read-only zeros
+        if (type != Resource::graphIO && index == 0)
+            return;
+
+        const auto key = std::make_pair ((int) type, index);
+
+        for (auto& a : currentAccesses)
+        {
+            if (a.first == key)
+            {
+                a.second = a.second || isWrite;
+                return;
+            }
+        }
+
+        currentAccesses.emplace_back (key, isWrite);
+    }
+
+    void endStep (int numOpsInSequence)
+    {
+        const auto firstOp = steps.empty() ? 0 : steps.back().firstOp + steps.back().numOps;
+        steps.push_back ({ firstOp, numOpsInSequence - firstOp, {}, 0 });
+
+        const auto stepIndex = (int) steps.size() - 1;
+        std::set<int> dependencies;
+
+        for (auto& access : currentAccesses)
+        {
+            auto& state = resourceStates[access.first];
+
+            if (state.lastWriter >= 0)
+                dependencies.insert (state.lastWriter);
+
+            if (access.second)
+            {
+                dependencies.insert (state.readersSinceLastWrite.begin(), state.readersSinceLastWrite.end());
+                state.readersSinceLastWrite.clear();
+                state.lastWriter = stepIndex;
+            }
+            else
+            {
+                state.readersSinceLastWrite.push_back (stepIndex);
+            }
+        }
+
+        for (auto dependency : dependencies)
+            steps[(size_t) dependency].successors.push_back (stepIndex);
+
+        steps.back().numDependencies = (int) dependencies.size();
+        currentAccesses.clear();
+    }
+
+    /** Called once all steps have been added, to allocate the render-time state. */
+    void prepare()
+    {
+        resourceStates.clear();
+
+        const auto numSteps = steps.size();
+        pendingDependencies.reset (new std::atomic<int>[numSteps]);
+        readyQueue.reset (new std::atomic<int>[numSteps]);
+
+        for (size_t i = 0; i < numSteps; ++i)
+            if (steps[i].numDependencies == 0)
+                rootSteps.push_back ((int) i);
+    }
+
+    bool isPrepared() const noexcept     { return readyQueue != nullptr; }
+    int getNumSteps() const noexcept     { return (int) steps.size(); }
+
+    //==============================================================================
+    /** Resets the render-time state before a new block. Must not be called while
+        any thread is still inside performSteps().
+    */
+    void startBlock() noexcept
+    {
+        const auto numSteps = steps.size();
+
+        for (size_t i = 0; i < numSteps; ++i)
+        {
+            pendingDependencies[i].store (steps[i].numDependencies, std::memory_order_relaxed);
+            readyQueue[i].store (-1, std::memory_order_relaxed);
+        }
+
+        readIndex.store (0, std::memory_order_relaxed);
+        writeIndex.store (0, std::memory_order_relaxed);
+        numStepsCompleted.store (0, std::memory_order_relaxed);
+
+        for (auto step : rootSteps)
+            pushReadyStep (step);
+    }
+
+    /** Runs ready steps on the calling thread until every step in the block has
+        completed. The callback is given the range of ops belonging to each step.
+    */
+    template <typename PerformOpsFn>
+    void performSteps (PerformOpsFn&& performOps) noexcept
+    {
+        const auto numSteps = (int) steps.size();
+
+        while (numStepsCompleted.load() < numSteps)
+        {
+            if (! performNextReadyStep (performOps))
+                Thread::yield();
+        }
+    }
+
+private:
+    struct Step
+    {
+        int firstOp, numOps;
+        std::vector<int> successors;
+        int numDependencies;
+    };
+
+    struct ResourceState
+    {
+        int lastWriter = -1;
+        std::vector<int> readersSinceLastWrite;
+    };
+
+    template <typename PerformOpsFn>
+    bool performNextReadyStep (PerformOpsFn& performOps) noexcept
+    {
+        auto slot = readIndex.load();
+
+        if (slot >= writeIndex.load() || ! readIndex.compare_exchange_weak (slot, slot + 1))
+            return false;
+
+        // The slot has been claimed by a producer, but it might not have been written yet
+        int stepIndex;
+
+        while ((stepIndex = readyQueue[(size_t) slot].load()) < 0)
+        {}
+
+        auto& step = steps[(size_t) stepIndex];
+        performOps (step.firstOp, step.numOps);
+
+        for (auto successor : step.successors)
+            if (--pendingDependencies[(size_t) successor] == 0)
+                pushReadyStep (successor);
+
+        ++numStepsCompleted;
+        return true;
+    }
+
+    void pushReadyStep (int stepIndex) noexcept
+    {
+        // Every step is pushed exactly once per block, so the queue can never overflow
+        readyQueue[(size_t) writeIndex++].store (stepIndex);
+    }
+
+    std::vector<Step> steps;
+    std::vector<int> rootSteps;
+    std::vector<std::pair<std::pair<int, int>, bool>> currentAccesses;
+    std::map<std::pair<int, int>, ResourceState> resourceStates;
+
+    std::unique_ptr<std::atomic<int>[]> pendingDependencies, readyQueue;
+    std::atomic<int> readIndex { 0 }, writeIndex { 0 }, numStepsCompleted { 0 };
+};
+
+//==============================================================================
+/*  A set of realtime worker threads that help the audio thread to get through
+    the steps of a render sequence.
+*/
+class GraphRenderThreadPool
+{
+public:
+    struct Job
+    {
+        virtual ~Job() = default;
+
+        /** Called concurrently on the audio thread and every worker thread. This
+            should return once all the work in the job has been finished.
+        */
+        virtual void performSteps() noexcept = 0;
+    };
+
+    explicit GraphRenderThreadPool (int numWorkerThreads)
+    {
+        for (int i = 0; i < numWorkerThreads; ++i)
+            workers.add (new WorkerThread (*this, i))->startThread (Thread::realtimeAudioPriority);
+    }
+
+    ~GraphRenderThreadPool()
+    {
+        for (auto* w : workers)
+            w->signalThreadShouldExit();
+
+        for (auto* w : workers)
+            w->notify();
+
+        workers.clear();
+    }
+
+    int getNumWorkerThreads() const noexcept    { return workers.size(); }
+
+    /** Runs a job on the calling thread and all the worker threads, and returns
+        once all of the workers have finished with it.
+    */
+    void perform (Job& job) noexcept
+    {
+        currentJob = &job;
+
+        for (auto* w : workers)
+            w->notify();
+
+        job.performSteps();
+
+        currentJob = nullptr;
+
+        while (numActiveWorkers.load() > 0)
+            Thread::yield();
+    }
+
+private:
+    struct WorkerThread  : public Thread
+    {
+        WorkerThread (GraphRenderThreadPool& p, int index)
+            : Thread ("Graph render thread " + String (index + 1)), pool (p)
+        {
+        }
+
+        ~WorkerThread() override
+        {
+            stopThread (1000);
+        }
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                wait (-1);
+
+                ++pool.numActiveWorkers;
+
+                if (auto* job = pool.currentJob.load())
+                {
+                    const ScopedNoDenormals noDenormals;
+                    job->performSteps();
+                }
+
+                --pool.numActiveWorkers;
+            }
+        }
+
+        GraphRenderThreadPool& pool;
+
+        JUCE_DECLARE_NON_COPYABLE (WorkerThread)
+    };
+
+    OwnedArray<WorkerThread> workers;
+    std::atomic<Job*> currentJob { nullptr };
+    std::atomic<int> numActiveWorkers { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GraphRenderThreadPool)
+};
+
+//==============================================================================
+/*  One of the MIDI buffers used by a GraphRenderSequence.
+
+    The events are held either as a MidiBuffer or as Universal MIDI Packets, in whichever
+    format they were produced, and are only converted when they're read by a node or
+    added to a buffer that uses the other format. The buffer that isn't in use is always
+    kept empty.
+*/
+class GraphMidiBuffer
+{
+public:
+    void ensureSize (size_t size)
+    {
+        messages.ensureSize (size);
+        packets.ensureSize (size);
+    }
+
+    void clear() noexcept
+    {
+        messages.clear();
+        packets.clear();
+    }
+
+    bool isEmpty() const noexcept       { return messages.isEmpty() && packets.isEmpty(); }
+
+    MidiBuffer& getMessages()
+    {
+        if (usesPackets)
+        {
+            converter.convert (packets, messages);
+            packets.clear();
+            usesPackets = false;
+        }
+
+        return messages;
+    }
+
+    UMPBuffer& getPackets()
+    {
+        if (! usesPackets)
+        {
+            converter.convert (messages, packets);
+            messages.clear();
+            usesPackets = true;
+        }
+
+        return packets;
+    }
+
+    void addFrom (const MidiBuffer& source, int numSamples)
+    {
+        if (isEmpty())
+            usesPackets = false;
+
+        if (usesPackets)
+            converter.convert (source, packets);
+        else
+            messages.addEvents (source, 0, numSamples, 0);
+    }
+
+    void addFrom (const UMPBuffer& source, int numSamples)
+    {
+        if (isEmpty())
+            usesPackets = true;
+
+        if (usesPackets)
+            packets.addEvents (source, 0, numSamples, 0);
+        else
+            converter.convert (source, messages);
+    }
+
+    void addFrom (const GraphMidiBuffer& source, int numSamples)
+    {
+        if (source.usesPackets)
+            addFrom (source.packets, numSamples);
+        else
+            addFrom (source.messages, numSamples);
+    }
+
+    void copyTo (MidiBuffer& destination, int numSamples)
+    {
+        destination.clear();
+
+        if (usesPackets)
+            converter.convert (packets, destination);
+        else
+            destination.addEvents (messages, 0, numSamples, 0);
+    }
+
+    void copyTo (UMPBuffer& destination, int numSamples)
+    {
+        destination.clear();
+
+        if (usesPackets)
+            destination.addEvents (packets, 0, numSamples, 0);
+        else
+            converter.convert (messages, destination);
+    }
+
+private:
+    MidiBuffer messages;
+    UMPBuffer packets;
+    UMPBufferConverter converter;
+    bool usesPackets = false;
+};
+
+//==============================================================================
 template <typename FloatType>
-struct GraphRenderSequence
+struct GraphRenderSequence  : private GraphRenderThreadPool::Job
 {
     struct Context
     {
         FloatType** audioBuffers;
-        MidiBuffer* midiBuffers;
+        GraphMidiBuffer* const* midiBuffers;
+        const MidiBuffer* midiInputMessages;
+        const UMPBuffer* midiInputPackets;
+        GraphMidiBuffer* midiOutput;
         AudioPlayHead* audioPlayHead;
         int numSamples;
     };
 
-    void perform (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead)
+    template <typename MidiBufferType>
+    void perform (AudioBuffer<FloatType>& buffer, MidiBufferType& midiMessages, AudioPlayHead* audioPlayHead,
+                  GraphRenderThreadPool* threadPool)
     {
         auto numSamples = buffer.getNumSamples();
         auto maxSamples = renderingBuffer.getNumSamples();
@@ -59,12 +445,13 @@ struct GraphRenderSequence
                 auto chunkSize = jmin (maxSamples, numSamples - chunkStartSample);
 
                 AudioBuffer<FloatType> audioChunk (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), chunkStartSample, chunkSize);
-                midiChunk.clear();
-                midiChunk.addEvents (midiMessages, chunkStartSample, chunkSize, -chunkStartSample);
+                auto& chunkMidi = getMidiChunk (midiMessages);
+                chunkMidi.clear();
+                chunkMidi.addEvents (midiMessages, chunkStartSample, chunkSize, -chunkStartSample);
 
                 // Splitting up the buffer like this will cause the play head and host time to be
                 // invalid for all but the first chunk...
-                perform (audioChunk, midiChunk, audioPlayHead);
+                perform (audioChunk, chunkMidi, audioPlayHead, threadPool);
 
                 chunkStartSample += maxSamples;
             }
@@ -75,31 +462,44 @@ struct GraphRenderSequence
         currentAudioInputBuffer = &buffer;
         currentAudioOutputBuffer.setSize (jmax (1, buffer.getNumChannels()), numSamples);
         currentAudioOutputBuffer.clear();
-        currentMidiInputBuffer = &midiMessages;
         currentMidiOutputBuffer.clear();
 
         {
-            const Context context { renderingBuffer.getArrayOfWritePointers(), midiBuffers.begin(), audioPlayHead, numSamples };
+            const Context context { renderingBuffer.getArrayOfWritePointers(), midiBuffers.begin(),
+                                    getInputMessages (midiMessages), getInputPackets (midiMessages),
+                                    &currentMidiOutputBuffer, audioPlayHead, numSamples };
 
-            for (auto* op : renderOps)
-                op->perform (context);
+            if (threadPool != nullptr && steps.isPrepared())
+            {
+                currentContext = &context;
+                steps.startBlock();
+                threadPool->perform (*this);
+                currentContext = nullptr;
+            }
+            else
+            {
+                for (auto* op : renderOps)
+                    op->perform (context);
+            }
         }
 
         for (int i = 0; i < buffer.getNumChannels(); ++i)
             buffer.copyFrom (i, 0, currentAudioOutputBuffer, i, 0, numSamples);
 
-        midiMessages.clear();
-        midiMessages.addEvents (currentMidiOutputBuffer, 0, buffer.getNumSamples(), 0);
+        currentMidiOutputBuffer.copyTo (midiMessages, buffer.getNumSamples());
         currentAudioInputBuffer = nullptr;
     }
 
     void addClearChannelOp (int index)
     {
+        steps.addAccess (GraphRenderSteps::Resource::audioBuffer, index, true);
         createOp ([=] (const Context& c)    { FloatVectorOperations::clear (c.audioBuffers[index], c.numSamples); });
     }
 
     void addCopyChannelOp (int srcIndex, int dstIndex)
     {
+        steps.addAccess (GraphRenderSteps::Resource::audioBuffer, srcIndex, false);
+        steps.addAccess (GraphRenderSteps::Resource::audioBuffer, dstIndex, true);
         createOp ([=] (const Context& c)    { FloatVectorOperations::copy (c.audioBuffers[dstIndex],
                                                                            c.audioBuffers[srcIndex],
                                                                            c.numSamples); });
@@ -107,6 +507,8 @@ struct GraphRenderSequence
 
     void addAddChannelOp (int srcIndex, int dstIndex)
     {
+        steps.addAccess (GraphRenderSteps::Resource::audioBuffer, srcIndex, false);
+        steps.addAccess (GraphRenderSteps::Resource::audioBuffer, dstIndex, true);
         createOp ([=] (const Context& c)    { FloatVectorOperations::add (c.audioBuffers[dstIndex],
                                                                           c.audioBuffers[srcIndex],
                                                                           c.numSamples); });
@@ -114,29 +516,54 @@ struct GraphRenderSequence
 
     void addClearMidiBufferOp (int index)
     {
-        createOp ([=] (const Context& c)    { c.midiBuffers[index].clear(); });
+        steps.addAccess (GraphRenderSteps::Resource::midiBuffer, index, true);
+        createOp ([=] (const Context& c)    { c.midiBuffers[index]->clear(); });
     }
 
     void addCopyMidiBufferOp (int srcIndex, int dstIndex)
     {
-        createOp ([=] (const Context& c)    { c.midiBuffers[dstIndex] = c.midiBuffers[srcIndex]; });
+        steps.addAccess (GraphRenderSteps::Resource::midiBuffer, srcIndex, false);
+        steps.addAccess (GraphRenderSteps::Resource::midiBuffer, dstIndex, true);
+        createOp ([=] (const Context& c)
+        {
+            c.midiBuffers[dstIndex]->clear();
+            c.midiBuffers[dstIndex]->addFrom (*c.midiBuffers[srcIndex], c.numSamples);
+        });
     }
 
     void addAddMidiBufferOp (int srcIndex, int dstIndex)
     {
-        createOp ([=] (const Context& c)    { c.midiBuffers[dstIndex].addEvents (c.midiBuffers[srcIndex],
-                                                                                 0, c.numSamples, 0); });
+        steps.addAccess (GraphRenderSteps::Resource::midiBuffer, srcIndex, false);
+        steps.addAccess (GraphRenderSteps::Resource::midiBuffer, dstIndex, true);
+        createOp ([=] (const Context& c)    { c.midiBuffers[dstIndex]->addFrom (*c.midiBuffers[srcIndex], c.numSamples); });
     }
 
     void addDelayChannelOp (int chan, int delaySize)
     {
+        steps.addAccess (GraphRenderSteps::Resource::audioBuffer, chan, true);
         renderOps.add (new DelayChannelOp (chan, delaySize));
     }
 
     void addProcessOp (const AudioProcessorGraph::Node::Ptr& node,
                        const Array<int>& audioChannelsUsed, int totalNumChans, int midiBuffer)
     {
+        for (auto channel : audioChannelsUsed)
+            steps.addAccess (GraphRenderSteps::Resource::audioBuffer, channel, true);
+
+        steps.addAccess (GraphRenderSteps::Resource::midiBuffer, midiBuffer, true);
+
+        // The graph's own I/O nodes all share the sequence's input and output buffers
+        if (dynamic_cast<AudioProcessorGraph::AudioGraphIOProcessor*> (node->getProcessor()) != nullptr)
+            steps.addAccess (GraphRenderSteps::Resource::graphIO, 0, true);
+
         renderOps.add (new ProcessOp (node, audioChannelsUsed, totalNumChans, midiBuffer));
+        steps.endStep (renderOps.size());
+    }
+
+    /** Works out which of the ops added so far can be run concurrently. */
+    void prepareParallelSteps()
+    {
+        steps.prepare();
     }
 
     void prepareBuffers (int blockSize)
@@ -147,18 +574,18 @@ struct GraphRenderSequence
         currentAudioOutputBuffer.clear();
 
         currentAudioInputBuffer = nullptr;
-        currentMidiInputBuffer = nullptr;
         currentMidiOutputBuffer.clear();
 
-        midiBuffers.clearQuick();
-        midiBuffers.resize (numMidiBuffersNeeded);
+        midiBuffers.clearQuick (true);
 
         const int defaultMIDIBufferSize = 512;
 
         midiChunk.ensureSize (defaultMIDIBufferSize);
+        packetChunk.ensureSize (defaultMIDIBufferSize);
+        currentMidiOutputBuffer.ensureSize (defaultMIDIBufferSize);
 
-        for (auto&& m : midiBuffers)
-            m.ensureSize (defaultMIDIBufferSize);
+        for (int i = 0; i < numMidiBuffersNeeded; ++i)
+            midiBuffers.add (new GraphMidiBuffer())->ensureSize (defaultMIDIBufferSize);
     }
 
     void releaseBuffers()
@@ -166,7 +593,6 @@ struct GraphRenderSequence
         renderingBuffer.setSize (1, 1);
         currentAudioOutputBuffer.setSize (1, 1);
         currentAudioInputBuffer = nullptr;
-        currentMidiInputBuffer = nullptr;
         currentMidiOutputBuffer.clear();
         midiBuffers.clear();
     }
@@ -176,13 +602,30 @@ struct GraphRenderSequence
     AudioBuffer<FloatType> renderingBuffer, currentAudioOutputBuffer;
     AudioBuffer<FloatType>* currentAudioInputBuffer = nullptr;
 
-    MidiBuffer* currentMidiInputBuffer = nullptr;
-    MidiBuffer currentMidiOutputBuffer;
+    GraphMidiBuffer currentMidiOutputBuffer;
 
-    Array<MidiBuffer> midiBuffers;
+    OwnedArray<GraphMidiBuffer> midiBuffers;
     MidiBuffer midiChunk;
+    UMPBuffer packetChunk;
 
 private:
+    MidiBuffer& getMidiChunk (const MidiBuffer&) noexcept      { return midiChunk; }
+    UMPBuffer&  getMidiChunk (const UMPBuffer&) noexcept       { return packetChunk; }
+
+    static const MidiBuffer* getInputMessages (const MidiBuffer& b) noexcept    { return &b; }
+    static const MidiBuffer* getInputMessages (const UMPBuffer&) noexcept      { return nullptr; }
+    static const UMPBuffer*  getInputPackets  (const MidiBuffer&) noexcept     { return nullptr; }
+    static const UMPBuffer*  getInputPackets  (const UMPBuffer& b) noexcept    { return &b; }
+
+    void performSteps() noexcept override
+    {
+        steps.performSteps ([this] (int firstOp, int numOps)
+        {
+            for (int i = firstOp; i < firstOp + numOps; ++i)
+                renderOps.getUnchecked (i)->perform (*currentContext);
+        });
+    }
+
     //==============================================================================
     struct RenderingOp
     {
@@ -194,6 +637,8 @@ private:
     };
 
     OwnedArray<RenderingOp> renderOps;
+    GraphRenderSteps steps;
+    const Context* currentContext = nullptr;
 
     //==============================================================================
     template <typename LambdaType,
@@ -253,7 +698,8 @@ private:
               processor (*n->getProcessor()),
               audioChannelsToUse (audioChannelsUsed),
               totalChans (jmax (1, totalNumChans)),
-              midiBufferToUse (midiBuffer)
+              midiBufferToUse (midiBuffer),
+              midiIOType (getMidiIOType (processor))
         {
             audioChannels.calloc ((size_t) totalChans);
 
@@ -281,13 +727,35 @@ private:
 
             const ScopedLock lock (processor.getCallbackLock());
 
+            auto& midi = *c.midiBuffers[midiBufferToUse];
+
             if (processor.isSuspended())
                 buffer.clear();
+            else if (midiIOType != MidiIOType::none)
+                performMidiIO (c, midi);
+            else if (processor.supportsUniversalMidiPackets())
+                callProcess (buffer, midi.getPackets());
             else
-                callProcess (buffer, c.midiBuffers[midiBufferToUse]);
+                callProcess (buffer, midi.getMessages());
+        }
+
+        // The graph's MIDI input and output nodes copy the events directly, so that they
+        // don't have to be converted to suit the nodes' processBlock methods.
+        void performMidiIO (const Context& c, GraphMidiBuffer& midi)
+        {
+            if (node->isBypassed())
+                return;
+
+            if (midiIOType == MidiIOType::output)
+                c.midiOutput->addFrom (midi, c.numSamples);
+            else if (c.midiInputPackets != nullptr)
+                midi.addFrom (*c.midiInputPackets, c.numSamples);
+            else if (c.midiInputMessages != nullptr)
+                midi.addFrom (*c.midiInputMessages, c.numSamples);
         }
 
-        void callProcess (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
+        template <typename MidiBufferType>
+        void callProcess (AudioBuffer<float>& buffer, MidiBufferType& midiMessages)
         {
             if (processor.isUsingDoublePrecision())
             {
@@ -309,7 +777,8 @@ private:
             }
         }
 
-        void callProcess (AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
+        template <typename MidiBufferType>
+        void callProcess (AudioBuffer<double>& buffer, MidiBufferType& midiMessages)
         {
             if (processor.isUsingDoublePrecision())
             {
@@ -331,6 +800,21 @@ private:
             }
         }
 
+        enum class MidiIOType { none, input, output };
+
+        static MidiIOType getMidiIOType (AudioProcessor& p)
+        {
+            using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
+
+            if (auto* io = dynamic_cast<IOProcessor*> (&p))
+            {
+                if (io->getType() == IOProcessor::midiInputNode)   return MidiIOType::input;
+                if (io->getType() == IOProcessor::midiOutputNode)  return MidiIOType::output;
+            }
+
+            return MidiIOType::none;
+        }
+
         const AudioProcessorGraph::Node::Ptr node;
         AudioProcessor& processor;
 
@@ -338,6 +822,7 @@ private:
         HeapBlock<FloatType*> audioChannels;
         AudioBuffer<float> tempBufferFloat, tempBufferDouble;
         const int totalChans, midiBufferToUse;
+        const MidiIOType midiIOType;
 
         JUCE_DECLARE_NON_COPYABLE (ProcessOp)
     };
@@ -348,8 +833,9 @@ private:
 template <typename RenderSequence>
 struct RenderSequenceBuilder
 {
-    RenderSequenceBuilder (AudioProcessorGraph& g, RenderSequence& s)
-        : graph (g), sequence (s), orderedNodes (createOrderedNodeList (graph))
+    RenderSequenceBuilder (AudioProcessorGraph& g, RenderSequence& s, bool buildForParallelRendering)
+        : graph (g), sequence (s), orderedNodes (createOrderedNodeList (graph)),
+          reuseFreeBuffers (! buildForParallelRendering)
     {
         audioBuffers.add (AssignedBuffer::createReadOnlyEmpty()); // first buffer is read-only zeros
         midiBuffers .add (AssignedBuffer::createReadOnlyEmpty());
@@ -365,6 +851,9 @@ struct RenderSequenceBuilder
 
         s.numBuffersNeeded = audioBuffers.size();
         s.numMidiBuffersNeeded = midiBuffers.size();
+
+        if (buildForParallelRendering)
+            s.prepareParallelSteps();
     }
 
     //==============================================================================
@@ -376,6 +865,10 @@ struct RenderSequenceBuilder
 
     const Array<Node*> orderedNodes;
 
+    // Sharing buffers between nodes saves memory, but stops those nodes from being
+    // rendered concurrently, so a parallel sequence gives every node its own buffers.
+    const bool reuseFreeBuffers;
+
     struct AssignedBuffer
     {
         AudioProcessorGraph::NodeAndChannel channel;
@@ -757,11 +1250,12 @@ struct RenderSequenceBuilder
         return results;
     }
 
-    static int getFreeBuffer (Array<AssignedBuffer>& buffers)
+    int getFreeBuffer (Array<AssignedBuffer>& buffers) const
     {
-        for (int i = 1; i < buffers.size(); ++i)
-            if (buffers.getReference (i).isFree())
-                return i;
+        if (reuseFreeBuffers)
+            for (int i = 1; i < buffers.size(); ++i)
+                if (buffers.getReference (i).isFree())
+                    return i;
 
         buffers.add (AssignedBuffer::createFree());
         return buffers.size() - 1;
@@ -932,6 +1426,7 @@ void AudioProcessorGraph::Node::setBypassed (bool shouldBeBypassed) noexcept
 //==============================================================================
 struct AudioProcessorGraph::RenderSequenceFloat   : public GraphRenderSequence<float> {};
 struct AudioProcessorGraph::RenderSequenceDouble  : public GraphRenderSequence<double> {};
+struct AudioProcessorGraph::RenderThreadPool      : public GraphRenderThreadPool { using GraphRenderThreadPool::GraphRenderThreadPool; };
 
 //==============================================================================
 AudioProcessorGraph::AudioProcessorGraph()
@@ -1278,8 +1773,10 @@ void AudioProcessorGraph::buildRenderingSequence()
     auto newSequenceF = std::make_unique<RenderSequenceFloat>();
     auto newSequenceD = std::make_unique<RenderSequenceDouble>();
 
-    RenderSequenceBuilder<RenderSequenceFloat>  builderF (*this, *newSequenceF);
-    RenderSequenceBuilder<RenderSequenceDouble> builderD (*this, *newSequenceD);
+    const auto buildForParallelRendering = (renderThreadPool != nullptr);
+
+    RenderSequenceBuilder<RenderSequenceFloat>  builderF (*this, *newSequenceF, buildForParallelRendering);
+    RenderSequenceBuilder<RenderSequenceDouble> builderD (*this, *newSequenceD, buildForParallelRendering);
 
     const ScopedLock sl (getCallbackLock());
 
@@ -1341,6 +1838,11 @@ bool AudioProcessorGraph::supportsDoublePrecisionProcessing() const
     return true;
 }
 
+bool AudioProcessorGraph::supportsUniversalMidiPackets() const
+{
+    return true;
+}
+
 void AudioProcessorGraph::unprepare()
 {
     prepareSettings.valid = false;
@@ -1390,10 +1892,44 @@ bool AudioProcessorGraph::producesMidi() const                      { return tru
 void AudioProcessorGraph::getStateInformation (MemoryBlock&)        {}
 void AudioProcessorGraph::setStateInformation (const void*, int)    {}
 
-template <typename FloatType, typename SequenceType>
-static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages,
+//==============================================================================
+void AudioProcessorGraph::setNumParallelRenderThreads (int numWorkerThreads)
+{
+    jassert (numWorkerThreads >= 0);
+    numWorkerThreads = jmax (0, numWorkerThreads);
+
+    if (numWorkerThreads == getNumParallelRenderThreads())
+        return;
+
+    std::unique_ptr<RenderThreadPool> newPool;
+
+    if (numWorkerThreads > 0)
+        newPool = std::make_unique<RenderThreadPool> (numWorkerThreads);
+
+    {
+        const ScopedLock sl (getCallbackLock());
+        std::swap (renderThreadPool, newPool);
+    }
+
+    // The existing sequence can still be rendered serially, but needs rebuilding
+    // before it can take advantage of the new threads
+    if (isPrepared)
+        updateOnMessageThread (*this);
+}
+
+int AudioProcessorGraph::getNumParallelRenderThreads() const noexcept
+{
+    return renderThreadPool != nullptr ? renderThreadPool->getNumWorkerThreads() : 0;
+}
+
+//==============================================================================
+// The thread pool is only read while holding the callback lock, because
+// setNumParallelRenderThreads() replaces it under that lock
+template <typename FloatType, typename MidiBufferType, typename SequenceType, typename ThreadPoolType>
+static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBufferType& midiMessages,
                                    AudioProcessorGraph& graph,
                                    std::unique_ptr<SequenceType>& renderSequence,
+                                   std::unique_ptr<ThreadPoolType>& threadPool,
                                    std::atomic<bool>& isPrepared)
 {
     if (graph.isNonRealtime())
@@ -1404,7 +1940,7 @@ static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& m
         const ScopedLock sl (graph.getCallbackLock());
 
         if (renderSequence != nullptr)
-            renderSequence->perform (buffer, midiMessages, graph.getPlayHead());
+            renderSequence->perform (buffer, midiMessages, graph.getPlayHead(), threadPool.get());
     }
     else
     {
@@ -1413,7 +1949,7 @@ static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& m
         if (isPrepared)
         {
             if (renderSequence != nullptr)
-                renderSequence->perform (buffer, midiMessages, graph.getPlayHead());
+                renderSequence->perform (buffer, midiMessages, graph.getPlayHead(), threadPool.get());
         }
         else
         {
@@ -1428,7 +1964,7 @@ void AudioProcessorGraph::processBlock (AudioBuffer<float>& buffer, MidiBuffer&
     if ((! isPrepared) && MessageManager::getInstance()->isThisTheMessageThread())
         handleAsyncUpdate();
 
-    processBlockForBuffer<float> (buffer, midiMessages, *this, renderSequenceFloat, isPrepared);
+    processBlockForBuffer<float> (buffer, midiMessages, *this, renderSequenceFloat, renderThreadPool, isPrepared);
 }
 
 void AudioProcessorGraph::processBlock (AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
@@ -1436,7 +1972,23 @@ void AudioProcessorGraph::processBlock (AudioBuffer<double>& buffer, MidiBuffer&
     if ((! isPrepared) && MessageManager::getInstance()->isThisTheMessageThread())
         handleAsyncUpdate();
 
-    processBlockForBuffer<double> (buffer, midiMessages, *this, renderSequenceDouble, isPrepared);
+    processBlockForBuffer<double> (buffer, midiMessages, *this, renderSequenceDouble, renderThreadPool, isPrepared);
+}
+
+void AudioProcessorGraph::processBlockUMP (AudioBuffer<float>& buffer, UMPBuffer& midiMessages)
+{
+    if ((! isPrepared) && MessageManager::getInstance()->isThisTheMessageThread())
+        handleAsyncUpdate();
+
+    processBlockForBuffer<float> (buffer, midiMessages, *this, renderSequenceFloat, renderThreadPool, isPrepared);
+}
+
+void AudioProcessorGraph::processBlockUMP (AudioBuffer<double>& buffer, UMPBuffer& midiMessages)
+{
+    if ((! isPrepared) && MessageManager::getInstance()->isThisTheMessageThread())
+        handleAsyncUpdate();
+
+    processBlockForBuffer<double> (buffer, midiMessages, *this, renderSequenceDouble, renderThreadPool, isPrepared);
 }
 
 //==============================================================================
@@ -1501,7 +2053,7 @@ bool AudioProcessorGraph::AudioGraphIOProcessor::supportsDoublePrecisionProcessi
 
 template <typename FloatType, typename SequenceType>
 static void processIOBlock (AudioProcessorGraph::AudioGraphIOProcessor& io, SequenceType& sequence,
-                            AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages)
+                            AudioBuffer<FloatType>& buffer)
 {
     switch (io.getType())
     {
@@ -1525,29 +2077,24 @@ static void processIOBlock (AudioProcessorGraph::AudioGraphIOProcessor& io, Sequ
             break;
         }
 
+        // The MIDI nodes are handled by the render sequence's ProcessOp
         case AudioProcessorGraph::AudioGraphIOProcessor::midiOutputNode:
-            sequence.currentMidiOutputBuffer.addEvents (midiMessages, 0, buffer.getNumSamples(), 0);
-            break;
-
         case AudioProcessorGraph::AudioGraphIOProcessor::midiInputNode:
-            midiMessages.addEvents (*sequence.currentMidiInputBuffer, 0, buffer.getNumSamples(), 0);
-            break;
-
         default:
             break;
     }
 }
 
-void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
+void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioBuffer<float>& buffer, MidiBuffer&)
 {
     jassert (graph != nullptr);
-    processIOBlock (*this, *graph->renderSequenceFloat, buffer, midiMessages);
+    processIOBlock (*this, *graph->renderSequenceFloat, buffer);
 }
 
-void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioBuffer<double>& buffer, MidiBuffer& midiMessages)
+void AudioProcessorGraph::AudioGraphIOProcessor::processBlock (AudioBuffer<double>& buffer, MidiBuffer&)
 {
     jassert (graph != nullptr);
-    processIOBlock (*this, *graph->renderSequenceDouble, buffer, midiMessages);
+    processIOBlock (*this, *graph->renderSequenceDouble, buffer);
 }
 
 double AudioProcessorGraph::AudioGraphIOProcessor::getTailLengthSeconds() const
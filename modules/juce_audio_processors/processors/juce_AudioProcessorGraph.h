@@ -155,10 +155,10 @@ public:
         void prepare (double newSampleRate, int newBlockSize, AudioProcessorGraph*, ProcessingPrecision);
         void unprepare();
 
-        template <typename Sample>
+        template <typename Sample, typename MidiBufferType>
         void callProcessFunction (AudioBuffer<Sample>& audio,
-                                  MidiBuffer& midi,
-                                  void (AudioProcessor::* function) (AudioBuffer<Sample>&, MidiBuffer&))
+                                  MidiBufferType& midi,
+                                  void (AudioProcessor::* function) (AudioBuffer<Sample>&, MidiBufferType&))
         {
             const ScopedLock lock (processorLock);
             (processor.get()->*function) (audio, midi);
@@ -176,6 +176,18 @@ public:
             callProcessFunction (audio, midi, &AudioProcessor::processBlockBypassed);
         }
 
+        template <typename Sample>
+        void processBlock (AudioBuffer<Sample>& audio, UMPBuffer& midi)
+        {
+            callProcessFunction (audio, midi, &AudioProcessor::processBlockUMP);
+        }
+
+        template <typename Sample>
+        void processBlockBypassed (AudioBuffer<Sample>& audio, UMPBuffer& midi)
+        {
+            callProcessFunction (audio, midi, &AudioProcessor::processBlockBypassedUMP);
+        }
+
         CriticalSection processorLock;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Node)
@@ -300,6 +312,24 @@ public:
     */
     bool removeIllegalConnections();
 
+    //==============================================================================
+    /** Allows nodes that don't depend on each other to be rendered concurrently.
+
+        When this is non-zero, the graph starts the given number of realtime worker
+        threads, which help the audio thread to render each block. Nodes are run as
+        soon as all of the nodes feeding into them have finished, so a wide graph with
+        many independent branches can make use of several cores.
+
+        Each node is given its own buffers in this mode, so the graph will use more
+        memory than when rendering serially. The output is identical in both modes.
+
+        The default is 0, which renders every node in turn on the audio thread.
+    */
+    void setNumParallelRenderThreads (int numWorkerThreads);
+
+    /** Returns the number of worker threads set with setNumParallelRenderThreads(). */
+    int getNumParallelRenderThreads() const noexcept;
+
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
         in order to use the audio that comes into and out of the graph itself.
@@ -394,6 +424,18 @@ public:
     void processBlock (AudioBuffer<double>&, MidiBuffer&) override;
     bool supportsDoublePrecisionProcessing() const override;
 
+    /** Renders the graph with its MIDI input and output as Universal MIDI Packets.
+
+        Inside the graph, each connection carries the events in whichever format its
+        source node produced them, and they're only converted when they reach a node
+        in the other format. So packets flowing between nodes that return true from
+        supportsUniversalMidiPackets() are never translated to MIDI 1.0, and a chain of
+        MIDI 1.0 nodes never sees a packet.
+    */
+    void processBlockUMP (AudioBuffer<float>&,  UMPBuffer&) override;
+    void processBlockUMP (AudioBuffer<double>&, UMPBuffer&) override;
+    bool supportsUniversalMidiPackets() const override;
+
     void reset() override;
     void setNonRealtime (bool) noexcept override;
 
@@ -439,6 +481,9 @@ private:
     std::unique_ptr<RenderSequenceFloat> renderSequenceFloat;
     std::unique_ptr<RenderSequenceDouble> renderSequenceDouble;
 
+    struct RenderThreadPool;
+    std::unique_ptr<RenderThreadPool> renderThreadPool;
+
     PrepareSettings prepareSettings;
 
     friend class AudioGraphIOProcessor;
@@ -0,0 +1,497 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace AudioProcessorGraphTestHelpers
+{
+
+/*  A stereo processor that runs its input through a few one-pole filters, so that
+    each node does a deterministic amount of work and its output depends on its
+    input and on its own state.
+*/
+class FilterProcessor  : public AudioProcessor
+{
+public:
+    FilterProcessor (float coefficientToUse, int numPassesToUse, int latency = 0)
+        : AudioProcessor (BusesProperties().withInput  ("Input",  AudioChannelSet::stereo())
+                                           .withOutput ("Output", AudioChannelSet::stereo())),
+          coefficient (coefficientToUse),
+          numPasses (numPassesToUse)
+    {
+        setLatencySamples (latency);
+    }
+
+    const String getName() const override                  { return "Filter"; }
+    void prepareToPlay (double, int) override               { std::fill (std::begin (state), std::end (state), 0.0f); }
+    void releaseResources() override                        {}
+
+    using AudioProcessor::processBlock;
+
+    void processBlock (AudioBuffer<float>& buffer, MidiBuffer&) override
+    {
+        for (int channel = 0; channel < jmin (2, buffer.getNumChannels()); ++channel)
+        {
+            auto* data = buffer.getWritePointer (channel);
+            auto s = state[channel];
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                auto x = data[i];
+
+                for (int pass = 0; pass < numPasses; ++pass)
+                {
+                    s += coefficient * (x - s);
+                    x = s;
+                }
+
+                data[i] = x;
+            }
+
+            state[channel] = s;
+        }
+    }
+
+    double getTailLengthSeconds() const override            { return 0.0; }
+    bool acceptsMidi() const override                       { return false; }
+    bool producesMidi() const override                      { return false; }
+    AudioProcessorEditor* createEditor() override           { return nullptr; }
+    bool hasEditor() const override                         { return false; }
+    int getNumPrograms() override                           { return 1; }
+    int getCurrentProgram() override                        { return 0; }
+    void setCurrentProgram (int) override                   {}
+    const String getProgramName (int) override              { return {}; }
+    void changeProgramName (int, const String&) override    {}
+    void getStateInformation (MemoryBlock&) override        {}
+    void setStateInformation (const void*, int) override    {}
+
+private:
+    const float coefficient;
+    const int numPasses;
+    float state[2] {};
+};
+
+struct TestGraph
+{
+    TestGraph (double sampleRate, int blockSize)
+    {
+        graph.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+
+        input  = graph.addNode (std::make_unique<AudioProcessorGraph::AudioGraphIOProcessor> (AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode));
+        output = graph.addNode (std::make_unique<AudioProcessorGraph::AudioGraphIOProcessor> (AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode));
+        midiIn  = graph.addNode (std::make_unique<AudioProcessorGraph::AudioGraphIOProcessor> (AudioProcessorGraph::AudioGraphIOProcessor::midiInputNode));
+        midiOut = graph.addNode (std::make_unique<AudioProcessorGraph::AudioGraphIOProcessor> (AudioProcessorGraph::AudioGraphIOProcessor::midiOutputNode));
+
+        graph.addConnection ({ { midiIn->nodeID,  AudioProcessorGraph::midiChannelIndex },
+                               { midiOut->nodeID, AudioProcessorGraph::midiChannelIndex } });
+    }
+
+    void connectStereo (AudioProcessorGraph::NodeID source, AudioProcessorGraph::NodeID dest)
+    {
+        for (int channel = 0; channel < 2; ++channel)
+            graph.addConnection ({ { source, channel }, { dest, channel } });
+    }
+
+    /*  Builds a layered graph where each node takes its input from one or more
+        random nodes in the layers above it.
+    */
+    void buildRandomLayers (Random& random, int numLayers, int nodesPerLayer, int numPasses)
+    {
+        Array<AudioProcessorGraph::NodeID> previousLayers { input->nodeID };
+
+        for (int layer = 0; layer < numLayers; ++layer)
+        {
+            Array<AudioProcessorGraph::NodeID> thisLayer;
+
+            for (int i = 0; i < nodesPerLayer; ++i)
+            {
+                auto node = graph.addNode (std::make_unique<FilterProcessor> (0.05f + 0.9f * random.nextFloat(),
+                                                                              numPasses,
+                                                                              random.nextInt (4) == 0 ? random.nextInt (100) : 0));
+
+                for (int numSources = 1 + random.nextInt (3); --numSources >= 0;)
+                    connectStereo (previousLayers[random.nextInt (previousLayers.size())], node->nodeID);
+
+                thisLayer.add (node->nodeID);
+            }
+
+            previousLayers.addArray (thisLayer);
+        }
+
+        for (auto nodeID : previousLayers)
+            if (random.nextBool())
+                connectStereo (nodeID, output->nodeID);
+    }
+
+    /*  Builds a graph where every node is fed directly from the input and mixed
+        straight into the output.
+    */
+    void buildWide (int numNodes, int numPasses)
+    {
+        for (int i = 0; i < numNodes; ++i)
+        {
+            auto node = graph.addNode (std::make_unique<FilterProcessor> (0.1f + 0.8f * (float) i / (float) numNodes, numPasses));
+            connectStereo (input->nodeID, node->nodeID);
+            connectStereo (node->nodeID, output->nodeID);
+        }
+    }
+
+    AudioProcessorGraph graph;
+    AudioProcessorGraph::Node::Ptr input, output, midiIn, midiOut;
+};
+
+/*  A MIDI effect that moves its notes up by a semitone, and counts the blocks that it
+    is given as MIDI 1.0 messages and as Universal MIDI Packets.
+*/
+class TransposeProcessor  : public AudioProcessor
+{
+public:
+    explicit TransposeProcessor (bool handlesPackets)
+        : AudioProcessor (BusesProperties()),
+          usesPackets (handlesPackets)
+    {}
+
+    const String getName() const override                  { return "Transpose"; }
+    void prepareToPlay (double, int) override               {}
+    void releaseResources() override                        {}
+
+    bool supportsUniversalMidiPackets() const override      { return usesPackets; }
+
+    using AudioProcessor::processBlock;
+    using AudioProcessor::processBlockUMP;
+
+    void processBlock (AudioBuffer<float>&, MidiBuffer& midi) override
+    {
+        ++numMessageBlocks;
+        MidiBuffer result;
+
+        for (const auto metadata : midi)
+        {
+            auto message = metadata.getMessage();
+
+            if (message.isNoteOnOrOff())
+                message.setNoteNumber (message.getNoteNumber() + 1);
+
+            result.addEvent (message, metadata.samplePosition);
+        }
+
+        midi.swapWith (result);
+    }
+
+    void processBlockUMP (AudioBuffer<float>&, UMPBuffer& packets) override
+    {
+        ++numPacketBlocks;
+        UMPBuffer result;
+
+        for (const auto event : packets)
+        {
+            uint32 words[4] {};
+            std::copy (event.data, event.data + event.numWords, words);
+
+            const auto status = (words[0] >> 20) & 0xf;
+
+            if ((words[0] >> 28) == 0x4 && (status == 0x8 || status == 0x9))
+                words[0] += 1 << 8;
+
+            result.addEvent (words, event.samplePosition);
+        }
+
+        packets.swapWith (result);
+    }
+
+    double getTailLengthSeconds() const override            { return 0.0; }
+    bool acceptsMidi() const override                       { return true; }
+    bool producesMidi() const override                      { return true; }
+    AudioProcessorEditor* createEditor() override           { return nullptr; }
+    bool hasEditor() const override                         { return false; }
+    int getNumPrograms() override                           { return 1; }
+    int getCurrentProgram() override                        { return 0; }
+    void setCurrentProgram (int) override                   {}
+    const String getProgramName (int) override              { return {}; }
+    void changeProgramName (int, const String&) override    {}
+    void getStateInformation (MemoryBlock&) override        {}
+    void setStateInformation (const void*, int) override    {}
+
+    int numMessageBlocks = 0, numPacketBlocks = 0;
+
+private:
+    const bool usesPackets;
+};
+
+/*  A graph that passes its MIDI input through a chain of TransposeProcessors. */
+struct MidiChainGraph
+{
+    MidiChainGraph (double sampleRate, int blockSize, std::initializer_list<bool> nodesHandlePackets)
+    {
+        using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
+
+        graph.setPlayConfigDetails (0, 0, sampleRate, blockSize);
+
+        auto previous = graph.addNode (std::make_unique<IOProcessor> (IOProcessor::midiInputNode))->nodeID;
+
+        for (auto handlesPackets : nodesHandlePackets)
+        {
+            auto node = graph.addNode (std::make_unique<TransposeProcessor> (handlesPackets));
+            connect (previous, node->nodeID);
+            transposers.push_back (static_cast<TransposeProcessor*> (node->getProcessor()));
+            previous = node->nodeID;
+        }
+
+        connect (previous, graph.addNode (std::make_unique<IOProcessor> (IOProcessor::midiOutputNode))->nodeID);
+    }
+
+    void connect (AudioProcessorGraph::NodeID source, AudioProcessorGraph::NodeID dest)
+    {
+        graph.addConnection ({ { source, AudioProcessorGraph::midiChannelIndex },
+                               { dest,   AudioProcessorGraph::midiChannelIndex } });
+    }
+
+    AudioProcessorGraph graph;
+    std::vector<TransposeProcessor*> transposers;
+};
+
+static void fillWithNoise (AudioBuffer<float>& buffer, Random& random)
+{
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+}
+
+} // namespace AudioProcessorGraphTestHelpers
+
+//==============================================================================
+class AudioProcessorGraphTests  : public UnitTest
+{
+public:
+    AudioProcessorGraphTests()
+        : UnitTest ("AudioProcessorGraph", UnitTestCategories::audioProcessors)
+    {}
+
+    void runTest() override
+    {
+        using namespace AudioProcessorGraphTestHelpers;
+
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 256;
+
+        beginTest ("Parallel rendering produces the same output as serial rendering");
+        {
+            const auto seed = getRandom().nextInt64();
+
+            for (auto numThreads : { 1, 3 })
+            {
+                Random serialRandom (seed), parallelRandom (seed), signalRandom (seed);
+
+                TestGraph serial (sampleRate, blockSize), parallel (sampleRate, blockSize);
+                serial.buildRandomLayers (serialRandom, 5, 6, 2);
+                parallel.buildRandomLayers (parallelRandom, 5, 6, 2);
+
+                parallel.graph.setNumParallelRenderThreads (numThreads);
+                expectEquals (parallel.graph.getNumParallelRenderThreads(), numThreads);
+
+                serial.graph.prepareToPlay (sampleRate, blockSize);
+                parallel.graph.prepareToPlay (sampleRate, blockSize);
+
+                AudioBuffer<float> serialBuffer (2, blockSize), parallelBuffer (2, blockSize);
+                MidiBuffer serialMidi, parallelMidi;
+
+                for (int block = 0; block < 20; ++block)
+                {
+                    fillWithNoise (serialBuffer, signalRandom);
+                    parallelBuffer.makeCopyOf (serialBuffer);
+
+                    serialMidi.clear();
+                    serialMidi.addEvent (MidiMessage::noteOn (1, block, 0.5f), block);
+                    parallelMidi = serialMidi;
+
+                    serial.graph.processBlock (serialBuffer, serialMidi);
+                    parallel.graph.processBlock (parallelBuffer, parallelMidi);
+
+                    for (int channel = 0; channel < 2; ++channel)
+                        expect (std::equal (serialBuffer.getReadPointer (channel),
+                                            serialBuffer.getReadPointer (channel) + blockSize,
+                                            parallelBuffer.getReadPointer (channel)));
+
+                    expectEquals (parallelMidi.getNumEvents(), serialMidi.getNumEvents());
+                }
+
+                parallel.graph.releaseResources();
+                serial.graph.releaseResources();
+            }
+        }
+
+        beginTest ("Render threads can be added and removed while prepared");
+        {
+            TestGraph test (sampleRate, blockSize);
+            test.buildWide (8, 1);
+            test.graph.prepareToPlay (sampleRate, blockSize);
+
+            AudioBuffer<float> buffer (2, blockSize);
+            MidiBuffer midi;
+
+            for (auto numThreads : { 2, 0, 4, 1, 0 })
+            {
+                test.graph.setNumParallelRenderThreads (numThreads);
+                expectEquals (test.graph.getNumParallelRenderThreads(), numThreads);
+
+                buffer.clear();
+                buffer.setSample (0, 0, 1.0f);
+                test.graph.processBlock (buffer, midi);
+
+                expect (buffer.getMagnitude (0, 0, blockSize) > 0.0f);
+                expectEquals (buffer.getMagnitude (1, 0, blockSize), 0.0f);
+            }
+        }
+
+        beginTest ("Packets pass between nodes that support them without being converted");
+        {
+            for (auto numThreads : { 0, 2 })
+            {
+                MidiChainGraph test (sampleRate, blockSize, { true, true });
+                test.graph.setNumParallelRenderThreads (numThreads);
+                test.graph.prepareToPlay (sampleRate, blockSize);
+
+                AudioBuffer<float> buffer (0, blockSize);
+                // A MIDI 2.0 note-on for note 60, with a 16-bit velocity of 0x1234
+                const uint32 noteOn[] { 0x40903c00, 0x12340000 };
+
+                UMPBuffer packets;
+                packets.addEvent (noteOn, 10);
+
+                test.graph.processBlockUMP (buffer, packets);
+
+                expectEquals (packets.getNumEvents(), 1);
+
+                const auto event = *packets.begin();
+                expectEquals (event.samplePosition, 10);
+                expectEquals ((int) ((event.data[0] >> 8) & 0x7f), 62);
+
+                // A velocity that can't be represented in MIDI 1.0 arrives intact
+                expectEquals ((int) (event.data[1] >> 16), 0x1234);
+
+                for (auto* transposer : test.transposers)
+                {
+                    expectEquals (transposer->numPacketBlocks, 1);
+                    expectEquals (transposer->numMessageBlocks, 0);
+                }
+
+                test.graph.releaseResources();
+            }
+        }
+
+        beginTest ("Events are converted where MIDI 1.0 nodes meet nodes that use packets");
+        {
+            MidiChainGraph test (sampleRate, blockSize, { true, false, true, true, false });
+            test.graph.prepareToPlay (sampleRate, blockSize);
+
+            AudioBuffer<float> buffer (0, blockSize);
+            MidiBuffer midi;
+            midi.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 5);
+            midi.addEvent (MidiMessage::controllerEvent (1, 7, 64), 6);
+
+            test.graph.processBlock (buffer, midi);
+
+            MidiBuffer expected;
+            expected.addEvent (MidiMessage::noteOn (1, 65, (uint8) 100), 5);
+            expected.addEvent (MidiMessage::controllerEvent (1, 7, 64), 6);
+
+            expectEquals (midi.getNumEvents(), expected.getNumEvents());
+            expect (std::equal (midi.data.begin(), midi.data.end(), expected.data.begin(), expected.data.end()));
+
+            expectEquals (test.transposers[0]->numPacketBlocks,  1);
+            expectEquals (test.transposers[1]->numMessageBlocks, 1);
+            expectEquals (test.transposers[2]->numPacketBlocks,  1);
+            expectEquals (test.transposers[3]->numPacketBlocks,  1);
+            expectEquals (test.transposers[4]->numMessageBlocks, 1);
+
+            test.graph.releaseResources();
+        }
+    }
+};
+
+static AudioProcessorGraphTests audioProcessorGraphTests;
+
+//==============================================================================
+class AudioProcessorGraphBenchmarks  : public UnitTest
+{
+public:
+    AudioProcessorGraphBenchmarks()
+        : UnitTest ("AudioProcessorGraph parallel rendering", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        using namespace AudioProcessorGraphTestHelpers;
+
+        constexpr double sampleRate = 48000.0;
+        constexpr int numNodes = 64;
+        constexpr int numPasses = 16;
+        const auto maxThreads = SystemStats::getNumCpus();
+
+        for (auto blockSize : { 32, 64, 128 })
+        {
+            beginTest ("Wide graph, " + String (numNodes) + " nodes, block size " + String (blockSize));
+
+            TestGraph test (sampleRate, blockSize);
+            test.buildWide (numNodes, numPasses);
+            test.graph.prepareToPlay (sampleRate, blockSize);
+
+            AudioBuffer<float> buffer (2, blockSize);
+            MidiBuffer midi;
+            Random random (1);
+            double serialTime = 0.0;
+
+            for (int numThreads = 1; numThreads <= maxThreads; ++numThreads)
+            {
+                test.graph.setNumParallelRenderThreads (numThreads - 1);
+
+                const auto numBlocks = (int) (sampleRate * 2.0) / blockSize;
+                const auto start = Time::getHighResolutionTicks();
+
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    fillWithNoise (buffer, random);
+                    test.graph.processBlock (buffer, midi);
+                }
+
+                const auto microsecondsPerBlock = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start)
+                                                    * 1.0e6 / numBlocks;
+
+                if (numThreads == 1)
+                    serialTime = microsecondsPerBlock;
+
+                logMessage (String (numThreads) + " thread(s): " + String (microsecondsPerBlock, 2)
+                              + " us per block, speedup " + String (serialTime / microsecondsPerBlock, 2) + "x");
+            }
+
+            expect (serialTime > 0.0);
+        }
+    }
+};
+
+static AudioProcessorGraphBenchmarks audioProcessorGraphBenchmarks;
+
+} // namespace juce
@@ -33,6 +33,8 @@ void KnownPluginList::clear()
 {
     ScopedLock lock (typesArrayLock);
 
+    scannedFiles.clear();
+
     if (! types.isEmpty())
     {
         types.clear();
@@ -123,9 +125,106 @@ void KnownPluginList::removeType (const PluginDescription& type)
     sendChangeMessage();
 }
 
+//==============================================================================
+struct ScanCacheHelpers
+{
+    // Finds the total size and latest modification time of a file or bundle. Identifiers
+    // that aren't absolute paths, such as AudioUnit IDs, can't be cached.
+    static bool getFileSignature (const String& fileOrIdentifier, int64& size, int64& modificationTime)
+    {
+        if (! File::isAbsolutePath (fileOrIdentifier))
+            return false;
+
+        const File file (fileOrIdentifier);
+
+        if (! file.exists())
+            return false;
+
+        size = file.getSize();
+        modificationTime = file.getLastModificationTime().toMilliseconds();
+
+        if (file.isDirectory())
+        {
+            for (const auto& entry : RangedDirectoryIterator (file, true, "*", File::findFiles))
+            {
+                size += entry.getFileSize();
+                modificationTime = jmax (modificationTime, entry.getModificationTime().toMilliseconds());
+            }
+        }
+
+        return true;
+    }
+
+    static bool matches (const PluginDescription& desc, const String& fileOrIdentifier, AudioPluginFormat& format)
+    {
+        return desc.fileOrIdentifier == fileOrIdentifier && desc.pluginFormatName == format.getName();
+    }
+};
+
+bool KnownPluginList::getUnchangedTypesForFile (const String& fileOrIdentifier,
+                                                AudioPluginFormat& format,
+                                                OwnedArray<PluginDescription>* typesFound) const
+{
+    int64 size = 0, modificationTime = 0;
+
+    if (! ScanCacheHelpers::getFileSignature (fileOrIdentifier, size, modificationTime))
+        return false;
+
+    ScopedLock lock (typesArrayLock);
+
+    const auto cached = scannedFiles.find ({ format.getName(), fileOrIdentifier });
+
+    if (cached == scannedFiles.end()
+         || cached->second.size != size
+         || cached->second.modificationTime != modificationTime)
+        return false;
+
+    // If some of the types have been removed from the list since the file was
+    // scanned, it needs scanning again to get them back
+    Array<const PluginDescription*> matchingTypes;
+
+    for (auto& d : types)
+        if (ScanCacheHelpers::matches (d, fileOrIdentifier, format))
+            matchingTypes.add (&d);
+
+    if (matchingTypes.size() != cached->second.numTypes)
+        return false;
+
+    if (typesFound != nullptr)
+        for (auto* d : matchingTypes)
+            typesFound->add (new PluginDescription (*d));
+
+    return true;
+}
+
+void KnownPluginList::addToScanCache (const String& fileOrIdentifier,
+                                      AudioPluginFormat& format,
+                                      const ScannedFile& signature)
+{
+    ScopedLock lock (typesArrayLock);
+
+    auto entry = signature;
+    entry.numTypes = 0;
+
+    for (auto& d : types)
+        if (ScanCacheHelpers::matches (d, fileOrIdentifier, format))
+            ++entry.numTypes;
+
+    scannedFiles[{ format.getName(), fileOrIdentifier }] = entry;
+}
+
+void KnownPluginList::clearScanCache()
+{
+    ScopedLock lock (typesArrayLock);
+    scannedFiles.clear();
+}
+
 bool KnownPluginList::isListingUpToDate (const String& fileOrIdentifier,
                                          AudioPluginFormat& formatToUse) const
 {
+    if (getUnchangedTypesForFile (fileOrIdentifier, formatToUse, nullptr))
+        return true;
+
     if (getTypeForFile (fileOrIdentifier) == nullptr)
         return false;
 
@@ -151,6 +250,9 @@ bool KnownPluginList::scanAndAddFile (const String& fileOrIdentifier,
 {
     const ScopedLock sl (scanLock);
 
+    if (dontRescanIfAlreadyInList && getUnchangedTypesForFile (fileOrIdentifier, format, &typesFound))
+        return false;
+
     if (dontRescanIfAlreadyInList
          && getTypeForFile (fileOrIdentifier) != nullptr)
     {
@@ -173,18 +275,33 @@ bool KnownPluginList::scanAndAddFile (const String& fileOrIdentifier,
             return false;
     }
 
-    if (blacklist.contains (fileOrIdentifier))
-        return false;
+    {
+        ScopedLock lock (typesArrayLock);
+
+        if (blacklist.contains (fileOrIdentifier))
+            return false;
+    }
 
     OwnedArray<PluginDescription> found;
+    ScannedFile signature;
+    bool canCache = false;
 
     {
         const ScopedUnlock sl2 (scanLock);
 
+        canCache = ScanCacheHelpers::getFileSignature (fileOrIdentifier, signature.size, signature.modificationTime);
+
         if (scanner != nullptr)
         {
             if (! scanner->findPluginTypesFor (format, found, fileOrIdentifier))
+            {
                 addToBlacklist (fileOrIdentifier);
+                canCache = false;
+            }
+
+            // An abandoned scan doesn't tell us anything about the file
+            if (scanner->shouldExit())
+                canCache = false;
         }
         else
         {
@@ -204,6 +321,9 @@ bool KnownPluginList::scanAndAddFile (const String& fileOrIdentifier,
         typesFound.add (new PluginDescription (*desc));
     }
 
+    if (canCache)
+        addToScanCache (fileOrIdentifier, format, signature);
+
     return ! found.isEmpty();
 }
 
@@ -250,38 +370,53 @@ void KnownPluginList::scanFinished()
         scanner->scanFinished();
 }
 
-const StringArray& KnownPluginList::getBlacklistedFiles() const
+StringArray KnownPluginList::getBlacklistedFiles() const
 {
+    ScopedLock lock (typesArrayLock);
     return blacklist;
 }
 
 void KnownPluginList::addToBlacklist (const String& pluginID)
 {
-    if (! blacklist.contains (pluginID))
     {
+        ScopedLock lock (typesArrayLock);
+
+        if (blacklist.contains (pluginID))
+            return;
+
         blacklist.add (pluginID);
-        sendChangeMessage();
     }
+
+    sendChangeMessage();
 }
 
 void KnownPluginList::removeFromBlacklist (const String& pluginID)
 {
-    const int index = blacklist.indexOf (pluginID);
-
-    if (index >= 0)
     {
+        ScopedLock lock (typesArrayLock);
+        const int index = blacklist.indexOf (pluginID);
+
+        if (index < 0)
+            return;
+
         blacklist.remove (index);
-        sendChangeMessage();
     }
+
+    sendChangeMessage();
 }
 
 void KnownPluginList::clearBlacklistedFiles()
 {
-    if (blacklist.size() > 0)
     {
+        ScopedLock lock (typesArrayLock);
+
+        if (blacklist.isEmpty())
+            return;
+
         blacklist.clear();
-        sendChangeMessage();
     }
+
+    sendChangeMessage();
 }
 
 //==============================================================================
@@ -368,10 +503,20 @@ std::unique_ptr<XmlElement> KnownPluginList::createXml() const
 
         for (int i = types.size(); --i >= 0;)
             e->prependChildElement (types.getUnchecked (i).createXml().release());
-    }
 
-    for (auto& b : blacklist)
-        e->createNewChildElement ("BLACKLISTED")->setAttribute ("id", b);
+        for (auto& b : blacklist)
+            e->createNewChildElement ("BLACKLISTED")->setAttribute ("id", b);
+
+        for (auto& scanned : scannedFiles)
+        {
+            auto* f = e->createNewChildElement ("SCANNED");
+            f->setAttribute ("format", scanned.first.first);
+            f->setAttribute ("file", scanned.first.second);
+            f->setAttribute ("size", String (scanned.second.size));
+            f->setAttribute ("modified", String::toHexString (scanned.second.modificationTime));
+            f->setAttribute ("numTypes", scanned.second.numTypes);
+        }
+    }
 
     return e;
 }
@@ -388,9 +533,24 @@ void KnownPluginList::recreateFromXml (const XmlElement& xml)
             PluginDescription info;
 
             if (e->hasTagName ("BLACKLISTED"))
+            {
+                ScopedLock lock (typesArrayLock);
                 blacklist.add (e->getStringAttribute ("id"));
+            }
+            else if (e->hasTagName ("SCANNED"))
+            {
+                ScannedFile scanned;
+                scanned.size = e->getStringAttribute ("size").getLargeIntValue();
+                scanned.modificationTime = e->getStringAttribute ("modified").getHexValue64();
+                scanned.numTypes = e->getIntAttribute ("numTypes");
+
+                ScopedLock lock (typesArrayLock);
+                scannedFiles[{ e->getStringAttribute ("format"), e->getStringAttribute ("file") }] = scanned;
+            }
             else if (info.loadFromXml (*e))
+            {
                 addType (info);
+            }
         }
     }
 }
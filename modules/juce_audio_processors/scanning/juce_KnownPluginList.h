@@ -48,7 +48,10 @@ public:
     ~KnownPluginList() override;
 
     //==============================================================================
-    /** Clears the list. */
+    /** Clears the list.
+        This also clears the record of which files have been scanned, so that the
+        next scan will load every file again.
+    */
     void clear();
 
     /** Adds a type manually from its description. */
@@ -84,9 +87,19 @@ public:
         time has changed since the list was created. If dontRescanIfAlreadyInList is
         false, the file will always be reloaded and tested.
 
+        The list remembers the size and modification time of each file that it scans,
+        and when dontRescanIfAlreadyInList is true, a file whose size and modification
+        time haven't changed since it was last scanned won't be loaded again, even if
+        it didn't contain any plugins. This record is saved by createXml(), so it
+        persists between sessions.
+
         Returns true if any new types were added, and all the types found in this
         file (even if it was already known and hasn't been re-scanned) get returned
         in the array.
+
+        This may be called from several threads at once, in which case the files are
+        scanned concurrently. If you've supplied a CustomScanner, it must be able to
+        handle concurrent calls to CustomScanner::findPluginTypesFor().
     */
     bool scanAndAddFile (const String& possiblePluginFileOrIdentifier,
                          bool dontRescanIfAlreadyInList,
@@ -98,6 +111,9 @@ public:
 
     /** Returns true if the specified file is already known about and if it
         hasn't been modified since our entry was created.
+
+        This also returns true for a file that didn't contain any plugins when it was
+        last scanned, if its size and modification time haven't changed since.
     */
     bool isListingUpToDate (const String& possiblePluginFileOrIdentifier,
                             AudioPluginFormat& formatToUse) const;
@@ -110,8 +126,8 @@ public:
                                         OwnedArray<PluginDescription>& typesFound);
 
     //==============================================================================
-    /** Returns the list of blacklisted files. */
-    const StringArray& getBlacklistedFiles() const;
+    /** Returns a copy of the list of blacklisted files. */
+    StringArray getBlacklistedFiles() const;
 
     /** Adds a plugin ID to the black-list. */
     void addToBlacklist (const String& pluginID);
@@ -164,6 +180,12 @@ public:
     /** Recreates the state of this list from its stored XML format. */
     void recreateFromXml (const XmlElement& xml);
 
+    /** Forgets the sizes and modification times of the files that have been scanned,
+        so that the next scan will load every file again, without removing any of the
+        types from the list.
+    */
+    void clearScanCache();
+
     //==============================================================================
     /** A structure that recursively holds a tree of plugins.
         @see KnownPluginList::createTree()
@@ -187,6 +209,10 @@ public:
         virtual ~CustomScanner();
 
         /** Attempts to load the given file and find a list of plugins in it.
+
+            If shouldExit() becomes true, this may return early, and the file
+            won't be recorded as having been scanned.
+
             @returns true if the plugin loaded, false if it crashed
         */
         virtual bool findPluginTypesFor (AudioPluginFormat& format,
@@ -234,6 +260,18 @@ private:
     std::unique_ptr<CustomScanner> scanner;
     CriticalSection scanLock, typesArrayLock;
 
+    struct ScannedFile
+    {
+        int64 size = 0, modificationTime = 0;
+        int numTypes = 0;
+    };
+
+    // Keyed by format name and file. This and the blacklist are guarded by typesArrayLock
+    std::map<std::pair<String, String>, ScannedFile> scannedFiles;
+
+    bool getUnchangedTypesForFile (const String&, AudioPluginFormat&, OwnedArray<PluginDescription>*) const;
+    void addToScanCache (const String&, AudioPluginFormat&, const ScannedFile&);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (KnownPluginList)
 };
 
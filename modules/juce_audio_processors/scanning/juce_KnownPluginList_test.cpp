@@ -0,0 +1,294 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class KnownPluginListTests  : public UnitTest
+{
+public:
+    KnownPluginListTests()
+        : UnitTest ("KnownPluginList", UnitTestCategories::audioProcessors)
+    {}
+
+    void runTest() override
+    {
+        const auto directory = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("KnownPluginListTests", {});
+        directory.createDirectory();
+
+        beginTest ("Unchanged files aren't scanned again, even if they contain no plugins");
+        {
+            TestFormat format;
+            KnownPluginList list;
+
+            writePlugin (directory, "a", "Alpha\nBeta");
+            writePlugin (directory, "b", "Gamma");
+            writePlugin (directory, "empty", {});
+
+            scan (list, format, directory, true);
+            expectEquals (format.numScans.load(), 3);
+            expectEquals (list.getNumTypes(), 3);
+
+            scan (list, format, directory, true);
+            expectEquals (format.numScans.load(), 3);
+            expectEquals (list.getNumTypes(), 3);
+
+            OwnedArray<PluginDescription> found;
+            list.scanAndAddFile (directory.getChildFile ("a.testplugin").getFullPathName(), true, found, format);
+            expectEquals (format.numScans.load(), 3);
+            expectEquals (found.size(), 2);
+
+            scan (list, format, directory, false);
+            expectEquals (format.numScans.load(), 6);
+        }
+
+        beginTest ("The record of scanned files is saved with the list");
+        {
+            TestFormat format;
+            KnownPluginList list;
+            scan (list, format, directory, true);
+            expectEquals (format.numScans.load(), 3);
+
+            KnownPluginList restored;
+            restored.recreateFromXml (*list.createXml());
+            scan (restored, format, directory, true);
+
+            expectEquals (format.numScans.load(), 3);
+            expectEquals (restored.getNumTypes(), 3);
+        }
+
+        beginTest ("Files are scanned again when their size or modification time changes");
+        {
+            TestFormat format;
+            KnownPluginList list;
+            scan (list, format, directory, true);
+
+            writePlugin (directory, "empty", "Delta");
+            scan (list, format, directory, true);
+            expectEquals (format.numScans.load(), 4);
+            expectEquals (list.getNumTypes(), 4);
+
+            const auto file = directory.getChildFile ("b.testplugin");
+            file.setLastModificationTime (file.getLastModificationTime() - RelativeTime::hours (1));
+            scan (list, format, directory, true);
+            expectEquals (format.numScans.load(), 5);
+        }
+
+        beginTest ("Files are scanned again when their plugins have been removed from the list");
+        {
+            TestFormat format;
+            KnownPluginList list;
+            scan (list, format, directory, true);
+            expectEquals (format.numScans.load(), 3);
+
+            list.removeType (*list.getTypeForFile (directory.getChildFile ("b.testplugin").getFullPathName()));
+            scan (list, format, directory, true);
+            expectEquals (format.numScans.load(), 4);
+
+            list.clear();
+            scan (list, format, directory, true);
+            expectEquals (format.numScans.load(), 7);
+            expectEquals (list.getNumTypes(), 4);
+        }
+
+        beginTest ("Scanning on several threads finds every plugin");
+        {
+            directory.deleteRecursively();
+            directory.createDirectory();
+
+            constexpr int numFiles = 40;
+
+            for (int i = 0; i < numFiles; ++i)
+                writePlugin (directory, "plugin" + String (i), "Plugin " + String (i) + "\nPlugin " + String (i) + " Synth");
+
+            writePlugin (directory, "empty", {});
+
+            TestFormat format;
+            format.scanTimeMs = 10;
+
+            KnownPluginList list;
+            const auto deadMansPedal = directory.getChildFile ("pedal.txt");
+
+            {
+                PluginDirectoryScanner scanner (list, format, FileSearchPath (directory.getFullPathName()), false, deadMansPedal);
+                scanner.scanRemainingFiles (4, true);
+
+                expectEquals (scanner.getFailedFiles().size(), 1);
+                expectEquals (scanner.getProgress(), 1.0f);
+            }
+
+            expectEquals (format.numScans.load(), numFiles + 1);
+            expectEquals (list.getNumTypes(), numFiles * 2);
+            expect (format.maxConcurrentScans.load() > 1);
+            expect (deadMansPedal.loadFileAsString().trim().isEmpty());
+        }
+
+        beginTest ("Files aren't recorded as scanned when the scan is abandoned");
+        {
+            directory.deleteRecursively();
+            directory.createDirectory();
+            writePlugin (directory, "slow", "Slow");
+
+            const auto file = directory.getChildFile ("slow.testplugin").getFullPathName();
+
+            TestFormat format;
+            KnownPluginList list;
+            auto* scanner = new WaitingScanner();
+            list.setCustomScanner (std::unique_ptr<KnownPluginList::CustomScanner> (scanner));
+
+            ThreadPool pool (1);
+            pool.addJob (new ScanFileJob (list, format, file), true);
+
+            expect (scanner->started.wait (10000));
+            expect (pool.removeAllJobs (true, 10000));
+
+            expect (! list.isListingUpToDate (file, format));
+            expect (list.createXml()->getChildByName ("SCANNED") == nullptr);
+            expect (list.getBlacklistedFiles().isEmpty());
+
+            list.setCustomScanner (nullptr);
+            scan (list, format, directory, true);
+            expectEquals (format.numScans.load(), 1);
+            expectEquals (list.getNumTypes(), 1);
+        }
+
+        directory.deleteRecursively();
+    }
+
+private:
+    // Waits until the scan is abandoned, like a scanner whose plugin takes too long to load.
+    struct WaitingScanner  : public KnownPluginList::CustomScanner
+    {
+        bool findPluginTypesFor (AudioPluginFormat&, OwnedArray<PluginDescription>&, const String&) override
+        {
+            started.signal();
+
+            while (! shouldExit())
+                Thread::sleep (1);
+
+            return true;
+        }
+
+        WaitableEvent started;
+    };
+
+    struct ScanFileJob  : public ThreadPoolJob
+    {
+        ScanFileJob (KnownPluginList& l, AudioPluginFormat& f, const String& fileToScan)
+            : ThreadPoolJob ("scan"), list (l), format (f), file (fileToScan)
+        {}
+
+        JobStatus runJob() override
+        {
+            OwnedArray<PluginDescription> found;
+            list.scanAndAddFile (file, true, found, format);
+            return jobHasFinished;
+        }
+
+        KnownPluginList& list;
+        AudioPluginFormat& format;
+        const String file;
+    };
+
+    // Each file holds the names of the plugins that it contains, one per line.
+    struct TestFormat  : public AudioPluginFormat
+    {
+        String getName() const override                                     { return "TestFormat"; }
+
+        void findAllTypesForFile (OwnedArray<PluginDescription>& results, const String& fileOrIdentifier) override
+        {
+            const auto concurrent = ++numConcurrentScans;
+            ++numScans;
+
+            for (auto current = maxConcurrentScans.load(); concurrent > current && ! maxConcurrentScans.compare_exchange_weak (current, concurrent);)
+            {}
+
+            if (scanTimeMs > 0)
+                Thread::sleep (scanTimeMs);
+
+            const File file (fileOrIdentifier);
+
+            for (auto& name : StringArray::fromLines (file.loadFileAsString()))
+            {
+                if (name.isEmpty())
+                    continue;
+
+                auto* desc = results.add (new PluginDescription());
+                desc->name = name;
+                desc->pluginFormatName = getName();
+                desc->fileOrIdentifier = fileOrIdentifier;
+                desc->uniqueId = name.hashCode();
+                desc->lastFileModTime = file.getLastModificationTime();
+            }
+
+            --numConcurrentScans;
+        }
+
+        bool fileMightContainThisPluginType (const String& f) override      { return f.endsWith (".testplugin"); }
+        String getNameOfPluginFromIdentifier (const String& f) override     { return File (f).getFileNameWithoutExtension(); }
+        bool pluginNeedsRescanning (const PluginDescription& d) override    { return File (d.fileOrIdentifier).getLastModificationTime() != d.lastFileModTime; }
+        bool doesPluginStillExist (const PluginDescription& d) override     { return File (d.fileOrIdentifier).exists(); }
+        bool canScanForPlugins() const override                             { return true; }
+        bool isTrivialToScan() const override                               { return false; }
+        FileSearchPath getDefaultLocationsToSearch() override               { return {}; }
+
+        bool requiresUnblockedMessageThreadDuringCreation (const PluginDescription&) const override  { return false; }
+
+        StringArray searchPathsForPlugins (const FileSearchPath& paths, bool, bool) override
+        {
+            StringArray result;
+
+            for (int i = 0; i < paths.getNumPaths(); ++i)
+                for (const auto& entry : RangedDirectoryIterator (paths[i], false, "*.testplugin"))
+                    result.add (entry.getFile().getFullPathName());
+
+            result.sort (true);
+            return result;
+        }
+
+        void createPluginInstance (const PluginDescription&, double, int, PluginCreationCallback callback) override
+        {
+            callback (nullptr, "Not supported");
+        }
+
+        std::atomic<int> numScans { 0 }, numConcurrentScans { 0 }, maxConcurrentScans { 0 };
+        int scanTimeMs = 0;
+    };
+
+    static void writePlugin (const File& directory, const String& name, const String& contents)
+    {
+        directory.getChildFile (name + ".testplugin").replaceWithText (contents);
+    }
+
+    static void scan (KnownPluginList& list, AudioPluginFormat& format, const File& directory, bool dontRescanIfAlreadyInList)
+    {
+        PluginDirectoryScanner scanner (list, format, FileSearchPath (directory.getFullPathName()), false, {});
+        scanner.scanRemainingFiles (1, dontRescanIfAlreadyInList);
+    }
+};
+
+static KnownPluginListTests knownPluginListTests;
+
+} // namespace juce
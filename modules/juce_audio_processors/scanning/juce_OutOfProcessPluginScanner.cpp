@@ -0,0 +1,284 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+// Requests are sent as the format name followed by the file or identifier, and the
+// results come back as an XML list of plugin descriptions.
+class OutOfProcessPluginScanner::Coordinator  : public ChildProcessCoordinator
+{
+public:
+    enum class State
+    {
+        timeout,
+        gotResult,
+        connectionLost
+    };
+
+    bool launch (const File& executable, const String& commandLineID, int timeoutMs)
+    {
+        return launchWorkerProcess (executable, commandLineID, timeoutMs, 0);
+    }
+
+    bool sendRequest (const String& formatName, const String& fileOrIdentifier)
+    {
+        MemoryBlock block;
+
+        {
+            MemoryOutputStream stream (block, false);
+            stream.writeString (formatName);
+            stream.writeString (fileOrIdentifier);
+        }
+
+        return sendMessageToWorker (block);
+    }
+
+    State waitForResponse (int timeoutMs, OwnedArray<PluginDescription>& result)
+    {
+        responseArrived.wait ((double) timeoutMs);
+
+        const ScopedLock sl (lock);
+
+        if (connectionLost)
+            return State::connectionLost;
+
+        if (response == nullptr)
+            return State::timeout;
+
+        for (auto* item : response->getChildIterator())
+        {
+            auto desc = std::make_unique<PluginDescription>();
+
+            if (desc->loadFromXml (*item))
+                result.add (std::move (desc));
+        }
+
+        response.reset();
+        return State::gotResult;
+    }
+
+private:
+    void handleMessageFromWorker (const MemoryBlock& mb) override
+    {
+        {
+            const ScopedLock sl (lock);
+            response = parseXML (mb.toString());
+
+            if (response == nullptr)
+                response = std::make_unique<XmlElement> ("LIST");
+        }
+
+        responseArrived.signal();
+    }
+
+    void handleConnectionLost() override
+    {
+        {
+            const ScopedLock sl (lock);
+            connectionLost = true;
+        }
+
+        responseArrived.signal();
+    }
+
+    CriticalSection lock;
+    WaitableEvent responseArrived;
+    std::unique_ptr<XmlElement> response;
+    bool connectionLost = false;
+};
+
+//==============================================================================
+OutOfProcessPluginScanner::OutOfProcessPluginScanner (const File& workerExecutable,
+                                                      const String& commandLineUniqueID,
+                                                      int timeoutMs)
+    : executable (workerExecutable),
+      commandLineID (commandLineUniqueID),
+      timeout (timeoutMs)
+{
+}
+
+OutOfProcessPluginScanner::~OutOfProcessPluginScanner()
+{
+    scanFinished();
+}
+
+std::unique_ptr<OutOfProcessPluginScanner::Coordinator> OutOfProcessPluginScanner::getIdleCoordinator()
+{
+    {
+        const ScopedLock sl (idleLock);
+
+        if (! idleCoordinators.empty())
+        {
+            auto coordinator = std::move (idleCoordinators.back());
+            idleCoordinators.pop_back();
+            return coordinator;
+        }
+    }
+
+    auto coordinator = std::make_unique<Coordinator>();
+
+    if (coordinator->launch (executable, commandLineID, timeout))
+        return coordinator;
+
+    return {};
+}
+
+bool OutOfProcessPluginScanner::findPluginTypesFor (AudioPluginFormat& format,
+                                                    OwnedArray<PluginDescription>& result,
+                                                    const String& fileOrIdentifier)
+{
+    auto coordinator = getIdleCoordinator();
+
+    if (coordinator == nullptr)
+    {
+        // The worker process couldn't be launched! Make sure that the executable creates
+        // a PluginScannerWorker at startup, using the same command-line ID as this scanner.
+        // The file isn't loaded in this process instead, as that would lose the protection
+        // against plugins that crash.
+        jassertfalse;
+        return false;
+    }
+
+    if (! coordinator->sendRequest (format.getName(), fileOrIdentifier))
+        return false;
+
+    for (;;)
+    {
+        // Abandoning a scan leaves the worker busy, so it can't be reused
+        if (shouldExit())
+            return true;
+
+        switch (coordinator->waitForResponse (50, result))
+        {
+            case Coordinator::State::timeout:
+                break;
+
+            case Coordinator::State::gotResult:
+            {
+                const ScopedLock sl (idleLock);
+                idleCoordinators.push_back (std::move (coordinator));
+                return true;
+            }
+
+            case Coordinator::State::connectionLost:
+                return false;
+        }
+    }
+}
+
+void OutOfProcessPluginScanner::scanFinished()
+{
+    decltype (idleCoordinators) coordinators;
+
+    {
+        const ScopedLock sl (idleLock);
+        std::swap (coordinators, idleCoordinators);
+    }
+}
+
+//==============================================================================
+PluginScannerWorker::PluginScannerWorker (AudioPluginFormatManager& formatsToUse)
+    : formatManager (formatsToUse)
+{
+}
+
+PluginScannerWorker::~PluginScannerWorker()
+{
+    cancelPendingUpdate();
+}
+
+void PluginScannerWorker::handleMessageFromCoordinator (const MemoryBlock& mb)
+{
+    if (mb.isEmpty() || scan (mb))
+        return;
+
+    {
+        const ScopedLock sl (pendingLock);
+        pendingRequests.push_back (mb);
+    }
+
+    triggerAsyncUpdate();
+}
+
+void PluginScannerWorker::handleConnectionLost()
+{
+    JUCEApplicationBase::quit();
+}
+
+void PluginScannerWorker::handleAsyncUpdate()
+{
+    decltype (pendingRequests) requests;
+
+    {
+        const ScopedLock sl (pendingLock);
+        std::swap (requests, pendingRequests);
+    }
+
+    for (auto& request : requests)
+        scan (request);
+}
+
+bool PluginScannerWorker::scan (const MemoryBlock& block)
+{
+    MemoryInputStream stream (block, false);
+    const auto formatName = stream.readString();
+    const auto fileOrIdentifier = stream.readString();
+
+    PluginDescription pd;
+    pd.fileOrIdentifier = fileOrIdentifier;
+    pd.uniqueId = pd.deprecatedUid = 0;
+
+    AudioPluginFormat* format = nullptr;
+
+    for (auto* f : formatManager.getFormats())
+        if (f->getName() == formatName)
+            format = f;
+
+    // Most formats need to be scanned on the message thread, so requests that arrive
+    // on the connection's thread are passed over to it. Formats that need the message
+    // thread to be free while a plugin is created are scanned where they arrive.
+    if (format != nullptr
+         && ! MessageManager::getInstance()->isThisTheMessageThread()
+         && ! format->requiresUnblockedMessageThreadDuringCreation (pd))
+        return false;
+
+    OwnedArray<PluginDescription> results;
+
+    if (format != nullptr)
+        format->findAllTypesForFile (results, fileOrIdentifier);
+
+    XmlElement xml ("LIST");
+
+    for (auto* desc : results)
+        xml.addChildElement (desc->createXml().release());
+
+    const auto text = xml.toString();
+    sendMessageToCoordinator ({ text.toRawUTF8(), text.getNumBytesAsUTF8() });
+    return true;
+}
+
+} // namespace juce
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A KnownPluginList::CustomScanner that loads each plugin in a separate process,
+    so that a plugin which crashes while it's being scanned can't take the host
+    down with it.
+
+    The worker processes are launched from an executable that creates a
+    PluginScannerWorker at startup - usually the host itself. Each thread that asks
+    the scanner to find the types in a file is given a worker process of its own, so
+    a PluginDirectoryScanner that scans on several threads will keep that many
+    processes busy. If a worker crashes, only the file that it was scanning is
+    blacklisted, and a new process is launched for the next file.
+
+    Plugins are never loaded by the host process itself. If a worker process can't
+    be launched, the file that it was needed for is treated as if it had crashed.
+
+    @code
+    // In the host, when the scan starts:
+    knownPluginList.setCustomScanner (std::make_unique<OutOfProcessPluginScanner> (
+        File::getSpecialLocation (File::currentExecutableFile), "myhostscanner"));
+
+    PluginDirectoryScanner scanner (knownPluginList, format, paths, true, deadMansPedalFile);
+    scanner.scanRemainingFiles (SystemStats::getNumCpus(), true);
+
+    // In JUCEApplication::initialise():
+    auto worker = std::make_unique<PluginScannerWorker> (formatManager);
+
+    if (worker->initialiseFromCommandLine (commandLine, "myhostscanner"))
+    {
+        scannerWorker = std::move (worker);
+        return;
+    }
+    @endcode
+
+    @see PluginScannerWorker, PluginDirectoryScanner::scanRemainingFiles
+    @tags{Audio}
+*/
+class JUCE_API  OutOfProcessPluginScanner  : public KnownPluginList::CustomScanner
+{
+public:
+    //==============================================================================
+    /** Creates a scanner.
+
+        @param workerExecutable     the executable to launch for each worker process
+        @param commandLineUniqueID  the ID that the executable passes to
+                                    PluginScannerWorker::initialiseFromCommandLine()
+        @param timeoutMs            how long a worker may go without responding to a ping
+                                    before it's assumed to have died. Passing <= 0 uses
+                                    the ChildProcessCoordinator default
+    */
+    OutOfProcessPluginScanner (const File& workerExecutable,
+                               const String& commandLineUniqueID,
+                               int timeoutMs = 0);
+
+    /** Destructor. This kills any worker processes that are still running. */
+    ~OutOfProcessPluginScanner() override;
+
+    //==============================================================================
+    /** @internal */
+    bool findPluginTypesFor (AudioPluginFormat&, OwnedArray<PluginDescription>&, const String&) override;
+    /** @internal */
+    void scanFinished() override;
+
+private:
+    //==============================================================================
+    class Coordinator;
+
+    std::unique_ptr<Coordinator> getIdleCoordinator();
+
+    const File executable;
+    const String commandLineID;
+    const int timeout;
+
+    CriticalSection idleLock;
+    std::vector<std::unique_ptr<Coordinator>> idleCoordinators;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessPluginScanner)
+};
+
+//==============================================================================
+/**
+    The worker end of an OutOfProcessPluginScanner.
+
+    Create one of these in your app's startup code, and call initialiseFromCommandLine()
+    with the ID that was given to the OutOfProcessPluginScanner. If that returns true,
+    the process has been launched as a scanner, and should keep the worker alive
+    without doing anything else. The worker quits the app if the connection to the
+    coordinator is lost.
+
+    @see OutOfProcessPluginScanner
+    @tags{Audio}
+*/
+class JUCE_API  PluginScannerWorker  : public ChildProcessWorker,
+                                       private AsyncUpdater
+{
+public:
+    //==============================================================================
+    /** Creates a worker that will scan files using the given formats.
+        The format manager must outlive the worker.
+    */
+    explicit PluginScannerWorker (AudioPluginFormatManager& formatsToUse);
+
+    /** Destructor. */
+    ~PluginScannerWorker() override;
+
+    //==============================================================================
+    /** @internal */
+    void handleMessageFromCoordinator (const MemoryBlock&) override;
+    /** @internal */
+    void handleConnectionLost() override;
+
+private:
+    //==============================================================================
+    void handleAsyncUpdate() override;
+    bool scan (const MemoryBlock&);
+
+    AudioPluginFormatManager& formatManager;
+
+    CriticalSection pendingLock;
+    std::vector<MemoryBlock> pendingRequests;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginScannerWorker)
+};
+
+} // namespace juce
@@ -77,7 +77,8 @@ String PluginDirectoryScanner::getNextPluginFileThatWillBeScanned() const
 
 void PluginDirectoryScanner::updateProgress()
 {
-    progress = (1.0f - (float) nextIndex.get() / (float) filesOrIdentifiersToScan.size());
+    // When scanning on several threads, each thread moves the index past the end once
+    progress = (1.0f - (float) jmax (0, nextIndex.get()) / (float) filesOrIdentifiersToScan.size());
 }
 
 bool PluginDirectoryScanner::scanNextFile (bool dontRescanIfAlreadyInList,
@@ -96,14 +97,22 @@ bool PluginDirectoryScanner::scanNextFile (bool dontRescanIfAlreadyInList,
             OwnedArray<PluginDescription> typesFound;
 
             // Add this plugin to the end of the dead-man's pedal list in case it crashes...
-            auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
-            crashedPlugins.removeString (file);
-            crashedPlugins.add (file);
-            setDeadMansPedalFile (crashedPlugins);
+            {
+                const ScopedLock sl (scanStateLock);
+
+                auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
+                crashedPlugins.removeString (file);
+                crashedPlugins.add (file);
+                setDeadMansPedalFile (crashedPlugins);
+            }
 
             list.scanAndAddFile (file, dontRescanIfAlreadyInList, typesFound, format);
 
             // Managed to load without crashing, so remove it from the dead-man's-pedal..
+            // Other threads may have added their own files since, so the file is re-read.
+            const ScopedLock sl (scanStateLock);
+
+            auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
             crashedPlugins.removeString (file);
             setDeadMansPedalFile (crashedPlugins);
 
@@ -116,6 +125,48 @@ bool PluginDirectoryScanner::scanNextFile (bool dontRescanIfAlreadyInList,
     return index > 0;
 }
 
+void PluginDirectoryScanner::scanRemainingFiles (int numThreads, bool dontRescanIfAlreadyInList)
+{
+    if (numThreads < 2)
+    {
+        String name;
+
+        while (scanNextFile (dontRescanIfAlreadyInList, name))
+        {}
+
+        return;
+    }
+
+    struct ScanJob  : public ThreadPoolJob
+    {
+        ScanJob (PluginDirectoryScanner& s, bool dontRescan)
+            : ThreadPoolJob ("pluginscan"), scanner (s), dontRescanIfAlreadyInList (dontRescan)
+        {}
+
+        JobStatus runJob() override
+        {
+            String name;
+
+            while (! shouldExit() && scanner.scanNextFile (dontRescanIfAlreadyInList, name))
+            {}
+
+            return jobHasFinished;
+        }
+
+        PluginDirectoryScanner& scanner;
+        const bool dontRescanIfAlreadyInList;
+    };
+
+    ThreadPool pool (numThreads);
+    OwnedArray<ScanJob> jobs;
+
+    for (int i = 0; i < numThreads; ++i)
+        pool.addJob (jobs.add (new ScanJob (*this, dontRescanIfAlreadyInList)), false);
+
+    for (auto* job : jobs)
+        pool.waitForJobToFinish (job, -1);
+}
+
 bool PluginDirectoryScanner::skipNextFile()
 {
     updateProgress();
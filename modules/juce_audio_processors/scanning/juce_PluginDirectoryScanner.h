@@ -31,7 +31,11 @@ namespace juce
     Scans a directory for plugins, and adds them to a KnownPluginList.
 
     To use one of these, create it and call scanNextFile() repeatedly, until
-    it returns false.
+    it returns false. scanNextFile() can be called from several threads at once,
+    or you can call scanRemainingFiles() to scan everything on a pool of threads.
+
+    To stop a plugin that crashes while it's being scanned from taking the scan
+    down with it, give the KnownPluginList an OutOfProcessPluginScanner.
 
     @tags{Audio}
 */
@@ -93,6 +97,20 @@ public:
     bool scanNextFile (bool dontRescanIfAlreadyInList,
                        String& nameOfPluginBeingScanned);
 
+    /** Scans all the files that haven't been scanned yet, using a pool of threads,
+        and returns when they've all been tried.
+
+        Each thread repeatedly calls scanNextFile(), so the KnownPluginList will be
+        asked to scan several files at once. That's only safe if the plugin format can
+        create instances on background threads, or if the list has a CustomScanner that
+        scans each file in a separate process, such as an OutOfProcessPluginScanner.
+
+        If numThreads is less than 2, the files are scanned on the calling thread.
+
+        @see OutOfProcessPluginScanner, KnownPluginList::setCustomScanner
+    */
+    void scanRemainingFiles (int numThreads, bool dontRescanIfAlreadyInList);
+
     /** Skips over the next file without scanning it.
         Returns false when there are no more files to try.
     */
@@ -111,6 +129,8 @@ public:
 
     /** This returns a list of all the filenames of things that looked like being
         a plugin file, but which failed to open for some reason.
+
+        If the scan is running on several threads, only call this after it has finished.
     */
     const StringArray& getFailedFiles() const noexcept              { return failedFiles; }
 
@@ -125,6 +145,7 @@ private:
     StringArray filesOrIdentifiersToScan;
     File deadMansPedalFile;
     StringArray failedFiles;
+    CriticalSection scanStateLock;
     Atomic<int> nextIndex;
     std::atomic<float> progress { 0.0f };
     const bool allowAsync;
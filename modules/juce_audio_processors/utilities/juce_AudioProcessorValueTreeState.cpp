@@ -61,6 +61,154 @@ void AudioProcessorValueTreeState::Parameter::valueChanged (float newValue)
         onValueChanged();
 }
 
+//==============================================================================
+/*  Holds the queue of timestamped changes which is drained by the audio thread, and the
+    list of parameters whose values need to be written back to the ValueTree.
+
+    Parameters can be changed from any thread, so both lists are bounded multi-producer,
+    single-consumer queues, in which each slot carries a sequence number that tells the
+    producers and the consumer whose turn it is to use it.
+*/
+class AudioProcessorValueTreeState::ParameterChangeQueue
+{
+public:
+    ParameterChangeQueue (int maxNumPendingChanges, int numParameters)
+        : changes (maxNumPendingChanges),
+          changedAdapters (numParameters),
+          poppedChanges ((size_t) changes.getCapacity())
+    {
+    }
+
+    void pushChange (RangedAudioParameter& parameter, float value, int sampleOffset) noexcept
+    {
+        const auto time = blockStartTime.load (std::memory_order_relaxed) + sampleOffset;
+
+        if (! changes.push ({ &parameter, value, time }))
+            numDroppedChanges.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    const ParameterChange* popChanges (int numSamples, int& numChanges) noexcept
+    {
+        const auto startTime = blockStartTime.load (std::memory_order_relaxed);
+        const auto lastOffset = (int64) jmax (0, numSamples - 1);
+
+        TimedChange change;
+        int num = 0;
+
+        while (num < (int) poppedChanges.size() && changes.pop (change))
+        {
+            poppedChanges[(size_t) num] = { change.parameter, change.value, (int) jlimit ((int64) 0, lastOffset, change.time - startTime) };
+
+            // The changes will usually arrive in order, so an insertion sort is cheap,
+            // and keeps changes with the same offset in the order they were made
+            for (auto i = (size_t) num; i > 0 && poppedChanges[i - 1].sampleOffset > poppedChanges[i].sampleOffset; --i)
+                std::swap (poppedChanges[i - 1], poppedChanges[i]);
+
+            ++num;
+        }
+
+        blockStartTime.store (startTime + jmax (0, numSamples), std::memory_order_relaxed);
+        numChanges = num;
+        return poppedChanges.data();
+    }
+
+    void markChanged (ParameterAdapter& adapter) noexcept
+    {
+        // Each adapter can only be in this queue once, so it can never fill up
+        const auto pushed = changedAdapters.push (&adapter);
+        jassertquiet (pushed);
+    }
+
+    bool popChangedAdapter (ParameterAdapter*& adapter) noexcept   { return changedAdapters.pop (adapter); }
+
+    int64 getNumDroppedChanges() const noexcept   { return numDroppedChanges.load (std::memory_order_relaxed); }
+
+private:
+    template <typename Item>
+    class Queue
+    {
+    public:
+        explicit Queue (int minCapacity)
+            : cells ((size_t) nextPowerOfTwo (jmax (2, minCapacity))),
+              mask (cells.size() - 1)
+        {
+            for (size_t i = 0; i < cells.size(); ++i)
+                cells[i].sequence.store (i, std::memory_order_relaxed);
+        }
+
+        int getCapacity() const noexcept    { return (int) cells.size(); }
+
+        bool push (const Item& item) noexcept
+        {
+            auto position = writePosition.load (std::memory_order_relaxed);
+
+            for (;;)
+            {
+                auto& cell = cells[position & mask];
+                const auto sequence = cell.sequence.load (std::memory_order_acquire);
+                const auto difference = (int64) sequence - (int64) position;
+
+                if (difference == 0)
+                {
+                    if (writePosition.compare_exchange_weak (position, position + 1, std::memory_order_relaxed))
+                    {
+                        cell.item = item;
+                        cell.sequence.store (position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = writePosition.load (std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool pop (Item& item) noexcept
+        {
+            auto& cell = cells[readPosition & mask];
+
+            if (cell.sequence.load (std::memory_order_acquire) != readPosition + 1)
+                return false;
+
+            item = cell.item;
+            cell.sequence.store (readPosition + mask + 1, std::memory_order_release);
+            ++readPosition;
+            return true;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence { 0 };
+            Item item {};
+        };
+
+        std::vector<Cell> cells;
+        const size_t mask;
+        std::atomic<size_t> writePosition { 0 };
+        size_t readPosition = 0;
+    };
+
+    struct TimedChange
+    {
+        RangedAudioParameter* parameter;
+        float value;
+        int64 time;
+    };
+
+    Queue<TimedChange> changes;
+    Queue<ParameterAdapter*> changedAdapters;
+    std::vector<ParameterChange> poppedChanges;
+    std::atomic<int64> blockStartTime { 0 }, numDroppedChanges { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (ParameterChangeQueue)
+};
+
 //==============================================================================
 class AudioProcessorValueTreeState::ParameterAdapter   : private AudioProcessorParameter::Listener
 {
@@ -112,6 +260,24 @@ public:
     float getDenormalisedValue() const                { return unnormalisedValue; }
     std::atomic<float>& getRawDenormalisedValue()     { return unnormalisedValue; }
 
+    void setChangeQueue (ParameterChangeQueue& queue)
+    {
+        changeQueue = &queue;
+        markChanged();
+    }
+
+    void setNormalisedValueAtSampleOffset (float value, int sampleOffset)
+    {
+        // This is the same sequence of calls that the plugin wrappers use when
+        // the host changes a parameter
+        pendingSampleOffset = jmax (0, sampleOffset);
+        parameter.setValue (value);
+        parameter.sendValueChangedMessageToListeners (value);
+        pendingSampleOffset = 0;
+    }
+
+    void clearChangedFlag()     { isMarkedAsChanged = false; }
+
     bool flushToTree (const Identifier& key, UndoManager* um)
     {
         auto needsUpdateTestValue = true;
@@ -148,9 +314,22 @@ private:
             return;
 
         unnormalisedValue = newValue;
+
+        if (changeQueue != nullptr)
+            changeQueue->pushChange (parameter, newValue, pendingSampleOffset.exchange (0));
+
         listeners.call ([this] (Listener& l) { l.parameterChanged (parameter.paramID, unnormalisedValue); });
         listenersNeedCalling = false;
         needsUpdate = true;
+
+        if (changeQueue != nullptr)
+            markChanged();
+    }
+
+    void markChanged()
+    {
+        if (! isMarkedAsChanged.exchange (true))
+            changeQueue->markChanged (*this);
     }
 
     float denormalise (float normalised) const
@@ -201,7 +380,9 @@ private:
     RangedAudioParameter& parameter;
     LockedListeners listeners;
     std::atomic<float> unnormalisedValue { 0.0f };
-    std::atomic<bool> needsUpdate { true }, listenersNeedCalling { true };
+    std::atomic<bool> needsUpdate { true }, listenersNeedCalling { true }, isMarkedAsChanged { false };
+    std::atomic<int> pendingSampleOffset { 0 };
+    ParameterChangeQueue* changeQueue = nullptr;
     bool ignoreParameterChangedCallbacks { false };
 };
 
@@ -381,6 +562,55 @@ std::atomic<float>* AudioProcessorValueTreeState::getRawParameterValue (StringRe
     return nullptr;
 }
 
+//==============================================================================
+void AudioProcessorValueTreeState::enableParameterChangeQueue (int maxNumPendingChanges)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    // This can only be enabled once, before the processor starts running!
+    jassert (changeQueue == nullptr);
+
+    if (changeQueue != nullptr)
+        return;
+
+    changeQueue = std::make_unique<ParameterChangeQueue> (maxNumPendingChanges, (int) adapterTable.size());
+
+    for (auto& p : adapterTable)
+        p.second->setChangeQueue (*changeQueue);
+}
+
+void AudioProcessorValueTreeState::setParameterValueAtSampleOffset (RangedAudioParameter& parameter,
+                                                                    float newNormalisedValue,
+                                                                    int sampleOffset)
+{
+    auto* adapter = getParameterAdapter (parameter.paramID);
+
+    // The parameter must be one of the ones managed by this object!
+    jassert (adapter != nullptr && &adapter->getParameter() == &parameter);
+
+    if (adapter != nullptr)
+        adapter->setNormalisedValueAtSampleOffset (newNormalisedValue, sampleOffset);
+}
+
+const AudioProcessorValueTreeState::ParameterChange* AudioProcessorValueTreeState::popParameterChanges (int numSamples, int& numChanges) noexcept
+{
+    // You need to call enableParameterChangeQueue() before using this method!
+    jassert (changeQueue != nullptr);
+
+    numChanges = 0;
+
+    if (changeQueue == nullptr)
+        return nullptr;
+
+    return changeQueue->popChanges (numSamples, numChanges);
+}
+
+int64 AudioProcessorValueTreeState::getNumDroppedParameterChanges() const noexcept
+{
+    return changeQueue != nullptr ? changeQueue->getNumDroppedChanges() : 0;
+}
+
+//==============================================================================
 ValueTree AudioProcessorValueTreeState::copyState()
 {
     ScopedLock lock (valueTreeChanging);
@@ -464,9 +694,26 @@ bool AudioProcessorValueTreeState::flushParameterValuesToValueTree()
     return anyUpdated;
 }
 
+bool AudioProcessorValueTreeState::flushChangedParameterValuesToValueTree()
+{
+    ScopedLock lock (valueTreeChanging);
+
+    bool anyUpdated = false;
+    ParameterAdapter* adapter = nullptr;
+
+    while (changeQueue->popChangedAdapter (adapter))
+    {
+        adapter->clearChangedFlag();
+        anyUpdated |= adapter->flushToTree (valuePropertyID, undoManager);
+    }
+
+    return anyUpdated;
+}
+
 void AudioProcessorValueTreeState::timerCallback()
 {
-    auto anythingUpdated = flushParameterValuesToValueTree();
+    auto anythingUpdated = changeQueue != nullptr ? flushChangedParameterValuesToValueTree()
+                                                  : flushParameterValuesToValueTree();
 
     startTimer (anythingUpdated ? 1000 / 50
                                 : jlimit (50, 500, getTimerInterval() + 20));
@@ -982,6 +1229,157 @@ public:
             expectEquals (listener.value, newValue);
             expectEquals (listener.id, String (key));
         }
+
+        beginTest ("Queued parameter changes are delivered in order with their sample offsets");
+        {
+            TestAudioProcessor proc ({ std::make_unique<AudioParameterFloat> ("a", "", NormalisableRange<float> { 0.0f, 10.0f }, 0.0f),
+                                       std::make_unique<AudioParameterFloat> ("b", "", NormalisableRange<float> { 0.0f, 1.0f }, 0.0f) });
+            auto& a = *proc.state.getParameter ("a");
+            auto& b = *proc.state.getParameter ("b");
+
+            proc.state.enableParameterChangeQueue (16);
+            expect (proc.state.isParameterChangeQueueEnabled());
+
+            a.setValueNotifyingHost (0.1f);
+            proc.state.setParameterValueAtSampleOffset (b, 0.75f, 100);
+            proc.state.setParameterValueAtSampleOffset (a, 0.5f, 20);
+            proc.state.setParameterValueAtSampleOffset (b, 0.25f, 1000);
+
+            expectWithinAbsoluteError (proc.state.getRawParameterValue ("a")->load(), 5.0f, 1.0e-5f);
+            expectWithinAbsoluteError (proc.state.getRawParameterValue ("b")->load(), 0.25f, 1.0e-5f);
+
+            std::vector<AudioProcessorValueTreeState::ParameterChange> changes;
+            proc.state.processParameterChanges (512, [&] (const auto& change) { changes.push_back (change); });
+
+            expectEquals ((int) changes.size(), 4);
+
+            if (changes.size() == 4)
+            {
+                expect (changes[0].parameter == &a && changes[0].sampleOffset == 0);
+                expectWithinAbsoluteError (changes[0].value, 1.0f, 1.0e-5f);
+                expect (changes[1].parameter == &a && changes[1].sampleOffset == 20);
+                expectWithinAbsoluteError (changes[1].value, 5.0f, 1.0e-5f);
+                expect (changes[2].parameter == &b && changes[2].sampleOffset == 100);
+                expectWithinAbsoluteError (changes[2].value, 0.75f, 1.0e-5f);
+                expect (changes[3].parameter == &b && changes[3].sampleOffset == 511);
+            }
+
+            changes.clear();
+            proc.state.processParameterChanges (512, [&] (const auto& change) { changes.push_back (change); });
+            expect (changes.empty());
+        }
+
+        beginTest ("Changes made on other threads are queued without being lost");
+        {
+            constexpr int numThreads = 4, numChangesPerThread = 200;
+
+            ParameterLayout layout;
+
+            for (int i = 0; i < numThreads; ++i)
+                layout.add (std::make_unique<AudioParameterInt> (String (i), "", 0, numChangesPerThread, 0));
+
+            TestAudioProcessor proc (std::move (layout));
+            proc.state.enableParameterChangeQueue (numThreads * numChangesPerThread);
+
+            struct ChangingThread final : public Thread
+            {
+                explicit ChangingThread (RangedAudioParameter& p)  : Thread ("Parameter changer"), parameter (p) {}
+
+                void run() override
+                {
+                    for (int n = 1; n <= numChangesPerThread; ++n)
+                        parameter.setValueNotifyingHost (parameter.convertTo0to1 ((float) n));
+                }
+
+                RangedAudioParameter& parameter;
+            };
+
+            OwnedArray<ChangingThread> threads;
+
+            for (int i = 0; i < numThreads; ++i)
+                threads.add (new ChangingThread (*proc.state.getParameter (String (i))));
+
+            for (auto* thread : threads)
+                thread->startThread();
+
+            for (auto* thread : threads)
+                thread->waitForThreadToExit (-1);
+
+            std::vector<int> lastValues (numThreads, 0);
+            auto allInOrder = true;
+            int numChanges = 0;
+
+            proc.state.processParameterChanges (256, [&] (const auto& change)
+            {
+                auto& last = lastValues[(size_t) change.parameter->paramID.getIntValue()];
+                allInOrder = allInOrder && (int) change.value == last + 1 && change.sampleOffset == 0;
+                last = (int) change.value;
+                ++numChanges;
+            });
+
+            expectEquals (numChanges, numThreads * numChangesPerThread);
+            expect (allInOrder);
+            expectEquals (proc.state.getNumDroppedParameterChanges(), (int64) 0);
+        }
+
+        beginTest ("Changes which don't fit in the queue are counted as dropped");
+        {
+            TestAudioProcessor proc (std::make_unique<AudioParameterInt> ("a", "", 0, 100, 0));
+            proc.state.enableParameterChangeQueue (8);
+
+            auto& parameter = *proc.state.getParameter ("a");
+
+            for (int n = 1; n <= 10; ++n)
+                parameter.setValueNotifyingHost (parameter.convertTo0to1 ((float) n));
+
+            int numChanges = 0;
+            proc.state.processParameterChanges (64, [&] (const auto&) { ++numChanges; });
+
+            expectEquals (numChanges, 8);
+            expectEquals (proc.state.getNumDroppedParameterChanges(), (int64) 2);
+            expectEquals (proc.state.getRawParameterValue ("a")->load(), 10.0f);
+        }
+
+        beginTest ("With the queue enabled, only changed parameters are written to the ValueTree");
+        {
+            ParameterLayout layout;
+
+            for (int i = 0; i < 100; ++i)
+                layout.add (std::make_unique<AudioParameterFloat> (String (i), "", NormalisableRange<float>{}, 0.0f));
+
+            TestAudioProcessor proc (std::move (layout));
+            proc.state.enableParameterChangeQueue();
+            proc.state.timerCallback();
+
+            int numPropertyChanges = 0;
+
+            struct TreeListener final : public ValueTree::Listener
+            {
+                explicit TreeListener (int& numChangesIn) : numChanges (numChangesIn) {}
+                void valueTreePropertyChanged (ValueTree&, const Identifier&) override { ++numChanges; }
+                int& numChanges;
+            };
+
+            TreeListener treeListener (numPropertyChanges);
+            proc.state.state.addListener (&treeListener);
+
+            auto& parameter = *proc.state.getParameter ("42");
+
+            for (auto value : { 0.1f, 0.2f, 0.3f })
+                parameter.setValueNotifyingHost (value);
+
+            expectEquals (numPropertyChanges, 0);
+
+            proc.state.timerCallback();
+
+            expectEquals (numPropertyChanges, 1);
+            expectWithinAbsoluteError ((float) proc.state.state.getChildWithProperty ("id", "42").getProperty ("value"), 0.3f, 1.0e-5f);
+
+            proc.state.timerCallback();
+            expectEquals (numPropertyChanges, 1);
+
+            proc.state.state.removeListener (&treeListener);
+        }
     }
     JUCE_END_IGNORE_WARNINGS_MSVC
 };
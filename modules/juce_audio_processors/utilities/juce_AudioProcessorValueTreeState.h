@@ -365,6 +365,88 @@ public:
     /** Removes a callback that was previously added with addParameterCallback(). */
     void removeParameterListener (StringRef parameterID, Listener* listener);
 
+    //==============================================================================
+    /** Describes a single parameter change that was read from the parameter change queue.
+
+        @see enableParameterChangeQueue, processParameterChanges
+    */
+    struct ParameterChange
+    {
+        /** The parameter that was changed. */
+        RangedAudioParameter* parameter = nullptr;
+
+        /** The new, denormalised value of the parameter. */
+        float value = 0.0f;
+
+        /** The index of the sample in the current block at which the change should take effect. */
+        int sampleOffset = 0;
+    };
+
+    /** Enables a lock-free queue which records every change made to the parameters, so
+        that the audio thread can apply them in order, at the right sample positions.
+
+        Once this has been called, each parameter change is pushed into a fixed-size queue
+        which your processBlock() method can drain with processParameterChanges(). Pushing
+        and draining are both lock-free, so changes made by the host, the GUI or the audio
+        thread itself are never lost or reordered while they fit into the queue.
+
+        Enabling the queue also makes the ValueTree state update lazily: instead of checking
+        every parameter on each timer callback, only the parameters which changed since the
+        previous update are written back to the tree, in a single batch.
+
+        This must be called on the message thread, after all the parameters have been added
+        and before the processor starts processing audio.
+
+        @param maxNumPendingChanges    the number of changes that can be waiting in the queue.
+                                       This will be rounded up to a power of two. Changes made
+                                       while the queue is full are dropped, although their
+                                       values will still be visible via getRawParameterValue()
+    */
+    void enableParameterChangeQueue (int maxNumPendingChanges = 4096);
+
+    /** Returns true if enableParameterChangeQueue() has been called. */
+    bool isParameterChangeQueueEnabled() const noexcept         { return changeQueue != nullptr; }
+
+    /** Changes a parameter's value, and records the change in the parameter change queue
+        with the given position in the block that will next be passed to processParameterChanges().
+
+        This is intended for code running on the audio thread which receives sample-accurate
+        automation data, such as a plugin wrapper. The parameter's listeners will be notified
+        in the same way as when a host changes the parameter, so the host won't be told about
+        the change. If the queue isn't enabled, the value is set with a sample offset of zero.
+
+        @param parameter            one of the parameters managed by this object
+        @param newNormalisedValue   the new value, in the range 0 to 1
+        @param sampleOffset         the position within the next processed block at which the
+                                    change should happen
+    */
+    void setParameterValueAtSampleOffset (RangedAudioParameter& parameter, float newNormalisedValue, int sampleOffset);
+
+    /** Removes all the pending changes from the parameter change queue, and calls the
+        callback with each of them in order of increasing sample offset.
+
+        This should be called once per block from the audio thread, and is realtime-safe.
+        Changes which were made while the previous block was being processed, or by other
+        threads, will have a sample offset of zero.
+
+        The callback should have the signature void (const ParameterChange&).
+
+        @param numSamples   the number of samples in the block that is about to be processed
+        @param callback     a function to call with each change
+    */
+    template <typename Callback>
+    void processParameterChanges (int numSamples, Callback&& callback)
+    {
+        int numChanges = 0;
+        const auto* changes = popParameterChanges (numSamples, numChanges);
+
+        for (int i = 0; i < numChanges; ++i)
+            callback (changes[i]);
+    }
+
+    /** Returns the number of changes which were dropped because the parameter change queue was full. */
+    int64 getNumDroppedParameterChanges() const noexcept;
+
     //==============================================================================
     /** Returns a Value object that can be used to control a particular parameter. */
     Value getParameterAsValue (StringRef parameterID) const;
@@ -419,6 +501,7 @@ public:
 private:
     //==============================================================================
     class ParameterAdapter;
+    class ParameterChangeQueue;
 
 public:
     //==============================================================================
@@ -627,12 +710,15 @@ private:
     //==============================================================================
    #if JUCE_UNIT_TESTS
     friend struct ParameterAdapterTests;
+    friend class AudioProcessorValueTreeStateTests;
    #endif
 
     void addParameterAdapter (RangedAudioParameter&);
     ParameterAdapter* getParameterAdapter (StringRef) const;
 
     bool flushParameterValuesToValueTree();
+    bool flushChangedParameterValuesToValueTree();
+    const ParameterChange* popParameterChanges (int numSamples, int& numChanges) noexcept;
     void setNewState (ValueTree);
     void timerCallback() override;
 
@@ -648,6 +734,7 @@ private:
         bool operator() (StringRef a, StringRef b) const noexcept { return a.text.compare (b.text) < 0; }
     };
 
+    std::unique_ptr<ParameterChangeQueue> changeQueue;
     std::map<StringRef, std::unique_ptr<ParameterAdapter>, StringRefLessThan> adapterTable;
 
     CriticalSection valueTreeChanging;
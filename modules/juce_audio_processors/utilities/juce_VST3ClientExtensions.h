@@ -94,6 +94,50 @@ struct VST3ClientExtensions
         All other input buses will always be designated kAux.
     */
     virtual bool getPluginHasMainInput() const  { return true; }
+
+    //==============================================================================
+    /** A single parameter automation point received from the host.
+
+        @see handleParameterAutomation
+    */
+    struct ParameterAutomationPoint
+    {
+        /** The position of the point within the block that is about to be processed. */
+        int sampleOffset;
+
+        /** The index of the parameter in the AudioProcessor's list of parameters. */
+        int parameterIndex;
+
+        /** The normalised value that the parameter should have at this point. */
+        float value;
+    };
+
+    /** Return true from this function if you'd like handleParameterAutomation() to be
+        called with every automation point that the host sends.
+
+        By default, the wrapper only applies the last value that the host sends for each
+        parameter in a block, so any ramps that the host sends in between are lost.
+
+        This is checked each time the plugin is prepared to play.
+    */
+    virtual bool wantsSampleAccurateParameterAutomation() const    { return false; }
+
+    /** If wantsSampleAccurateParameterAutomation() returns true, this is called on the
+        audio thread immediately before each call to processBlock() or processBlockBypassed(),
+        with all the automation points that the host sent for the block, sorted by sample offset.
+
+        Before this is called, each automated parameter will already have been set to the
+        value of its final point, as usual, so you only need to use the list if you want to
+        follow the changes within the block, e.g. by splitting your processing at each point
+        or by building smoothed ramps between them.
+
+        The array is only valid for the duration of this call. It is filled without allocating,
+        so if the host sends an unusually large number of points, some of them may be missing.
+    */
+    virtual void handleParameterAutomation (const ParameterAutomationPoint* points, int numPoints)
+    {
+        ignoreUnused (points, numPoints);
+    }
 };
 
 } // namespace juce
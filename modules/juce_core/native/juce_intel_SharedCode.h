@@ -47,6 +47,24 @@ static void doCPUID (uint32& a, uint32& b, uint32& c, uint32& d, uint32 type)
     a = la; b = lb; c = lc; d = ld;
 }
 
+// Returns the register state that the OS saves and restores (XCR0), or 0 if the
+// OS hasn't enabled the XGETBV instruction
+static uint64 getEnabledRegisterState()
+{
+    uint32 a = 0, b = 0, c = 0, d = 0;
+    SystemStatsHelpers::doCPUID (a, b, c, d, 1);
+
+    if ((c & (1u << 27)) == 0)
+        return 0;
+
+    uint32 low = 0, high = 0;
+    asm (".byte 0x0f, 0x01, 0xd0" // xgetbv
+           : "=a" (low), "=d" (high)
+           : "c" (0));
+
+    return ((uint64) high << 32) | low;
+}
+
 static void getCPUInfo (bool& hasMMX,
                         bool& hasSSE,
                         bool& hasSSE2,
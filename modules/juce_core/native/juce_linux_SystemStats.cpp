@@ -255,6 +255,8 @@ void CPUInformation::initialise() noexcept
                                     hasAVX512VL,
                                     hasAVX512VBMI,
                                     hasAVX512VPOPCNTDQ);
+
+    clearFlagsForDisabledRegisterState (SystemStatsHelpers::getEnabledRegisterState());
    #endif
 
     numLogicalCPUs = numPhysicalCPUs = []
@@ -269,6 +271,7 @@ void CPUInformation::initialise() noexcept
         return result == 0 ? numCPUs : 1;
     }();
   #else
+    // The kernel leaves out the flags for any instruction sets whose registers it doesn't save
     auto flags = getCpuInfo ("flags");
 
     hasMMX             = flags.contains ("mmx");
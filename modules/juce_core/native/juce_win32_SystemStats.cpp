@@ -59,11 +59,26 @@ static void callCPUID (int result[4], uint32 type)
   result[0] = (int) la; result[1] = (int) lb;
   result[2] = (int) lc; result[3] = (int) ld;
 }
+
+static uint64 callXGETBV()
+{
+    uint32 low = 0, high = 0;
+    asm (".byte 0x0f, 0x01, 0xd0" // xgetbv
+           : "=a" (low), "=d" (high)
+           : "c" (0));
+
+    return ((uint64) high << 32) | low;
+}
 #else
 static void callCPUID (int result[4], int infoType)
 {
     __cpuid (result, infoType);
 }
+
+static uint64 callXGETBV()
+{
+    return (uint64) _xgetbv (0);
+}
 #endif
 
 String SystemStats::getCpuVendor()
@@ -168,6 +183,10 @@ void CPUInformation::initialise() noexcept
     hasAVX512VBMI      = ((unsigned int) info[2] & (1u <<  1)) != 0;
     hasAVX512VPOPCNTDQ = ((unsigned int) info[2] & (1u << 14)) != 0;
 
+    callCPUID (info, 1);
+    const auto osUsesXSave = ((unsigned int) info[2] & (1u << 27)) != 0;
+    clearFlagsForDisabledRegisterState (osUsesXSave ? callXGETBV() : 0);
+
     SYSTEM_INFO systemInfo;
     GetNativeSystemInfo (&systemInfo);
     numLogicalCPUs  = (int) systemInfo.dwNumberOfProcessors;
@@ -107,3 +107,15 @@
 #else
  #define JUCE_NODISCARD
 #endif
+
+//==============================================================================
+/*  When this is set, modules may compile AVX2 and AVX-512 versions of their hot loops
+    with per-function target attributes, so that they can be built alongside code that
+    only assumes SSE2, and only call them if SystemStats::hasAVX2() or hasAVX512F() say
+    that they can run. clang-cl's headers don't allow intrinsics to be used in functions
+    that are compiled for a different target.
+*/
+#if ! defined (JUCE_USE_AVX_DISPATCH) && JUCE_INTEL && JUCE_64BIT \
+     && (JUCE_MSVC || ((JUCE_GCC || JUCE_CLANG) && ! defined (_MSC_VER)))
+ #define JUCE_USE_AVX_DISPATCH 1
+#endif
@@ -88,6 +88,24 @@ struct CPUInformation
 
     void initialise() noexcept;
 
+    /*  CPUID only says which instructions the CPU supports, but the AVX and AVX-512
+        registers can only be used if the OS saves and restores them when it switches
+        threads. This takes the register state that the OS has enabled in XCR0, and
+        clears the flags for any instruction sets that need more than that.
+    */
+    void clearFlagsForDisabledRegisterState (uint64 enabledRegisterState) noexcept
+    {
+        constexpr uint64 avxState    = (1u << 1) | (1u << 2);                          // XMM and YMM
+        constexpr uint64 avx512State = avxState | (1u << 5) | (1u << 6) | (1u << 7);   // opmask, ZMM_Hi256 and Hi16_ZMM
+
+        if ((enabledRegisterState & avxState) != avxState)
+            hasAVX = hasAVX2 = hasFMA3 = hasFMA4 = false;
+
+        if ((enabledRegisterState & avx512State) != avx512State)
+            hasAVX512F = hasAVX512BW = hasAVX512CD = hasAVX512DQ = hasAVX512ER = hasAVX512IFMA
+                = hasAVX512PF = hasAVX512VBMI = hasAVX512VL = hasAVX512VPOPCNTDQ = false;
+    }
+
     int numLogicalCPUs = 0, numPhysicalCPUs = 0;
 
     bool hasMMX      = false, hasSSE        = false, hasSSE2       = false, hasSSE3       = false,
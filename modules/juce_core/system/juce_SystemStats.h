@@ -172,6 +172,9 @@ public:
     */
     static String getCpuModel();
 
+    /*  The AVX, FMA and AVX-512 flags are only set if the operating system has enabled
+        the registers that those instructions use, as well as the CPU supporting them.
+    */
     static bool hasMMX() noexcept;             /**< Returns true if Intel MMX instructions are available. */
     static bool has3DNow() noexcept;           /**< Returns true if AMD 3DNOW instructions are available. */
     static bool hasFMA3() noexcept;            /**< Returns true if AMD FMA3 instructions are available. */
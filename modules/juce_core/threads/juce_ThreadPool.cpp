@@ -23,22 +23,141 @@
 namespace juce
 {
 
+//==============================================================================
+struct ThreadPool::Task
+{
+    std::function<void()> job;
+    std::function<ThreadPoolJob::JobStatus()> jobWithStatus;
+};
+
+//==============================================================================
+/*  A fixed-size lock-free queue of tasks that any number of threads can push to
+    and pop from. This is Dmitry Vyukov's bounded MPMC queue: each cell has a
+    sequence number which tells producers and consumers whether the cell is
+    ready for them, so the only contention is on the two position counters.
+*/
+class ThreadPool::TaskQueue
+{
+public:
+    explicit TaskQueue (size_t capacity)
+        : cells (capacity), mask (capacity - 1)
+    {
+        jassert (isPowerOfTwo (capacity));
+
+        for (size_t i = 0; i < capacity; ++i)
+            cells[i].sequence.store (i, std::memory_order_relaxed);
+    }
+
+    bool push (Task&& task) noexcept
+    {
+        auto pos = enqueuePos.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[pos & mask];
+            const auto seq = cell.sequence.load (std::memory_order_acquire);
+            const auto diff = (intptr_t) seq - (intptr_t) pos;
+
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.task = std::move (task);
+                    cell.sequence.store (pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop (Task& result) noexcept
+    {
+        auto pos = dequeuePos.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[pos & mask];
+            const auto seq = cell.sequence.load (std::memory_order_acquire);
+            const auto diff = (intptr_t) seq - (intptr_t) (pos + 1);
+
+            if (diff == 0)
+            {
+                if (dequeuePos.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                {
+                    result = std::move (cell.task);
+                    cell.task = {};
+                    cell.sequence.store (pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = dequeuePos.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence { 0 };
+        Task task;
+    };
+
+    std::vector<Cell> cells;
+    const size_t mask;
+    std::atomic<size_t> enqueuePos { 0 }, dequeuePos { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (TaskQueue)
+};
+
+//==============================================================================
 struct ThreadPool::ThreadPoolThread  : public Thread
 {
-    ThreadPoolThread (ThreadPool& p, size_t stackSize)
-       : Thread ("Pool", stackSize), pool (p)
+    ThreadPoolThread (ThreadPool& p, size_t stackSize, int threadIndex)
+       : Thread ("Pool", stackSize), pool (p), index (threadIndex)
     {
+        if (pool.jobScheduling == JobScheduling::workStealing)
+            tasks = std::make_unique<TaskQueue> (taskQueueSize);
     }
 
     void run() override
     {
         while (! threadShouldExit())
-            if (! pool.runNextJob (*this))
+        {
+            if (pool.runNextTask (*this) || pool.runNextJob (*this))
+                continue;
+
+            isIdle = true;
+
+            // A task may have been added just before this thread was marked as idle,
+            // in which case nobody will have woken it
+            if (pool.numQueuedTasks.load() <= 0)
                 wait (500);
+
+            isIdle = false;
+        }
     }
 
+    static constexpr size_t taskQueueSize = 1024;
+
     std::atomic<ThreadPoolJob*> currentJob { nullptr };
     ThreadPool& pool;
+    const int index;
+    std::unique_ptr<TaskQueue> tasks;
+    std::atomic<bool> isIdle { false };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
 };
@@ -102,6 +221,14 @@ ThreadPool::ThreadPool()
     createThreads (SystemStats::getNumCpus());
 }
 
+ThreadPool::ThreadPool (int numThreads, size_t threadStackSize, JobScheduling scheduling)
+    : jobScheduling (scheduling)
+{
+    jassert (numThreads > 0); // not much point having a pool without any threads!
+
+    createThreads (numThreads, threadStackSize);
+}
+
 ThreadPool::~ThreadPool()
 {
     removeAllJobs (true, 5000);
@@ -110,8 +237,8 @@ ThreadPool::~ThreadPool()
 
 void ThreadPool::createThreads (int numThreads, size_t threadStackSize)
 {
-    for (int i = jmax (1, numThreads); --i >= 0;)
-        threads.add (new ThreadPoolThread (*this, threadStackSize));
+    for (int i = 0; i < jmax (1, numThreads); ++i)
+        threads.add (new ThreadPoolThread (*this, threadStackSize, i));
 
     for (auto* t : threads)
         t->startThread();
@@ -150,6 +277,18 @@ void ThreadPool::addJob (ThreadPoolJob* job, bool deleteJobWhenFinished)
 
 void ThreadPool::addJob (std::function<ThreadPoolJob::JobStatus()> jobToRun)
 {
+    if (jobScheduling == JobScheduling::workStealing)
+    {
+        Task task;
+        task.jobWithStatus = std::move (jobToRun);
+
+        if (addTask (std::move (task)))
+            return;
+
+        // All the queues are full, so fall back to the shared queue
+        jobToRun = std::move (task.jobWithStatus);
+    }
+
     struct LambdaJobWrapper  : public ThreadPoolJob
     {
         LambdaJobWrapper (std::function<ThreadPoolJob::JobStatus()> j) : ThreadPoolJob ("lambda"), job (j) {}
@@ -163,6 +302,18 @@ void ThreadPool::addJob (std::function<ThreadPoolJob::JobStatus()> jobToRun)
 
 void ThreadPool::addJob (std::function<void()> jobToRun)
 {
+    if (jobScheduling == JobScheduling::workStealing)
+    {
+        Task task;
+        task.job = std::move (jobToRun);
+
+        if (addTask (std::move (task)))
+            return;
+
+        // All the queues are full, so fall back to the shared queue
+        jobToRun = std::move (task.job);
+    }
+
     struct LambdaJobWrapper  : public ThreadPoolJob
     {
         LambdaJobWrapper (std::function<void()> j) : ThreadPoolJob ("lambda"), job (j) {}
@@ -177,7 +328,7 @@ void ThreadPool::addJob (std::function<void()> jobToRun)
 int ThreadPool::getNumJobs() const noexcept
 {
     const ScopedLock sl (lock);
-    return jobs.size();
+    return jobs.size() + numTasks.load();
 }
 
 int ThreadPool::getNumThreads() const noexcept
@@ -294,6 +445,7 @@ bool ThreadPool::removeAllJobs (bool interruptRunningJobs, int timeOutMs,
         }
     }
 
+    const auto removeTasks = (jobScheduling == JobScheduling::workStealing && selectedJobsToRemove == nullptr);
     auto start = Time::getMillisecondCounter();
 
     for (;;)
@@ -306,7 +458,12 @@ bool ThreadPool::removeAllJobs (bool interruptRunningJobs, int timeOutMs,
                 jobsToWaitFor.remove (i);
         }
 
-        if (jobsToWaitFor.size() == 0)
+        // Tasks that are running can't be interrupted, but any that they add to the
+        // queues while we're waiting must also be removed
+        if (removeTasks)
+            removeQueuedTasks();
+
+        if (jobsToWaitFor.size() == 0 && (! removeTasks || numTasks.load() <= 0))
             break;
 
         if (timeOutMs >= 0 && Time::getMillisecondCounter() >= start + (uint32) timeOutMs)
@@ -420,6 +577,120 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
     return false;
 }
 
+//==============================================================================
+bool ThreadPool::addTask (Task&& task)
+{
+    const auto numThreads = threads.size();
+
+    // Jobs added by one of our own threads go to the back of its own queue, so that
+    // related work tends to stay on the same core
+    auto* currentThread = dynamic_cast<ThreadPoolThread*> (Thread::getCurrentThread());
+    const auto firstQueue = (currentThread != nullptr && &currentThread->pool == this)
+                              ? currentThread->index
+                              : (int) (nextTaskQueue++ % (uint32) numThreads);
+
+    ++numTasks;
+    ++numQueuedTasks;
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        const auto queueIndex = (firstQueue + i) % numThreads;
+
+        if (threads.getUnchecked (queueIndex)->tasks->push (std::move (task)))
+        {
+            wakeThreadForTask (queueIndex);
+            return true;
+        }
+    }
+
+    --numQueuedTasks;
+    --numTasks;
+    return false;
+}
+
+void ThreadPool::wakeThreadForTask (int preferredThread)
+{
+    const auto numThreads = threads.size();
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        auto* thread = threads.getUnchecked ((preferredThread + i) % numThreads);
+
+        if (thread->isIdle.load())
+        {
+            thread->notify();
+            return;
+        }
+    }
+}
+
+bool ThreadPool::runNextTask (ThreadPoolThread& thread)
+{
+    if (jobScheduling != JobScheduling::workStealing)
+        return false;
+
+    Task task;
+    const auto numThreads = threads.size();
+
+    // Start with this thread's own queue, then try to steal from the others
+    for (int i = 0; i < numThreads; ++i)
+    {
+        if (threads.getUnchecked ((thread.index + i) % numThreads)->tasks->pop (task))
+        {
+            --numQueuedTasks;
+
+            auto result = ThreadPoolJob::jobHasFinished;
+
+            try
+            {
+                if (task.job != nullptr)
+                    task.job();
+                else
+                    result = task.jobWithStatus();
+            }
+            catch (...)
+            {
+                jassertfalse; // Your job mustn't throw any exceptions!
+            }
+
+            if (result == ThreadPoolJob::jobNeedsRunningAgain)
+            {
+                ++numQueuedTasks;
+
+                if (thread.tasks->push (std::move (task)))
+                    return true;
+
+                // This thread's queue is full, so the shared queue will have to take it
+                --numQueuedTasks;
+                addJob (std::move (task.jobWithStatus));
+            }
+
+            if (--numTasks == 0)
+                jobFinishedSignal.signal();
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::removeQueuedTasks()
+{
+    Task task;
+
+    for (auto* t : threads)
+    {
+        while (t->tasks->pop (task))
+        {
+            --numQueuedTasks;
+
+            if (--numTasks == 0)
+                jobFinishedSignal.signal();
+        }
+    }
+}
+
 void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, ThreadPoolJob* job) const
 {
     job->shouldStop = true;
@@ -429,4 +700,179 @@ void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, Threa
         deletionList.add (job);
 }
 
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ThreadPoolTests  : public UnitTest
+{
+public:
+    ThreadPoolTests()
+        : UnitTest ("ThreadPool", UnitTestCategories::threads)
+    {}
+
+    void runTest() override
+    {
+        for (auto scheduling : { ThreadPool::JobScheduling::sharedQueue, ThreadPool::JobScheduling::workStealing })
+        {
+            const String suffix (scheduling == ThreadPool::JobScheduling::workStealing ? " (work stealing)" : " (shared queue)");
+
+            beginTest ("Every lambda job runs exactly once" + suffix);
+            {
+                constexpr int numJobs = 5000;
+                std::vector<std::atomic<int>> counts (numJobs);
+
+                {
+                    ThreadPool pool (4, 0, scheduling);
+                    expect (pool.getJobScheduling() == scheduling);
+
+                    for (int i = 0; i < numJobs; ++i)
+                        pool.addJob ([&counts, i] { ++counts[(size_t) i]; });
+
+                    expect (waitForAllJobs (pool));
+                }
+
+                expect (std::all_of (counts.begin(), counts.end(), [] (const std::atomic<int>& c) { return c.load() == 1; }));
+            }
+
+            beginTest ("Jobs can be run again" + suffix);
+            {
+                std::atomic<int> count { 0 };
+
+                ThreadPool pool (2, 0, scheduling);
+
+                pool.addJob (std::function<ThreadPoolJob::JobStatus()> ([&count]
+                {
+                    return ++count < 10 ? ThreadPoolJob::jobNeedsRunningAgain
+                                        : ThreadPoolJob::jobHasFinished;
+                }));
+
+                expect (waitForAllJobs (pool));
+                expectEquals (count.load(), 10);
+            }
+
+            beginTest ("Jobs can add more jobs" + suffix);
+            {
+                std::atomic<int> count { 0 };
+
+                ThreadPool pool (3, 0, scheduling);
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    pool.addJob ([&pool, &count]
+                    {
+                        for (int j = 0; j < 10; ++j)
+                            pool.addJob ([&count] { ++count; });
+                    });
+                }
+
+                expect (waitForAllJobs (pool));
+                expectEquals (count.load(), 1000);
+            }
+
+            beginTest ("Queued jobs are removed" + suffix);
+            {
+                std::atomic<int> count { 0 };
+
+                ThreadPool pool (1, 0, scheduling);
+
+                pool.addJob ([] { Thread::sleep (200); });
+
+                for (int i = 0; i < 100; ++i)
+                    pool.addJob ([&count] { ++count; });
+
+                expect (pool.removeAllJobs (true, 5000));
+                expectEquals (pool.getNumJobs(), 0);
+                expectEquals (count.load(), 0);
+            }
+        }
+    }
+
+    static bool waitForAllJobs (ThreadPool& pool)
+    {
+        const auto timeout = Time::getMillisecondCounter() + 10000;
+
+        while (pool.getNumJobs() > 0)
+        {
+            if (Time::getMillisecondCounter() > timeout)
+                return false;
+
+            Thread::sleep (1);
+        }
+
+        return true;
+    }
+};
+
+static ThreadPoolTests threadPoolTests;
+
+//==============================================================================
+class ThreadPoolBenchmarks  : public UnitTest
+{
+public:
+    ThreadPoolBenchmarks()
+        : UnitTest ("ThreadPool throughput", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        constexpr int numJobs = 200000;
+
+        for (auto numThreads : { 1, 4, 16, 64 })
+        {
+            beginTest (String (numJobs) + " small jobs on " + String (numThreads) + " thread(s)");
+
+            const auto sharedTime   = timeJobs (numThreads, numJobs, ThreadPool::JobScheduling::sharedQueue);
+            const auto stealingTime = timeJobs (numThreads, numJobs, ThreadPool::JobScheduling::workStealing);
+
+            logMessage ("Shared queue:  " + String (numJobs / sharedTime, 0) + " jobs/s");
+            logMessage ("Work stealing: " + String (numJobs / stealingTime, 0) + " jobs/s, "
+                          + String (sharedTime / stealingTime, 2) + "x");
+
+            expect (sharedTime > 0.0 && stealingTime > 0.0);
+        }
+    }
+
+    static double timeJobs (int numThreads, int numJobs, ThreadPool::JobScheduling scheduling)
+    {
+        struct State
+        {
+            std::atomic<int> remaining;
+            std::atomic<uint32> sink { 0 };
+            WaitableEvent finished;
+        };
+
+        ThreadPool pool (numThreads, 0, scheduling);
+        State state;
+        state.remaining = numJobs;
+
+        const auto start = Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numJobs; ++i)
+        {
+            // Keeping the captures small means that std::function doesn't need to allocate
+            pool.addJob ([s = &state, i]
+            {
+                auto x = (uint32) i;
+
+                for (int j = 0; j < 100; ++j)
+                    x = x * 1664525u + 1013904223u;
+
+                s->sink += x;
+
+                if (--s->remaining == 0)
+                    s->finished.signal();
+            });
+        }
+
+        state.finished.wait (-1);
+        return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+    }
+};
+
+static ThreadPoolBenchmarks threadPoolBenchmarks;
+
+#endif
+
 } // namespace juce
@@ -175,6 +175,37 @@ public:
     */
     ThreadPool();
 
+    //==============================================================================
+    /** The ways in which a pool can hand out jobs to its threads. */
+    enum class JobScheduling
+    {
+        /** All jobs wait in a single queue, which is shared by all of the threads. */
+        sharedQueue,
+
+        /** Lambda jobs are spread across a queue for each thread, and threads that run
+            out of work steal jobs from the queues of the others. ThreadPoolJob objects
+            still go through the shared queue.
+
+            This avoids contention between threads when adding large numbers of small
+            jobs, and lambda jobs are added without the pool allocating any memory. The
+            downside is that the lambda jobs added in this mode don't appear in the list
+            of jobs returned by getJob() or getNamesOfAllJobs(), and can only be removed
+            with removeAllJobs().
+        */
+        workStealing
+    };
+
+    /** Creates a thread pool that uses a particular scheduling strategy.
+
+        @param numberOfThreads  the number of threads to run. These will be started
+                                immediately, and will run until the pool is deleted.
+        @param threadStackSize  the size of the stack of each thread. If this value
+                                is zero then the default stack size of the OS will
+                                be used.
+        @param scheduling       the way in which jobs are given to the threads
+    */
+    ThreadPool (int numberOfThreads, size_t threadStackSize, JobScheduling scheduling);
+
     /** Destructor.
 
         This will attempt to remove all the jobs before deleting, but if you want to
@@ -221,12 +252,14 @@ public:
                  bool deleteJobWhenFinished);
 
     /** Adds a lambda function to be called as a job.
-        This will create an internal ThreadPoolJob object to encapsulate and call the lambda.
+        This will create an internal ThreadPoolJob object to encapsulate and call the lambda,
+        unless the pool is using JobScheduling::workStealing.
     */
     void addJob (std::function<ThreadPoolJob::JobStatus()> job);
 
     /** Adds a lambda function to be called as a job.
-        This will create an internal ThreadPoolJob object to encapsulate and call the lambda.
+        This will create an internal ThreadPoolJob object to encapsulate and call the lambda,
+        unless the pool is using JobScheduling::workStealing.
     */
     void addJob (std::function<void()> job);
 
@@ -272,6 +305,9 @@ public:
     /** Returns the number of threads assigned to this thread pool. */
     int getNumThreads() const noexcept;
 
+    /** Returns the scheduling strategy that was chosen when the pool was created. */
+    JobScheduling getJobScheduling() const noexcept     { return jobScheduling; }
+
     /** Returns one of the jobs in the queue.
 
         Note that this can be a very volatile list as jobs might be continuously getting shifted
@@ -327,7 +363,17 @@ private:
     CriticalSection lock;
     WaitableEvent jobFinishedSignal;
 
+    struct Task;
+    class TaskQueue;
+    const JobScheduling jobScheduling = JobScheduling::sharedQueue;
+    std::atomic<int> numTasks { 0 }, numQueuedTasks { 0 };
+    std::atomic<uint32> nextTaskQueue { 0 };
+
     bool runNextJob (ThreadPoolThread&);
+    bool runNextTask (ThreadPoolThread&);
+    bool addTask (Task&&);
+    void removeQueuedTasks();
+    void wakeThreadForTask (int preferredThread);
     ThreadPoolJob* pickNextJobToRun();
     void addToDeleteList (OwnedArray<ThreadPoolJob>&, ThreadPoolJob*) const;
     void createThreads (int numThreads, size_t threadStackSize = 0);
@@ -151,19 +151,34 @@ struct ConvolutionEngine
     ConvolutionEngine (const float* samples,
                        size_t numSamples,
                        size_t maxBlockSize)
-        : blockSize ((size_t) nextPowerOfTwo ((int) maxBlockSize)),
+        : ConvolutionEngine (&samples, 1, 1, numSamples, maxBlockSize)
+    {}
+
+    // Creates an engine that convolves several inputs with a matrix of impulse responses,
+    // where paths[input * numOutputs + output] is the response from that input to that output.
+    // Each input is transformed once per block and shared between all of its paths, and the
+    // products for each output are summed before a single inverse transform.
+    ConvolutionEngine (const float* const* paths,
+                       size_t numInputsIn,
+                       size_t numOutputsIn,
+                       size_t numSamples,
+                       size_t maxBlockSize)
+        : numInputs (numInputsIn),
+          numOutputs (numOutputsIn),
+          blockSize ((size_t) nextPowerOfTwo ((int) maxBlockSize)),
           fftSize (blockSize > 128 ? 2 * blockSize : 4 * blockSize),
           fftObject (std::make_unique<FFT> (roundToInt (std::log2 (fftSize)))),
           numSegments (numSamples / (fftSize - blockSize) + 1u),
           numInputSegments ((blockSize > 128 ? numSegments : 3 * numSegments)),
-          bufferInput      (1, static_cast<int> (fftSize)),
-          bufferOutput     (1, static_cast<int> (fftSize * 2)),
-          bufferTempOutput (1, static_cast<int> (fftSize * 2)),
-          bufferOverlap    (1, static_cast<int> (fftSize))
+          bufferInput      (static_cast<int> (numInputs),  static_cast<int> (fftSize)),
+          bufferOutput     (static_cast<int> (numOutputs), static_cast<int> (fftSize * 2)),
+          bufferTempOutput (static_cast<int> (numOutputs), static_cast<int> (fftSize * 2)),
+          bufferOverlap    (static_cast<int> (numOutputs), static_cast<int> (fftSize))
     {
         bufferOutput.clear();
 
         auto updateSegmentsIfNecessary = [this] (size_t numSegmentsToUpdate,
+                                                 size_t numChannels,
                                                  std::vector<AudioBuffer<float>>& segments)
         {
             if (numSegmentsToUpdate == 0
@@ -173,12 +188,12 @@ struct ConvolutionEngine
                 segments.clear();
 
                 for (size_t i = 0; i < numSegmentsToUpdate; ++i)
-                    segments.push_back ({ 1, static_cast<int> (fftSize * 2) });
+                    segments.push_back ({ static_cast<int> (numChannels), static_cast<int> (fftSize * 2) });
             }
         };
 
-        updateSegmentsIfNecessary (numInputSegments, buffersInputSegments);
-        updateSegmentsIfNecessary (numSegments,      buffersImpulseSegments);
+        updateSegmentsIfNecessary (numInputSegments, numInputs,              buffersInputSegments);
+        updateSegmentsIfNecessary (numSegments,      numInputs * numOutputs, buffersImpulseSegments);
 
         auto FFTTempObject = std::make_unique<FFT> (roundToInt (std::log2 (fftSize)));
         size_t currentPtr = 0;
@@ -187,17 +202,20 @@ struct ConvolutionEngine
         {
             buf.clear();
 
-            auto* impulseResponse = buf.getWritePointer (0);
+            for (auto path = 0; path < buf.getNumChannels(); ++path)
+            {
+                auto* impulseResponse = buf.getWritePointer (path);
 
-            if (&buf == &buffersImpulseSegments.front())
-                impulseResponse[0] = 1.0f;
+                if (&buf == &buffersImpulseSegments.front())
+                    impulseResponse[0] = 1.0f;
 
-            FloatVectorOperations::copy (impulseResponse,
-                                         samples + currentPtr,
-                                         static_cast<int> (jmin (fftSize - blockSize, numSamples - currentPtr)));
+                FloatVectorOperations::copy (impulseResponse,
+                                             paths[path] + currentPtr,
+                                             static_cast<int> (jmin (fftSize - blockSize, numSamples - currentPtr)));
 
-            FFTTempObject->performRealOnlyForwardTransform (impulseResponse);
-            prepareForConvolution (impulseResponse);
+                FFTTempObject->performRealOnlyForwardTransform (impulseResponse);
+                prepareForConvolution (impulseResponse);
+            }
 
             currentPtr += (fftSize - blockSize);
         }
@@ -221,60 +239,63 @@ struct ConvolutionEngine
 
     void processSamples (const float* input, float* output, size_t numSamples)
     {
-        // Overlap-add, zero latency convolution algorithm with uniform partitioning
-        size_t numSamplesProcessed = 0;
+        processSamples (&input, 1, &output, 1, numSamples);
+    }
 
-        auto indexStep = numInputSegments / numSegments;
+    // Any inputs beyond numInputChannels are treated as silent, and any outputs beyond
+    // numOutputChannels are computed but discarded.
+    void processSamples (const float* const* input, size_t numInputChannels,
+                         float* const* output, size_t numOutputChannels,
+                         size_t numSamples)
+    {
+        jassert (numInputChannels <= numInputs && numOutputChannels <= numOutputs);
 
-        auto* inputData      = bufferInput.getWritePointer (0);
-        auto* outputTempData = bufferTempOutput.getWritePointer (0);
-        auto* outputData     = bufferOutput.getWritePointer (0);
-        auto* overlapData    = bufferOverlap.getWritePointer (0);
+        // Overlap-add, zero latency convolution algorithm with uniform partitioning
+        size_t numSamplesProcessed = 0;
 
         while (numSamplesProcessed < numSamples)
         {
             const bool inputDataWasEmpty = (inputDataPos == 0);
             auto numSamplesToProcess = jmin (numSamples - numSamplesProcessed, blockSize - inputDataPos);
 
-            FloatVectorOperations::copy (inputData + inputDataPos, input + numSamplesProcessed, static_cast<int> (numSamplesToProcess));
+            for (size_t in = 0; in < numInputs; ++in)
+            {
+                auto* inputData = bufferInput.getWritePointer ((int) in);
 
-            auto* inputSegmentData = buffersInputSegments[currentSegment].getWritePointer (0);
-            FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
+                if (in < numInputChannels)
+                    FloatVectorOperations::copy (inputData + inputDataPos, input[in] + numSamplesProcessed, static_cast<int> (numSamplesToProcess));
 
-            fftObject->performRealOnlyForwardTransform (inputSegmentData);
-            prepareForConvolution (inputSegmentData);
+                auto* inputSegmentData = buffersInputSegments[currentSegment].getWritePointer ((int) in);
+                FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
 
-            // Complex multiplication
-            if (inputDataWasEmpty)
-            {
-                FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
+                fftObject->performRealOnlyForwardTransform (inputSegmentData);
+                prepareForConvolution (inputSegmentData);
+            }
 
-                auto index = currentSegment;
+            for (size_t out = 0; out < numOutputs; ++out)
+            {
+                auto* outputTempData = bufferTempOutput.getWritePointer ((int) out);
+                auto* outputData     = bufferOutput.getWritePointer ((int) out);
+                auto* overlapData    = bufferOverlap.getWritePointer ((int) out);
 
-                for (size_t i = 1; i < numSegments; ++i)
+                // Complex multiplication
+                if (inputDataWasEmpty)
                 {
-                    index += indexStep;
-
-                    if (index >= numInputSegments)
-                        index -= numInputSegments;
-
-                    convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
-                                                        buffersImpulseSegments[i].getWritePointer (0),
-                                                        outputTempData);
+                    FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
+                    accumulatePreviousSegments (out, outputTempData);
                 }
-            }
 
-            FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
+                FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
 
-            convolutionProcessingAndAccumulate (inputSegmentData,
-                                                buffersImpulseSegments.front().getWritePointer (0),
-                                                outputData);
+                accumulateSegment (currentSegment, 0, out, outputData);
 
-            updateSymmetricFrequencyDomainData (outputData);
-            fftObject->performRealOnlyInverseTransform (outputData);
+                updateSymmetricFrequencyDomainData (outputData);
+                fftObject->performRealOnlyInverseTransform (outputData);
 
-            // Add overlap
-            FloatVectorOperations::add (&output[numSamplesProcessed], &outputData[inputDataPos], &overlapData[inputDataPos], (int) numSamplesToProcess);
+                // Add overlap
+                if (out < numOutputChannels)
+                    FloatVectorOperations::add (&output[out][numSamplesProcessed], &outputData[inputDataPos], &overlapData[inputDataPos], (int) numSamplesToProcess);
+            }
 
             // Input buffer full => Next block
             inputDataPos += numSamplesToProcess;
@@ -282,15 +303,22 @@ struct ConvolutionEngine
             if (inputDataPos == blockSize)
             {
                 // Input buffer is empty again now
-                FloatVectorOperations::fill (inputData, 0.0f, static_cast<int> (fftSize));
+                for (size_t in = 0; in < numInputs; ++in)
+                    FloatVectorOperations::fill (bufferInput.getWritePointer ((int) in), 0.0f, static_cast<int> (fftSize));
 
                 inputDataPos = 0;
 
-                // Extra step for segSize > blockSize
-                FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
+                for (size_t out = 0; out < numOutputs; ++out)
+                {
+                    auto* outputData  = bufferOutput.getWritePointer ((int) out);
+                    auto* overlapData = bufferOverlap.getWritePointer ((int) out);
+
+                    // Extra step for segSize > blockSize
+                    FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
 
-                // Save the overlap
-                FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
+                    // Save the overlap
+                    FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
+                }
 
                 currentSegment = (currentSegment > 0) ? (currentSegment - 1) : (numInputSegments - 1);
             }
@@ -301,23 +329,27 @@ struct ConvolutionEngine
 
     void processSamplesWithAddedLatency (const float* input, float* output, size_t numSamples)
     {
-        // Overlap-add, zero latency convolution algorithm with uniform partitioning
-        size_t numSamplesProcessed = 0;
+        processSamplesWithAddedLatency (&input, 1, &output, 1, numSamples);
+    }
 
-        auto indexStep = numInputSegments / numSegments;
+    void processSamplesWithAddedLatency (const float* const* input, size_t numInputChannels,
+                                         float* const* output, size_t numOutputChannels,
+                                         size_t numSamples)
+    {
+        jassert (numInputChannels <= numInputs && numOutputChannels <= numOutputs);
 
-        auto* inputData      = bufferInput.getWritePointer (0);
-        auto* outputTempData = bufferTempOutput.getWritePointer (0);
-        auto* outputData     = bufferOutput.getWritePointer (0);
-        auto* overlapData    = bufferOverlap.getWritePointer (0);
+        // Overlap-add, zero latency convolution algorithm with uniform partitioning
+        size_t numSamplesProcessed = 0;
 
         while (numSamplesProcessed < numSamples)
         {
             auto numSamplesToProcess = jmin (numSamples - numSamplesProcessed, blockSize - inputDataPos);
 
-            FloatVectorOperations::copy (inputData + inputDataPos, input + numSamplesProcessed, static_cast<int> (numSamplesToProcess));
+            for (size_t in = 0; in < numInputChannels; ++in)
+                FloatVectorOperations::copy (bufferInput.getWritePointer ((int) in) + inputDataPos, input[in] + numSamplesProcessed, static_cast<int> (numSamplesToProcess));
 
-            FloatVectorOperations::copy (output + numSamplesProcessed, outputData + inputDataPos, static_cast<int> (numSamplesToProcess));
+            for (size_t out = 0; out < numOutputChannels; ++out)
+                FloatVectorOperations::copy (output[out] + numSamplesProcessed, bufferOutput.getReadPointer ((int) out) + inputDataPos, static_cast<int> (numSamplesToProcess));
 
             numSamplesProcessed += numSamplesToProcess;
             inputDataPos += numSamplesToProcess;
@@ -325,50 +357,47 @@ struct ConvolutionEngine
             // processing itself when needed (with latency)
             if (inputDataPos == blockSize)
             {
-                // Copy input data in input segment
-                auto* inputSegmentData = buffersInputSegments[currentSegment].getWritePointer (0);
-                FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
+                for (size_t in = 0; in < numInputs; ++in)
+                {
+                    auto* inputData = bufferInput.getWritePointer ((int) in);
 
-                fftObject->performRealOnlyForwardTransform (inputSegmentData);
-                prepareForConvolution (inputSegmentData);
+                    // Copy input data in input segment
+                    auto* inputSegmentData = buffersInputSegments[currentSegment].getWritePointer ((int) in);
+                    FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
 
-                // Complex multiplication
-                FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
+                    fftObject->performRealOnlyForwardTransform (inputSegmentData);
+                    prepareForConvolution (inputSegmentData);
 
-                auto index = currentSegment;
+                    // Input buffer is empty again now
+                    FloatVectorOperations::fill (inputData, 0.0f, static_cast<int> (fftSize));
+                }
 
-                for (size_t i = 1; i < numSegments; ++i)
+                for (size_t out = 0; out < numOutputs; ++out)
                 {
-                    index += indexStep;
-
-                    if (index >= numInputSegments)
-                        index -= numInputSegments;
-
-                    convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
-                                                        buffersImpulseSegments[i].getWritePointer (0),
-                                                        outputTempData);
-                }
+                    auto* outputTempData = bufferTempOutput.getWritePointer ((int) out);
+                    auto* outputData     = bufferOutput.getWritePointer ((int) out);
+                    auto* overlapData    = bufferOverlap.getWritePointer ((int) out);
 
-                FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
+                    // Complex multiplication
+                    FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
+                    accumulatePreviousSegments (out, outputTempData);
 
-                convolutionProcessingAndAccumulate (inputSegmentData,
-                                                    buffersImpulseSegments.front().getWritePointer (0),
-                                                    outputData);
+                    FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
 
-                updateSymmetricFrequencyDomainData (outputData);
-                fftObject->performRealOnlyInverseTransform (outputData);
+                    accumulateSegment (currentSegment, 0, out, outputData);
 
-                // Add overlap
-                FloatVectorOperations::add (outputData, overlapData, static_cast<int> (blockSize));
+                    updateSymmetricFrequencyDomainData (outputData);
+                    fftObject->performRealOnlyInverseTransform (outputData);
 
-                // Input buffer is empty again now
-                FloatVectorOperations::fill (inputData, 0.0f, static_cast<int> (fftSize));
+                    // Add overlap
+                    FloatVectorOperations::add (outputData, overlapData, static_cast<int> (blockSize));
 
-                // Extra step for segSize > blockSize
-                FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
+                    // Extra step for segSize > blockSize
+                    FloatVectorOperations::add (&(outputData[blockSize]), &(overlapData[blockSize]), static_cast<int> (fftSize - 2 * blockSize));
 
-                // Save the overlap
-                FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
+                    // Save the overlap
+                    FloatVectorOperations::copy (overlapData, &(outputData[blockSize]), static_cast<int> (fftSize - blockSize));
+                }
 
                 currentSegment = (currentSegment > 0) ? (currentSegment - 1) : (numInputSegments - 1);
 
@@ -377,6 +406,33 @@ struct ConvolutionEngine
         }
     }
 
+    // Sums the products of every input's spectrum in the given input segment with the
+    // matching impulse segment of its path to the given output.
+    void accumulateSegment (size_t inputSegment, size_t impulseSegment, size_t out, float* destination)
+    {
+        for (size_t in = 0; in < numInputs; ++in)
+            convolutionProcessingAndAccumulate (buffersInputSegments[inputSegment].getReadPointer ((int) in),
+                                                buffersImpulseSegments[impulseSegment].getReadPointer ((int) (in * numOutputs + out)),
+                                                destination);
+    }
+
+    // Sums the contributions of all previous input segments to the given output.
+    void accumulatePreviousSegments (size_t out, float* destination)
+    {
+        const auto indexStep = numInputSegments / numSegments;
+        auto index = currentSegment;
+
+        for (size_t i = 1; i < numSegments; ++i)
+        {
+            index += indexStep;
+
+            if (index >= numInputSegments)
+                index -= numInputSegments;
+
+            accumulateSegment (index, i, out, destination);
+        }
+    }
+
     // After each FFT, this function is called to allow convolution to be performed with only 4 SIMD functions calls.
     void prepareForConvolution (float *samples) noexcept
     {
@@ -428,6 +484,7 @@ struct ConvolutionEngine
     }
 
     //==============================================================================
+    const size_t numInputs, numOutputs;
     const size_t blockSize;
     const size_t fftSize;
     const std::unique_ptr<FFT> fftObject;
@@ -439,93 +496,412 @@ struct ConvolutionEngine
     std::vector<AudioBuffer<float>> buffersInputSegments, buffersImpulseSegments;
 };
 
+//==============================================================================
+// Describes how the channels of an impulse response map onto the channels being processed.
+// In stereo mode each IR channel is an independent path from an input to the matching output.
+// In matrix mode IR channel (input * numOutputs + output) is the path from that input to that output.
+struct ImpulseResponseLayout
+{
+    ImpulseResponseLayout() = default;
+
+    ImpulseResponseLayout (Convolution::Stereo stereo)
+        : numInputs (stereo == Convolution::Stereo::yes ? 2 : 1),
+          numOutputs (numInputs)
+    {}
+
+    ImpulseResponseLayout (Convolution::ChannelMatrix matrix)
+        : numInputs (jmax (1, matrix.numInputs)),
+          numOutputs (jmax (1, matrix.numOutputs)),
+          isMatrix (true)
+    {}
+
+    int getNumPaths() const noexcept    { return isMatrix ? numInputs * numOutputs : numInputs; }
+
+    int numInputs = 1, numOutputs = 1;
+    bool isMatrix = false;
+};
+
+//==============================================================================
+// Holds the engines that process one partition of an impulse response. In stereo mode
+// there is an engine for each channel, and in matrix mode a single engine handles every path.
+class PartitionEngines
+{
+public:
+    PartitionEngines (std::vector<std::unique_ptr<ConvolutionEngine>>&& enginesIn, ImpulseResponseLayout layout)
+        : engines (std::move (enginesIn)),
+          isMatrix (layout.isMatrix),
+          numInputs  (isMatrix ? (size_t) layout.numInputs  : engines.size()),
+          numOutputs (isMatrix ? (size_t) layout.numOutputs : engines.size())
+    {}
+
+    void reset()
+    {
+        for (const auto& e : engines)
+            e->reset();
+    }
+
+    void process (const float* const* input, size_t numInputChannels,
+                  float* const* output, size_t numOutputChannels,
+                  size_t numSamples, bool withAddedLatency)
+    {
+        if (isMatrix)
+        {
+            if (withAddedLatency)
+                engines.front()->processSamplesWithAddedLatency (input, numInputChannels, output, numOutputChannels, numSamples);
+            else
+                engines.front()->processSamples (input, numInputChannels, output, numOutputChannels, numSamples);
+
+            return;
+        }
+
+        for (size_t channel = 0; channel < jmin (engines.size(), numInputChannels, numOutputChannels); ++channel)
+        {
+            if (withAddedLatency)
+                engines[channel]->processSamplesWithAddedLatency (input[channel], output[channel], numSamples);
+            else
+                engines[channel]->processSamples (input[channel], output[channel], numSamples);
+        }
+    }
+
+    size_t getNumInputs() const noexcept   { return numInputs; }
+    size_t getNumOutputs() const noexcept  { return numOutputs; }
+    size_t getBlockSize() const noexcept   { return engines.front()->blockSize; }
+
+private:
+    std::vector<std::unique_ptr<ConvolutionEngine>> engines;
+    bool isMatrix;
+    size_t numInputs, numOutputs;
+};
+
+//==============================================================================
+// Processes one of the later partitions of a non-uniform convolution.
+//
+// A normal stage computes each block on the audio thread as soon as it is complete, and
+// delays its output by one block. A deferred stage hands each complete block of input to a
+// helper thread, and its result isn't needed until the following block has been collected,
+// so the output is delayed by two blocks, but the cost of large partitions is spread across
+// callbacks rather than landing on the audio thread every N blocks. If the helper hasn't
+// started on a block by the time its result is due, the audio thread computes it instead,
+// so the deadline is always met.
+class TailStage
+{
+public:
+    TailStage (PartitionEngines&& enginesIn, int maxBlockSize, bool shouldDefer)
+        : engines (std::move (enginesIn)),
+          blockSize (engines.getBlockSize()),
+          deferred (shouldDefer),
+          outputBuffer ((int) engines.getNumOutputs(), maxBlockSize),
+          outputPointers (engines.getNumOutputs()),
+          jobInputPointers (engines.getNumInputs()),
+          jobOutputPointers (engines.getNumOutputs())
+    {
+        if (deferred)
+        {
+            const auto numInputs  = (int) engines.getNumInputs();
+            const auto numOutputs = (int) engines.getNumOutputs();
+
+            inputBlock .setSize (numInputs,  (int) blockSize);
+            jobInput   .setSize (numInputs,  (int) blockSize);
+            jobOutput  .setSize (numOutputs, (int) blockSize);
+            readyOutput.setSize (numOutputs, (int) blockSize);
+        }
+
+        reset();
+    }
+
+    void reset()
+    {
+        // Drop any block that hasn't been started yet, and wait for one that has
+        auto expected = (int) queued;
+        jobState.compare_exchange_strong (expected, (int) idle);
+
+        while (jobState.load (std::memory_order_acquire) == running)
+            Thread::yield();
+
+        jobState = idle;
+        engines.reset();
+
+        for (auto* buffer : { &outputBuffer, &inputBlock, &jobInput, &jobOutput, &readyOutput })
+            buffer->clear();
+
+        position = 0;
+    }
+
+    // Reads the next block of input, and puts this stage's output for the same period into
+    // the stage's output buffer, ready to be added to the final output with addTo().
+    void process (const float* const* input, size_t numInputChannels, size_t numSamples)
+    {
+        numInputChannels = jmin (numInputChannels, engines.getNumInputs());
+        const auto numOutputs = engines.getNumOutputs();
+
+        if (! deferred)
+        {
+            for (size_t channel = 0; channel < numOutputs; ++channel)
+                outputPointers[channel] = outputBuffer.getWritePointer ((int) channel);
+
+            engines.process (input, numInputChannels, outputPointers.data(), numOutputs, numSamples, true);
+            return;
+        }
+
+        for (size_t numDone = 0; numDone < numSamples;)
+        {
+            const auto numToCopy = jmin (numSamples - numDone, blockSize - position);
+
+            for (size_t channel = 0; channel < numInputChannels; ++channel)
+                FloatVectorOperations::copy (inputBlock.getWritePointer ((int) channel, (int) position),
+                                             input[channel] + numDone,
+                                             (int) numToCopy);
+
+            for (size_t channel = 0; channel < numOutputs; ++channel)
+                FloatVectorOperations::copy (outputBuffer.getWritePointer ((int) channel, (int) numDone),
+                                             readyOutput.getReadPointer ((int) channel, (int) position),
+                                             (int) numToCopy);
+
+            position += numToCopy;
+            numDone += numToCopy;
+
+            if (position == blockSize)
+            {
+                position = 0;
+                startNextJob();
+            }
+        }
+    }
+
+    void addTo (float* const* output, size_t numOutputChannels, size_t numSamples) const
+    {
+        for (size_t channel = 0; channel < jmin (numOutputChannels, engines.getNumOutputs()); ++channel)
+            FloatVectorOperations::add (output[channel], outputBuffer.getReadPointer ((int) channel), (int) numSamples);
+    }
+
+    // Computes the pending block, unless there isn't one or another thread has already started on it.
+    // May be called from any thread.
+    bool runPendingJob()
+    {
+        auto expected = (int) queued;
+
+        if (! jobState.compare_exchange_strong (expected, (int) running, std::memory_order_acquire))
+            return false;
+
+        for (size_t channel = 0; channel < jobInputPointers.size(); ++channel)
+            jobInputPointers[channel] = jobInput.getReadPointer ((int) channel);
+
+        for (size_t channel = 0; channel < jobOutputPointers.size(); ++channel)
+            jobOutputPointers[channel] = jobOutput.getWritePointer ((int) channel);
+
+        engines.process (jobInputPointers.data(), jobInputPointers.size(),
+                         jobOutputPointers.data(), jobOutputPointers.size(),
+                         blockSize, false);
+
+        jobState.store ((int) finished, std::memory_order_release);
+        return true;
+    }
+
+    bool isDeferred() const noexcept            { return deferred; }
+    void setHelperThread (Thread* t) noexcept   { helper = t; }
+
+private:
+    enum JobState { idle, queued, running, finished };
+
+    void startNextJob()
+    {
+        runPendingJob();
+
+        while (jobState.load (std::memory_order_acquire) == running)
+            Thread::yield();
+
+        if (jobState.load (std::memory_order_acquire) == finished)
+            for (auto channel = 0; channel < readyOutput.getNumChannels(); ++channel)
+                readyOutput.copyFrom (channel, 0, jobOutput, channel, 0, (int) blockSize);
+
+        for (auto channel = 0; channel < jobInput.getNumChannels(); ++channel)
+            jobInput.copyFrom (channel, 0, inputBlock, channel, 0, (int) blockSize);
+
+        jobState.store ((int) queued, std::memory_order_release);
+
+        if (helper != nullptr)
+            helper->notify();
+    }
+
+    PartitionEngines engines;
+    const size_t blockSize;
+    const bool deferred;
+
+    AudioBuffer<float> outputBuffer, inputBlock, jobInput, jobOutput, readyOutput;
+    std::vector<float*> outputPointers;
+    std::vector<const float*> jobInputPointers;
+    std::vector<float*> jobOutputPointers;
+    size_t position = 0;
+
+    std::atomic<int> jobState { idle };
+    Thread* helper = nullptr;
+};
+
+// Computes the deferred tail stages of a MultichannelEngine in the background.
+class TailStageThread  : public Thread
+{
+public:
+    explicit TailStageThread (std::vector<TailStage*> stagesIn)
+        : Thread ("Convolution tail"), stages (std::move (stagesIn))
+    {}
+
+    ~TailStageThread() override
+    {
+        stopThread (-1);
+    }
+
+private:
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            auto didWork = false;
+
+            for (auto* stage : stages)
+                didWork = stage->runPendingJob() || didWork;
+
+            if (! didWork)
+                wait (100);
+        }
+    }
+
+    const std::vector<TailStage*> stages;
+};
+
 //==============================================================================
 class MultichannelEngine
 {
 public:
     MultichannelEngine (const AudioBuffer<float>& buf,
+                        ImpulseResponseLayout layoutIn,
                         int maxBlockSize,
                         int maxBufferSize,
-                        Convolution::NonUniform headSizeIn,
-                        bool isZeroDelayIn)
-        : tailBuffer (1, maxBlockSize),
+                        const std::vector<int>& partitionSizes,
+                        bool isZeroDelayIn,
+                        bool useBackgroundThread)
+        : layout (layoutIn),
           latency (isZeroDelayIn ? 0 : maxBufferSize),
           irSize (buf.getNumSamples()),
           blockSize (maxBlockSize),
           isZeroDelay (isZeroDelayIn)
     {
-        constexpr auto numChannels = 2;
-
-        const auto makeEngine = [&] (int channel, int offset, int length, uint32 thisBlockSize)
+        const auto makeEngines = [&] (int offset, int length, int thisBlockSize)
         {
-            return std::make_unique<ConvolutionEngine> (buf.getReadPointer (jmin (buf.getNumChannels() - 1, channel), offset),
-                                                        length,
-                                                        static_cast<size_t> (thisBlockSize));
+            std::vector<std::unique_ptr<ConvolutionEngine>> engines;
+
+            if (layout.isMatrix)
+            {
+                // A single engine handles every path, so that the inputs are only transformed once
+                std::vector<const float*> paths;
+
+                for (auto path = 0; path < layout.getNumPaths(); ++path)
+                    paths.push_back (buf.getReadPointer (jmin (buf.getNumChannels() - 1, path), offset));
+
+                engines.push_back (std::make_unique<ConvolutionEngine> (paths.data(),
+                                                                        static_cast<size_t> (layout.numInputs),
+                                                                        static_cast<size_t> (layout.numOutputs),
+                                                                        length,
+                                                                        static_cast<size_t> (thisBlockSize)));
+            }
+            else
+            {
+                for (auto channel = 0; channel < 2; ++channel)
+                    engines.push_back (std::make_unique<ConvolutionEngine> (buf.getReadPointer (jmin (buf.getNumChannels() - 1, channel), offset),
+                                                                            length,
+                                                                            static_cast<size_t> (thisBlockSize)));
+            }
+
+            return PartitionEngines (std::move (engines), layout);
         };
 
-        if (headSizeIn.headSizeInSamples == 0)
+        if (partitionSizes.empty())
         {
-            for (int i = 0; i < numChannels; ++i)
-                head.emplace_back (makeEngine (i, 0, buf.getNumSamples(), static_cast<uint32> (maxBufferSize)));
+            head = std::make_unique<PartitionEngines> (makeEngines (0, irSize, maxBufferSize));
         }
         else
         {
-            const auto size = jmin (buf.getNumSamples(), headSizeIn.headSizeInSamples);
+            // Each stage after the head uses the previous partition size as its block size, and
+            // starts at that offset in the IR so that its latency matches its position.
+            const auto headLength = jmin (irSize, partitionSizes.front());
+            head = std::make_unique<PartitionEngines> (makeEngines (0, headLength, maxBufferSize));
+
+            auto offset = headLength;
+
+            for (size_t stage = 0; offset < irSize; ++stage)
+            {
+                const auto end = stage + 1 < partitionSizes.size() ? jmin (irSize, partitionSizes[stage + 1])
+                                                                   : irSize;
+
+                // Deferred stages add two blocks of latency, so they use half the partition size
+                const auto shouldDefer = useBackgroundThread && isZeroDelay && partitionSizes[stage] / 2 >= maxBlockSize;
+                const auto stageBlockSize = shouldDefer ? partitionSizes[stage] / 2
+                                                        : partitionSizes[stage] + (isZeroDelay ? 0 : maxBufferSize);
+
+                tail.push_back (std::make_unique<TailStage> (makeEngines (offset, end - offset, stageBlockSize),
+                                                             maxBlockSize,
+                                                             shouldDefer));
+                offset = end;
+            }
+        }
 
-            for (int i = 0; i < numChannels; ++i)
-                head.emplace_back (makeEngine (i, 0, size, static_cast<uint32> (maxBufferSize)));
+        std::vector<TailStage*> deferredStages;
 
-            const auto tailBufferSize = static_cast<uint32> (headSizeIn.headSizeInSamples + (isZeroDelay ? 0 : maxBufferSize));
+        for (const auto& stage : tail)
+            if (stage->isDeferred())
+                deferredStages.push_back (stage.get());
+
+        if (! deferredStages.empty())
+        {
+            helper = std::make_unique<TailStageThread> (deferredStages);
 
-            if (size != buf.getNumSamples())
-                for (int i = 0; i < numChannels; ++i)
-                    tail.emplace_back (makeEngine (i, size, buf.getNumSamples() - size, tailBufferSize));
+            for (auto* stage : deferredStages)
+                stage->setHelperThread (helper.get());
+
+            helper->startThread (Thread::realtimeAudioPriority);
         }
+
+        inputPointers.resize (head->getNumInputs());
+        outputPointers.resize (head->getNumOutputs());
     }
 
     void reset()
     {
-        for (const auto& e : head)
-            e->reset();
+        head->reset();
 
-        for (const auto& e : tail)
-            e->reset();
+        for (const auto& stage : tail)
+            stage->reset();
     }
 
     void processSamples (const AudioBlock<const float>& input, AudioBlock<float>& output)
     {
-        const auto numChannels = jmin (head.size(), input.getNumChannels(), output.getNumChannels());
-        const auto numSamples  = jmin (input.getNumSamples(), output.getNumSamples());
+        const auto numInputs  = jmin (head->getNumInputs(),  input.getNumChannels());
+        const auto numOutputs = jmin (head->getNumOutputs(), output.getNumChannels());
+        const auto numSamples = jmin (input.getNumSamples(), output.getNumSamples());
 
-        const AudioBlock<float> fullTailBlock (tailBuffer);
-        const auto tailBlock = fullTailBlock.getSubBlock (0, (size_t) numSamples);
+        for (size_t channel = 0; channel < numInputs; ++channel)
+            inputPointers[channel] = input.getChannelPointer (channel);
 
-        const auto isUniform = tail.empty();
+        for (size_t channel = 0; channel < numOutputs; ++channel)
+            outputPointers[channel] = output.getChannelPointer (channel);
 
-        for (size_t channel = 0; channel < numChannels; ++channel)
-        {
-            if (! isUniform)
-                tail[channel]->processSamplesWithAddedLatency (input.getChannelPointer (channel),
-                                                               tailBlock.getChannelPointer (0),
-                                                               numSamples);
-
-            if (isZeroDelay)
-                head[channel]->processSamples (input.getChannelPointer (channel),
-                                               output.getChannelPointer (channel),
-                                               numSamples);
-            else
-                head[channel]->processSamplesWithAddedLatency (input.getChannelPointer (channel),
-                                                               output.getChannelPointer (channel),
-                                                               numSamples);
+        // The tail stages have to read the input before the head overwrites it
+        for (const auto& stage : tail)
+            stage->process (inputPointers.data(), numInputs, numSamples);
 
-            if (! isUniform)
-                output.getSingleChannelBlock (channel) += tailBlock;
-        }
+        head->process (inputPointers.data(), numInputs,
+                       outputPointers.data(), numOutputs,
+                       numSamples, ! isZeroDelay);
 
-        const auto numOutputChannels = output.getNumChannels();
+        for (const auto& stage : tail)
+            stage->addTo (outputPointers.data(), numOutputs, numSamples);
 
-        for (auto i = numChannels; i < numOutputChannels; ++i)
-            output.getSingleChannelBlock (i).copyFrom (output.getSingleChannelBlock (0));
+        for (auto i = numOutputs; i < output.getNumChannels(); ++i)
+        {
+            if (layout.isMatrix)
+                output.getSingleChannelBlock (i).clear();
+            else
+                output.getSingleChannelBlock (i).copyFrom (output.getSingleChannelBlock (0));
+        }
     }
 
     int getIRSize() const noexcept     { return irSize; }
@@ -533,8 +909,15 @@ public:
     int getBlockSize() const noexcept  { return blockSize; }
 
 private:
-    std::vector<std::unique_ptr<ConvolutionEngine>> head, tail;
-    AudioBuffer<float> tailBuffer;
+    const ImpulseResponseLayout layout;
+    std::unique_ptr<PartitionEngines> head;
+    std::vector<std::unique_ptr<TailStage>> tail;
+
+    // Declared after the stages, so that it's stopped before they're destroyed
+    std::unique_ptr<TailStageThread> helper;
+
+    std::vector<const float*> inputPointers;
+    std::vector<float*> outputPointers;
 
     const int latency;
     const int irSize;
@@ -542,20 +925,38 @@ private:
     const bool isZeroDelay;
 };
 
-static AudioBuffer<float> fixNumChannels (const AudioBuffer<float>& buf, Convolution::Stereo stereo)
+static AudioBuffer<float> fixNumChannels (const AudioBuffer<float>& buf, ImpulseResponseLayout layout)
 {
-    const auto numChannels = jmin (buf.getNumChannels(), stereo == Convolution::Stereo::yes ? 2 : 1);
+    // In matrix mode every path needs a channel, and any missing paths are silent
+    const auto numChannels = layout.isMatrix ? layout.getNumPaths()
+                                             : jmin (buf.getNumChannels(), layout.getNumPaths());
     const auto numSamples = buf.getNumSamples();
 
     AudioBuffer<float> result (numChannels, buf.getNumSamples());
 
     for (auto channel = 0; channel != numChannels; ++channel)
-        result.copyFrom (channel, 0, buf.getReadPointer (channel), numSamples);
+    {
+        if (channel < buf.getNumChannels())
+            result.copyFrom (channel, 0, buf.getReadPointer (channel), numSamples);
+        else
+            result.clear (channel, 0, numSamples);
+    }
 
     if (result.getNumSamples() == 0 || result.getNumChannels() == 0)
     {
-        result.setSize (1, 1);
-        result.setSample (0, 0, 1.0f);
+        if (layout.isMatrix)
+        {
+            result.setSize (numChannels, 1);
+            result.clear();
+
+            for (auto channel = 0; channel < jmin (layout.numInputs, layout.numOutputs); ++channel)
+                result.setSample (channel * layout.numOutputs + channel, 0, 1.0f);
+        }
+        else
+        {
+            result.setSize (1, 1);
+            result.setSample (0, 0, 1.0f);
+        }
     }
 
     return result;
@@ -699,7 +1100,7 @@ struct BufferWithSampleRate
     double sampleRate = 0.0;
 };
 
-static BufferWithSampleRate loadStreamToBuffer (std::unique_ptr<InputStream> stream, size_t maxLength)
+static BufferWithSampleRate loadStreamToBuffer (std::unique_ptr<InputStream> stream, size_t maxLength, int maxNumChannels)
 {
     AudioFormatManager manager;
     manager.registerBasicFormats();
@@ -711,7 +1112,7 @@ static BufferWithSampleRate loadStreamToBuffer (std::unique_ptr<InputStream> str
     const auto fileLength = static_cast<size_t> (formatReader->lengthInSamples);
     const auto lengthToLoad = maxLength == 0 ? fileLength : jmin (maxLength, fileLength);
 
-    BufferWithSampleRate result { { jlimit (1, 2, static_cast<int> (formatReader->numChannels)),
+    BufferWithSampleRate result { { jlimit (1, maxNumChannels, static_cast<int> (formatReader->numChannels)),
                                     static_cast<int> (lengthToLoad) },
                                   formatReader->sampleRate };
 
@@ -723,6 +1124,25 @@ static BufferWithSampleRate loadStreamToBuffer (std::unique_ptr<InputStream> str
     return result;
 }
 
+// Rounds each partition size up to a power of two, and drops any that don't increase.
+static std::vector<int> makePartitionSizes (const Convolution::MultiStage& multiStage)
+{
+    std::vector<int> result;
+
+    for (const auto size : multiStage.partitionSizesInSamples)
+    {
+        if (size <= 0)
+            break;
+
+        const auto rounded = jmax (64, nextPowerOfTwo (size));
+
+        if (result.empty() || rounded > result.back())
+            result.push_back (rounded);
+    }
+
+    return result;
+}
+
 // This class caches the data required to build a new convolution engine
 // (in particular, impulse response data and a ProcessSpec).
 // Calls to `setProcessSpec` and `setImpulseResponse` construct a
@@ -731,10 +1151,11 @@ class ConvolutionEngineFactory
 {
 public:
     ConvolutionEngineFactory (Convolution::Latency requiredLatency,
-                              Convolution::NonUniform requiredHeadSize)
+                              const Convolution::MultiStage& requiredPartitions)
         : latency  { (requiredLatency.latencyInSamples   <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredLatency.latencyInSamples)) },
-          headSize { (requiredHeadSize.headSizeInSamples <= 0) ? 0 : jmax (64, nextPowerOfTwo (requiredHeadSize.headSizeInSamples)) },
-          shouldBeZeroLatency (requiredLatency.latencyInSamples == 0)
+          partitionSizes (makePartitionSizes (requiredPartitions)),
+          shouldBeZeroLatency (requiredLatency.latencyInSamples == 0),
+          useBackgroundThread (requiredPartitions.useBackgroundThread)
     {}
 
     // It is safe to call this method simultaneously with other public
@@ -750,17 +1171,18 @@ public:
     // It is safe to call this method simultaneously with other public
     // member functions.
     void setImpulseResponse (BufferWithSampleRate&& buf,
-                             Convolution::Stereo stereo,
+                             ImpulseResponseLayout layout,
                              Convolution::Trim trim,
                              Convolution::Normalise normalise)
     {
         const std::lock_guard<std::mutex> lock (mutex);
         wantsNormalise = normalise;
         originalSampleRate = buf.sampleRate;
+        impulseResponseLayout = layout;
 
         impulseResponse = [&]
         {
-            auto corrected = fixNumChannels (buf.buffer, stereo);
+            auto corrected = fixNumChannels (buf.buffer, layout);
             return trim == Convolution::Trim::yes ? trimImpulseResponse (corrected) : corrected;
         }();
 
@@ -789,10 +1211,12 @@ private:
                                                        : nextPowerOfTwo (static_cast<int> (currentLatency));
 
         return std::make_unique<MultichannelEngine> (resampled,
+                                                     impulseResponseLayout,
                                                      processSpec.maximumBlockSize,
                                                      maxBufferSize,
-                                                     headSize,
-                                                     shouldBeZeroLatency);
+                                                     partitionSizes,
+                                                     shouldBeZeroLatency,
+                                                     useBackgroundThread);
     }
 
     static AudioBuffer<float> makeImpulseBuffer()
@@ -804,11 +1228,12 @@ private:
 
     ProcessSpec processSpec { 44100.0, 128, 2 };
     AudioBuffer<float> impulseResponse = makeImpulseBuffer();
+    ImpulseResponseLayout impulseResponseLayout;
     double originalSampleRate = processSpec.sampleRate;
     Convolution::Normalise wantsNormalise = Convolution::Normalise::no;
     const Convolution::Latency latency;
-    const Convolution::NonUniform headSize;
-    const bool shouldBeZeroLatency;
+    const std::vector<int> partitionSizes;
+    const bool shouldBeZeroLatency, useBackgroundThread;
 
     TryLockedPtr<MultichannelEngine> engine;
 
@@ -818,24 +1243,24 @@ private:
 static void setImpulseResponse (ConvolutionEngineFactory& factory,
                                 const void* sourceData,
                                 size_t sourceDataSize,
-                                Convolution::Stereo stereo,
+                                ImpulseResponseLayout layout,
                                 Convolution::Trim trim,
                                 size_t size,
                                 Convolution::Normalise normalise)
 {
-    factory.setImpulseResponse (loadStreamToBuffer (std::make_unique<MemoryInputStream> (sourceData, sourceDataSize, false), size),
-                                stereo, trim, normalise);
+    factory.setImpulseResponse (loadStreamToBuffer (std::make_unique<MemoryInputStream> (sourceData, sourceDataSize, false), size, layout.getNumPaths()),
+                                layout, trim, normalise);
 }
 
 static void setImpulseResponse (ConvolutionEngineFactory& factory,
                                 const File& fileImpulseResponse,
-                                Convolution::Stereo stereo,
+                                ImpulseResponseLayout layout,
                                 Convolution::Trim trim,
                                 size_t size,
                                 Convolution::Normalise normalise)
 {
-    factory.setImpulseResponse (loadStreamToBuffer (std::make_unique<FileInputStream> (fileImpulseResponse), size),
-                                stereo, trim, normalise);
+    factory.setImpulseResponse (loadStreamToBuffer (std::make_unique<FileInputStream> (fileImpulseResponse), size, layout.getNumPaths()),
+                                layout, trim, normalise);
 }
 
 // This class acts as a destination for convolution engines which are loaded on
@@ -850,43 +1275,43 @@ class ConvolutionEngineQueue  : public std::enable_shared_from_this<ConvolutionE
 public:
     ConvolutionEngineQueue (BackgroundMessageQueue& queue,
                             Convolution::Latency latencyIn,
-                            Convolution::NonUniform headSizeIn)
-        : messageQueue (queue), factory (latencyIn, headSizeIn) {}
+                            const Convolution::MultiStage& partitionsIn)
+        : messageQueue (queue), factory (latencyIn, partitionsIn) {}
 
     void loadImpulseResponse (AudioBuffer<float>&& buffer,
                               double sr,
-                              Convolution::Stereo stereo,
+                              ImpulseResponseLayout layout,
                               Convolution::Trim trim,
                               Convolution::Normalise normalise)
     {
-        callLater ([b = std::move (buffer), sr, stereo, trim, normalise] (ConvolutionEngineFactory& f) mutable
+        callLater ([b = std::move (buffer), sr, layout, trim, normalise] (ConvolutionEngineFactory& f) mutable
         {
-            f.setImpulseResponse ({ std::move (b), sr }, stereo, trim, normalise);
+            f.setImpulseResponse ({ std::move (b), sr }, layout, trim, normalise);
         });
     }
 
     void loadImpulseResponse (const void* sourceData,
                               size_t sourceDataSize,
-                              Convolution::Stereo stereo,
+                              ImpulseResponseLayout layout,
                               Convolution::Trim trim,
                               size_t size,
                               Convolution::Normalise normalise)
     {
-        callLater ([sourceData, sourceDataSize, stereo, trim, size, normalise] (ConvolutionEngineFactory& f) mutable
+        callLater ([sourceData, sourceDataSize, layout, trim, size, normalise] (ConvolutionEngineFactory& f) mutable
         {
-            setImpulseResponse (f, sourceData, sourceDataSize, stereo, trim, size, normalise);
+            setImpulseResponse (f, sourceData, sourceDataSize, layout, trim, size, normalise);
         });
     }
 
     void loadImpulseResponse (const File& fileImpulseResponse,
-                              Convolution::Stereo stereo,
+                              ImpulseResponseLayout layout,
                               Convolution::Trim trim,
                               size_t size,
                               Convolution::Normalise normalise)
     {
-        callLater ([fileImpulseResponse, stereo, trim, size, normalise] (ConvolutionEngineFactory& f) mutable
+        callLater ([fileImpulseResponse, layout, trim, size, normalise] (ConvolutionEngineFactory& f) mutable
         {
-            setImpulseResponse (f, fileImpulseResponse, stereo, trim, size, normalise);
+            setImpulseResponse (f, fileImpulseResponse, layout, trim, size, normalise);
         });
     }
 
@@ -1014,12 +1439,12 @@ class Convolution::Impl
 {
 public:
     Impl (Latency requiredLatency,
-          NonUniform requiredHeadSize,
+          const MultiStage& requiredPartitions,
           OptionalQueue&& queue)
         : messageQueue (std::move (queue)),
           engineQueue (std::make_shared<ConvolutionEngineQueue> (*messageQueue->pimpl,
                                                                  requiredLatency,
-                                                                 requiredHeadSize))
+                                                                 requiredPartitions))
     {}
 
     void reset()
@@ -1074,30 +1499,30 @@ public:
 
     void loadImpulseResponse (AudioBuffer<float>&& buffer,
                               double originalSampleRate,
-                              Stereo stereo,
+                              ImpulseResponseLayout layout,
                               Trim trim,
                               Normalise normalise)
     {
-        engineQueue->loadImpulseResponse (std::move (buffer), originalSampleRate, stereo, trim, normalise);
+        engineQueue->loadImpulseResponse (std::move (buffer), originalSampleRate, layout, trim, normalise);
     }
 
     void loadImpulseResponse (const void* sourceData,
                               size_t sourceDataSize,
-                              Stereo stereo,
+                              ImpulseResponseLayout layout,
                               Trim trim,
                               size_t size,
                               Normalise normalise)
     {
-        engineQueue->loadImpulseResponse (sourceData, sourceDataSize, stereo, trim, size, normalise);
+        engineQueue->loadImpulseResponse (sourceData, sourceDataSize, layout, trim, size, normalise);
     }
 
     void loadImpulseResponse (const File& fileImpulseResponse,
-                              Stereo stereo,
+                              ImpulseResponseLayout layout,
                               Trim trim,
                               size_t size,
                               Normalise normalise)
     {
-        engineQueue->loadImpulseResponse (fileImpulseResponse, stereo, trim, size, normalise);
+        engineQueue->loadImpulseResponse (fileImpulseResponse, layout, trim, size, normalise);
     }
 
 private:
@@ -1131,6 +1556,10 @@ private:
 //==============================================================================
 void Convolution::Mixer::prepare (const ProcessSpec& spec)
 {
+    const auto numChannels = jmax ((size_t) 1, (size_t) spec.numChannels);
+    volumeDry.resize (numChannels);
+    volumeWet.resize (numChannels);
+
     for (auto& dry : volumeDry)
         dry.reset (spec.sampleRate, 0.05);
 
@@ -1140,7 +1569,7 @@ void Convolution::Mixer::prepare (const ProcessSpec& spec)
     sampleRate = spec.sampleRate;
 
     dryBlock = AudioBlock<float> (dryBlockStorage,
-                                  jmin (spec.numChannels, 2u),
+                                  numChannels,
                                   spec.maximumBlockSize);
 
 }
@@ -1211,8 +1640,12 @@ Convolution::Convolution (const Latency& requiredLatency)
 {}
 
 Convolution::Convolution (const NonUniform& nonUniform)
+    : Convolution (MultiStage { { nonUniform.headSizeInSamples }, nonUniform.useBackgroundThread })
+{}
+
+Convolution::Convolution (const MultiStage& multiStage)
     : Convolution ({},
-                   nonUniform,
+                   multiStage,
                    OptionalQueue { std::make_unique<ConvolutionMessageQueue>() })
 {}
 
@@ -1221,13 +1654,17 @@ Convolution::Convolution (const Latency& requiredLatency, ConvolutionMessageQueu
 {}
 
 Convolution::Convolution (const NonUniform& nonUniform, ConvolutionMessageQueue& queue)
-    : Convolution ({}, nonUniform, OptionalQueue { queue })
+    : Convolution (MultiStage { { nonUniform.headSizeInSamples }, nonUniform.useBackgroundThread }, queue)
+{}
+
+Convolution::Convolution (const MultiStage& multiStage, ConvolutionMessageQueue& queue)
+    : Convolution ({}, multiStage, OptionalQueue { queue })
 {}
 
 Convolution::Convolution (const Latency& latency,
-                          const NonUniform& nonUniform,
+                          const MultiStage& multiStage,
                           OptionalQueue&& queue)
-    : pimpl (std::make_unique<Impl> (latency, nonUniform, std::move (queue)))
+    : pimpl (std::make_unique<Impl> (latency, multiStage, std::move (queue)))
 {}
 
 Convolution::~Convolution() noexcept = default;
@@ -1260,6 +1697,34 @@ void Convolution::loadImpulseResponse (AudioBuffer<float>&& buffer,
     pimpl->loadImpulseResponse (std::move (buffer), originalSampleRate, stereo, trim, normalise);
 }
 
+void Convolution::loadImpulseResponse (const void* sourceData,
+                                       size_t sourceDataSize,
+                                       ChannelMatrix matrix,
+                                       Trim trim,
+                                       size_t size,
+                                       Normalise normalise)
+{
+    pimpl->loadImpulseResponse (sourceData, sourceDataSize, matrix, trim, size, normalise);
+}
+
+void Convolution::loadImpulseResponse (const File& fileImpulseResponse,
+                                       ChannelMatrix matrix,
+                                       Trim trim,
+                                       size_t size,
+                                       Normalise normalise)
+{
+    pimpl->loadImpulseResponse (fileImpulseResponse, matrix, trim, size, normalise);
+}
+
+void Convolution::loadImpulseResponse (AudioBuffer<float>&& buffer,
+                                       double originalSampleRate,
+                                       ChannelMatrix matrix,
+                                       Trim trim,
+                                       Normalise normalise)
+{
+    pimpl->loadImpulseResponse (std::move (buffer), originalSampleRate, matrix, trim, normalise);
+}
+
 void Convolution::prepare (const ProcessSpec& spec)
 {
     mixer.prepare (spec);
@@ -1281,7 +1746,6 @@ void Convolution::processSamples (const AudioBlock<const float>& input,
         return;
 
     jassert (input.getNumChannels() == output.getNumChannels());
-    jassert (isPositiveAndBelow (input.getNumChannels(), static_cast<size_t> (3))); // only mono and stereo is supported
 
     mixer.processSamples (input, output, isBypassed, [this] (const auto& in, auto& out)
     {
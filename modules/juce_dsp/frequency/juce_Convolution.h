@@ -73,6 +73,10 @@ private:
     Performs stereo partitioned convolution of an input signal with an
     impulse response in the frequency domain, using the JUCE FFT class.
 
+    Impulse responses containing a full matrix of paths between several input
+    and output channels (for example "true stereo" or ambisonic IRs) can be
+    loaded using the overloads taking a ChannelMatrix.
+
     This class provides some thread-safe functions to load impulse responses
     from audio files or memory on-the-fly without noticeable artefacts,
     performing resampling and trimming if necessary.
@@ -131,7 +135,15 @@ public:
     explicit Convolution (const Latency& requiredLatency);
 
     /** Contains configuration information for a non-uniform convolution. */
-    struct NonUniform { int headSizeInSamples; };
+    struct NonUniform
+    {
+        int headSizeInSamples;
+
+        /** If this is true and the head is at least twice the host's block size, the
+            tail is computed on a helper thread. @see Convolution (const NonUniform&)
+        */
+        bool useBackgroundThread = false;
+    };
 
     /** Initialises an object for performing convolution in the frequency domain
         using a non-uniform partitioned algorithm.
@@ -140,11 +152,53 @@ public:
         efficiency of the processing for IR sizes of 4096 samples or greater
         (recommended for reverberation IRs).
 
+        If useBackgroundThread is set and the head size is at least twice the
+        host's block size, the tail is computed on a helper thread while the next
+        block of input is collected. Each Convolution that does this starts its
+        own realtime-priority thread, so it's best kept for a few long IRs.
+
         @param requiredHeadSize       the head IR size for two stage non-uniform
                                       partitioned convolution
+        @see MultiStage
      */
     explicit Convolution (const NonUniform& requiredHeadSize);
 
+    /** Contains configuration information for a non-uniform convolution with
+        several stages.
+
+        The first size is the length of the head, which is processed with the
+        host's block size. Each further stage uses the previous size as its block
+        size and covers the IR from that point up to the next size, and the last
+        stage covers the remainder of the IR. For example, { 64, 512, 4096, 32768 }
+        uses blocks of 64 samples for the IR from 64 to 512 samples, blocks of
+        512 for 512 to 4096, and so on.
+
+        Sizes are rounded up to powers of two of at least 64 samples.
+    */
+    struct MultiStage
+    {
+        std::vector<int> partitionSizesInSamples;
+
+        /** If this is true, stages with a block size at least twice the host's block
+            size are computed on a helper thread. @see Convolution (const MultiStage&)
+        */
+        bool useBackgroundThread = false;
+    };
+
+    /** Initialises an object for performing convolution in the frequency domain
+        using a non-uniform partitioned algorithm with several stages.
+
+        If useBackgroundThread is set, stages with a block size at least twice the
+        host's block size are computed on a helper thread while the next block of
+        input is collected, which keeps the cost of each callback roughly constant,
+        even for very long IRs. Each Convolution that does this starts its own
+        realtime-priority thread, so it's best kept for a few long IRs.
+
+        @param requiredPartitions     the partition sizes of each stage
+        @see MultiStage
+    */
+    explicit Convolution (const MultiStage& requiredPartitions);
+
     /** Behaves the same as the constructor taking a single Latency argument,
         but with a shared background message queue.
 
@@ -161,6 +215,14 @@ public:
     */
     Convolution (const NonUniform&, ConvolutionMessageQueue&);
 
+    /** Behaves the same as the constructor taking a single MultiStage argument,
+        but with a shared background message queue.
+
+        IMPORTANT: the queue *must* remain alive throughout the lifetime of the
+        Convolution.
+    */
+    Convolution (const MultiStage&, ConvolutionMessageQueue&);
+
     ~Convolution() noexcept;
 
     //==============================================================================
@@ -195,6 +257,22 @@ public:
     enum class Trim      { no, yes };
     enum class Normalise { no, yes };
 
+    /** Describes an impulse response containing a path from every input channel
+        to every output channel, such as a four-channel "true stereo" IR or an
+        ambisonic decoder.
+
+        Channel (input * numOutputs + output) of the impulse response holds the
+        path from that input to that output, so a true stereo IR uses the channel
+        order LL, LR, RL, RR. Paths missing from the impulse response are silent.
+
+        When processing, the first numInputs channels of the block are read, the
+        first numOutputs channels are written with the sum of their paths, and
+        any remaining channels are cleared. Each input is only transformed once
+        per block, and the paths to each output are summed before a single inverse
+        transform, which is much cheaper than using a Convolution for each path.
+    */
+    struct ChannelMatrix { int numInputs, numOutputs; };
+
     //==============================================================================
     /** This function loads an impulse response audio file from memory, added in a
         JUCE project with the Projucer as binary data. It can load any of the audio
@@ -254,6 +332,32 @@ public:
     void loadImpulseResponse (AudioBuffer<float>&& buffer, double bufferSampleRate,
                               Stereo isStereo, Trim requiresTrimming, Normalise requiresNormalisation);
 
+    /** Loads a matrix impulse response from memory, in the same way as the
+        overload taking a Stereo argument.
+
+        @see ChannelMatrix
+    */
+    void loadImpulseResponse (const void* sourceData, size_t sourceDataSize,
+                              ChannelMatrix matrix, Trim requiresTrimming, size_t size,
+                              Normalise requiresNormalisation = Normalise::yes);
+
+    /** Loads a matrix impulse response from an audio file, in the same way as the
+        overload taking a Stereo argument.
+
+        @see ChannelMatrix
+    */
+    void loadImpulseResponse (const File& fileImpulseResponse,
+                              ChannelMatrix matrix, Trim requiresTrimming, size_t size,
+                              Normalise requiresNormalisation = Normalise::yes);
+
+    /** Loads a matrix impulse response from an audio buffer, in the same way as the
+        overload taking a Stereo argument.
+
+        @see ChannelMatrix
+    */
+    void loadImpulseResponse (AudioBuffer<float>&& buffer, double bufferSampleRate,
+                              ChannelMatrix matrix, Trim requiresTrimming, Normalise requiresNormalisation);
+
     /** This function returns the size of the current IR in samples. */
     int getCurrentIRSize() const;
 
@@ -268,7 +372,7 @@ public:
 private:
     //==============================================================================
     Convolution (const Latency&,
-                 const NonUniform&,
+                 const MultiStage&,
                  OptionalScopedPointer<ConvolutionMessageQueue>&&);
 
     void processSamples (const AudioBlock<const float>&, AudioBlock<float>&, bool isBypassed) noexcept;
@@ -287,7 +391,7 @@ private:
         void reset();
 
     private:
-        std::array<SmoothedValue<float>, 2> volumeDry, volumeWet;
+        std::vector<SmoothedValue<float>> volumeDry, volumeWet;
         AudioBlock<float> dryBlock;
         HeapBlock<char> dryBlockStorage;
         double sampleRate = 0;
@@ -122,6 +122,11 @@ class ConvolutionTest  : public UnitTest
 
     void checkLatency (const Convolution&, const Convolution::NonUniform&) {}
 
+    void checkLatency (const Convolution& convolution, const Convolution::MultiStage&)
+    {
+        expect (convolution.getLatency() == 0);
+    }
+
     template <typename ConvolutionConfig>
     void testConvolution (const ProcessSpec& spec,
                           const ConvolutionConfig& config,
@@ -243,6 +248,65 @@ class ConvolutionTest  : public UnitTest
             testConvolution (spec, config, ir, irSampleRate, stereo, trim, normalise, expectedResult, sequence);
     }
 
+    template <typename ConvolutionConfig>
+    void testMatrixConvolution (const ProcessSpec& spec,
+                                const ConvolutionConfig& config,
+                                Convolution::ChannelMatrix matrix,
+                                int irLength)
+    {
+        auto random = getRandom();
+
+        AudioBuffer<float> ir (matrix.numInputs * matrix.numOutputs, irLength);
+
+        for (auto channel = 0; channel != ir.getNumChannels(); ++channel)
+            for (auto sample = 0; sample != irLength; ++sample)
+                ir.setSample (channel, sample, (random.nextFloat() * 2.0f - 1.0f) * 0.05f);
+
+        const auto blockSize = static_cast<int> (spec.maximumBlockSize);
+        const auto numChannels = static_cast<int> (spec.numChannels);
+        const auto numSamples = blockSize * 8;
+
+        AudioBuffer<float> input (numChannels, numSamples);
+
+        for (auto channel = 0; channel != numChannels; ++channel)
+            for (auto sample = 0; sample != numSamples; ++sample)
+                input.setSample (channel, sample, random.nextFloat() * 2.0f - 1.0f);
+
+        // Each output should be the sum of every input convolved with its path to that output
+        AudioBuffer<float> expected (numChannels, numSamples);
+        expected.clear();
+
+        for (auto out = 0; out != matrix.numOutputs; ++out)
+            for (auto in = 0; in != matrix.numInputs; ++in)
+                for (auto sample = 0; sample != numSamples; ++sample)
+                    for (auto tap = 0; tap <= jmin (sample, irLength - 1); ++tap)
+                        expected.addSample (out, sample, ir.getSample (in * matrix.numOutputs + out, tap)
+                                                           * input.getSample (in, sample - tap));
+
+        Convolution convolution (config);
+        convolution.loadImpulseResponse (std::move (ir), spec.sampleRate, matrix, Convolution::Trim::no, Convolution::Normalise::no);
+        convolution.prepare (spec);
+
+        expectEquals (convolution.getCurrentIRSize(), irLength);
+
+        AudioBuffer<float> output (input);
+
+        for (auto start = 0; start < numSamples; start += blockSize)
+        {
+            auto block = AudioBlock<float> (output).getSubBlock ((size_t) start, (size_t) blockSize);
+            convolution.process (ProcessContextReplacing<float> (block));
+        }
+
+        const auto latency = convolution.getLatency();
+        auto maxError = 0.0f;
+
+        for (auto channel = 0; channel != numChannels; ++channel)
+            for (auto sample = 0; sample + latency < numSamples; ++sample)
+                maxError = jmax (maxError, std::abs (output.getSample (channel, sample + latency) - expected.getSample (channel, sample)));
+
+        expectLessThan (maxError, 1.0e-3f);
+    }
+
 public:
     ConvolutionTest()
         : UnitTest ("Convolution", UnitTestCategories::dsp)
@@ -537,15 +601,88 @@ public:
 
             for (auto headSize : { spec.maximumBlockSize / 2, spec.maximumBlockSize, spec.maximumBlockSize * 9 })
             {
-                testConvolution (spec,
-                                 Convolution::NonUniform { static_cast<int> (headSize) },
-                                 ramp,
-                                 spec.sampleRate,
-                                 Convolution::Stereo::yes,
-                                 Convolution::Trim::yes,
-                                 Convolution::Normalise::no,
-                                 ramp);
+                for (auto useBackgroundThread : { false, true })
+                {
+                    testConvolution (spec,
+                                     Convolution::NonUniform { static_cast<int> (headSize), useBackgroundThread },
+                                     ramp,
+                                     spec.sampleRate,
+                                     Convolution::Stereo::yes,
+                                     Convolution::Trim::yes,
+                                     Convolution::Normalise::no,
+                                     ramp);
+                }
+            }
+        }
+
+        beginTest ("True stereo convolutions work");
+        {
+            const Convolution::ChannelMatrix trueStereo { 2, 2 };
+
+            testMatrixConvolution (spec, Convolution::Latency { 0 }, trueStereo, 1500);
+            testMatrixConvolution (spec, Convolution::Latency { 1024 }, trueStereo, 1500);
+            testMatrixConvolution (spec, Convolution::NonUniform { 256 }, trueStereo, 3000);
+        }
+
+        beginTest ("Matrix convolutions read and write the requested number of channels");
+        {
+            testMatrixConvolution ({ 44100.0, 256, 3 }, Convolution::Latency { 0 }, { 2, 3 }, 700);
+            testMatrixConvolution ({ 44100.0, 256, 4 }, Convolution::Latency { 0 }, { 4, 2 }, 700);
+            testMatrixConvolution ({ 44100.0, 256, 4 }, Convolution::NonUniform { 128 }, { 1, 4 }, 700);
+        }
+
+        beginTest ("Multi-stage non-uniform convolutions work");
+        {
+            const auto ramp = makeStereoRamp (static_cast<int> (spec.maximumBlockSize) * 40);
+
+            for (const auto& partitions : { std::vector<int> { 256, 1024, 4096 },
+                                            std::vector<int> { 64, 512, 4096, 8192 },
+                                            std::vector<int> { 1024, 2048, 16384 } })
+            {
+                for (auto useBackgroundThread : { false, true })
+                {
+                    testConvolution (spec,
+                                     Convolution::MultiStage { partitions, useBackgroundThread },
+                                     ramp,
+                                     spec.sampleRate,
+                                     Convolution::Stereo::yes,
+                                     Convolution::Trim::yes,
+                                     Convolution::Normalise::no,
+                                     ramp);
+                }
             }
+
+            testMatrixConvolution (spec, Convolution::MultiStage { { 128, 512, 2048 } }, { 2, 2 }, 3000);
+            testMatrixConvolution (spec, Convolution::MultiStage { { 128, 512, 2048 }, true }, { 2, 2 }, 3000);
+        }
+
+        beginTest ("Multi-stage convolutions can be reset while running");
+        {
+            const auto ramp = makeRamp (static_cast<int> (spec.maximumBlockSize) * 16);
+
+            Convolution convolution (Convolution::MultiStage { { 256, 1024, 4096 }, true });
+            auto copy = ramp;
+            convolution.loadImpulseResponse (std::move (copy),
+                                             spec.sampleRate,
+                                             Convolution::Stereo::no,
+                                             Convolution::Trim::no,
+                                             Convolution::Normalise::no);
+            convolution.prepare (spec);
+
+            nTimes (50, [&]
+            {
+                addDiracImpulse (block);
+                convolution.process (context);
+                convolution.reset();
+            });
+
+            // After a reset, there should be no trace of the earlier input
+            block.clear();
+            nTimes (20, [&]
+            {
+                convolution.process (context);
+                expectEquals (block.findMinAndMax().getEnd(), 0.0f);
+            });
         }
 
         beginTest ("Convolutions with latency work");
@@ -574,6 +711,71 @@ public:
 
 ConvolutionTest convolutionUnitTest;
 
+//==============================================================================
+class ConvolutionBenchmarks  : public UnitTest
+{
+public:
+    ConvolutionBenchmarks()
+        : UnitTest ("Convolution partitioning", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        const ProcessSpec spec { 48000.0, 256, 2 };
+        const auto irLength = static_cast<int> (spec.sampleRate * 10.0);
+
+        AudioBuffer<float> ir (2, irLength);
+        Random random (1);
+
+        for (auto channel = 0; channel != ir.getNumChannels(); ++channel)
+            for (auto sample = 0; sample != irLength; ++sample)
+                ir.setSample (channel, sample, (random.nextFloat() * 2.0f - 1.0f) * std::exp (-4.0f * (float) sample / (float) irLength));
+
+        const auto measure = [&] (const String& testName, auto config)
+        {
+            beginTest (testName);
+
+            Convolution convolution (config);
+            auto copy = ir;
+            convolution.loadImpulseResponse (std::move (copy), spec.sampleRate, Convolution::Stereo::yes,
+                                             Convolution::Trim::no, Convolution::Normalise::yes);
+            convolution.prepare (spec);
+
+            AudioBuffer<float> buffer ((int) spec.numChannels, (int) spec.maximumBlockSize);
+            AudioBlock<float> block { buffer };
+            const auto numBlocks = (int) (spec.sampleRate * 20.0) / (int) spec.maximumBlockSize;
+
+            double total = 0.0, worst = 0.0;
+
+            for (auto i = 0; i < numBlocks; ++i)
+            {
+                for (auto channel = 0; channel != buffer.getNumChannels(); ++channel)
+                    for (auto sample = 0; sample != buffer.getNumSamples(); ++sample)
+                        buffer.setSample (channel, sample, random.nextFloat() * 2.0f - 1.0f);
+
+                const auto start = Time::getHighResolutionTicks();
+                convolution.process (ProcessContextReplacing<float> (block));
+                const auto elapsed = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6;
+
+                total += elapsed;
+                worst = jmax (worst, elapsed);
+            }
+
+            logMessage ("Mean " + String (total / numBlocks, 1) + " us, worst " + String (worst, 1) + " us per block");
+            expect (total > 0.0);
+        };
+
+        measure ("10 second IR, uniform", Convolution::Latency { 0 });
+        measure ("10 second IR, two stages", Convolution::NonUniform { 256 });
+        measure ("10 second IR, 256/2048/16384", Convolution::MultiStage { { 256, 2048, 16384 } });
+        measure ("10 second IR, 256/2048/16384, background thread", Convolution::MultiStage { { 256, 2048, 16384 }, true });
+        measure ("10 second IR, 256/1024/4096/16384/65536", Convolution::MultiStage { { 256, 1024, 4096, 16384, 65536 } });
+        measure ("10 second IR, 256/1024/4096/16384/65536, background thread", Convolution::MultiStage { { 256, 1024, 4096, 16384, 65536 }, true });
+    }
+};
+
+ConvolutionBenchmarks convolutionBenchmarks;
+
 }
 }
 }
@@ -34,6 +34,26 @@ struct FFT::Instance
     virtual void perform (const Complex<float>* input, Complex<float>* output, bool inverse) const noexcept = 0;
     virtual void performRealOnlyForwardTransform (float*, bool) const noexcept = 0;
     virtual void performRealOnlyInverseTransform (float*) const noexcept = 0;
+
+    // Engines that can do several transforms more efficiently than one at a time should override these
+    virtual void performMultiple (const Complex<float>* const* inputs, Complex<float>* const* outputs,
+                                  int numTransforms, bool inverse) const noexcept
+    {
+        for (int i = 0; i < numTransforms; ++i)
+            perform (inputs[i], outputs[i], inverse);
+    }
+
+    virtual void performRealOnlyForwardTransforms (float* const* data, int numTransforms, bool ignoreNegativeFreqs) const noexcept
+    {
+        for (int i = 0; i < numTransforms; ++i)
+            performRealOnlyForwardTransform (data[i], ignoreNegativeFreqs);
+    }
+
+    virtual void performRealOnlyInverseTransforms (float* const* data, int numTransforms) const noexcept
+    {
+        for (int i = 0; i < numTransforms; ++i)
+            performRealOnlyInverseTransform (data[i]);
+    }
 };
 
 struct FFT::Engine
@@ -190,6 +210,159 @@ struct FFTFallback  : public FFT::Instance
         }
     }
 
+   #if JUCE_USE_SIMD
+    //==============================================================================
+    // The batched transforms run a separate transform in each lane of a SIMDRegister, using an
+    // iterative radix-2 algorithm on split real and imaginary data, so that every step is a plain
+    // vertical SIMD operation. Any unused lanes in the last group are padded with zeros.
+    using Lanes = SIMDRegister<float>;
+    static constexpr int numLanes = (int) Lanes::SIMDNumElements;
+
+    void performMultiple (const Complex<float>* const* inputs, Complex<float>* const* outputs,
+                          int numTransforms, bool inverse) const noexcept override
+    {
+        if (size == 1)
+        {
+            for (int i = 0; i < numTransforms; ++i)
+                *outputs[i] = *inputs[i];
+
+            return;
+        }
+
+        const auto scale = inverse ? 1.0f / (float) size : 1.0f;
+
+        performInLanes (numTransforms, inverse,
+                        [&] (int transform, int index) { return inputs[transform][index]; },
+                        [&] (int transform, int index, float re, float im) { outputs[transform][index] = { re * scale, im * scale }; });
+    }
+
+    void performRealOnlyForwardTransforms (float* const* data, int numTransforms, bool) const noexcept override
+    {
+        if (size == 1)
+            return;
+
+        performInLanes (numTransforms, false,
+                        [&] (int transform, int index) { return Complex<float> { data[transform][index], 0.0f }; },
+                        [&] (int transform, int index, float re, float im)
+                        {
+                            data[transform][2 * index]     = re;
+                            data[transform][2 * index + 1] = im;
+                        });
+    }
+
+    void performRealOnlyInverseTransforms (float* const* data, int numTransforms) const noexcept override
+    {
+        if (size == 1)
+            return;
+
+        const auto scale = 1.0f / (float) size;
+
+        // Like the single transform, the upper half of the spectrum is rebuilt from the lower half
+        performInLanes (numTransforms, true,
+                        [&] (int transform, int index)
+                        {
+                            const auto* input = reinterpret_cast<const Complex<float>*> (data[transform]);
+                            return index < size / 2 ? input[index] : std::conj (input[size - index]);
+                        },
+                        [&] (int transform, int index, float re, float im)
+                        {
+                            data[transform][index]        = re * scale;
+                            data[transform][index + size] = im * scale;
+                        });
+    }
+
+    template <typename ReadInput, typename WriteOutput>
+    void performInLanes (int numTransforms, bool inverse, ReadInput&& readInput, WriteOutput&& writeOutput) const noexcept
+    {
+        // The whole input is read before any output is written, so in-place transforms are safe
+        const auto scratchSize = sizeof (Lanes) + 2 * (size_t) size * sizeof (Lanes);
+
+        const auto process = [&] (char* scratch)
+        {
+            auto* re = Lanes::getNextSIMDAlignedPtr (reinterpret_cast<float*> (scratch));
+            auto* im = re + size * numLanes;
+
+            for (int first = 0; first < numTransforms; first += numLanes)
+            {
+                const auto numInGroup = jmin (numLanes, numTransforms - first);
+
+                // Load the inputs in bit-reversed order
+                for (int i = 0, reversed = 0; i < size; ++i)
+                {
+                    for (int lane = 0; lane < numLanes; ++lane)
+                    {
+                        const auto value = lane < numInGroup ? readInput (first + lane, i) : Complex<float>();
+                        re[reversed * numLanes + lane] = value.real();
+                        im[reversed * numLanes + lane] = value.imag();
+                    }
+
+                    auto bit = size >> 1;
+
+                    for (; (reversed & bit) != 0; bit >>= 1)
+                        reversed ^= bit;
+
+                    reversed |= bit;
+                }
+
+                performButterfliesInLanes (re, im, inverse);
+
+                for (int lane = 0; lane < numInGroup; ++lane)
+                    for (int i = 0; i < size; ++i)
+                        writeOutput (first + lane, i, re[i * numLanes + lane], im[i * numLanes + lane]);
+            }
+        };
+
+        if (scratchSize < maxFFTScratchSpaceToAlloca)
+        {
+            JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6255)
+            process (static_cast<char*> (alloca (scratchSize)));
+            JUCE_END_IGNORE_WARNINGS_MSVC
+        }
+        else
+        {
+            HeapBlock<char> heapSpace (scratchSize);
+            process (heapSpace.getData());
+        }
+    }
+
+    void performButterfliesInLanes (float* re, float* im, bool inverse) const noexcept
+    {
+        const auto* twiddles = (inverse ? configInverse : configForward)->twiddleTable.getData();
+
+        for (int length = 2; length <= size; length <<= 1)
+        {
+            const auto half = length >> 1;
+            const auto twiddleStep = size / length;
+
+            for (int start = 0; start < size; start += length)
+            {
+                for (int k = 0; k < half; ++k)
+                {
+                    const auto twiddle = twiddles[k * twiddleStep];
+                    const auto twiddleRe = Lanes::expand (twiddle.real());
+                    const auto twiddleIm = Lanes::expand (twiddle.imag());
+
+                    auto* reA = re + (start + k) * numLanes;
+                    auto* imA = im + (start + k) * numLanes;
+                    auto* reB = reA + half * numLanes;
+                    auto* imB = imA + half * numLanes;
+
+                    const auto aRe = Lanes::fromRawArray (reA), aIm = Lanes::fromRawArray (imA);
+                    const auto bRe = Lanes::fromRawArray (reB), bIm = Lanes::fromRawArray (imB);
+
+                    const auto tRe = bRe * twiddleRe - bIm * twiddleIm;
+                    const auto tIm = bRe * twiddleIm + bIm * twiddleRe;
+
+                    (aRe - tRe).copyToRawArray (reB);
+                    (aIm - tIm).copyToRawArray (imB);
+                    (aRe + tRe).copyToRawArray (reA);
+                    (aIm + tIm).copyToRawArray (imA);
+                }
+            }
+        }
+    }
+   #endif
+
     //==============================================================================
     struct FFTConfig
     {
@@ -431,6 +604,488 @@ struct FFTFallback  : public FFT::Instance
 
 FFT::EngineImpl<FFTFallback> fftFallback;
 
+//==============================================================================
+//==============================================================================
+#if JUCE_USE_SIMD
+/*  A portable vectorised engine, used when no platform FFT library is available.
+
+    It works on split real and imaginary arrays using the Stockham autosort algorithm
+    with radix-4 passes, so each pass reads and writes contiguous runs of data which map
+    directly onto SIMDRegister operations. Real transforms are done with a complex
+    transform of half the size, followed by a post-processing pass.
+*/
+struct SIMDFFT  : public FFT::Instance
+{
+    // higher than the fallback, but lower than any of the platform libraries
+    static constexpr int priority = 0;
+
+    static SIMDFFT* create (int order)
+    {
+        // the fallback is just as fast for tiny sizes
+        return order >= 3 ? new SIMDFFT (order) : nullptr;
+    }
+
+    explicit SIMDFFT (int order)
+        : size (1 << order),
+          fullTransform (size),
+          halfTransform (size >> 1)
+    {
+        const auto halfSize = size >> 1;
+        realTwiddles.resize (2 * (size_t) (halfSize + 1));
+
+        for (int k = 0; k <= halfSize; ++k)
+        {
+            const auto angle = -MathConstants<double>::twoPi * k / size;
+            realTwiddles[(size_t) (2 * k)]     = (float) std::cos (angle);
+            realTwiddles[(size_t) (2 * k + 1)] = (float) std::sin (angle);
+        }
+    }
+
+    void perform (const Complex<float>* input, Complex<float>* output, bool inverse) const noexcept override
+    {
+        withScratch (size, [&] (float* re, float* im, float* workRe, float* workIm)
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                re[i] = input[i].real();
+                im[i] = input[i].imag();
+            }
+
+            writeComplexResult (performComplex (re, im, workRe, workIm, inverse, 1), 1, inverse, output);
+        });
+    }
+
+    void performRealOnlyForwardTransform (float* d, bool ignoreNegativeFreqs) const noexcept override
+    {
+        const auto halfSize = size >> 1;
+
+        withScratch (halfSize, [&] (float* re, float* im, float* workRe, float* workIm)
+        {
+            // Treat the even and odd samples as the real and imaginary parts of a half-size transform
+            for (int i = 0; i < halfSize; ++i)
+            {
+                re[i] = d[2 * i];
+                im[i] = d[2 * i + 1];
+            }
+
+            const auto result = halfTransform.perform (re, im, workRe, workIm);
+            combineRealSpectrum (result.first, result.second, 1, d);
+        });
+
+        if (! ignoreNegativeFreqs)
+            mirrorNegativeFrequencies (d);
+    }
+
+    void performRealOnlyInverseTransform (float* d) const noexcept override
+    {
+        withScratch (size >> 1, [&] (float* re, float* im, float* workRe, float* workIm)
+        {
+            splitRealSpectrum (d, re, im, 1);
+
+            const auto result = halfTransform.perform (re, im, workRe, workIm);
+            writeRealResult (result.second, result.first, 1, d);
+        });
+    }
+
+    //==============================================================================
+    // The batched versions interleave a group of transforms, one per SIMD lane, so that every
+    // pass of the transform works on whole registers. Unused lanes in the last group are zeroed.
+    // Once a group's working set is too big for the cache, it's quicker to do them one at a time.
+    void performMultiple (const Complex<float>* const* inputs, Complex<float>* const* outputs,
+                          int numTransforms, bool inverse) const noexcept override
+    {
+        if (! canInterleave (size))
+            return Instance::performMultiple (inputs, outputs, numTransforms, inverse);
+
+        withScratch (size * numLanes, [&] (float* re, float* im, float* workRe, float* workIm)
+        {
+            for (int first = 0; first < numTransforms; first += numLanes)
+            {
+                const auto numInGroup = jmin (numLanes, numTransforms - first);
+
+                // The whole group is read before anything is written, so in-place transforms are safe
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    for (int i = 0; i < size; ++i)
+                    {
+                        const auto value = lane < numInGroup ? inputs[first + lane][i] : Complex<float>();
+                        re[i * numLanes + lane] = value.real();
+                        im[i * numLanes + lane] = value.imag();
+                    }
+                }
+
+                const auto result = performComplex (re, im, workRe, workIm, inverse, numLanes);
+
+                for (int lane = 0; lane < numInGroup; ++lane)
+                    writeComplexResult ({ result.first + lane, result.second + lane }, numLanes, inverse, outputs[first + lane]);
+            }
+        });
+    }
+
+    void performRealOnlyForwardTransforms (float* const* data, int numTransforms, bool ignoreNegativeFreqs) const noexcept override
+    {
+        const auto halfSize = size >> 1;
+
+        if (! canInterleave (halfSize))
+            return Instance::performRealOnlyForwardTransforms (data, numTransforms, ignoreNegativeFreqs);
+
+        withScratch (halfSize * numLanes, [&] (float* re, float* im, float* workRe, float* workIm)
+        {
+            for (int first = 0; first < numTransforms; first += numLanes)
+            {
+                const auto numInGroup = jmin (numLanes, numTransforms - first);
+
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    for (int i = 0; i < halfSize; ++i)
+                    {
+                        re[i * numLanes + lane] = lane < numInGroup ? data[first + lane][2 * i]     : 0.0f;
+                        im[i * numLanes + lane] = lane < numInGroup ? data[first + lane][2 * i + 1] : 0.0f;
+                    }
+                }
+
+                const auto result = halfTransform.perform (re, im, workRe, workIm, numLanes);
+
+                for (int lane = 0; lane < numInGroup; ++lane)
+                    combineRealSpectrum (result.first + lane, result.second + lane, numLanes, data[first + lane]);
+            }
+        });
+
+        if (! ignoreNegativeFreqs)
+            for (int i = 0; i < numTransforms; ++i)
+                mirrorNegativeFrequencies (data[i]);
+    }
+
+    void performRealOnlyInverseTransforms (float* const* data, int numTransforms) const noexcept override
+    {
+        const auto halfSize = size >> 1;
+
+        if (! canInterleave (halfSize))
+            return Instance::performRealOnlyInverseTransforms (data, numTransforms);
+
+        withScratch (halfSize * numLanes, [&] (float* re, float* im, float* workRe, float* workIm)
+        {
+            for (int first = 0; first < numTransforms; first += numLanes)
+            {
+                const auto numInGroup = jmin (numLanes, numTransforms - first);
+
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    if (lane < numInGroup)
+                    {
+                        splitRealSpectrum (data[first + lane], re + lane, im + lane, numLanes);
+                    }
+                    else
+                    {
+                        for (int i = 0; i < halfSize; ++i)
+                            re[i * numLanes + lane] = im[i * numLanes + lane] = 0.0f;
+                    }
+                }
+
+                const auto result = halfTransform.perform (re, im, workRe, workIm, numLanes);
+
+                for (int lane = 0; lane < numInGroup; ++lane)
+                    writeRealResult (result.second + lane, result.first + lane, numLanes, data[first + lane]);
+            }
+        });
+    }
+
+private:
+    //==============================================================================
+    // In all of the helpers below, element i of the split arrays is found at index i * stride
+
+    static bool canInterleave (int length) noexcept
+    {
+        return getScratchSize (length * numLanes) <= maxInterleavedScratchSize;
+    }
+
+    std::pair<float*, float*> performComplex (float* re, float* im, float* workRe, float* workIm,
+                                              bool inverse, int stride) const noexcept
+    {
+        // An inverse transform is a forward transform with the real and imaginary parts swapped
+        if (inverse)
+        {
+            const auto result = fullTransform.perform (im, re, workIm, workRe, stride);
+            return { result.second, result.first };
+        }
+
+        return fullTransform.perform (re, im, workRe, workIm, stride);
+    }
+
+    void writeComplexResult (std::pair<const float*, const float*> result, int stride,
+                             bool inverse, Complex<float>* output) const noexcept
+    {
+        const auto scale = inverse ? 1.0f / (float) size : 1.0f;
+
+        for (int i = 0; i < size; ++i)
+            output[i] = { result.first[i * stride] * scale, result.second[i * stride] * scale };
+    }
+
+    void combineRealSpectrum (const float* zRe, const float* zIm, int stride, float* d) const noexcept
+    {
+        const auto halfSize = size >> 1;
+
+        for (int k = 0; k <= halfSize; ++k)
+        {
+            const auto a = (k == halfSize ? 0 : k) * stride;
+            const auto b = (k == 0 ? 0 : halfSize - k) * stride;
+
+            // Separate the spectra of the even and odd samples, then combine them
+            const auto evenRe = 0.5f * (zRe[a] + zRe[b]);
+            const auto evenIm = 0.5f * (zIm[a] - zIm[b]);
+            const auto oddRe  = 0.5f * (zIm[a] + zIm[b]);
+            const auto oddIm  = 0.5f * (zRe[b] - zRe[a]);
+
+            const auto twiddleRe = realTwiddles[(size_t) (2 * k)];
+            const auto twiddleIm = realTwiddles[(size_t) (2 * k + 1)];
+
+            d[2 * k]     = evenRe + oddRe * twiddleRe - oddIm * twiddleIm;
+            d[2 * k + 1] = evenIm + oddRe * twiddleIm + oddIm * twiddleRe;
+        }
+    }
+
+    void mirrorNegativeFrequencies (float* d) const noexcept
+    {
+        for (int k = (size >> 1) + 1; k < size; ++k)
+        {
+            d[2 * k]     =  d[2 * (size - k)];
+            d[2 * k + 1] = -d[2 * (size - k) + 1];
+        }
+    }
+
+    void splitRealSpectrum (const float* d, float* re, float* im, int stride) const noexcept
+    {
+        const auto halfSize = size >> 1;
+
+        for (int k = 0; k < halfSize; ++k)
+        {
+            const auto a = 2 * k;
+            const auto b = 2 * (halfSize - k);
+
+            const auto evenRe = 0.5f * (d[a] + d[b]);
+            const auto evenIm = 0.5f * (d[a + 1] - d[b + 1]);
+            const auto diffRe = 0.5f * (d[a] - d[b]);
+            const auto diffIm = 0.5f * (d[a + 1] + d[b + 1]);
+
+            const auto twiddleRe =  realTwiddles[(size_t) (2 * k)];
+            const auto twiddleIm = -realTwiddles[(size_t) (2 * k + 1)];
+
+            const auto oddRe = diffRe * twiddleRe - diffIm * twiddleIm;
+            const auto oddIm = diffRe * twiddleIm + diffIm * twiddleRe;
+
+            // Written with the real and imaginary parts swapped, to get an inverse transform
+            im[k * stride] = evenRe - oddIm;
+            re[k * stride] = evenIm + oddRe;
+        }
+    }
+
+    void writeRealResult (const float* zRe, const float* zIm, int stride, float* d) const noexcept
+    {
+        const auto halfSize = size >> 1;
+        const auto scale = 1.0f / (float) halfSize;
+
+        for (int i = 0; i < halfSize; ++i)
+        {
+            d[2 * i]     = zRe[i * stride] * scale;
+            d[2 * i + 1] = zIm[i * stride] * scale;
+        }
+
+        std::fill (d + size, d + 2 * size, 0.0f);
+    }
+
+    //==============================================================================
+    using Lanes = SIMDRegister<float>;
+    static constexpr int numLanes = (int) Lanes::SIMDNumElements;
+
+    struct ScalarOps
+    {
+        using Type = float;
+        static constexpr int width = 1;
+
+        static Type load (const float* p) noexcept          { return *p; }
+        static void store (Type v, float* p) noexcept       { *p = v; }
+        static Type expand (float v) noexcept               { return v; }
+    };
+
+    struct VectorOps
+    {
+        using Type = Lanes;
+        static constexpr int width = numLanes;
+
+        static Type load (const float* p) noexcept          { return Lanes::fromRawArray (p); }
+        static void store (Type v, float* p) noexcept       { v.copyToRawArray (p); }
+        static Type expand (float v) noexcept               { return Lanes::expand (v); }
+    };
+
+    //==============================================================================
+    class ComplexTransform
+    {
+    public:
+        explicit ComplexTransform (int lengthToUse)
+            : length (lengthToUse)
+        {
+            for (int n = length; n >= 4; n >>= 2)
+            {
+                const auto m = n / 4;
+
+                for (int factor = 1; factor <= 3; ++factor)
+                    for (int part = 0; part < 2; ++part)
+                        for (int p = 0; p < m; ++p)
+                        {
+                            const auto angle = -MathConstants<double>::twoPi * factor * p / n;
+                            twiddles.push_back ((float) (part == 0 ? std::cos (angle) : std::sin (angle)));
+                        }
+            }
+        }
+
+        /*  Transforms the data in re/im, using workRe/workIm as temporary storage. Returns the
+            pair of arrays which holds the result. All arrays must be SIMD-aligned.
+
+            If numInterleaved is more than one, that many transforms are done at once, with
+            element i of transform t stored at index i * numInterleaved + t, and the results
+            are interleaved in the same way. It must then be a multiple of the SIMD width.
+        */
+        std::pair<float*, float*> perform (float* re, float* im, float* workRe, float* workIm,
+                                           int numInterleaved = 1) const noexcept
+        {
+            const auto* stageTwiddles = twiddles.data();
+            int n = length, stride = numInterleaved;
+
+            for (; n >= 4; n >>= 2, stride <<= 2)
+            {
+                if (stride >= numLanes)
+                    radix4Pass<VectorOps> (n, stride, stageTwiddles, re, im, workRe, workIm);
+                else
+                    radix4Pass<ScalarOps> (n, stride, stageTwiddles, re, im, workRe, workIm);
+
+                stageTwiddles += 6 * (n / 4);
+                std::swap (re, workRe);
+                std::swap (im, workIm);
+            }
+
+            if (n == 2)
+            {
+                if (stride >= numLanes)
+                    radix2Pass<VectorOps> (stride, re, im, workRe, workIm);
+                else
+                    radix2Pass<ScalarOps> (stride, re, im, workRe, workIm);
+
+                std::swap (re, workRe);
+                std::swap (im, workIm);
+            }
+
+            return { re, im };
+        }
+
+    private:
+        template <typename Ops>
+        static void radix4Pass (int n, int stride, const float* stageTwiddles,
+                                const float* xr, const float* xi, float* yr, float* yi) noexcept
+        {
+            using T = typename Ops::Type;
+            const auto m = n / 4;
+
+            for (int p = 0; p < m; ++p)
+            {
+                const auto w1r = Ops::expand (stageTwiddles[p]),         w1i = Ops::expand (stageTwiddles[m + p]);
+                const auto w2r = Ops::expand (stageTwiddles[2 * m + p]), w2i = Ops::expand (stageTwiddles[3 * m + p]);
+                const auto w3r = Ops::expand (stageTwiddles[4 * m + p]), w3i = Ops::expand (stageTwiddles[5 * m + p]);
+
+                const auto in0 = stride * p, in1 = stride * (p + m), in2 = stride * (p + 2 * m), in3 = stride * (p + 3 * m);
+                const auto out0 = stride * 4 * p, out1 = out0 + stride, out2 = out1 + stride, out3 = out2 + stride;
+
+                for (int q = 0; q < stride; q += Ops::width)
+                {
+                    const T ar = Ops::load (xr + in0 + q), ai = Ops::load (xi + in0 + q);
+                    const T br = Ops::load (xr + in1 + q), bi = Ops::load (xi + in1 + q);
+                    const T cr = Ops::load (xr + in2 + q), ci = Ops::load (xi + in2 + q);
+                    const T dr = Ops::load (xr + in3 + q), di = Ops::load (xi + in3 + q);
+
+                    const T apcR = ar + cr, apcI = ai + ci;
+                    const T amcR = ar - cr, amcI = ai - ci;
+                    const T bpdR = br + dr, bpdI = bi + di;
+                    const T bmdR = br - dr, bmdI = bi - di;
+
+                    Ops::store (apcR + bpdR, yr + out0 + q);
+                    Ops::store (apcI + bpdI, yi + out0 + q);
+
+                    const T t1r = amcR + bmdI, t1i = amcI - bmdR;
+                    Ops::store (t1r * w1r - t1i * w1i, yr + out1 + q);
+                    Ops::store (t1r * w1i + t1i * w1r, yi + out1 + q);
+
+                    const T t2r = apcR - bpdR, t2i = apcI - bpdI;
+                    Ops::store (t2r * w2r - t2i * w2i, yr + out2 + q);
+                    Ops::store (t2r * w2i + t2i * w2r, yi + out2 + q);
+
+                    const T t3r = amcR - bmdI, t3i = amcI + bmdR;
+                    Ops::store (t3r * w3r - t3i * w3i, yr + out3 + q);
+                    Ops::store (t3r * w3i + t3i * w3r, yi + out3 + q);
+                }
+            }
+        }
+
+        template <typename Ops>
+        static void radix2Pass (int stride, const float* xr, const float* xi, float* yr, float* yi) noexcept
+        {
+            using T = typename Ops::Type;
+
+            for (int q = 0; q < stride; q += Ops::width)
+            {
+                const T ar = Ops::load (xr + q),          ai = Ops::load (xi + q);
+                const T br = Ops::load (xr + stride + q), bi = Ops::load (xi + stride + q);
+
+                Ops::store (ar + br, yr + q);
+                Ops::store (ai + bi, yi + q);
+                Ops::store (ar - br, yr + stride + q);
+                Ops::store (ai - bi, yi + stride + q);
+            }
+        }
+
+        int length;
+        std::vector<float> twiddles;
+    };
+
+    //==============================================================================
+    template <typename Fn>
+    static void withScratch (int length, Fn&& fn) noexcept
+    {
+        const auto scratchSize = getScratchSize (length);
+
+        const auto process = [&] (char* scratch)
+        {
+            auto* re = Lanes::getNextSIMDAlignedPtr (reinterpret_cast<float*> (scratch));
+            fn (re, re + length, re + 2 * length, re + 3 * length);
+        };
+
+        if (scratchSize < maxFFTScratchSpaceToAlloca)
+        {
+            JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6255)
+            process (static_cast<char*> (alloca (scratchSize)));
+            JUCE_END_IGNORE_WARNINGS_MSVC
+        }
+        else
+        {
+            HeapBlock<char> heapSpace (scratchSize);
+            process (heapSpace.getData());
+        }
+    }
+
+    static size_t getScratchSize (int length) noexcept
+    {
+        return sizeof (Lanes) + 4 * (size_t) length * sizeof (float);
+    }
+
+    static constexpr size_t maxFFTScratchSpaceToAlloca = 256 * 1024;
+    static constexpr size_t maxInterleavedScratchSize = 64 * 1024;
+
+    int size;
+    ComplexTransform fullTransform, halfTransform;
+    std::vector<float> realTwiddles;
+};
+
+FFT::EngineImpl<SIMDFFT> simdFFT;
+#endif
+
 //==============================================================================
 //==============================================================================
 #if (JUCE_MAC || JUCE_IOS) && JUCE_USE_VDSP_FRAMEWORK
@@ -981,6 +1636,25 @@ void FFT::performRealOnlyInverseTransform (float* inputOutputData) const noexcep
         engine->performRealOnlyInverseTransform (inputOutputData);
 }
 
+void FFT::perform (const Complex<float>* const* inputs, Complex<float>* const* outputs,
+                   int numTransforms, bool inverse) const noexcept
+{
+    if (engine != nullptr)
+        engine->performMultiple (inputs, outputs, numTransforms, inverse);
+}
+
+void FFT::performRealOnlyForwardTransform (float* const* inputOutputData, int numTransforms, bool ignoreNegativeFreqs) const noexcept
+{
+    if (engine != nullptr)
+        engine->performRealOnlyForwardTransforms (inputOutputData, numTransforms, ignoreNegativeFreqs);
+}
+
+void FFT::performRealOnlyInverseTransform (float* const* inputOutputData, int numTransforms) const noexcept
+{
+    if (engine != nullptr)
+        engine->performRealOnlyInverseTransforms (inputOutputData, numTransforms);
+}
+
 void FFT::performFrequencyOnlyForwardTransform (float* inputOutputData, bool ignoreNegativeFreqs) const noexcept
 {
     if (size == 1)
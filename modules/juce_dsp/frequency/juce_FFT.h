@@ -107,6 +107,34 @@ public:
     void performFrequencyOnlyForwardTransform (float* inputOutputData,
                                                bool onlyCalculateNonNegativeFrequencies = false) const noexcept;
 
+    //==============================================================================
+    /** Performs several out-of-place FFTs of the same size, either forward or inverse.
+
+        This gives the same results as calling perform() for each pair of arrays, but
+        engines that can run several transforms in parallel will do so. Each array
+        must contain at least getSize() elements.
+    */
+    void perform (const Complex<float>* const* inputs, Complex<float>* const* outputs,
+                  int numTransforms, bool inverse) const noexcept;
+
+    /** Performs in-place forward transforms on several blocks of real data.
+
+        This gives the same results as calling performRealOnlyForwardTransform() for
+        each block, but engines that can run several transforms in parallel will do so.
+        This makes it a good fit for multichannel analysis or STFT processing, where
+        many transforms of the same size are needed at once.
+    */
+    void performRealOnlyForwardTransform (float* const* inputOutputData, int numTransforms,
+                                          bool onlyCalculateNonNegativeFrequencies = false) const noexcept;
+
+    /** Performs in-place inverse transforms on several blocks of data created by
+        performRealOnlyForwardTransform().
+
+        This gives the same results as calling performRealOnlyInverseTransform() for
+        each block, but engines that can run several transforms in parallel will do so.
+    */
+    void performRealOnlyInverseTransform (float* const* inputOutputData, int numTransforms) const noexcept;
+
     /** Returns the number of data points that this FFT was created to work with. */
     int getSize() const noexcept            { return size; }
 
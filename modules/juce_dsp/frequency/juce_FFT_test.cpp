@@ -196,6 +196,211 @@ struct FFTUnitTest  : public UnitTest
         }
     };
 
+    struct BatchTest
+    {
+        static void run (FFTUnitTest& u)
+        {
+            Random random (61729);
+
+            for (int order = 0; order <= 8; ++order)
+            {
+                const auto n = (size_t) 1 << order;
+                FFT fft (order);
+
+                for (auto numTransforms : { 1, 3, 4, 5, 8, 9, 17 })
+                {
+                    std::vector<std::vector<Complex<float>>> inputs, outputs, expected;
+
+                    for (int i = 0; i < numTransforms; ++i)
+                    {
+                        inputs.emplace_back (n);
+                        outputs.emplace_back (n);
+                        expected.emplace_back (n);
+                        fillRandom (random, inputs.back().data(), n);
+                    }
+
+                    std::vector<const Complex<float>*> inputPointers;
+                    std::vector<Complex<float>*> outputPointers;
+
+                    for (int i = 0; i < numTransforms; ++i)
+                    {
+                        inputPointers.push_back (inputs[(size_t) i].data());
+                        outputPointers.push_back (outputs[(size_t) i].data());
+                    }
+
+                    for (auto inverse : { false, true })
+                    {
+                        for (int i = 0; i < numTransforms; ++i)
+                            fft.perform (inputs[(size_t) i].data(), expected[(size_t) i].data(), inverse);
+
+                        fft.perform (inputPointers.data(), outputPointers.data(), numTransforms, inverse);
+
+                        for (int i = 0; i < numTransforms; ++i)
+                            u.expect (checkArrayIsSimilar (outputs[(size_t) i].data(), expected[(size_t) i].data(), n));
+                    }
+
+                    std::vector<std::vector<float>> real, realExpected;
+                    std::vector<float*> realPointers;
+
+                    for (int i = 0; i < numTransforms; ++i)
+                    {
+                        real.emplace_back (2 * n);
+                        fillRandom (random, real.back().data(), n);
+                        realExpected.push_back (real.back());
+                        realPointers.push_back (real.back().data());
+                    }
+
+                    for (auto& block : realExpected)
+                        fft.performRealOnlyForwardTransform (block.data());
+
+                    fft.performRealOnlyForwardTransform (realPointers.data(), numTransforms);
+
+                    for (int i = 0; i < numTransforms; ++i)
+                        u.expect (checkArrayIsSimilar (real[(size_t) i].data(), realExpected[(size_t) i].data(), 2 * n));
+
+                    for (auto& block : realExpected)
+                        fft.performRealOnlyInverseTransform (block.data());
+
+                    fft.performRealOnlyInverseTransform (realPointers.data(), numTransforms);
+
+                    for (int i = 0; i < numTransforms; ++i)
+                        u.expect (checkArrayIsSimilar (real[(size_t) i].data(), realExpected[(size_t) i].data(), n));
+                }
+            }
+        }
+    };
+
+   #if JUCE_USE_SIMD
+    struct SIMDEngineTest
+    {
+        static bool checkArrayIsClose (const float* a, const float* b, size_t n) noexcept
+        {
+            auto largest = 1.0f;
+
+            for (size_t i = 0; i < n; ++i)
+                largest = jmax (largest, std::abs (b[i]));
+
+            for (size_t i = 0; i < n; ++i)
+                if (std::abs (a[i] - b[i]) > 1.0e-5f * largest)
+                    return false;
+
+            return true;
+        }
+
+        static void run (FFTUnitTest& u)
+        {
+            Random random (1984);
+
+            for (int order = 3; order <= 14; ++order)
+            {
+                const auto n = (size_t) 1 << order;
+
+                std::unique_ptr<SIMDFFT> engine (SIMDFFT::create (order));
+                std::unique_ptr<FFTFallback> reference (FFTFallback::create (order));
+
+                std::vector<float> input (2 * n), output (2 * n), expected (2 * n);
+                fillRandom (random, input.data(), n);
+
+                for (auto ignoreNegative : { false, true })
+                {
+                    output = input;
+                    expected = input;
+                    engine->performRealOnlyForwardTransform (output.data(), ignoreNegative);
+                    reference->performRealOnlyForwardTransform (expected.data(), ignoreNegative);
+
+                    u.expect (checkArrayIsClose (output.data(), expected.data(), ignoreNegative ? n + 2 : 2 * n));
+                }
+
+                engine->performRealOnlyInverseTransform (output.data());
+                u.expect (checkArrayIsClose (output.data(), input.data(), n));
+
+                std::vector<Complex<float>> complexInput (n), complexOutput (n), complexExpected (n);
+                fillRandom (random, complexInput.data(), n);
+
+                for (auto inverse : { false, true })
+                {
+                    engine->perform (complexInput.data(), complexOutput.data(), inverse);
+                    reference->perform (complexInput.data(), complexExpected.data(), inverse);
+
+                    u.expect (checkArrayIsClose (reinterpret_cast<const float*> (complexOutput.data()),
+                                                 reinterpret_cast<const float*> (complexExpected.data()), 2 * n));
+                }
+
+                checkBatchedTransforms (u, random, *engine, n);
+            }
+        }
+
+        // The batched transforms must give the same results as the single ones, including
+        // when the number of transforms isn't a multiple of the SIMD width
+        static void checkBatchedTransforms (FFTUnitTest& u, Random& random, const SIMDFFT& engine, size_t n)
+        {
+            constexpr int numTransforms = 7;
+
+            std::vector<std::vector<Complex<float>>> complexBlocks, complexExpected;
+            std::vector<const Complex<float>*> inputPointers;
+            std::vector<Complex<float>*> outputPointers;
+
+            for (int i = 0; i < numTransforms; ++i)
+            {
+                complexBlocks.emplace_back (n);
+                fillRandom (random, complexBlocks.back().data(), n);
+                complexExpected.push_back (complexBlocks.back());
+            }
+
+            for (auto& block : complexBlocks)
+            {
+                inputPointers.push_back (block.data());
+                outputPointers.push_back (block.data());
+            }
+
+            for (auto inverse : { false, true })
+            {
+                for (auto& block : complexExpected)
+                    engine.perform (block.data(), block.data(), inverse);
+
+                // in-place
+                engine.performMultiple (inputPointers.data(), outputPointers.data(), numTransforms, inverse);
+
+                for (int i = 0; i < numTransforms; ++i)
+                    u.expect (checkArrayIsClose (reinterpret_cast<const float*> (complexBlocks[(size_t) i].data()),
+                                                 reinterpret_cast<const float*> (complexExpected[(size_t) i].data()), 2 * n));
+            }
+
+            for (auto ignoreNegative : { false, true })
+            {
+                std::vector<std::vector<float>> blocks, expected;
+                std::vector<float*> pointers;
+
+                for (int i = 0; i < numTransforms; ++i)
+                {
+                    blocks.emplace_back (2 * n);
+                    fillRandom (random, blocks.back().data(), n);
+                    expected.push_back (blocks.back());
+                }
+
+                for (auto& block : blocks)
+                    pointers.push_back (block.data());
+
+                for (auto& block : expected)
+                    engine.performRealOnlyForwardTransform (block.data(), ignoreNegative);
+
+                engine.performRealOnlyForwardTransforms (pointers.data(), numTransforms, ignoreNegative);
+
+                for (int i = 0; i < numTransforms; ++i)
+                    u.expect (checkArrayIsClose (blocks[(size_t) i].data(), expected[(size_t) i].data(), ignoreNegative ? n + 2 : 2 * n));
+
+                for (auto& block : expected)
+                    engine.performRealOnlyInverseTransform (block.data());
+
+                engine.performRealOnlyInverseTransforms (pointers.data(), numTransforms);
+
+                for (int i = 0; i < numTransforms; ++i)
+                    u.expect (checkArrayIsClose (blocks[(size_t) i].data(), expected[(size_t) i].data(), 2 * n));
+            }
+        }
+    };
+   #endif
+
     template <class TheTest>
     void runTestForAllTypes (const char* unitTestName)
     {
@@ -209,10 +414,159 @@ struct FFTUnitTest  : public UnitTest
         runTestForAllTypes<RealTest> ("Real input numbers Test");
         runTestForAllTypes<FrequencyOnlyTest> ("Frequency only Test");
         runTestForAllTypes<ComplexTest> ("Complex input numbers Test");
+        runTestForAllTypes<BatchTest> ("Batched transforms Test");
+
+       #if JUCE_USE_SIMD
+        runTestForAllTypes<SIMDEngineTest> ("SIMD engine Test");
+       #endif
     }
 };
 
 static FFTUnitTest fftUnitTest;
 
+//==============================================================================
+struct FFTBenchmarks  : public UnitTest
+{
+    FFTBenchmarks()
+        : UnitTest ("FFT batching", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        constexpr int numTransforms = 64;
+        constexpr int numRepeats = 200;
+        Random random (1);
+
+        for (auto order : { 6, 8, 10, 12 })
+        {
+            beginTest ("Order " + String (order) + ", " + String (numTransforms) + " real transforms");
+
+            FFT fft (order);
+            const auto n = (size_t) fft.getSize();
+
+            std::vector<std::vector<float>> blocks;
+            std::vector<float*> pointers;
+
+            for (int i = 0; i < numTransforms; ++i)
+            {
+                blocks.emplace_back (2 * n);
+                FFTUnitTest::fillRandom (random, blocks.back().data(), n);
+                pointers.push_back (blocks.back().data());
+            }
+
+            const auto measure = [&] (auto&& transform)
+            {
+                const auto start = Time::getHighResolutionTicks();
+
+                for (int repeat = 0; repeat < numRepeats; ++repeat)
+                    transform();
+
+                return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6 / numRepeats;
+            };
+
+            const auto looped = measure ([&]
+            {
+                for (auto* block : pointers)
+                {
+                    fft.performRealOnlyForwardTransform (block);
+                    fft.performRealOnlyInverseTransform (block);
+                }
+            });
+
+            const auto batched = measure ([&]
+            {
+                fft.performRealOnlyForwardTransform (pointers.data(), numTransforms);
+                fft.performRealOnlyInverseTransform (pointers.data(), numTransforms);
+            });
+
+            logMessage ("Looped " + String (looped, 1) + " us, batched " + String (batched, 1) + " us per forward/inverse pass");
+            expect (looped > 0.0 && batched > 0.0);
+        }
+    }
+};
+
+static FFTBenchmarks fftBenchmarks;
+
+//==============================================================================
+struct FFTEngineBenchmarks  : public UnitTest
+{
+    FFTEngineBenchmarks()
+        : UnitTest ("FFT engines", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        measure<FFTFallback> ("Fallback");
+
+       #if JUCE_USE_SIMD
+        measure<SIMDFFT> ("SIMD");
+       #endif
+
+       #if (JUCE_MAC || JUCE_IOS) && JUCE_USE_VDSP_FRAMEWORK
+        measure<AppleFFT> ("vDSP");
+       #endif
+
+       #if JUCE_DSP_USE_SHARED_FFTW || JUCE_DSP_USE_STATIC_FFTW
+        measure<FFTWImpl> ("FFTW");
+       #endif
+
+       #if JUCE_DSP_USE_INTEL_MKL
+        measure<IntelFFT> ("Intel MKL");
+       #endif
+
+       #if _IPP_SEQUENTIAL_STATIC || _IPP_SEQUENTIAL_DYNAMIC || _IPP_PARALLEL_STATIC || _IPP_PARALLEL_DYNAMIC
+        measure<IntelPerformancePrimitivesFFT> ("Intel IPP");
+       #endif
+    }
+
+    template <typename Engine>
+    void measure (const String& engineName)
+    {
+        beginTest (engineName);
+        Random random (1);
+
+        for (int order = 6; order <= 16; ++order)
+        {
+            std::unique_ptr<Engine> engine (Engine::create (order));
+
+            if (engine == nullptr)
+                continue;
+
+            const auto n = (size_t) 1 << order;
+            const auto numRepeats = jmax (8, (1 << 20) >> order);
+
+            std::vector<float> data (2 * n);
+            FFTUnitTest::fillRandom (random, data.data(), n);
+
+            std::vector<Complex<float>> complexInput (n), complexOutput (n);
+            FFTUnitTest::fillRandom (random, complexInput.data(), n);
+
+            const auto time = [numRepeats] (auto&& transform)
+            {
+                const auto start = Time::getHighResolutionTicks();
+
+                for (int repeat = 0; repeat < numRepeats; ++repeat)
+                    transform();
+
+                return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6 / numRepeats;
+            };
+
+            const auto real = time ([&]
+            {
+                engine->performRealOnlyForwardTransform (data.data(), true);
+                engine->performRealOnlyInverseTransform (data.data());
+            });
+
+            const auto complex = time ([&] { engine->perform (complexInput.data(), complexOutput.data(), false); });
+
+            logMessage ("Order " + String (order) + ": real forward/inverse " + String (real, 2)
+                          + " us, complex forward " + String (complex, 2) + " us");
+            expect (real > 0.0 && complex > 0.0);
+        }
+    }
+};
+
+static FFTEngineBenchmarks fftEngineBenchmarks;
+
 } // namespace dsp
 } // namespace juce
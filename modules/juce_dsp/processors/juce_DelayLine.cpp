@@ -28,6 +28,188 @@ namespace juce
 namespace dsp
 {
 
+//==============================================================================
+namespace DelayLineHelpers
+{
+    /*  Runs a calculation over a block, one SIMDRegister at a time where possible.
+        The function is called with the index of the first sample and a loader that
+        turns a pointer into either a SIMDRegister or a single sample.
+    */
+    template <typename SampleType, typename Function>
+    void processVectorised (SampleType* result, int numSamples, Function&& compute) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SIMD
+        using Vec = SIMDRegister<SampleType>;
+
+        for (; i + (int) Vec::size() <= numSamples; i += (int) Vec::size())
+            compute (i, [] (const SampleType* p) { return Vec::fromRawArray (p); }).copyToRawArray (result + i);
+       #endif
+
+        for (; i < numSamples; ++i)
+            result[i] = compute (i, [] (const SampleType* p) { return *p; });
+    }
+
+    /*  Each kernel reads numPoints consecutive samples for every output sample, the
+        oldest first. In interpolateFixed, points[n + k] is point k of sample n, and in
+        interpolateVarying, points[k] is an aligned array holding point k of every sample.
+    */
+    template <typename InterpolationType>
+    struct Kernel;
+
+    template <>
+    struct Kernel<DelayLineInterpolationTypes::None>
+    {
+        static constexpr int numPoints = 1;
+
+        template <typename SampleType>
+        static void adjustDelay (int&, SampleType&) noexcept {}
+
+        template <typename SampleType>
+        static void interpolateFixed (const SampleType* points, SampleType, SampleType* output, int numSamples, SampleType&) noexcept
+        {
+            FloatVectorOperations::copy (output, points, numSamples);
+        }
+
+        template <typename SampleType>
+        static void interpolateVarying (const SampleType* const* points, const SampleType*, SampleType* result, int numSamples, SampleType&) noexcept
+        {
+            FloatVectorOperations::copy (result, points[0], numSamples);
+        }
+    };
+
+    template <>
+    struct Kernel<DelayLineInterpolationTypes::Linear>
+    {
+        static constexpr int numPoints = 2;
+
+        template <typename SampleType>
+        static void adjustDelay (int&, SampleType&) noexcept {}
+
+        template <typename SampleType>
+        static void interpolateFixed (const SampleType* points, SampleType frac, SampleType* output, int numSamples, SampleType&) noexcept
+        {
+            FloatVectorOperations::copyWithMultiply (output, points + 1, (SampleType) 1 - frac, numSamples);
+            FloatVectorOperations::addWithMultiply  (output, points, frac, numSamples);
+        }
+
+        template <typename SampleType>
+        static void interpolateVarying (const SampleType* const* points, const SampleType* fractions, SampleType* result, int numSamples, SampleType&) noexcept
+        {
+            processVectorised (result, numSamples, [&] (int i, auto load)
+            {
+                auto value1 = load (points[1] + i);
+                return value1 + load (fractions + i) * (load (points[0] + i) - value1);
+            });
+        }
+    };
+
+    template <>
+    struct Kernel<DelayLineInterpolationTypes::Lagrange3rd>
+    {
+        static constexpr int numPoints = 4;
+
+        template <typename SampleType>
+        static void adjustDelay (int& delayInt, SampleType& delayFrac) noexcept
+        {
+            if (delayInt >= 1)
+            {
+                delayFrac++;
+                delayInt--;
+            }
+        }
+
+        template <typename SampleType>
+        static void interpolateFixed (const SampleType* points, SampleType frac, SampleType* output, int numSamples, SampleType&) noexcept
+        {
+            auto d1 = frac - 1;
+            auto d2 = frac - 2;
+            auto d3 = frac - 3;
+
+            FloatVectorOperations::copyWithMultiply (output, points + 3, -d1 * d2 * d3 / 6, numSamples);
+            FloatVectorOperations::addWithMultiply  (output, points + 2, frac * d2 * d3 / 2, numSamples);
+            FloatVectorOperations::addWithMultiply  (output, points + 1, -frac * d1 * d3 / 2, numSamples);
+            FloatVectorOperations::addWithMultiply  (output, points,     frac * d1 * d2 / 6, numSamples);
+        }
+
+        template <typename SampleType>
+        static void interpolateVarying (const SampleType* const* points, const SampleType* fractions, SampleType* result, int numSamples, SampleType&) noexcept
+        {
+            processVectorised (result, numSamples, [&] (int i, auto load)
+            {
+                auto frac = load (fractions + i);
+                auto d1 = frac - (SampleType) 1;
+                auto d2 = frac - (SampleType) 2;
+                auto d3 = frac - (SampleType) 3;
+
+                auto c1 = d1 * d2 * d3 * (SampleType) (-1.0 / 6.0);
+                auto c2 = d2 * d3 * (SampleType) 0.5;
+                auto c3 = d1 * d3 * (SampleType) -0.5;
+                auto c4 = d1 * d2 * (SampleType) (1.0 / 6.0);
+
+                return load (points[3] + i) * c1
+                         + frac * (load (points[2] + i) * c2 + load (points[1] + i) * c3 + load (points[0] + i) * c4);
+            });
+        }
+    };
+
+    template <>
+    struct Kernel<DelayLineInterpolationTypes::Thiran>
+    {
+        static constexpr int numPoints = 2;
+
+        template <typename SampleType>
+        static void adjustDelay (int& delayInt, SampleType& delayFrac) noexcept
+        {
+            if (delayFrac < (SampleType) 0.618 && delayInt >= 1)
+            {
+                delayFrac++;
+                delayInt--;
+            }
+        }
+
+        // The allpass recursion can't be vectorised, but its feed-forward part can
+        template <typename SampleType>
+        static void interpolateFixed (const SampleType* points, SampleType frac, SampleType* output, int numSamples, SampleType& state) noexcept
+        {
+            if (numSamples <= 0)
+                return;
+
+            if (frac == 0)
+            {
+                FloatVectorOperations::copy (output, points + 1, numSamples);
+                state = output[numSamples - 1];
+                return;
+            }
+
+            auto alpha = (1 - frac) / (1 + frac);
+
+            FloatVectorOperations::copy (output, points, numSamples);
+            FloatVectorOperations::addWithMultiply (output, points + 1, alpha, numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] -= alpha * state;
+                state = output[i];
+            }
+        }
+
+        template <typename SampleType>
+        static void interpolateVarying (const SampleType* const* points, const SampleType* fractions, SampleType* result, int numSamples, SampleType& state) noexcept
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto frac = fractions[i];
+                auto alpha = (1 - frac) / (1 + frac);
+
+                state = frac == 0 ? points[1][i] : points[0][i] + alpha * (points[1][i] - state);
+                result[i] = state;
+            }
+        }
+    };
+}
+
 //==============================================================================
 template <typename SampleType, typename InterpolationType>
 DelayLine<SampleType, InterpolationType>::DelayLine()
@@ -71,12 +253,14 @@ void DelayLine<SampleType, InterpolationType>::prepare (const ProcessSpec& spec)
 {
     jassert (spec.numChannels > 0);
 
-    bufferData.setSize ((int) spec.numChannels, totalSize, false, false, true);
+    maximumBlockSize = (int) spec.maximumBlockSize;
+    updateBufferSize ((int) spec.numChannels);
 
     writePos.resize (spec.numChannels);
     readPos.resize  (spec.numChannels);
 
     v.resize (spec.numChannels);
+    tapStates.resize (spec.numChannels * (size_t) maximumNumTaps);
     sampleRate = spec.sampleRate;
 
     reset();
@@ -87,17 +271,36 @@ void DelayLine<SampleType, InterpolationType>::setMaximumDelayInSamples (int max
 {
     jassert (maxDelayInSamples >= 0);
     totalSize = jmax (4, maxDelayInSamples + 1);
-    bufferData.setSize ((int) bufferData.getNumChannels(), totalSize, false, false, true);
+    updateBufferSize (bufferData.getNumChannels());
+    reset();
+}
+
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::setMaximumNumTaps (int maxNumTaps)
+{
+    jassert (maxNumTaps > 0);
+    maximumNumTaps = jmax (1, maxNumTaps);
+    tapStates.resize (v.size() * (size_t) maximumNumTaps);
     reset();
 }
 
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::updateBufferSize (int numChannels)
+{
+    // Leaves room for a whole block to be pushed before it is read back, and for
+    // the interpolation points beyond the maximum delay
+    ringSize = totalSize + 3 + jmax ((int) maxChunkSize, maximumBlockSize);
+    bufferData.setSize (numChannels, ringSize + guardSize, false, false, true);
+}
+
 template <typename SampleType, typename InterpolationType>
 void DelayLine<SampleType, InterpolationType>::reset()
 {
     for (auto vec : { &writePos, &readPos })
         std::fill (vec->begin(), vec->end(), 0);
 
-    std::fill (v.begin(), v.end(), static_cast<SampleType> (0));
+    for (auto vec : { &v, &tapStates })
+        std::fill (vec->begin(), vec->end(), static_cast<SampleType> (0));
 
     bufferData.clear();
 }
@@ -106,8 +309,15 @@ void DelayLine<SampleType, InterpolationType>::reset()
 template <typename SampleType, typename InterpolationType>
 void DelayLine<SampleType, InterpolationType>::pushSample (int channel, SampleType sample)
 {
-    bufferData.setSample (channel, writePos[(size_t) channel], sample);
-    writePos[(size_t) channel] = (writePos[(size_t) channel] + totalSize - 1) % totalSize;
+    auto* samples = bufferData.getWritePointer (channel);
+    auto& pos = writePos[(size_t) channel];
+
+    samples[pos] = sample;
+
+    if (pos < guardSize)
+        samples[pos + ringSize] = sample;
+
+    pos = wrapIndex (pos + 1);
 }
 
 template <typename SampleType, typename InterpolationType>
@@ -119,11 +329,163 @@ SampleType DelayLine<SampleType, InterpolationType>::popSample (int channel, Sam
     auto result = interpolateSample (channel);
 
     if (updateReadPointer)
-        readPos[(size_t) channel] = (readPos[(size_t) channel] + totalSize - 1) % totalSize;
+        readPos[(size_t) channel] = wrapIndex (readPos[(size_t) channel] + 1);
 
     return result;
 }
 
+//==============================================================================
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::pushBlock (int channel, const SampleType* samples, int numSamples)
+{
+    jassert (isPositiveAndBelow (channel, bufferData.getNumChannels()));
+
+    auto* data = bufferData.getWritePointer (channel);
+    auto& pos = writePos[(size_t) channel];
+
+    while (numSamples > 0)
+    {
+        auto numThisTime = jmin (numSamples, ringSize - pos);
+
+        FloatVectorOperations::copy (data + pos, samples, numThisTime);
+
+        if (pos < guardSize)
+            FloatVectorOperations::copy (data + ringSize + pos, samples, jmin (numThisTime, guardSize - pos));
+
+        pos = wrapIndex (pos + numThisTime);
+        samples += numThisTime;
+        numSamples -= numThisTime;
+    }
+}
+
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::popMultiTapBlock (int channel, const SampleType* delaysInSamples,
+                                                                 const AudioBlock<SampleType>& tapOutputs,
+                                                                 bool updateReadPointer)
+{
+    jassert (isPositiveAndBelow (channel, bufferData.getNumChannels()));
+
+    const auto numTaps = (int) tapOutputs.getNumChannels();
+    const auto numSamples = (int) tapOutputs.getNumSamples();
+
+    for (int tap = 0; tap < numTaps; ++tap)
+    {
+        int tapDelayInt;
+        SampleType tapDelayFrac, unusedState = 0;
+        splitDelay (delaysInSamples[tap], tapDelayInt, tapDelayFrac);
+
+        readBlock (channel, tapDelayInt, tapDelayFrac, tapOutputs.getChannelPointer ((size_t) tap),
+                   numSamples, getTapState (channel, tap, unusedState));
+    }
+
+    if (updateReadPointer)
+        readPos[(size_t) channel] = (readPos[(size_t) channel] + numSamples) % ringSize;
+}
+
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::popMultiTapBlock (int channel, const AudioBlock<const SampleType>& tapDelays,
+                                                                 const AudioBlock<SampleType>& tapOutputs,
+                                                                 bool updateReadPointer)
+{
+    using Kernel = DelayLineHelpers::Kernel<InterpolationType>;
+
+    jassert (isPositiveAndBelow (channel, bufferData.getNumChannels()));
+    jassert (tapDelays.getNumChannels() == tapOutputs.getNumChannels());
+    jassert (tapDelays.getNumSamples() >= tapOutputs.getNumSamples());
+
+    const auto numTaps = (int) tapOutputs.getNumChannels();
+    const auto numSamples = (int) tapOutputs.getNumSamples();
+    const auto* samples = bufferData.getReadPointer (channel);
+
+    struct alignas (16 * sizeof (SampleType)) Scratch
+    {
+        SampleType points[Kernel::numPoints][maxChunkSize], fractions[maxChunkSize], result[maxChunkSize];
+    };
+
+    Scratch scratch;
+    const SampleType* points[Kernel::numPoints];
+
+    for (int k = 0; k < Kernel::numPoints; ++k)
+        points[k] = scratch.points[k];
+
+    for (int tap = 0; tap < numTaps; ++tap)
+    {
+        auto* delays = tapDelays.getChannelPointer ((size_t) tap);
+        auto* output = tapOutputs.getChannelPointer ((size_t) tap);
+        SampleType unusedState = 0;
+        auto& state = getTapState (channel, tap, unusedState);
+        auto position = readPos[(size_t) channel];
+
+        for (int i = 0; i < numSamples; i += maxChunkSize)
+        {
+            auto numThisTime = jmin (numSamples - i, (int) maxChunkSize);
+
+            for (int n = 0; n < numThisTime; ++n)
+            {
+                int sampleDelayInt;
+                splitDelay (delays[i + n], sampleDelayInt, scratch.fractions[n]);
+
+                auto* oldestPoint = samples + wrapIndex (position + n - sampleDelayInt - (Kernel::numPoints - 1));
+
+                for (int k = 0; k < Kernel::numPoints; ++k)
+                    scratch.points[k][n] = oldestPoint[k];
+            }
+
+            Kernel::interpolateVarying (points, scratch.fractions, scratch.result, numThisTime, state);
+            FloatVectorOperations::copy (output + i, scratch.result, numThisTime);
+
+            position = wrapIndex (position + numThisTime);
+        }
+    }
+
+    if (updateReadPointer)
+        readPos[(size_t) channel] = (readPos[(size_t) channel] + numSamples) % ringSize;
+}
+
+//==============================================================================
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::splitDelay (SampleType delayInSamples, int& intPart, SampleType& fracPart) const noexcept
+{
+    auto clamped = jlimit ((SampleType) 0, (SampleType) getMaximumDelayInSamples(), delayInSamples);
+
+    intPart  = static_cast<int> (clamped);
+    fracPart = clamped - (SampleType) intPart;
+
+    DelayLineHelpers::Kernel<InterpolationType>::adjustDelay (intPart, fracPart);
+}
+
+template <typename SampleType, typename InterpolationType>
+SampleType& DelayLine<SampleType, InterpolationType>::getTapState (int channel, int tap, SampleType& unusedState) noexcept
+{
+    // When using Thiran interpolation, you need to call setMaximumNumTaps before
+    // reading this many taps at once!
+    jassert (tap < maximumNumTaps || ! (std::is_same<InterpolationType, DelayLineInterpolationTypes::Thiran>::value));
+
+    if (tap < maximumNumTaps)
+        return tapStates[(size_t) (channel * maximumNumTaps + tap)];
+
+    return unusedState;
+}
+
+template <typename SampleType, typename InterpolationType>
+void DelayLine<SampleType, InterpolationType>::readBlock (int channel, int delayIntToUse, SampleType delayFracToUse,
+                                                          SampleType* output, int numSamples, SampleType& state) const noexcept
+{
+    using Kernel = DelayLineHelpers::Kernel<InterpolationType>;
+
+    auto position = readPos[(size_t) channel];
+
+    for (int i = 0; i < numSamples; i += maxChunkSize)
+    {
+        auto numThisTime = jmin (numSamples - i, (int) maxChunkSize);
+
+        Kernel::interpolateFixed (getOldestPoint (channel, position, delayIntToUse, Kernel::numPoints),
+                                  delayFracToUse, output + i, numThisTime, state);
+
+        position = wrapIndex (position + numThisTime);
+    }
+}
+
 //==============================================================================
 template class DelayLine<float,  DelayLineInterpolationTypes::None>;
 template class DelayLine<double, DelayLineInterpolationTypes::None>;
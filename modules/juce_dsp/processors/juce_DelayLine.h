@@ -160,6 +160,73 @@ public:
     */
     SampleType popSample (int channel, SampleType delayInSamples = -1, bool updateReadPointer = true);
 
+    //==============================================================================
+    /** Pushes a block of samples into one channel of the delay line.
+
+        This has the same effect as calling pushSample for each of the samples in turn.
+
+        If you're going to read the same block back with popMultiTapBlock, numSamples
+        must not be greater than the maximumBlockSize of the ProcessSpec passed to prepare().
+
+        @see popMultiTapBlock, pushSample
+    */
+    void pushBlock (int channel, const SampleType* samples, int numSamples);
+
+    /** Reads a block of samples from several taps of one channel of the delay line,
+        each of them with a fixed delay.
+
+        Tap i of the output is filled with the samples that popSample would return
+        when called with delaysInSamples[i] for each sample of the block, but the
+        interpolation runs over whole blocks using vector instructions, and the buffer
+        is laid out so that these reads never have to wrap around its end.
+
+        The delays are relative to the read position, so you can either push a block
+        and then read it back, or read a block before pushing the samples that will
+        follow it, as you would in a feedback loop. In the latter case every delay must
+        be at least as long as the block.
+
+        When using Thiran interpolation, each tap has its own allpass state, so the
+        number of taps must not be greater than the value passed to setMaximumNumTaps().
+
+        @param channel              the target channel for the delay line.
+
+        @param delaysInSamples      an array holding the fractional delay of each tap, with
+                                    one entry for each channel of tapOutputs.
+
+        @param tapOutputs           a block with one channel for each tap, which will receive
+                                    the delayed samples. Its length sets the number of
+                                    samples to read.
+
+        @param updateReadPointer    if true, the read position is moved on by the length of
+                                    the block, as if popSample had been called for each sample.
+
+        @see pushBlock, popSample
+    */
+    void popMultiTapBlock (int channel, const SampleType* delaysInSamples,
+                           const AudioBlock<SampleType>& tapOutputs,
+                           bool updateReadPointer = true);
+
+    /** Reads a block of samples from several taps of one channel of the delay line,
+        with a delay that changes for every sample.
+
+        This behaves like the other version of popMultiTapBlock, except that channel i
+        of tapDelays holds the fractional delay to use for each sample of tap i, which
+        is what you'd need for a chorus or a modulated multi-tap delay.
+
+        @see pushBlock, popSample
+    */
+    void popMultiTapBlock (int channel, const AudioBlock<const SampleType>& tapDelays,
+                           const AudioBlock<SampleType>& tapOutputs,
+                           bool updateReadPointer = true);
+
+    /** Sets the maximum number of taps that popMultiTapBlock will be asked to read.
+
+        This only matters when using Thiran interpolation, where every tap needs its
+        own state. It may allocate internally, so you should never call it from the
+        audio thread.
+    */
+    void setMaximumNumTaps (int maxNumTaps);
+
     //==============================================================================
     /** Processes the input and output samples supplied in the processing context.
 
@@ -191,39 +258,65 @@ public:
             auto* inputSamples = inputBlock.getChannelPointer (channel);
             auto* outputSamples = outputBlock.getChannelPointer (channel);
 
-            for (size_t i = 0; i < numSamples; ++i)
+            for (size_t i = 0; i < numSamples;)
             {
-                pushSample ((int) channel, inputSamples[i]);
-                outputSamples[i] = popSample ((int) channel);
+                auto numThisTime = jmin (numSamples - i, (size_t) maxChunkSize);
+
+                pushBlock ((int) channel, inputSamples + i, (int) numThisTime);
+                readBlock ((int) channel, delayInt, delayFrac, outputSamples + i, (int) numThisTime, v[channel]);
+
+                readPos[channel] = wrapIndex (readPos[channel] + (int) numThisTime);
+                i += numThisTime;
             }
         }
     }
 
 private:
+    //==============================================================================
+    /*  The samples are stored in ascending order, and the first guardSize samples
+        of each channel are mirrored after its end, so that a read of up to
+        maxChunkSize consecutive samples plus the interpolation points before them
+        never has to wrap around.
+    */
+    static constexpr int maxChunkSize = 64;
+    static constexpr int guardSize = maxChunkSize + 3;
+
+    int wrapIndex (int index) const noexcept
+    {
+        if (index < 0)          return index + ringSize;
+        if (index >= ringSize)  return index - ringSize;
+
+        return index;
+    }
+
+    // Returns the oldest of the numPoints samples needed to interpolate at the given delay
+    const SampleType* getOldestPoint (int channel, int position, int delayInSamples, int numPoints) const noexcept
+    {
+        return bufferData.getReadPointer (channel) + wrapIndex (position - delayInSamples - (numPoints - 1));
+    }
+
+    void updateBufferSize (int numChannels);
+    void splitDelay (SampleType delayInSamples, int& intPart, SampleType& fracPart) const noexcept;
+    SampleType& getTapState (int channel, int tap, SampleType& unusedState) noexcept;
+    void readBlock (int channel, int delayIntToUse, SampleType delayFracToUse,
+                    SampleType* output, int numSamples, SampleType& state) const noexcept;
+
     //==============================================================================
     template <typename T = InterpolationType>
     typename std::enable_if <std::is_same <T, DelayLineInterpolationTypes::None>::value, SampleType>::type
     interpolateSample (int channel) const
     {
-        auto index = (readPos[(size_t) channel] + delayInt) % totalSize;
-        return bufferData.getSample (channel, index);
+        return *getOldestPoint (channel, readPos[(size_t) channel], delayInt, 1);
     }
 
     template <typename T = InterpolationType>
     typename std::enable_if <std::is_same <T, DelayLineInterpolationTypes::Linear>::value, SampleType>::type
     interpolateSample (int channel) const
     {
-        auto index1 = readPos[(size_t) channel] + delayInt;
-        auto index2 = index1 + 1;
-
-        if (index2 >= totalSize)
-        {
-            index1 %= totalSize;
-            index2 %= totalSize;
-        }
+        auto* samples = getOldestPoint (channel, readPos[(size_t) channel], delayInt, 2);
 
-        auto value1 = bufferData.getSample (channel, index1);
-        auto value2 = bufferData.getSample (channel, index2);
+        auto value1 = samples[1];
+        auto value2 = samples[0];
 
         return value1 + delayFrac * (value2 - value1);
     }
@@ -232,25 +325,12 @@ private:
     typename std::enable_if <std::is_same <T, DelayLineInterpolationTypes::Lagrange3rd>::value, SampleType>::type
     interpolateSample (int channel) const
     {
-        auto index1 = readPos[(size_t) channel] + delayInt;
-        auto index2 = index1 + 1;
-        auto index3 = index2 + 1;
-        auto index4 = index3 + 1;
+        auto* samples = getOldestPoint (channel, readPos[(size_t) channel], delayInt, 4);
 
-        if (index4 >= totalSize)
-        {
-            index1 %= totalSize;
-            index2 %= totalSize;
-            index3 %= totalSize;
-            index4 %= totalSize;
-        }
-
-        auto* samples = bufferData.getReadPointer (channel);
-
-        auto value1 = samples[index1];
-        auto value2 = samples[index2];
-        auto value3 = samples[index3];
-        auto value4 = samples[index4];
+        auto value1 = samples[3];
+        auto value2 = samples[2];
+        auto value3 = samples[1];
+        auto value4 = samples[0];
 
         auto d1 = delayFrac - 1.f;
         auto d2 = delayFrac - 2.f;
@@ -268,17 +348,10 @@ private:
     typename std::enable_if <std::is_same <T, DelayLineInterpolationTypes::Thiran>::value, SampleType>::type
     interpolateSample (int channel)
     {
-        auto index1 = readPos[(size_t) channel] + delayInt;
-        auto index2 = index1 + 1;
-
-        if (index2 >= totalSize)
-        {
-            index1 %= totalSize;
-            index2 %= totalSize;
-        }
+        auto* samples = getOldestPoint (channel, readPos[(size_t) channel], delayInt, 2);
 
-        auto value1 = bufferData.getSample (channel, index1);
-        auto value2 = bufferData.getSample (channel, index2);
+        auto value1 = samples[1];
+        auto value2 = samples[0];
 
         auto output = delayFrac == 0 ? value1 : value2 + alpha * (value1 - v[(size_t) channel]);
         v[(size_t) channel] = output;
@@ -328,10 +401,10 @@ private:
 
     //==============================================================================
     AudioBuffer<SampleType> bufferData;
-    std::vector<SampleType> v;
+    std::vector<SampleType> v, tapStates;
     std::vector<int> writePos, readPos;
     SampleType delay = 0.0, delayFrac = 0.0;
-    int delayInt = 0, totalSize = 4;
+    int delayInt = 0, totalSize = 4, ringSize = 4, maximumBlockSize = 0, maximumNumTaps = 1;
     SampleType alpha = 0.0;
 };
 
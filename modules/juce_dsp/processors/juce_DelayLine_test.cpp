@@ -0,0 +1,392 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class DelayLineTests  : public UnitTest
+{
+public:
+    DelayLineTests()
+        : UnitTest ("DelayLine", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runTestsForType<DelayLineInterpolationTypes::None>        ("None");
+        runTestsForType<DelayLineInterpolationTypes::Linear>      ("Linear");
+        runTestsForType<DelayLineInterpolationTypes::Lagrange3rd> ("Lagrange3rd");
+        runTestsForType<DelayLineInterpolationTypes::Thiran>      ("Thiran");
+    }
+
+private:
+    static constexpr int maxDelay = 300, maxBlockSize = 200;
+
+    template <typename InterpolationType>
+    void runTestsForType (const String& typeName)
+    {
+        beginTest ("Integer delays reproduce the input exactly, " + typeName);
+        testIntegerDelays<float,  InterpolationType>();
+        testIntegerDelays<double, InterpolationType>();
+
+        beginTest ("Fixed multi-tap reads match popSample, " + typeName);
+        testMultiTap<float,  InterpolationType> (false);
+        testMultiTap<double, InterpolationType> (false);
+
+        beginTest ("Modulated multi-tap reads match popSample, " + typeName);
+        testMultiTap<float,  InterpolationType> (true);
+        testMultiTap<double, InterpolationType> (true);
+
+        beginTest ("Reading a block before pushing it works in a feedback loop, " + typeName);
+        testFeedbackLoop<float, InterpolationType>();
+
+        beginTest ("Block processing matches sample-by-sample processing, " + typeName);
+        testProcess<float,  InterpolationType>();
+        testProcess<double, InterpolationType>();
+    }
+
+    template <typename SampleType>
+    static void fillRandom (Random& random, AudioBuffer<SampleType>& buffer)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, (SampleType) (random.nextFloat() * 2.0f - 1.0f));
+    }
+
+    template <typename SampleType>
+    static double getMaxDifference (const AudioBuffer<SampleType>& a, const AudioBuffer<SampleType>& b)
+    {
+        double maxDifference = 0.0;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                maxDifference = jmax (maxDifference, std::abs ((double) a.getSample (channel, i) - (double) b.getSample (channel, i)));
+
+        return maxDifference;
+    }
+
+    template <typename SampleType, typename InterpolationType>
+    void testIntegerDelays()
+    {
+        constexpr int numSamples = 2000, blockSize = 100;
+        const SampleType delays[] = { 0, 1, 5, 37, (SampleType) maxDelay };
+        constexpr int numTaps = (int) numElementsInArray (delays);
+
+        auto random = getRandom();
+        AudioBuffer<SampleType> input (1, numSamples);
+        fillRandom (random, input);
+        const auto* in = input.getReadPointer (0);
+
+        DelayLine<SampleType, InterpolationType> line (maxDelay), reference (maxDelay);
+        line.setMaximumNumTaps (numTaps);
+
+        for (auto* l : { &line, &reference })
+            l->prepare ({ 44100.0, (uint32) blockSize, 1 });
+
+        AudioBuffer<SampleType> tapOutputs (numTaps, blockSize);
+        double maxError = 0.0;
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            line.pushBlock (0, in + start, blockSize);
+            line.popMultiTapBlock (0, delays, AudioBlock<SampleType> (tapOutputs));
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                reference.pushSample (0, in[start + i]);
+
+                for (int tap = 0; tap < numTaps; ++tap)
+                {
+                    const auto delayed = start + i - (int) delays[tap];
+                    const auto expected = delayed >= 0 ? in[delayed] : (SampleType) 0;
+                    const auto fromSample = reference.popSample (0, delays[tap], tap == numTaps - 1);
+
+                    maxError = jmax (maxError,
+                                     std::abs ((double) (fromSample - expected)),
+                                     std::abs ((double) (tapOutputs.getSample (tap, i) - expected)));
+                }
+            }
+        }
+
+        expectLessOrEqual (maxError, 1.0e-6);
+    }
+
+    template <typename SampleType, typename InterpolationType>
+    void testMultiTap (bool modulated)
+    {
+        constexpr int numTaps = 5, numBlocks = 20;
+        auto random = getRandom();
+
+        DelayLine<SampleType, InterpolationType> line (maxDelay);
+        line.setMaximumNumTaps (numTaps);
+        line.prepare ({ 44100.0, (uint32) maxBlockSize, 2 });
+
+        // Thiran interpolation keeps a state for each tap, so each tap is checked
+        // against its own delay line
+        std::vector<DelayLine<SampleType, InterpolationType>> references;
+
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            references.emplace_back (maxDelay);
+            references.back().prepare ({ 44100.0, (uint32) maxBlockSize, 2 });
+        }
+
+        SampleType baseDelays[numTaps], depths[numTaps], rates[numTaps];
+
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            depths[tap] = modulated ? (SampleType) (random.nextDouble() * 20.0) : (SampleType) 0;
+            baseDelays[tap] = (SampleType) (depths[tap] + random.nextDouble() * (maxDelay - 2.0 * depths[tap]));
+            rates[tap] = (SampleType) (0.001 + random.nextDouble() * 0.01);
+        }
+
+        baseDelays[0] = depths[0];
+
+        double maxError = 0.0;
+        int64 time = 0;
+
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            const auto numSamples = 1 + random.nextInt (maxBlockSize);
+
+            AudioBuffer<SampleType> input (2, numSamples), tapDelays (numTaps, numSamples),
+                                    tapOutputs (numTaps, numSamples), expected (numTaps, numSamples);
+            fillRandom (random, input);
+
+            for (int tap = 0; tap < numTaps; ++tap)
+                for (int i = 0; i < numSamples; ++i)
+                    tapDelays.setSample (tap, i, baseDelays[tap] + depths[tap] * (SampleType) std::sin ((double) rates[tap] * (double) (time + i)));
+
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                line.pushBlock (channel, input.getReadPointer (channel), numSamples);
+
+                if (modulated)
+                    line.popMultiTapBlock (channel, AudioBlock<const SampleType> (tapDelays), AudioBlock<SampleType> (tapOutputs));
+                else
+                    line.popMultiTapBlock (channel, baseDelays, AudioBlock<SampleType> (tapOutputs));
+
+                for (int tap = 0; tap < numTaps; ++tap)
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        references[(size_t) tap].pushSample (channel, input.getSample (channel, i));
+                        expected.setSample (tap, i, references[(size_t) tap].popSample (channel, tapDelays.getSample (tap, i)));
+                    }
+                }
+
+                maxError = jmax (maxError, getMaxDifference (tapOutputs, expected));
+            }
+
+            time += numSamples;
+        }
+
+        expectLessOrEqual (maxError, 1.0e-5);
+    }
+
+    template <typename SampleType, typename InterpolationType>
+    void testFeedbackLoop()
+    {
+        constexpr int blockSize = 64, loopDelay = 150, numSamples = 50 * blockSize;
+        const auto feedback = (SampleType) 0.7;
+
+        auto random = getRandom();
+        AudioBuffer<SampleType> input (1, numSamples);
+        fillRandom (random, input);
+        const auto* in = input.getReadPointer (0);
+
+        std::vector<SampleType> expected ((size_t) numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+            expected[(size_t) i] = in[i] + (i >= loopDelay ? feedback * expected[(size_t) (i - loopDelay)] : (SampleType) 0);
+
+        DelayLine<SampleType, InterpolationType> line (loopDelay);
+        line.prepare ({ 44100.0, (uint32) blockSize, 1 });
+
+        AudioBuffer<SampleType> delayed (1, blockSize);
+        std::vector<SampleType> result ((size_t) numSamples);
+        const SampleType delays[] = { (SampleType) loopDelay };
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            line.popMultiTapBlock (0, delays, AudioBlock<SampleType> (delayed));
+
+            for (int i = 0; i < blockSize; ++i)
+                result[(size_t) (start + i)] = in[start + i] + feedback * delayed.getSample (0, i);
+
+            line.pushBlock (0, result.data() + start, blockSize);
+        }
+
+        double maxError = 0.0;
+
+        for (size_t i = 0; i < result.size(); ++i)
+            maxError = jmax (maxError, std::abs ((double) (result[i] - expected[i])));
+
+        expectLessOrEqual (maxError, 1.0e-6);
+    }
+
+    template <typename SampleType, typename InterpolationType>
+    void testProcess()
+    {
+        constexpr int numChannels = 3, numBlocks = 10;
+        auto random = getRandom();
+
+        DelayLine<SampleType, InterpolationType> line (maxDelay), reference (maxDelay);
+        const auto delay = (SampleType) (random.nextDouble() * maxDelay);
+
+        for (auto* l : { &line, &reference })
+        {
+            l->prepare ({ 44100.0, (uint32) maxBlockSize, (uint32) numChannels });
+            l->setDelay (delay);
+        }
+
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            // process() is allowed to be called with blocks longer than the prepared size
+            const auto numSamples = 1 + random.nextInt (3 * maxBlockSize);
+
+            AudioBuffer<SampleType> buffer (numChannels, numSamples);
+            fillRandom (random, buffer);
+            AudioBuffer<SampleType> expected (buffer);
+
+            AudioBlock<SampleType> block (buffer);
+            line.process (ProcessContextReplacing<SampleType> (block));
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    reference.pushSample (channel, expected.getSample (channel, i));
+                    expected.setSample (channel, i, reference.popSample (channel));
+                }
+            }
+
+            expectLessOrEqual (getMaxDifference (buffer, expected), 1.0e-5);
+        }
+    }
+};
+
+static DelayLineTests delayLineTests;
+
+//==============================================================================
+class DelayLineBenchmarks  : public UnitTest
+{
+public:
+    DelayLineBenchmarks()
+        : UnitTest ("DelayLine throughput", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("popMultiTapBlock vs popSample");
+
+        runBenchmark<DelayLineInterpolationTypes::Linear>      ("Linear");
+        runBenchmark<DelayLineInterpolationTypes::Lagrange3rd> ("Lagrange3rd");
+        runBenchmark<DelayLineInterpolationTypes::Thiran>      ("Thiran");
+    }
+
+private:
+    template <typename InterpolationType>
+    void runBenchmark (const String& typeName)
+    {
+        constexpr int blockSize = 512, numTaps = 16, numBlocks = 200, maximumDelay = 48000;
+
+        DelayLine<float, InterpolationType> line (maximumDelay);
+        line.setMaximumNumTaps (numTaps);
+        line.prepare ({ 48000.0, (uint32) blockSize, 1 });
+
+        auto random = getRandom();
+        AudioBuffer<float> input (1, blockSize), tapDelays (numTaps, blockSize), tapOutputs (numTaps, blockSize);
+        float fixedDelays[numTaps];
+
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (0, i, random.nextFloat() * 2.0f - 1.0f);
+
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            fixedDelays[tap] = 100.0f + random.nextFloat() * (float) (maximumDelay - 200);
+
+            for (int i = 0; i < blockSize; ++i)
+                tapDelays.setSample (tap, i, fixedDelays[tap] + 50.0f * std::sin ((float) i * 0.01f * (float) (tap + 1)));
+        }
+
+        const auto* in = input.getReadPointer (0);
+
+        const auto time = [&] (auto&& processBlock)
+        {
+            const auto start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numBlocks; ++i)
+                processBlock();
+
+            const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+            return seconds * 1.0e9 / ((double) numBlocks * blockSize * numTaps);
+        };
+
+        const auto perSampleTime = [&] (bool modulated)
+        {
+            return time ([&]
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    line.pushSample (0, in[i]);
+
+                    for (int tap = 0; tap < numTaps; ++tap)
+                        tapOutputs.setSample (tap, i, line.popSample (0, modulated ? tapDelays.getSample (tap, i) : fixedDelays[tap],
+                                                                      tap == numTaps - 1));
+                }
+            });
+        };
+
+        const auto fixedSampleTime = perSampleTime (false);
+        const auto fixedBlockTime = time ([&]
+        {
+            line.pushBlock (0, in, blockSize);
+            line.popMultiTapBlock (0, fixedDelays, AudioBlock<float> (tapOutputs));
+        });
+
+        const auto modulatedSampleTime = perSampleTime (true);
+        const auto modulatedBlockTime = time ([&]
+        {
+            line.pushBlock (0, in, blockSize);
+            line.popMultiTapBlock (0, AudioBlock<const float> (tapDelays), AudioBlock<float> (tapOutputs));
+        });
+
+        logMessage (typeName + ", " + String (numTaps) + " taps, ns per tap-sample: fixed "
+                      + String (fixedSampleTime, 3) + " -> " + String (fixedBlockTime, 3)
+                      + " (" + String (fixedSampleTime / fixedBlockTime, 2) + "x), modulated "
+                      + String (modulatedSampleTime, 3) + " -> " + String (modulatedBlockTime, 3)
+                      + " (" + String (modulatedSampleTime / modulatedBlockTime, 2) + "x)");
+
+        expect (fixedBlockTime > 0.0 && modulatedBlockTime > 0.0);
+    }
+};
+
+static DelayLineBenchmarks delayLineBenchmarks;
+
+} // namespace dsp
+} // namespace juce
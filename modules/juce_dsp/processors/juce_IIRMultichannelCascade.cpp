@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+namespace IIR
+{
+
+namespace MultichannelCascadeHelpers
+{
+   #if JUCE_USE_SIMD
+    template <typename SampleType>
+    using Vector = SIMDRegister<SampleType>;
+
+    template <typename SampleType>
+    static forcedinline Vector<SampleType> load (const SampleType* source) noexcept   { return Vector<SampleType>::fromRawArray (source); }
+
+    template <typename SampleType>
+    static forcedinline void store (SampleType* dest, Vector<SampleType> v) noexcept  { v.copyToRawArray (dest); }
+   #else
+    template <typename SampleType>
+    using Vector = SampleType;
+
+    template <typename SampleType>
+    static forcedinline SampleType load (const SampleType* source) noexcept           { return *source; }
+
+    template <typename SampleType>
+    static forcedinline void store (SampleType* dest, SampleType v) noexcept          { *dest = v; }
+   #endif
+
+    /*  Runs some sections over a buffer of interleaved samples, using the same sequence
+        of operations as IIR::Filter. The recursion in each section limits how quickly
+        one group of channels can be processed, so several groups or several sections are
+        interleaved to give the CPU independent work to overlap.
+    */
+    template <size_t numGroups, size_t numSections, typename SampleType>
+    static void processSections (const SampleType* coefficients, size_t coefficientStride,
+                                 SampleType* state, size_t stateStride,
+                                 SampleType* samples, size_t numSamples) noexcept
+    {
+        constexpr auto width = MultichannelCascade<SampleType>::getNumChannelsPerVector();
+        constexpr auto sectionCoefficientSize = 5 * width, sectionStateSize = 2 * width;
+
+        Vector<SampleType> b0[numSections][numGroups], b1[numSections][numGroups], b2[numSections][numGroups],
+                           a1[numSections][numGroups], a2[numSections][numGroups],
+                           lv1[numSections][numGroups], lv2[numSections][numGroups];
+
+        for (size_t section = 0; section < numSections; ++section)
+        {
+            for (size_t group = 0; group < numGroups; ++group)
+            {
+                const auto* c = coefficients + group * coefficientStride + section * sectionCoefficientSize;
+                b0[section][group] = load (c);
+                b1[section][group] = load (c + width);
+                b2[section][group] = load (c + width * 2);
+                a1[section][group] = load (c + width * 3);
+                a2[section][group] = load (c + width * 4);
+
+                const auto* s = state + group * stateStride + section * sectionStateSize;
+                lv1[section][group] = load (s);
+                lv2[section][group] = load (s + width);
+            }
+        }
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            auto* frame = samples + i * numGroups * width;
+
+            for (size_t group = 0; group < numGroups; ++group)
+            {
+                auto input = load (frame + group * width);
+
+                for (size_t section = 0; section < numSections; ++section)
+                {
+                    const auto output = (input * b0[section][group]) + lv1[section][group];
+
+                    lv1[section][group] = (input * b1[section][group]) - (output * a1[section][group]) + lv2[section][group];
+                    lv2[section][group] = (input * b2[section][group]) - (output * a2[section][group]);
+
+                    input = output;
+                }
+
+                store (frame + group * width, input);
+            }
+        }
+
+        for (size_t section = 0; section < numSections; ++section)
+        {
+            for (size_t group = 0; group < numGroups; ++group)
+            {
+                auto* s = state + group * stateStride + section * sectionStateSize;
+                store (s, lv1[section][group]);
+                store (s + width, lv2[section][group]);
+            }
+        }
+    }
+
+    /*  Processes all the sections for up to four groups of channels, fusing together
+        more sections when there are fewer groups to interleave.
+    */
+    template <typename SampleType>
+    static void processAllSections (size_t numGroups, size_t numSections,
+                                    const SampleType* coefficients, size_t coefficientStride,
+                                    SampleType* state, size_t stateStride,
+                                    SampleType* samples, size_t numSamples) noexcept
+    {
+        constexpr auto width = MultichannelCascade<SampleType>::getNumChannelsPerVector();
+
+        for (size_t section = 0; section < numSections;)
+        {
+            const auto remaining = numSections - section;
+            const auto numToFuse = numGroups == 1 ? jmin (remaining, (size_t) 4)
+                                 : numGroups == 2 ? jmin (remaining, (size_t) 2)
+                                                  : (size_t) 1;
+
+            const auto* c = coefficients + section * 5 * width;
+            auto* s = state + section * 2 * width;
+
+            switch ((numGroups << 4) | numToFuse)
+            {
+                case 0x11:  processSections<1, 1> (c, coefficientStride, s, stateStride, samples, numSamples); break;
+                case 0x12:  processSections<1, 2> (c, coefficientStride, s, stateStride, samples, numSamples); break;
+                case 0x13:  processSections<1, 3> (c, coefficientStride, s, stateStride, samples, numSamples); break;
+                case 0x14:  processSections<1, 4> (c, coefficientStride, s, stateStride, samples, numSamples); break;
+                case 0x21:  processSections<2, 1> (c, coefficientStride, s, stateStride, samples, numSamples); break;
+                case 0x22:  processSections<2, 2> (c, coefficientStride, s, stateStride, samples, numSamples); break;
+                case 0x31:  processSections<3, 1> (c, coefficientStride, s, stateStride, samples, numSamples); break;
+                case 0x41:  processSections<4, 1> (c, coefficientStride, s, stateStride, samples, numSamples); break;
+                default:    jassertfalse; break;
+            }
+
+            section += numToFuse;
+        }
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+MultichannelCascade<SampleType>::MultichannelCascade (size_t numSections)
+{
+    setNumSections (numSections);
+}
+
+template <typename SampleType>
+void MultichannelCascade<SampleType>::setNumSections (size_t newNumSections)
+{
+    defaultCoefficients.resize (newNumSections, { { 1, 0, 0, 0, 0 } });
+    allocate();
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelCascade<SampleType>::setCoefficients (size_t sectionIndex, const Coefficients<SampleType>& newCoefficients) noexcept
+{
+    jassert (sectionIndex < getNumSections());
+
+    const auto sectionCoefficients = toSectionCoefficients (newCoefficients);
+    defaultCoefficients[sectionIndex] = sectionCoefficients;
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+        applyCoefficients (sectionIndex, channel, sectionCoefficients);
+}
+
+template <typename SampleType>
+void MultichannelCascade<SampleType>::setCoefficients (size_t sectionIndex, size_t channel, const Coefficients<SampleType>& newCoefficients) noexcept
+{
+    jassert (sectionIndex < getNumSections());
+    jassert (channel < numChannels);
+
+    applyCoefficients (sectionIndex, channel, toSectionCoefficients (newCoefficients));
+}
+
+template <typename SampleType>
+typename MultichannelCascade<SampleType>::SectionCoefficients
+    MultichannelCascade<SampleType>::toSectionCoefficients (const Coefficients<SampleType>& c) noexcept
+{
+    const auto* raw = c.getRawCoefficients();
+
+    switch (c.getFilterOrder())
+    {
+        case 1:   return { { raw[0], raw[1], 0, raw[2], 0 } };
+        case 2:   return { { raw[0], raw[1], raw[2], raw[3], raw[4] } };
+        default:  break;
+    }
+
+    // Only first and second order sections can be used in a cascade. Higher order
+    // filters need to be split up into several sections.
+    jassertfalse;
+    return { { 1, 0, 0, 0, 0 } };
+}
+
+template <typename SampleType>
+void MultichannelCascade<SampleType>::applyCoefficients (size_t sectionIndex, size_t channel,
+                                                         const SectionCoefficients& sectionCoefficients) noexcept
+{
+    constexpr auto width = getNumChannelsPerVector();
+    const auto group = channel / width;
+
+    auto* dest = getAlignedData (coefficientData)
+                   + ((group * getNumSections() + sectionIndex) * numCoefficientsPerSection * width)
+                   + (channel % width);
+
+    for (size_t i = 0; i < numCoefficientsPerSection; ++i)
+        dest[i * width] = sectionCoefficients[i];
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelCascade<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.numChannels > 0);
+
+    numChannels = spec.numChannels;
+    allocate();
+}
+
+template <typename SampleType>
+void MultichannelCascade<SampleType>::reset() noexcept
+{
+    std::fill (stateData.begin(), stateData.end(), SampleType());
+}
+
+template <typename SampleType>
+void MultichannelCascade<SampleType>::allocate()
+{
+    constexpr auto width = getNumChannelsPerVector();
+    const auto numGroups = (numChannels + width - 1) / width;
+    const auto numSections = getNumSections();
+
+    // Each array has an extra vector's worth of space so that it can be aligned
+    coefficientData.assign ((numGroups * numSections * numCoefficientsPerSection + 1) * width, SampleType());
+    stateData      .assign ((numGroups * numSections * numStatesPerSection + 1) * width, SampleType());
+    scratchData    .assign ((maxChunkSize * maxGroupsPerPass + 1) * width, SampleType());
+
+    for (size_t channel = 0; channel < numGroups * width; ++channel)
+        for (size_t section = 0; section < numSections; ++section)
+            applyCoefficients (section, channel, defaultCoefficients[section]);
+}
+
+template <typename SampleType>
+SampleType* MultichannelCascade<SampleType>::getAlignedData (std::vector<SampleType>& data) noexcept
+{
+    return snapPointerToAlignment (data.data(), getNumChannelsPerVector() * sizeof (SampleType));
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultichannelCascade<SampleType>::processBlock (const AudioBlock<const SampleType>& input,
+                                                    const AudioBlock<SampleType>& output,
+                                                    bool bypassed) noexcept
+{
+    constexpr auto width = getNumChannelsPerVector();
+    const auto numChannelsToProcess = jmin (input.getNumChannels(), numChannels);
+    const auto numSamples = input.getNumSamples();
+    const auto numSections = getNumSections();
+
+    auto* coefficients = getAlignedData (coefficientData);
+    auto* state = getAlignedData (stateData);
+    auto* scratch = getAlignedData (scratchData);
+
+    const auto coefficientStride = numSections * numCoefficientsPerSection * width;
+    const auto stateStride       = numSections * numStatesPerSection * width;
+
+    for (size_t firstChannel = 0; firstChannel < numChannelsToProcess; firstChannel += maxGroupsPerPass * width)
+    {
+        const auto numChannelsThisPass = jmin (maxGroupsPerPass * width, numChannelsToProcess - firstChannel);
+        const auto numGroups = (numChannelsThisPass + width - 1) / width;
+        const auto frameSize = numGroups * width;
+
+        // Any unused lanes in the last group just filter silence
+        if (numChannelsThisPass < frameSize)
+            std::fill (scratchData.begin(), scratchData.end(), SampleType());
+
+        for (size_t start = 0; start < numSamples; start += (size_t) maxChunkSize)
+        {
+            const auto numThisTime = jmin ((size_t) maxChunkSize, numSamples - start);
+
+            for (size_t channel = 0; channel < numChannelsThisPass; ++channel)
+            {
+                const auto* source = input.getChannelPointer (firstChannel + channel) + start;
+
+                for (size_t i = 0; i < numThisTime; ++i)
+                    scratch[i * frameSize + channel] = source[i];
+            }
+
+            MultichannelCascadeHelpers::processAllSections (numGroups, numSections,
+                                                            coefficients, coefficientStride,
+                                                            state, stateStride,
+                                                            scratch, numThisTime);
+
+            if (! bypassed)
+            {
+                for (size_t channel = 0; channel < numChannelsThisPass; ++channel)
+                {
+                    auto* dest = output.getChannelPointer (firstChannel + channel) + start;
+
+                    for (size_t i = 0; i < numThisTime; ++i)
+                        dest[i] = scratch[i * frameSize + channel];
+                }
+            }
+        }
+
+        coefficients += numGroups * coefficientStride;
+        state        += numGroups * stateStride;
+    }
+
+    for (auto& s : stateData)
+        util::snapToZero (s);
+}
+
+//==============================================================================
+template class MultichannelCascade<float>;
+template class MultichannelCascade<double>;
+
+} // namespace IIR
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+namespace IIR
+{
+
+//==============================================================================
+/**
+    A cascade of second-order IIR sections which processes many channels at once.
+
+    Using ProcessorDuplicator with IIR::Filter runs a separate scalar filter for
+    each channel. This class instead stores the coefficients and state of groups of
+    adjacent channels side by side, so that each section of the cascade can process
+    as many channels as fit into a SIMDRegister with every instruction. Each channel
+    can have its own coefficients.
+
+    The blocks passed to process() are ordinary non-interleaved AudioBlocks; the
+    samples are interleaved into a small internal buffer as they're processed.
+
+    The arithmetic is the same Transposed Direct Form II used by IIR::Filter, so a
+    cascade gives the same results as a chain of IIR::Filter objects with the same
+    coefficients.
+
+    @see IIR::Filter, ProcessorDuplicator
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class MultichannelCascade
+{
+public:
+    //==============================================================================
+    /** Creates a cascade with a given number of sections, each of which initially
+        passes its input through unchanged.
+    */
+    explicit MultichannelCascade (size_t numSections = 1);
+
+    //==============================================================================
+    /** Changes the number of sections in the cascade.
+
+        Any new sections will pass their input through unchanged. This allocates
+        memory, so it mustn't be called while processing.
+    */
+    void setNumSections (size_t newNumSections);
+
+    /** Returns the number of sections in the cascade. */
+    size_t getNumSections() const noexcept                  { return defaultCoefficients.size(); }
+
+    /** Returns the number of channels which are processed together by each instruction. */
+    static constexpr size_t getNumChannelsPerVector() noexcept
+    {
+       #if JUCE_USE_SIMD
+        return SIMDRegister<SampleType>::size();
+       #else
+        return 1;
+       #endif
+    }
+
+    //==============================================================================
+    /** Sets the coefficients of one section for all channels.
+
+        The coefficients must be first or second order. Coefficients set before
+        calling prepare() will be used for all the channels it allocates.
+    */
+    void setCoefficients (size_t sectionIndex, const Coefficients<SampleType>& newCoefficients) noexcept;
+
+    /** Sets the coefficients of one section for a single channel.
+
+        The coefficients must be first or second order, and the channel must be one of
+        those allocated by the last call to prepare().
+    */
+    void setCoefficients (size_t sectionIndex, size_t channel, const Coefficients<SampleType>& newCoefficients) noexcept;
+
+    //==============================================================================
+    /** Allocates the state for the number of channels in the spec, and resets it. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Clears the state of all the sections, without changing their coefficients. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context.
+
+        If the context is bypassed, the input is copied to the output, but the
+        filter state still runs so that it's up to date when the bypass is removed.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        static_assert (std::is_same<typename ProcessContext::SampleType, SampleType>::value,
+                       "The sample-type of the cascade must match the sample-type supplied to this process callback");
+
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock      = context.getOutputBlock();
+
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumChannels() <= numChannels);
+        jassert (inputBlock.getNumSamples()  == outputBlock.getNumSamples());
+
+        processBlock (inputBlock, outputBlock, context.isBypassed);
+
+        if (context.isBypassed && context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom (inputBlock);
+    }
+
+private:
+    //==============================================================================
+    enum { numCoefficientsPerSection = 5, numStatesPerSection = 2, maxChunkSize = 64, maxGroupsPerPass = 4 };
+
+    using SectionCoefficients = std::array<SampleType, numCoefficientsPerSection>;
+
+    void allocate();
+    void applyCoefficients (size_t sectionIndex, size_t channel, const SectionCoefficients&) noexcept;
+    void processBlock (const AudioBlock<const SampleType>& input, const AudioBlock<SampleType>& output, bool bypassed) noexcept;
+
+    static SectionCoefficients toSectionCoefficients (const Coefficients<SampleType>&) noexcept;
+    static SampleType* getAlignedData (std::vector<SampleType>&) noexcept;
+
+    //==============================================================================
+    std::vector<SectionCoefficients> defaultCoefficients;
+    std::vector<SampleType> coefficientData, stateData, scratchData;
+    size_t numChannels = 0;
+};
+
+} // namespace IIR
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,296 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+class IIRMultichannelCascadeTests  : public UnitTest
+{
+public:
+    IIRMultichannelCascadeTests()
+        : UnitTest ("IIR::MultichannelCascade", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Float output matches a chain of IIR::Filters");
+        testAgainstFilters<float>();
+
+        beginTest ("Double output matches a chain of IIR::Filters");
+        testAgainstFilters<double>();
+
+        beginTest ("Non-replacing contexts leave the input unchanged");
+        {
+            constexpr size_t numChannels = 5, numSamples = 300;
+            auto random = getRandom();
+
+            IIR::MultichannelCascade<float> cascade (2);
+            cascade.setCoefficients (0, *IIR::Coefficients<float>::makeLowPass (44100.0, 1000.0f));
+            cascade.setCoefficients (1, *IIR::Coefficients<float>::makeHighPass (44100.0, 100.0f));
+            cascade.prepare ({ 44100.0, (uint32) numSamples, (uint32) numChannels });
+
+            AudioBuffer<float> input ((int) numChannels, (int) numSamples), output ((int) numChannels, (int) numSamples);
+            fillRandom (random, input);
+            AudioBuffer<float> original (input);
+
+            AudioBlock<float> inputBlock (input), outputBlock (output);
+            cascade.process (ProcessContextNonReplacing<float> (inputBlock, outputBlock));
+
+            expect (buffersMatch (input, original, 0.0));
+
+            AudioBuffer<float> replaced (input);
+            AudioBlock<float> replacedBlock (replaced);
+            cascade.reset();
+            cascade.process (ProcessContextReplacing<float> (replacedBlock));
+
+            expect (buffersMatch (replaced, output, 0.0));
+        }
+
+        beginTest ("Bypassed processing copies the input");
+        {
+            constexpr size_t numChannels = 3, numSamples = 128;
+            auto random = getRandom();
+
+            IIR::MultichannelCascade<float> cascade;
+            cascade.setCoefficients (0, *IIR::Coefficients<float>::makeLowPass (48000.0, 500.0f));
+            cascade.prepare ({ 48000.0, (uint32) numSamples, (uint32) numChannels });
+
+            AudioBuffer<float> input ((int) numChannels, (int) numSamples), output ((int) numChannels, (int) numSamples);
+            fillRandom (random, input);
+
+            AudioBlock<float> inputBlock (input), outputBlock (output);
+            ProcessContextNonReplacing<float> context (inputBlock, outputBlock);
+            context.isBypassed = true;
+            cascade.process (context);
+
+            expect (buffersMatch (input, output, 0.0));
+        }
+
+        beginTest ("Reset clears the state");
+        {
+            constexpr size_t numChannels = 9, numSamples = 200;
+
+            IIR::MultichannelCascade<double> cascade (3);
+
+            for (size_t section = 0; section < cascade.getNumSections(); ++section)
+                cascade.setCoefficients (section, *IIR::Coefficients<double>::makePeakFilter (44100.0, 300.0 * (double) (section + 1), 2.0, 4.0));
+
+            cascade.prepare ({ 44100.0, (uint32) numSamples, (uint32) numChannels });
+
+            const auto processImpulse = [&]
+            {
+                AudioBuffer<double> buffer ((int) numChannels, (int) numSamples);
+                buffer.clear();
+
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    buffer.setSample (channel, 0, 1.0);
+
+                AudioBlock<double> block (buffer);
+                cascade.process (ProcessContextReplacing<double> (block));
+                return buffer;
+            };
+
+            const auto first = processImpulse();
+            cascade.reset();
+            const auto second = processImpulse();
+
+            expect (buffersMatch (first, second, 0.0));
+            expect (first.getMagnitude (0, (int) numSamples) > 0.0);
+        }
+    }
+
+private:
+    template <typename SampleType>
+    static void fillRandom (Random& random, AudioBuffer<SampleType>& buffer)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (channel, i, (SampleType) (random.nextFloat() * 2.0f - 1.0f));
+    }
+
+    template <typename SampleType>
+    static bool buffersMatch (const AudioBuffer<SampleType>& a, const AudioBuffer<SampleType>& b, double tolerance)
+    {
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                if (std::abs ((double) a.getSample (channel, i) - (double) b.getSample (channel, i)) > tolerance)
+                    return false;
+
+        return true;
+    }
+
+    template <typename SampleType>
+    void testAgainstFilters()
+    {
+        using Coeffs = IIR::Coefficients<SampleType>;
+
+        auto random = getRandom();
+        const auto width = IIR::MultichannelCascade<SampleType>::getNumChannelsPerVector();
+        constexpr double sampleRate = 48000.0;
+
+        for (auto numChannels : { (size_t) 1, width - 1, width, width + 1, 2 * width + 3, (size_t) 32 })
+        {
+            if (numChannels == 0)
+                continue;
+
+            for (auto numSections : { 1, 3, 4 })
+            {
+                constexpr int maxBlockSize = 500, numBlocks = 6;
+
+                IIR::MultichannelCascade<SampleType> cascade ((size_t) numSections);
+                cascade.prepare ({ sampleRate, (uint32) maxBlockSize, (uint32) numChannels });
+
+                std::vector<std::vector<IIR::Filter<SampleType>>> filters (numChannels);
+
+                for (size_t channel = 0; channel < numChannels; ++channel)
+                {
+                    for (int section = 0; section < numSections; ++section)
+                    {
+                        const auto frequency = (SampleType) (50.0 + random.nextDouble() * 15000.0);
+
+                        auto coefficients = [&]
+                        {
+                            switch (random.nextInt (4))
+                            {
+                                case 0:   return Coeffs::makeLowPass (sampleRate, frequency, (SampleType) 0.9);
+                                case 1:   return Coeffs::makeHighShelf (sampleRate, frequency, (SampleType) 0.7, (SampleType) 0.5);
+                                case 2:   return Coeffs::makePeakFilter (sampleRate, frequency, (SampleType) 3.0, (SampleType) 2.0);
+                                default:  return Coeffs::makeFirstOrderHighPass (sampleRate, frequency);
+                            }
+                        }();
+
+                        cascade.setCoefficients ((size_t) section, channel, *coefficients);
+                        filters[channel].emplace_back (coefficients);
+                    }
+                }
+
+                for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+                {
+                    const auto numSamples = 1 + random.nextInt (maxBlockSize);
+                    AudioBuffer<SampleType> buffer ((int) numChannels, numSamples);
+                    fillRandom (random, buffer);
+
+                    AudioBuffer<SampleType> expected (buffer);
+
+                    for (size_t channel = 0; channel < numChannels; ++channel)
+                    {
+                        auto channelBlock = AudioBlock<SampleType> (expected).getSingleChannelBlock (channel);
+
+                        for (auto& filter : filters[channel])
+                            filter.process (ProcessContextReplacing<SampleType> (channelBlock));
+                    }
+
+                    AudioBlock<SampleType> block (buffer);
+                    cascade.process (ProcessContextReplacing<SampleType> (block));
+
+                    expect (buffersMatch (buffer, expected, 1.0e-5),
+                            String (numChannels) + " channels, " + String (numSections) + " sections");
+                }
+            }
+        }
+    }
+};
+
+static IIRMultichannelCascadeTests iirMultichannelCascadeTests;
+
+//==============================================================================
+class IIRMultichannelCascadeBenchmarks  : public UnitTest
+{
+public:
+    IIRMultichannelCascadeBenchmarks()
+        : UnitTest ("IIR::MultichannelCascade throughput", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("MultichannelCascade vs ProcessorDuplicator<IIR::Filter>");
+
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512, numSections = 4, numBlocks = 400;
+
+        for (auto numChannels : { 2, 8, 32 })
+        {
+            const ProcessSpec spec { sampleRate, (uint32) blockSize, (uint32) numChannels };
+
+            using Duplicator = ProcessorDuplicator<IIR::Filter<float>, IIR::Coefficients<float>>;
+            std::vector<Duplicator> duplicators;
+            IIR::MultichannelCascade<float> cascade ((size_t) numSections);
+
+            for (int section = 0; section < numSections; ++section)
+            {
+                auto coefficients = IIR::Coefficients<float>::makePeakFilter (sampleRate, 200.0f * (float) (section + 1), 1.5f, 2.0f);
+                duplicators.emplace_back (coefficients);
+                cascade.setCoefficients ((size_t) section, *coefficients);
+            }
+
+            for (auto& duplicator : duplicators)
+                duplicator.prepare (spec);
+
+            cascade.prepare (spec);
+
+            AudioBuffer<float> source (numChannels, blockSize), buffer (numChannels, blockSize);
+            auto random = getRandom();
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    source.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+            AudioBlock<float> block (buffer);
+            const AudioBlock<const float> sourceBlock (source);
+            ProcessContextReplacing<float> context (block);
+
+            const auto time = [&] (auto&& processBlock)
+            {
+                const auto start = Time::getHighResolutionTicks();
+
+                for (int i = 0; i < numBlocks; ++i)
+                {
+                    block.copyFrom (sourceBlock);
+                    processBlock();
+                }
+
+                const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+                return seconds * 1.0e9 / ((double) numBlocks * blockSize * numChannels * numSections);
+            };
+
+            const auto duplicatorTime = time ([&] { for (auto& duplicator : duplicators) duplicator.process (context); });
+            const auto cascadeTime    = time ([&] { cascade.process (context); });
+
+            logMessage (String (numChannels) + " channels x " + String (numSections) + " sections, ns per channel-section-sample: "
+                          + "ProcessorDuplicator " + String (duplicatorTime, 3)
+                          + ", MultichannelCascade " + String (cascadeTime, 3)
+                          + " (" + String (duplicatorTime / cascadeTime, 2) + "x)");
+
+            expect (duplicatorTime > 0.0 && cascadeTime > 0.0);
+        }
+    }
+};
+
+static IIRMultichannelCascadeBenchmarks iirMultichannelCascadeBenchmarks;
+
+} // namespace dsp
+} // namespace juce
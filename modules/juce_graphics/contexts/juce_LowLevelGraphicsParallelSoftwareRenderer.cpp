@@ -0,0 +1,604 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+namespace ParallelRendererHelpers
+{
+    // The bands draw through these rather than the target image itself, because
+    // locking an image's pixels for writing notifies its listeners, which isn't safe
+    // to do from several threads at once. One of these can also hold just the rows of
+    // a transparency layer that a band will draw into.
+    class BandPixelData  : public ImagePixelData
+    {
+    public:
+        explicit BandPixelData (const Image::BitmapData& target)
+            : ImagePixelData (target.pixelFormat, target.width, target.height),
+              rows (0, target.height),
+              firstRow (target.data),
+              pixelStride (target.pixelStride),
+              lineStride (target.lineStride)
+        {
+        }
+
+        BandPixelData (int w, int h, Range<int> rowsToAllocate)
+            : ImagePixelData (Image::ARGB, w, h),
+              rows (rowsToAllocate),
+              pixelStride (4),
+              lineStride (4 * w)
+        {
+            storage.allocate ((size_t) lineStride * (size_t) jmax (1, rows.getLength()), true);
+            firstRow = storage;
+        }
+
+        std::unique_ptr<LowLevelGraphicsContext> createLowLevelContext() override
+        {
+            return std::make_unique<LowLevelGraphicsSoftwareRenderer> (Image (*this));
+        }
+
+        void initialiseBitmapData (Image::BitmapData& bitmap, int x, int y, Image::BitmapData::ReadWriteMode) override
+        {
+            // Rows outside the allocated range must never be drawn into or read
+            bitmap.data = firstRow + (x * pixelStride + (y - rows.getStart()) * lineStride);
+            bitmap.size = (size_t) ((rows.getEnd() - y) * lineStride - x * pixelStride);
+            bitmap.pixelFormat = pixelFormat;
+            bitmap.lineStride = lineStride;
+            bitmap.pixelStride = pixelStride;
+        }
+
+        ImagePixelData::Ptr clone() override
+        {
+            Image newImage (SoftwareImageType().create (pixelFormat, width, height, true));
+            Image::BitmapData dest (newImage, Image::BitmapData::writeOnly);
+
+            for (auto y = rows.getStart(); y < rows.getEnd(); ++y)
+                memcpy (dest.getLinePointer (y), firstRow + (y - rows.getStart()) * lineStride, (size_t) (width * pixelStride));
+
+            return newImage.getPixelData();
+        }
+
+        std::unique_ptr<ImageType> createType() const override    { return std::make_unique<SoftwareImageType>(); }
+
+    private:
+        const Range<int> rows;
+        HeapBlock<uint8> storage;
+        uint8* firstRow = nullptr;
+        const int pixelStride, lineStride;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BandPixelData)
+    };
+
+    using SavedState = RenderingHelpers::SoftwareRendererSavedState;
+
+    // A band's clip region. Some of the ways that the software renderer fills and clips
+    // depend on how the clip region is divided into rectangles, and on its horizontal extent,
+    // and not just on the pixels inside it, so this keeps the clip region of the whole image,
+    // and uses the parts of its rectangles that lie inside the band.
+    class BandClipRegion  : public SavedState::RectangleListRegionType
+    {
+    public:
+        BandClipRegion (const RectangleList<int>& fullClip, Rectangle<int> bandArea)
+            : RectangleListRegion (fullClip), wholeImageClip (fullClip), band (bandArea)
+        {
+            clip.clipTo (band);
+        }
+
+        BandClipRegion (const BandClipRegion& other)
+            : RectangleListRegion (other), wholeImageClip (other.wholeImageClip), band (other.band)
+        {
+        }
+
+        Ptr clone() const override                          { return *new BandClipRegion (*this); }
+
+        Ptr clipToRectangle (Rectangle<int> r) override
+        {
+            wholeImageClip.clipTo (r);
+            return updateBandClip();
+        }
+
+        Ptr clipToRectangleList (const RectangleList<int>& r) override
+        {
+            wholeImageClip.clipTo (r);
+            return updateBandClip();
+        }
+
+        Ptr excludeClipRectangle (Rectangle<int> r) override
+        {
+            wholeImageClip.subtract (r);
+            return updateBandClip();
+        }
+
+        Ptr clipToPath (const Path& p, const AffineTransform& t) override   { return toEdgeTable()->clipToPath (p, t); }
+        Ptr clipToEdgeTable (const EdgeTable& et) override                  { return toEdgeTable()->clipToEdgeTable (et); }
+
+        Ptr clipToImageAlpha (const Image& image, const AffineTransform& t, Graphics::ResamplingQuality quality) override
+        {
+            return toEdgeTable()->clipToImageAlpha (image, t, quality);
+        }
+
+        void translate (Point<int> delta) override
+        {
+            wholeImageClip.offsetAll (delta);
+            band += delta;
+            RectangleListRegion::translate (delta);
+        }
+
+        Rectangle<int> getClipBounds() const override
+        {
+            const auto bandBounds = clip.getBounds();
+            const auto wholeBounds = wholeImageClip.getBounds();
+            return { wholeBounds.getX(), bandBounds.getY(), wholeBounds.getWidth(), bandBounds.getHeight() };
+        }
+
+    private:
+        RectangleList<int> wholeImageClip;
+        Rectangle<int> band;
+
+        Ptr updateBandClip()
+        {
+            clip = wholeImageClip;
+            clip.clipTo (band);
+            return clip.isEmpty() ? Ptr() : Ptr (*this);
+        }
+
+        Ptr toEdgeTable() const
+        {
+            // An EdgeTable takes its bounds from the rectangles that it's given, so a pixel at
+            // each end of the whole image's clip is added in the row above the band, and then
+            // removed, leaving the band's rows as they would be in the whole image's edge table.
+            const auto bounds = getClipBounds();
+
+            RectangleList<int> rects (clip);
+            rects.addWithoutMerging ({ bounds.getX(), bounds.getY() - 1, 1, 1 });
+            rects.addWithoutMerging ({ bounds.getRight() - 1, bounds.getY() - 1, 1, 1 });
+
+            EdgeTable et (rects);
+            et.clipToRectangle (bounds);
+            return *new SavedState::EdgeTableRegionType (et);
+        }
+    };
+
+    // Bands shorter than this aren't worth the cost of replaying the commands
+    static constexpr int minimumBandHeight = 16;
+}
+
+//==============================================================================
+class LowLevelGraphicsParallelSoftwareRenderer::Renderer  : public RenderingHelpers::StackBasedLowLevelGraphicsContext<RenderingHelpers::SoftwareRendererSavedState>
+{
+public:
+    Renderer (const Image& imageToRenderOnto, Point<int> origin, const RectangleList<int>& initialClip)
+        : StackBasedLowLevelGraphicsContext (new RenderingHelpers::SoftwareRendererSavedState (imageToRenderOnto, initialClip, origin))
+    {
+    }
+
+    Renderer (const Image& imageToRenderOnto, Point<int> origin, const RectangleList<int>& initialClip, Rectangle<int> band)
+        : Renderer (imageToRenderOnto, origin, initialClip)
+    {
+        stack->clip = *new ParallelRendererHelpers::BandClipRegion (initialClip, band);
+    }
+
+    RenderingHelpers::SoftwareRendererSavedState& getState() const noexcept    { return *stack; }
+
+    // A band's clip region is smaller than the whole image's, so these are given the
+    // bounds that the layer would have if the whole image were being drawn. That puts
+    // everything drawn into the layer at the same position, and only the rows that the
+    // band covers are allocated.
+    void beginLayer (float opacity, Rectangle<int> layerBounds)
+    {
+        auto* layer = new RenderingHelpers::SoftwareRendererSavedState (*stack);
+        Rectangle<int> rowsToDraw;
+
+        if (layer->clip != nullptr)
+        {
+            const auto bandBounds = layer->clip->getClipBounds();
+            rowsToDraw = layerBounds.getIntersection (layerBounds.withY (bandBounds.getY()).withHeight (bandBounds.getHeight()));
+
+            layer->image = Image (new ParallelRendererHelpers::BandPixelData (layerBounds.getWidth(), layerBounds.getHeight(),
+                                                                              { rowsToDraw.getY() - layerBounds.getY(),
+                                                                                rowsToDraw.getBottom() - layerBounds.getY() }));
+            layer->transparencyLayerAlpha = opacity;
+            layer->transform.moveOriginInDeviceSpace (-layerBounds.getPosition());
+            layer->cloneClipIfMultiplyReferenced();
+            layer->clip->translate (-layerBounds.getPosition());
+        }
+
+        stack.save();
+        stack.initialise (layer);
+        layerRows.push_back (rowsToDraw);
+    }
+
+    void endLayer (Rectangle<int> layerBounds)
+    {
+        jassert (! layerRows.empty());
+
+        if (layerRows.empty())
+            return;
+
+        const auto rowsToDraw = layerRows.back();
+        layerRows.pop_back();
+
+        const auto layerImage = stack->image;
+        const auto layerAlpha = stack->transparencyLayerAlpha;
+        stack.restore();
+
+        if (stack->clip != nullptr && ! rowsToDraw.isEmpty())
+        {
+            auto g = stack->image.createLowLevelContext();
+            g->clipToRectangle (rowsToDraw);
+            g->setOpacity (layerAlpha);
+            g->drawImage (layerImage, AffineTransform::translation (layerBounds.getPosition()));
+        }
+    }
+
+private:
+    std::vector<Rectangle<int>> layerRows;
+};
+
+//==============================================================================
+class LowLevelGraphicsParallelSoftwareRenderer::BandJob  : public ThreadPoolJob
+{
+public:
+    explicit BandJob (std::function<void()> work)
+        : ThreadPoolJob ("Render bands"), renderBands (std::move (work))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        renderBands();
+        return jobHasFinished;
+    }
+
+private:
+    std::function<void()> renderBands;
+};
+
+//==============================================================================
+LowLevelGraphicsParallelSoftwareRenderer::LowLevelGraphicsParallelSoftwareRenderer (const Image& im, ThreadPool& pool, int bands)
+    : LowLevelGraphicsParallelSoftwareRenderer (im, {}, im.getBounds(), pool, bands)
+{
+}
+
+LowLevelGraphicsParallelSoftwareRenderer::LowLevelGraphicsParallelSoftwareRenderer (const Image& im, Point<int> o,
+                                                                                    const RectangleList<int>& clip,
+                                                                                    ThreadPool& pool, int bands)
+    : image (im),
+      origin (o),
+      initialClip (clip),
+      threadPool (pool),
+      numBands (bands > 0 ? bands : 2 * (pool.getNumThreads() + 1)),
+      currentState (std::make_unique<Renderer> (im, o, clip))
+{
+}
+
+LowLevelGraphicsParallelSoftwareRenderer::~LowLevelGraphicsParallelSoftwareRenderer()
+{
+    renderCommands();
+}
+
+//==============================================================================
+void LowLevelGraphicsParallelSoftwareRenderer::flush()
+{
+    // The contents of a transparency layer can't be drawn until the layer has ended
+    jassert (transparencyLayers.empty());
+
+    if (transparencyLayers.empty())
+        renderCommands();
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::renderCommands()
+{
+    if (numDrawingCommands == 0)
+        return;
+
+    const auto bounds = initialClip.getBounds().getIntersection (image.getBounds());
+
+    if (! bounds.isEmpty())
+    {
+        Image::BitmapData data (image, Image::BitmapData::readWrite);
+        const Image target (new ParallelRendererHelpers::BandPixelData (data));
+
+        const auto bandsToUse = jlimit (1, numBands, bounds.getHeight() / ParallelRendererHelpers::minimumBandHeight);
+        std::atomic<int> nextBand { 0 };
+
+        const auto renderBands = [&]
+        {
+            for (int band; (band = nextBand++) < bandsToUse;)
+            {
+                const auto top    = bounds.getY() + bounds.getHeight() * band / bandsToUse;
+                const auto bottom = bounds.getY() + bounds.getHeight() * (band + 1) / bandsToUse;
+
+                // Each band covers whole rows, so every span that's drawn is the same as it
+                // would be when drawing the whole image, and produces the same pixels
+                const Rectangle<int> bandArea (bounds.getX(), top, bounds.getWidth(), bottom - top);
+
+                if (initialClip.intersectsRectangle (bandArea))
+                {
+                    Renderer renderer (target, origin, initialClip, bandArea);
+
+                    for (auto& command : commands)
+                        command.perform (renderer);
+                }
+            }
+        };
+
+        std::vector<std::unique_ptr<BandJob>> jobs;
+
+        for (int i = jmin (threadPool.getNumThreads(), bandsToUse - 1); --i >= 0;)
+        {
+            jobs.push_back (std::make_unique<BandJob> (renderBands));
+            threadPool.addJob (jobs.back().get(), false);
+        }
+
+        renderBands();
+
+        // Any jobs that haven't started yet will find that there's nothing left to do
+        for (auto& job : jobs)
+            threadPool.removeJob (job.get(), false, -1);
+    }
+
+    // The state commands are kept, so that the next batch of commands can be replayed
+    // from the same state
+    commands.erase (std::remove_if (commands.begin(), commands.end(), [] (const Command& c) { return c.isDrawing; }),
+                    commands.end());
+
+    numDrawingCommands = 0;
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::addStateCommand (std::function<void (Renderer&)> command)
+{
+    commands.push_back ({ std::move (command), ! transparencyLayers.empty() });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::addDrawingCommand (std::function<void (Renderer&)> command)
+{
+    commands.push_back ({ std::move (command), true });
+    ++numDrawingCommands;
+}
+
+bool LowLevelGraphicsParallelSoftwareRenderer::isDrawingPossible() const
+{
+    return ! currentState->isClipEmpty();
+}
+
+//==============================================================================
+bool LowLevelGraphicsParallelSoftwareRenderer::isVectorDevice() const
+{
+    return false;
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::setOrigin (Point<int> o)
+{
+    currentState->setOrigin (o);
+    addStateCommand ([o] (Renderer& r) { r.setOrigin (o); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::addTransform (const AffineTransform& t)
+{
+    currentState->addTransform (t);
+    addStateCommand ([t] (Renderer& r) { r.addTransform (t); });
+}
+
+float LowLevelGraphicsParallelSoftwareRenderer::getPhysicalPixelScaleFactor()
+{
+    return currentState->getPhysicalPixelScaleFactor();
+}
+
+bool LowLevelGraphicsParallelSoftwareRenderer::clipToRectangle (const Rectangle<int>& r)
+{
+    addStateCommand ([r] (Renderer& renderer) { renderer.clipToRectangle (r); });
+    return currentState->clipToRectangle (r);
+}
+
+bool LowLevelGraphicsParallelSoftwareRenderer::clipToRectangleList (const RectangleList<int>& list)
+{
+    addStateCommand ([list] (Renderer& r) { r.clipToRectangleList (list); });
+    return currentState->clipToRectangleList (list);
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::excludeClipRectangle (const Rectangle<int>& r)
+{
+    currentState->excludeClipRectangle (r);
+    addStateCommand ([r] (Renderer& renderer) { renderer.excludeClipRectangle (r); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::clipToPath (const Path& path, const AffineTransform& t)
+{
+    currentState->clipToPath (path, t);
+    addStateCommand ([path, t] (Renderer& r) { r.clipToPath (path, t); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::clipToImageAlpha (const Image& im, const AffineTransform& t)
+{
+    currentState->clipToImageAlpha (im, t);
+    addStateCommand ([im, t] (Renderer& r) { r.clipToImageAlpha (im, t); });
+}
+
+bool LowLevelGraphicsParallelSoftwareRenderer::clipRegionIntersects (const Rectangle<int>& r)
+{
+    return currentState->clipRegionIntersects (r);
+}
+
+Rectangle<int> LowLevelGraphicsParallelSoftwareRenderer::getClipBounds() const
+{
+    return currentState->getClipBounds();
+}
+
+bool LowLevelGraphicsParallelSoftwareRenderer::isClipEmpty() const
+{
+    return currentState->isClipEmpty();
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::saveState()
+{
+    currentState->saveState();
+    addStateCommand ([] (Renderer& r) { r.saveState(); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::restoreState()
+{
+    currentState->restoreState();
+    addStateCommand ([] (Renderer& r) { r.restoreState(); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::beginTransparencyLayer (float opacity)
+{
+    // The layer's bounds are found in the same coordinate space that a
+    // LowLevelGraphicsSoftwareRenderer would use, which is offset by any enclosing layers
+    auto& s = currentState->getState();
+    Rectangle<int> layerBounds;
+
+    if (s.clip != nullptr)
+    {
+        layerBounds = s.clip->getClipBounds();
+
+        for (auto& enclosingLayer : transparencyLayers)
+            layerBounds -= enclosingLayer.getPosition();
+    }
+
+    // A layer doesn't change the clip region or transform, so there's no need to
+    // allocate a layer image here
+    currentState->saveState();
+    addDrawingCommand ([opacity, layerBounds] (Renderer& r) { r.beginLayer (opacity, layerBounds); });
+    transparencyLayers.push_back (layerBounds);
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::endTransparencyLayer()
+{
+    jassert (! transparencyLayers.empty());
+
+    if (transparencyLayers.empty())
+        return;
+
+    const auto layerBounds = transparencyLayers.back();
+    transparencyLayers.pop_back();
+
+    currentState->restoreState();
+    addDrawingCommand ([layerBounds] (Renderer& r) { r.endLayer (layerBounds); });
+}
+
+//==============================================================================
+void LowLevelGraphicsParallelSoftwareRenderer::setFill (const FillType& fillType)
+{
+    currentState->setFill (fillType);
+    addStateCommand ([fillType] (Renderer& r) { r.setFill (fillType); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::setOpacity (float newOpacity)
+{
+    currentState->setOpacity (newOpacity);
+    addStateCommand ([newOpacity] (Renderer& r) { r.setOpacity (newOpacity); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::setInterpolationQuality (Graphics::ResamplingQuality quality)
+{
+    currentState->setInterpolationQuality (quality);
+    addStateCommand ([quality] (Renderer& r) { r.setInterpolationQuality (quality); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::setFont (const Font& newFont)
+{
+    currentState->setFont (newFont);
+    addStateCommand ([newFont] (Renderer& r) { r.setFont (newFont); });
+}
+
+const Font& LowLevelGraphicsParallelSoftwareRenderer::getFont()
+{
+    return currentState->getFont();
+}
+
+//==============================================================================
+void LowLevelGraphicsParallelSoftwareRenderer::fillRect (const Rectangle<int>& r, bool replaceExistingContents)
+{
+    if (isDrawingPossible())
+        addDrawingCommand ([r, replaceExistingContents] (Renderer& renderer) { renderer.fillRect (r, replaceExistingContents); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::fillRect (const Rectangle<float>& r)
+{
+    if (isDrawingPossible())
+        addDrawingCommand ([r] (Renderer& renderer) { renderer.fillRect (r); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::fillRectList (const RectangleList<float>& list)
+{
+    if (isDrawingPossible())
+        addDrawingCommand ([list] (Renderer& r) { r.fillRectList (list); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::fillPath (const Path& path, const AffineTransform& t)
+{
+    if (isDrawingPossible())
+        addDrawingCommand ([path, t] (Renderer& r) { r.fillPath (path, t); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::drawImage (const Image& im, const AffineTransform& t)
+{
+    if (isDrawingPossible())
+        addDrawingCommand ([im, t] (Renderer& r) { r.drawImage (im, t); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::drawLine (const Line<float>& line)
+{
+    if (isDrawingPossible())
+        addDrawingCommand ([line] (Renderer& r) { r.drawLine (line); });
+}
+
+void LowLevelGraphicsParallelSoftwareRenderer::drawGlyph (int glyphNumber, const AffineTransform& t)
+{
+    if (! isDrawingPossible())
+        return;
+
+    // The typeface is only used on this thread: glyphs are either looked up in the glyph
+    // cache here, which stops them being evicted until the bands have drawn them, or are
+    // turned into an edge table here, which the bands fill
+    auto& state = currentState->getState();
+
+    if (t.isOnlyTranslation() && ! state.transform.isRotated)
+    {
+        auto& cache = RenderingHelpers::SoftwareRendererSavedState::GlyphCacheType::getInstance();
+        auto glyph = cache.findOrCreateGlyph (state.transform.isOnlyTranslated ? state.font
+                                                                               : state.getScaledFontForGlyphCache(),
+                                              glyphNumber);
+
+        addDrawingCommand ([glyph, glyphNumber, t] (Renderer& r)
+        {
+            ignoreUnused (glyph);
+            r.drawGlyph (glyphNumber, t);
+        });
+    }
+    else if (std::shared_ptr<EdgeTable> et = state.createEdgeTableForGlyph (glyphNumber, t))
+    {
+        addDrawingCommand ([et] (Renderer& r)
+        {
+            auto& bandState = r.getState();
+
+            if (bandState.clip != nullptr)
+                bandState.fillShape (*new RenderingHelpers::SoftwareRendererSavedState::EdgeTableRegionType (*et), false);
+        });
+    }
+}
+
+} // namespace juce
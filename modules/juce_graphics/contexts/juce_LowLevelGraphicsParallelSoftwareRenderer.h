@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+//==============================================================================
+/**
+    A LowLevelGraphicsContext that renders into an image in memory, using several
+    threads.
+
+    Rather than drawing straight away, this context records the calls that are made
+    to it. When flush() is called, or the context is deleted, the target image is
+    split into horizontal bands, and each band replays the recorded calls on a thread
+    from a ThreadPool, through a LowLevelGraphicsSoftwareRenderer that is clipped to
+    that band. The calling thread renders bands too, and flush() returns once the
+    whole image has been drawn.
+
+    The pixels that are produced are identical to those produced by a
+    LowLevelGraphicsSoftwareRenderer that is given the same calls.
+
+    Because the drawing is deferred, any images that are drawn, or used as fills or
+    clip masks, must not be modified until the context has been flushed, and they
+    should be software-based images that can safely be read from several threads.
+
+    To use this for a component's window, you can return one from
+    LookAndFeel::createGraphicsContext(). To render a component into an image, create
+    one and pass it to a Graphics object:
+
+    @code
+    Image image (Image::ARGB, 3840, 2160, true);
+
+    {
+        LowLevelGraphicsParallelSoftwareRenderer context (image, threadPool);
+        Graphics g (context);
+        component.paintEntireComponent (g, true);
+    }
+    @endcode
+
+    @see LowLevelGraphicsSoftwareRenderer
+    @tags{Graphics}
+*/
+class JUCE_API  LowLevelGraphicsParallelSoftwareRenderer    : public LowLevelGraphicsContext
+{
+public:
+    //==============================================================================
+    /** Creates a context to render into an image, using a pool of threads.
+
+        The pool must outlive this context. If numBands is 0, a number will be
+        chosen to suit the size of the pool.
+    */
+    LowLevelGraphicsParallelSoftwareRenderer (const Image& imageToRenderOnto,
+                                              ThreadPool& threadPoolToUse,
+                                              int numBands = 0);
+
+    /** Creates a context to render into a clipped subsection of an image, using a pool
+        of threads.
+    */
+    LowLevelGraphicsParallelSoftwareRenderer (const Image& imageToRenderOnto,
+                                              Point<int> origin,
+                                              const RectangleList<int>& initialClip,
+                                              ThreadPool& threadPoolToUse,
+                                              int numBands = 0);
+
+    /** Destructor. This renders anything that hasn't yet been flushed. */
+    ~LowLevelGraphicsParallelSoftwareRenderer() override;
+
+    //==============================================================================
+    /** Renders all the calls that have been made since the last flush, and waits
+        for them to finish.
+
+        The context's state, such as its clip region and transform, isn't affected.
+    */
+    void flush();
+
+    /** Returns the number of bands that the image is split into when rendering. */
+    int getNumBands() const noexcept        { return numBands; }
+
+    //==============================================================================
+    /** @internal */
+    bool isVectorDevice() const override;
+    /** @internal */
+    void setOrigin (Point<int>) override;
+    /** @internal */
+    void addTransform (const AffineTransform&) override;
+    /** @internal */
+    float getPhysicalPixelScaleFactor() override;
+    /** @internal */
+    bool clipToRectangle (const Rectangle<int>&) override;
+    /** @internal */
+    bool clipToRectangleList (const RectangleList<int>&) override;
+    /** @internal */
+    void excludeClipRectangle (const Rectangle<int>&) override;
+    /** @internal */
+    void clipToPath (const Path&, const AffineTransform&) override;
+    /** @internal */
+    void clipToImageAlpha (const Image&, const AffineTransform&) override;
+    /** @internal */
+    bool clipRegionIntersects (const Rectangle<int>&) override;
+    /** @internal */
+    Rectangle<int> getClipBounds() const override;
+    /** @internal */
+    bool isClipEmpty() const override;
+    /** @internal */
+    void saveState() override;
+    /** @internal */
+    void restoreState() override;
+    /** @internal */
+    void beginTransparencyLayer (float opacity) override;
+    /** @internal */
+    void endTransparencyLayer() override;
+    /** @internal */
+    void setFill (const FillType&) override;
+    /** @internal */
+    void setOpacity (float) override;
+    /** @internal */
+    void setInterpolationQuality (Graphics::ResamplingQuality) override;
+    /** @internal */
+    void fillRect (const Rectangle<int>&, bool replaceExistingContents) override;
+    /** @internal */
+    void fillRect (const Rectangle<float>&) override;
+    /** @internal */
+    void fillRectList (const RectangleList<float>&) override;
+    /** @internal */
+    void fillPath (const Path&, const AffineTransform&) override;
+    /** @internal */
+    void drawImage (const Image&, const AffineTransform&) override;
+    /** @internal */
+    void drawLine (const Line<float>&) override;
+    /** @internal */
+    void setFont (const Font&) override;
+    /** @internal */
+    const Font& getFont() override;
+    /** @internal */
+    void drawGlyph (int glyphNumber, const AffineTransform&) override;
+
+private:
+    //==============================================================================
+    class Renderer;
+    class BandJob;
+
+    struct Command
+    {
+        std::function<void (Renderer&)> perform;
+        bool isDrawing;
+    };
+
+    Image image;
+    Point<int> origin;
+    RectangleList<int> initialClip;
+    ThreadPool& threadPool;
+    int numBands;
+
+    // This follows the calls that change the clip and transform, without drawing
+    // anything, so that it can answer questions about the clip region
+    std::unique_ptr<Renderer> currentState;
+    std::vector<Command> commands;
+    std::vector<Rectangle<int>> transparencyLayers;
+    int numDrawingCommands = 0;
+
+    void renderCommands();
+    void addStateCommand (std::function<void (Renderer&)>);
+    void addDrawingCommand (std::function<void (Renderer&)>);
+    bool isDrawingPossible() const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsParallelSoftwareRenderer)
+};
+
+} // namespace juce
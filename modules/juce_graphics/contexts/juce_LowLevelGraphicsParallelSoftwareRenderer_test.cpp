@@ -0,0 +1,397 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+namespace juce
+{
+
+namespace ParallelRendererTestHelpers
+{
+    static Image createSprite()
+    {
+        Image sprite (Image::ARGB, 61, 47, true, SoftwareImageType());
+        Graphics g (sprite);
+
+        g.setGradientFill (ColourGradient (Colours::yellow, 0.0f, 0.0f, Colours::darkblue.withAlpha (0.3f), 61.0f, 47.0f, false));
+        g.fillEllipse (2.0f, 2.0f, 57.0f, 43.0f);
+        g.setColour (Colours::black);
+        g.drawLine (0.0f, 47.0f, 61.0f, 0.0f, 3.0f);
+        return sprite;
+    }
+
+    // A mixture of the kinds of drawing that the GraphicsDemo scenes do: paths and
+    // strokes with solid and gradient fills, transformed images, text, clipping and
+    // transparency layers.
+    static void drawScene (Graphics& g, Rectangle<int> area, const Image& sprite, int seed)
+    {
+        Random random (seed);
+        const auto w = (float) area.getWidth(), h = (float) area.getHeight();
+
+        const auto randomPoint = [&]   { return Point<float> (random.nextFloat() * w, random.nextFloat() * h); };
+        const auto randomColour = [&]  { return Colour ((uint32) random.nextInt()).withAlpha (0.2f + random.nextFloat() * 0.8f); };
+
+        g.fillAll (Colours::lightgrey);
+        g.fillCheckerBoard (area.toFloat().reduced (w * 0.1f, h * 0.1f), 23.0f, 17.0f, Colours::white, Colours::lightblue);
+
+        for (int i = 0; i < 12; ++i)
+        {
+            Path star;
+            star.addStar (randomPoint(), 5 + random.nextInt (5), 10.0f + random.nextFloat() * w * 0.05f, 20.0f + random.nextFloat() * w * 0.15f,
+                          random.nextFloat() * MathConstants<float>::twoPi);
+
+            const auto a = randomPoint(), b = randomPoint();
+            g.setGradientFill (ColourGradient (randomColour(), a, randomColour(), b, (i & 1) != 0));
+            g.fillPath (star, AffineTransform::rotation (random.nextFloat() * 0.2f, w * 0.5f, h * 0.5f));
+
+            g.setColour (randomColour());
+            g.strokePath (star, PathStrokeType (1.0f + random.nextFloat() * 4.0f, PathStrokeType::curved, PathStrokeType::rounded));
+        }
+
+        {
+            Graphics::ScopedSaveState saveState (g);
+
+            Path clip;
+            clip.addEllipse (w * 0.1f, h * 0.2f, w * 0.6f, h * 0.5f);
+            g.reduceClipRegion (clip);
+            g.excludeClipRegion (Rectangle<int> (area.getWidth() / 3, area.getHeight() / 3, area.getWidth() / 8, area.getHeight() / 8));
+
+            for (auto quality : { Graphics::lowResamplingQuality, Graphics::mediumResamplingQuality, Graphics::highResamplingQuality })
+            {
+                g.setImageResamplingQuality (quality);
+
+                for (int i = 0; i < 4; ++i)
+                {
+                    const auto p = randomPoint();
+                    g.setOpacity (0.3f + random.nextFloat() * 0.7f);
+                    g.drawImageTransformed (sprite, AffineTransform::rotation (random.nextFloat() * MathConstants<float>::twoPi)
+                                                                   .scaled (0.5f + random.nextFloat() * 4.0f)
+                                                                   .translated (p));
+                }
+            }
+
+            g.setTiledImageFill (sprite, 7, 11, 0.5f);
+            g.fillRect (area.reduced (area.getWidth() / 4, area.getHeight() / 4));
+        }
+
+        {
+            Graphics::ScopedSaveState saveState (g);
+            g.excludeClipRegion ({ 0, 0, area.getWidth() / 5, area.getHeight() });
+            g.excludeClipRegion ({ area.getWidth() / 2, 0, area.getWidth() / 2, area.getHeight() / 3 });
+
+            for (int i = 0; i < 6; ++i)
+                g.drawImageTransformed (sprite, AffineTransform::rotation (random.nextFloat() * 6.0f).scaled (1.0f + random.nextFloat() * 3.0f)
+                                                                .translated (randomPoint()));
+
+            g.setTiledImageFill (sprite, 3, 5, 0.7f);
+
+            Path p;
+            p.addEllipse (area.toFloat().reduced (w * 0.05f, h * 0.05f));
+            g.fillPath (p, AffineTransform::rotation (0.1f, w * 0.5f, h * 0.5f));
+
+            g.reduceClipRegion (sprite, AffineTransform::rotation (0.2f).scaled (3.1f).translated (w * 0.1f, h * 0.2f));
+            g.setColour (Colours::green);
+            g.fillAll();
+        }
+
+        {
+            Graphics::ScopedSaveState saveState (g);
+            g.reduceClipRegion (sprite, AffineTransform::scale (w / (float) sprite.getWidth() * 0.5f, h / (float) sprite.getHeight() * 0.5f)
+                                                         .translated (w * 0.4f, h * 0.4f));
+            g.setGradientFill (ColourGradient (Colours::red, w * 0.5f, h * 0.5f, Colours::blue, w, h, true));
+            g.fillAll();
+        }
+
+        g.beginTransparencyLayer (0.6f);
+        {
+            for (int i = 0; i < 20; ++i)
+            {
+                g.setColour (randomColour());
+                g.drawLine (Line<float> (randomPoint(), randomPoint()), 0.5f + random.nextFloat() * 6.0f);
+            }
+
+            const float dashes[] = { 8.0f, 3.0f, 2.0f, 3.0f };
+            g.setColour (Colours::darkgreen);
+            g.drawDashedLine (Line<float> (randomPoint(), randomPoint()), dashes, numElementsInArray (dashes), 2.5f);
+
+            RectangleList<float> rects;
+
+            for (int i = 0; i < 15; ++i)
+                rects.add (Rectangle<float> (randomPoint(), randomPoint()).withSizeKeepingCentre (5.0f + random.nextFloat() * 40.0f,
+                                                                                                 5.0f + random.nextFloat() * 40.0f));
+
+            g.setColour (randomColour());
+            g.fillRectList (rects);
+
+            g.setGradientFill (ColourGradient (randomColour(), randomPoint(), randomColour(), randomPoint(), true));
+            g.fillEllipse (Rectangle<float> (randomPoint(), randomPoint()));
+            g.drawImageTransformed (sprite, AffineTransform::rotation (0.7f).scaled (2.3f).translated (randomPoint()));
+        }
+        g.endTransparencyLayer();
+
+        for (int i = 0; i < 8; ++i)
+        {
+            g.setColour (randomColour());
+            g.setFont (6.0f + random.nextFloat() * h * 0.08f);
+
+            const auto p = randomPoint();
+            const auto text = "The quick brown fox " + String (i);
+
+            if (i % 3 == 2)
+            {
+                GlyphArrangement glyphs;
+                glyphs.addLineOfText (g.getCurrentFont(), text, 0.0f, 0.0f);
+                glyphs.draw (g, AffineTransform::rotation (random.nextFloat() * 2.0f).translated (p));
+            }
+            else
+                g.drawSingleLineText (text, (int) p.x, (int) p.y);
+        }
+
+        {
+            Graphics::ScopedSaveState saveState (g);
+            g.addTransform (AffineTransform::scale (1.5f, 0.75f).translated (w * 0.1f, h * 0.6f));
+            g.setColour (Colours::black);
+            g.setFont (18.0f);
+            g.drawText ("Scaled text", Rectangle<float> (0.0f, 0.0f, w * 0.5f, 30.0f), Justification::centredLeft);
+
+            g.setColour (Colours::purple.withAlpha (0.5f));
+            g.fillRoundedRectangle (10.3f, 30.7f, w * 0.3f, h * 0.1f, 8.0f);
+        }
+    }
+
+    template <typename Context>
+    static Image render (Image::PixelFormat format, Rectangle<int> area, Context&& createContext)
+    {
+        Image image (format, area.getWidth(), area.getHeight(), true, SoftwareImageType());
+        const auto sprite = createSprite();
+
+        {
+            auto context = createContext (image);
+            Graphics g (*context);
+            drawScene (g, area, sprite, 1234);
+        }
+
+        return image;
+    }
+
+    static bool imagesAreIdentical (const Image& a, const Image& b)
+    {
+        const Image::BitmapData dataA (a, Image::BitmapData::readOnly), dataB (b, Image::BitmapData::readOnly);
+
+        if (dataA.width != dataB.width || dataA.height != dataB.height || dataA.pixelFormat != dataB.pixelFormat)
+            return false;
+
+        for (int y = 0; y < dataA.height; ++y)
+            if (memcmp (dataA.getLinePointer (y), dataB.getLinePointer (y), (size_t) (dataA.width * dataA.pixelStride)) != 0)
+                return false;
+
+        return true;
+    }
+}
+
+//==============================================================================
+class LowLevelGraphicsParallelSoftwareRendererTests  : public UnitTest
+{
+public:
+    LowLevelGraphicsParallelSoftwareRendererTests()
+        : UnitTest ("LowLevelGraphicsParallelSoftwareRenderer", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        using namespace ParallelRendererTestHelpers;
+
+        ThreadPool pool (3);
+
+        beginTest ("Output is identical to the software renderer");
+        {
+            for (auto format : { Image::ARGB, Image::RGB })
+            {
+                const Rectangle<int> area (0, 0, 517, 389);
+
+                const auto expected = render (format, area, [] (const Image& im)
+                {
+                    return std::make_unique<LowLevelGraphicsSoftwareRenderer> (im);
+                });
+
+                for (auto numBands : { 1, 2, 5, 24 })
+                {
+                    const auto result = render (format, area, [&] (const Image& im)
+                    {
+                        return std::make_unique<LowLevelGraphicsParallelSoftwareRenderer> (im, pool, numBands);
+                    });
+
+                    expect (imagesAreIdentical (result, expected), String (numBands) + " bands");
+                }
+            }
+        }
+
+        beginTest ("Output is identical when rendering to a clipped region with an origin");
+        {
+            const Rectangle<int> area (0, 0, 400, 300);
+            const Point<int> origin (-13, 21);
+
+            RectangleList<int> clip;
+            clip.add ({ 10, 5, 200, 120 });
+            clip.add ({ 150, 100, 240, 180 });
+            clip.add ({ 0, 290, 400, 10 });
+
+            const auto expected = render (Image::ARGB, area, [&] (const Image& im)
+            {
+                return std::make_unique<LowLevelGraphicsSoftwareRenderer> (im, origin, clip);
+            });
+
+            const auto result = render (Image::ARGB, area, [&] (const Image& im)
+            {
+                return std::make_unique<LowLevelGraphicsParallelSoftwareRenderer> (im, origin, clip, pool, 7);
+            });
+
+            expect (imagesAreIdentical (result, expected));
+        }
+
+        beginTest ("Drawing can continue after a flush");
+        {
+            const Rectangle<int> area (0, 0, 300, 200);
+            const auto sprite = createSprite();
+
+            const auto draw = [&] (LowLevelGraphicsContext& context, std::function<void()> flush)
+            {
+                Graphics g (context);
+                g.setOrigin (7, 3);
+                g.reduceClipRegion (10, 10, 250, 150);
+                g.setColour (Colours::orange);
+
+                g.saveState();
+                g.addTransform (AffineTransform::rotation (0.3f));
+                drawScene (g, area, sprite, 99);
+                flush();
+
+                g.fillEllipse (20.0f, 20.0f, 100.0f, 60.0f);
+                g.restoreState();
+
+                flush();
+                g.fillRect (0, 0, 40, 40);
+            };
+
+            Image expected (Image::ARGB, area.getWidth(), area.getHeight(), true, SoftwareImageType());
+            Image result (expected.createCopy());
+
+            {
+                LowLevelGraphicsSoftwareRenderer context (expected);
+                draw (context, [] {});
+            }
+
+            {
+                LowLevelGraphicsParallelSoftwareRenderer context (result, pool, 4);
+                draw (context, [&] { context.flush(); });
+            }
+
+            expect (imagesAreIdentical (result, expected));
+        }
+
+        beginTest ("Clip queries match the software renderer");
+        {
+            Image image (Image::ARGB, 200, 100, true, SoftwareImageType());
+            LowLevelGraphicsSoftwareRenderer serial (image);
+            LowLevelGraphicsParallelSoftwareRenderer parallel (image.createCopy(), pool);
+
+            for (auto* context : { (LowLevelGraphicsContext*) &serial, (LowLevelGraphicsContext*) &parallel })
+            {
+                context->setOrigin ({ 10, 5 });
+                context->clipToRectangle ({ 0, 0, 100, 50 });
+                context->excludeClipRectangle ({ 20, 20, 10, 10 });
+                context->saveState();
+                context->addTransform (AffineTransform::scale (2.0f));
+            }
+
+            expect (parallel.getClipBounds() == serial.getClipBounds());
+            expect (parallel.clipRegionIntersects ({ 12, 12, 2, 2 }) == serial.clipRegionIntersects ({ 12, 12, 2, 2 }));
+            expectEquals (parallel.getPhysicalPixelScaleFactor(), serial.getPhysicalPixelScaleFactor());
+            expect (parallel.clipToRectangle ({ 200, 200, 5, 5 }) == serial.clipToRectangle ({ 200, 200, 5, 5 }));
+            expect (parallel.isClipEmpty() && serial.isClipEmpty());
+
+            parallel.restoreState();
+            serial.restoreState();
+            expect (parallel.getClipBounds() == serial.getClipBounds());
+        }
+    }
+};
+
+static LowLevelGraphicsParallelSoftwareRendererTests lowLevelGraphicsParallelSoftwareRendererTests;
+
+//==============================================================================
+class LowLevelGraphicsParallelSoftwareRendererBenchmarks  : public UnitTest
+{
+public:
+    LowLevelGraphicsParallelSoftwareRendererBenchmarks()
+        : UnitTest ("LowLevelGraphicsParallelSoftwareRenderer throughput", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        using namespace ParallelRendererTestHelpers;
+
+        beginTest ("Scenes at 1080p and 4K");
+
+        ThreadPool pool (jmax (1, SystemStats::getNumCpus() - 1));
+        const auto sprite = createSprite();
+        constexpr int numFrames = 5;
+
+        for (auto area : { Rectangle<int> (1920, 1080), Rectangle<int> (3840, 2160) })
+        {
+            Image image (Image::ARGB, area.getWidth(), area.getHeight(), true, SoftwareImageType());
+
+            const auto time = [&] (auto&& createContext)
+            {
+                const auto start = Time::getHighResolutionTicks();
+
+                for (int frame = 0; frame < numFrames; ++frame)
+                {
+                    auto context = createContext();
+                    Graphics g (*context);
+                    g.addTransform (AffineTransform::scale ((float) area.getWidth() / 960.0f));
+                    drawScene (g, { 960, area.getHeight() * 960 / area.getWidth() }, sprite, frame);
+
+                    // The scenes are drawn several times over, as a whole UI would be
+                    for (int i = 0; i < 3; ++i)
+                        drawScene (g, { 960, area.getHeight() * 960 / area.getWidth() }, sprite, frame * 10 + i);
+                }
+
+                return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1000.0 / numFrames;
+            };
+
+            const auto serialTime   = time ([&] { return std::make_unique<LowLevelGraphicsSoftwareRenderer> (image); });
+            const auto parallelTime = time ([&] { return std::make_unique<LowLevelGraphicsParallelSoftwareRenderer> (image, pool); });
+
+            logMessage (String (area.getWidth()) + "x" + String (area.getHeight()) + ", ms per frame: "
+                          + "serial " + String (serialTime, 2)
+                          + ", parallel with " + String (pool.getNumThreads() + 1) + " threads " + String (parallelTime, 2)
+                          + " (" + String (serialTime / parallelTime, 2) + "x)");
+
+            expect (serialTime > 0.0 && parallelTime > 0.0);
+        }
+    }
+};
+
+static LowLevelGraphicsParallelSoftwareRendererBenchmarks lowLevelGraphicsParallelSoftwareRendererBenchmarks;
+
+} // namespace juce
@@ -26,44 +26,232 @@
 namespace juce
 {
 
-static void blurDataTriplets (uint8* d, int num, const int delta) noexcept
+namespace DropShadowHelpers
 {
-    uint32 last = d[0];
-    d[0] = (uint8) ((d[0] + d[delta] + 1) / 3);
-    d += delta;
+    // The shadow is blurred with three passes of a box filter along each axis, which is
+    // a close approximation of a gaussian. Each pass keeps a running sum for every column,
+    // so the cost per pixel doesn't depend on the radius. The rows are blurred by
+    // transposing the image, so that both directions can use the same column pass, which
+    // works on several columns at a time.
+    using BoxRadii = std::array<int, 3>;
+
+    // Returns the radii of three box filters that have the same combined variance as the
+    // 2 * radius passes of a [1 1 1] / 3 kernel that were used by earlier versions.
+    static BoxRadii getBoxRadii (int shadowRadius) noexcept
+    {
+        constexpr int numPasses = 3;
+
+        // Keeps the running sums within 16 bits
+        constexpr int maxBoxRadius = 128;
+
+        const auto variance = 4.0 * (double) shadowRadius / 3.0;
+        const auto idealWidth = std::sqrt (12.0 * variance / numPasses + 1.0);
+
+        auto lowerWidth = (int) idealWidth;
+
+        if ((lowerWidth & 1) == 0)
+            --lowerWidth;
+
+        const auto upperWidth = lowerWidth + 2;
+        const auto numLower = roundToInt ((12.0 * variance - numPasses * lowerWidth * lowerWidth - 4 * numPasses * lowerWidth - 3 * numPasses)
+                                            / (-4.0 * lowerWidth - 4.0));
 
-    num -= 2;
+        BoxRadii radii;
 
-    do
+        for (int i = 0; i < numPasses; ++i)
+            radii[(size_t) i] = jmin (maxBoxRadius, ((i < numLower ? lowerWidth : upperWidth) - 1) / 2);
+
+        return radii;
+    }
+
+    // Moves the box down by one row: adds the row entering it, writes the average of each
+    // column, then subtracts the row that is leaving it.
+    static void updateColumnSums (uint16* sums, const uint8* enteringRow, const uint8* leavingRow,
+                                  uint8* dest, int width, float scale) noexcept
     {
-        const uint32 newLast = d[0];
-        d[0] = (uint8) ((last + d[0] + d[delta] + 1) / 3);
-        d += delta;
-        last = newLast;
+        int x = 0;
+
+       #if JUCE_GRAPHICS_USE_SSE2
+        const auto zero = _mm_setzero_si128();
+        const auto scaleVector = _mm_set1_ps (scale);
+        const auto half = _mm_set1_ps (0.5f);
+
+        for (; x <= width - 8; x += 8)
+        {
+            auto s = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (sums + x));
+            s = _mm_add_epi16 (s, _mm_unpacklo_epi8 (_mm_loadl_epi64 (reinterpret_cast<const __m128i*> (enteringRow + x)), zero));
+
+            const auto low  = _mm_cvttps_epi32 (_mm_add_ps (_mm_mul_ps (_mm_cvtepi32_ps (_mm_unpacklo_epi16 (s, zero)), scaleVector), half));
+            const auto high = _mm_cvttps_epi32 (_mm_add_ps (_mm_mul_ps (_mm_cvtepi32_ps (_mm_unpackhi_epi16 (s, zero)), scaleVector), half));
+            _mm_storel_epi64 (reinterpret_cast<__m128i*> (dest + x), _mm_packus_epi16 (_mm_packs_epi32 (low, high), zero));
+
+            s = _mm_sub_epi16 (s, _mm_unpacklo_epi8 (_mm_loadl_epi64 (reinterpret_cast<const __m128i*> (leavingRow + x)), zero));
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (sums + x), s);
+        }
+       #elif JUCE_GRAPHICS_USE_NEON
+        const auto scaleVector = vdupq_n_f32 (scale);
+        const auto half = vdupq_n_f32 (0.5f);
+
+        for (; x <= width - 8; x += 8)
+        {
+            auto s = vaddw_u8 (vld1q_u16 (sums + x), vld1_u8 (enteringRow + x));
+
+            const auto low  = vcvtq_u32_f32 (vaddq_f32 (vmulq_f32 (vcvtq_f32_u32 (vmovl_u16 (vget_low_u16  (s))), scaleVector), half));
+            const auto high = vcvtq_u32_f32 (vaddq_f32 (vmulq_f32 (vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (s))), scaleVector), half));
+            vst1_u8 (dest + x, vqmovn_u16 (vcombine_u16 (vmovn_u32 (low), vmovn_u32 (high))));
+
+            vst1q_u16 (sums + x, vsubw_u8 (s, vld1_u8 (leavingRow + x)));
+        }
+       #endif
+
+        for (; x < width; ++x)
+        {
+            const auto s = (uint16) (sums[x] + enteringRow[x]);
+            dest[x] = (uint8) (int) ((float) s * scale + 0.5f);
+            sums[x] = (uint16) (s - leavingRow[x]);
+        }
     }
-    while (--num > 0);
 
-    d[0] = (uint8) ((last + d[0] + 1) / 3);
-}
+    // Applies a box filter to each column, treating the pixels above and below the image
+    // as zero, in the same way as the old triplet blur.
+    static void blurColumns (const uint8* source, int sourceStride, uint8* dest, int destStride,
+                             int width, int height, int boxRadius, uint16* sums, const uint8* zeros) noexcept
+    {
+        const auto scale = 1.0f / (float) (2 * boxRadius + 1);
 
-static void blurSingleChannelImage (uint8* const data, const int width, const int height,
-                                    const int lineStride, const int repetitions) noexcept
-{
-    jassert (width > 2 && height > 2);
+        std::fill (sums, sums + width, (uint16) 0);
 
-    for (int y = 0; y < height; ++y)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + lineStride * y, width, 1);
+        for (int y = 0; y < jmin (boxRadius, height); ++y)
+            for (int x = 0; x < width; ++x)
+                sums[x] = (uint16) (sums[x] + source[y * sourceStride + x]);
 
-    for (int x = 0; x < width; ++x)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + x, height, lineStride);
-}
+        for (int y = 0; y < height; ++y)
+        {
+            const auto entering = y + boxRadius;
+            const auto leaving  = y - boxRadius;
 
-static void blurSingleChannelImage (Image& image, int radius)
-{
-    const Image::BitmapData bm (image, Image::BitmapData::readWrite);
-    blurSingleChannelImage (bm.data, bm.width, bm.height, bm.lineStride, 2 * radius);
+            updateColumnSums (sums,
+                              entering < height ? source + entering * sourceStride : zeros,
+                              leaving >= 0      ? source + leaving  * sourceStride : zeros,
+                              dest + y * destStride, width, scale);
+        }
+    }
+
+    static void transpose (const uint8* source, int sourceStride, uint8* dest, int destStride,
+                           int width, int height) noexcept
+    {
+        constexpr int tileSize = 16;
+
+        for (int tileY = 0; tileY < height; tileY += tileSize)
+        {
+            const auto endY = jmin (height, tileY + tileSize);
+
+            for (int tileX = 0; tileX < width; tileX += tileSize)
+            {
+                const auto endX = jmin (width, tileX + tileSize);
+
+                for (int y = tileY; y < endY; ++y)
+                    for (int x = tileX; x < endX; ++x)
+                        dest[x * destStride + y] = source[y * sourceStride + x];
+            }
+        }
+    }
+
+    static void blurSingleChannelImage (uint8* data, int width, int height, int lineStride, int shadowRadius)
+    {
+        jassert (width > 0 && height > 0);
+
+        const auto radii = getBoxRadii (shadowRadius);
+        const auto numPixels = (size_t) width * (size_t) height;
+        const auto maxSide = (size_t) jmax (width, height);
+
+        HeapBlock<uint8> scratch (2 * numPixels + maxSide, true);
+        HeapBlock<uint16> sums (maxSide);
+
+        auto* temp1 = scratch.get();
+        auto* temp2 = temp1 + numPixels;
+        const auto* zeros = temp2 + numPixels;
+
+        // Vertical passes, leaving the result in temp1
+        blurColumns (data,  lineStride, temp1, width,      width, height, radii[0], sums, zeros);
+        blurColumns (temp1, width,      data,  lineStride, width, height, radii[1], sums, zeros);
+        blurColumns (data,  lineStride, temp1, width,      width, height, radii[2], sums, zeros);
+
+        // Horizontal passes on the transposed image, leaving the result in temp1
+        transpose (temp1, width, temp2, height, width, height);
+
+        blurColumns (temp2, height, temp1, height, height, width, radii[0], sums, zeros);
+        blurColumns (temp1, height, temp2, height, height, width, radii[1], sums, zeros);
+        blurColumns (temp2, height, temp1, height, height, width, radii[2], sums, zeros);
+
+        transpose (temp1, height, data, lineStride, height, width);
+    }
+
+    static void blurSingleChannelImage (Image& image, int radius)
+    {
+        const Image::BitmapData bm (image, Image::BitmapData::readWrite);
+        blurSingleChannelImage (bm.data, bm.width, bm.height, bm.lineStride, radius);
+    }
+
+    //==============================================================================
+    static int64 getPathHash (const Path& path) noexcept
+    {
+        auto hash = (uint64) (path.isUsingNonZeroWinding() ? 1 : 2);
+
+        const auto addToHash = [&hash] (uint32 value)
+        {
+            hash = (hash ^ value) * 0x100000001b3ull;
+        };
+
+        const auto addPoint = [&addToHash] (float x, float y)
+        {
+            addToHash (readUnaligned<uint32> (&x));
+            addToHash (readUnaligned<uint32> (&y));
+        };
+
+        for (Path::Iterator i (path); i.next();)
+        {
+            addToHash ((uint32) i.elementType);
+
+            switch (i.elementType)
+            {
+                case Path::Iterator::cubicTo:           addPoint (i.x3, i.y3); JUCE_FALLTHROUGH
+                case Path::Iterator::quadraticTo:       addPoint (i.x2, i.y2); JUCE_FALLTHROUGH
+                case Path::Iterator::startNewSubPath:
+                case Path::Iterator::lineTo:            addPoint (i.x1, i.y1); break;
+                case Path::Iterator::closePath:
+                default:                                break;
+            }
+        }
+
+        return (int64) hash;
+    }
+
+    // Returns an ImageCache hash code for a blurred path mask
+    static int64 getShadowHash (const Path& path, int radius, Rectangle<int> area) noexcept
+    {
+        auto hash = (uint64) getPathHash (path);
+
+        for (auto value : { 0x5348414457ll, (int64) radius, (int64) area.getWidth(), (int64) area.getHeight() })
+            hash = (hash ^ (uint64) value) * 0x100000001b3ull;
+
+        return (int64) hash;
+    }
+
+    static Image createShadowImage (const Path& path, int radius, Point<int> origin, Rectangle<int> area)
+    {
+        Image renderedPath (Image::SingleChannel, area.getWidth(), area.getHeight(), true);
+
+        {
+            Graphics g (renderedPath);
+            g.setColour (Colours::white);
+            g.fillPath (path, AffineTransform::translation ((float) (origin.x - area.getX()),
+                                                            (float) (origin.y - area.getY())));
+        }
+
+        blurSingleChannelImage (renderedPath, radius);
+        return renderedPath;
+    }
 }
 
 //==============================================================================
@@ -82,7 +270,7 @@ void DropShadow::drawForImage (Graphics& g, const Image& srcImage) const
         Image shadowImage (srcImage.convertedToFormat (Image::SingleChannel));
         shadowImage.duplicateIfShared();
 
-        blurSingleChannelImage (shadowImage, radius);
+        DropShadowHelpers::blurSingleChannelImage (shadowImage, radius);
 
         g.setColour (colour);
         g.drawImageAt (shadowImage, offset.x, offset.y, true);
@@ -93,25 +281,33 @@ void DropShadow::drawForPath (Graphics& g, const Path& path) const
 {
     jassert (radius > 0);
 
-    auto area = (path.getBounds().getSmallestIntegerContainer() + offset)
-                  .expanded (radius + 1)
-                  .getIntersection (g.getClipBounds().expanded (radius + 1));
+    const auto shadowArea = (path.getBounds().getSmallestIntegerContainer() + offset).expanded (radius + 1);
+    const auto area = shadowArea.getIntersection (g.getClipBounds().expanded (radius + 1));
 
     if (area.getWidth() > 2 && area.getHeight() > 2)
     {
-        Image renderedPath (Image::SingleChannel, area.getWidth(), area.getHeight(), true);
+        Image shadowImage;
 
+        if (area == shadowArea)
         {
-            Graphics g2 (renderedPath);
-            g2.setColour (Colours::white);
-            g2.fillPath (path, AffineTransform::translation ((float) (offset.x - area.getX()),
-                                                             (float) (offset.y - area.getY())));
+            // When the whole shadow is visible, its mask only depends on the path and radius,
+            // so it can be shared between calls that draw the same shape.
+            const auto hash = DropShadowHelpers::getShadowHash (path, radius, area);
+            shadowImage = ImageCache::getFromHashCode (hash);
+
+            if (! shadowImage.isValid())
+            {
+                shadowImage = DropShadowHelpers::createShadowImage (path, radius, offset, area);
+                ImageCache::addImageToCache (shadowImage, hash);
+            }
+        }
+        else
+        {
+            shadowImage = DropShadowHelpers::createShadowImage (path, radius, offset, area);
         }
-
-        blurSingleChannelImage (renderedPath, radius);
 
         g.setColour (colour);
-        g.drawImageAt (renderedPath, area.getX(), area.getY(), true);
+        g.drawImageAt (shadowImage, area.getX(), area.getY(), true);
     }
 }
 
@@ -43,7 +43,12 @@ struct JUCE_API  DropShadow
     /** Renders a drop-shadow based on the alpha-channel of the given image. */
     void drawForImage (Graphics& g, const Image& srcImage) const;
 
-    /** Renders a drop-shadow based on the shape of a path. */
+    /** Renders a drop-shadow based on the shape of a path.
+
+        When the whole shadow lies within the clip region, its blurred mask is kept in the
+        ImageCache, so drawing the same path with the same radius again is cheap, even if
+        the shadow's colour or offset has changed.
+    */
     void drawForPath (Graphics& g, const Path& path) const;
 
     /** Renders a drop-shadow for a rectangle.
@@ -74,9 +79,10 @@ struct JUCE_API  DropShadow
     shadow based on what gets drawn inside it. The shadow will also
     be applied to the component's children.
 
-    For speed, this doesn't use a proper gaussian blur, but cheats by
-    using a simple bilinear filter. If you need a really high-quality
-    shadow, check out ImageConvolutionKernel::createGaussianBlur()
+    For speed, this doesn't use a proper gaussian blur, but approximates one
+    with three passes of a box filter, so the time it takes doesn't depend on
+    the radius. If you need a really high-quality shadow, check out
+    ImageConvolutionKernel::createGaussianBlur()
 
     @see Component::setComponentEffect
 
@@ -0,0 +1,360 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace DropShadowTestHelpers
+{
+    // The blur that was used before the box filter, kept as a reference
+    static void blurDataTriplets (uint8* d, int num, const int delta) noexcept
+    {
+        uint32 last = d[0];
+        d[0] = (uint8) ((d[0] + d[delta] + 1) / 3);
+        d += delta;
+
+        num -= 2;
+
+        do
+        {
+            const uint32 newLast = d[0];
+            d[0] = (uint8) ((last + d[0] + d[delta] + 1) / 3);
+            d += delta;
+            last = newLast;
+        }
+        while (--num > 0);
+
+        d[0] = (uint8) ((last + d[0] + 1) / 3);
+    }
+
+    static void blurWithTriplets (Image& image, int radius)
+    {
+        const Image::BitmapData bm (image, Image::BitmapData::readWrite);
+
+        for (int y = 0; y < bm.height; ++y)
+            for (int i = 2 * radius; --i >= 0;)
+                blurDataTriplets (bm.getLinePointer (y), bm.width, 1);
+
+        for (int x = 0; x < bm.width; ++x)
+            for (int i = 2 * radius; --i >= 0;)
+                blurDataTriplets (bm.data + x, bm.height, bm.lineStride);
+    }
+
+    static Image createMask (int width, int height, const Path& path)
+    {
+        Image image (Image::SingleChannel, width, height, true);
+        Graphics g (image);
+        g.setColour (Colours::white);
+        g.fillPath (path);
+        return image;
+    }
+
+    static Image createReferenceBlur (const Image& source, int radius)
+    {
+        const auto width = source.getWidth(), height = source.getHeight();
+        std::vector<double> values ((size_t) (width * height));
+
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                values[(size_t) (y * width + x)] = source.getPixelAt (x, y).getAlpha();
+
+        const auto blur = [&] (int boxRadius, int length, int numLines, int step, int lineStep)
+        {
+            std::vector<double> line ((size_t) length);
+
+            for (int i = 0; i < numLines; ++i)
+            {
+                for (int j = 0; j < length; ++j)
+                {
+                    double sum = 0;
+
+                    for (int k = jmax (0, j - boxRadius); k <= jmin (length - 1, j + boxRadius); ++k)
+                        sum += values[(size_t) (i * lineStep + k * step)];
+
+                    line[(size_t) j] = sum / (2 * boxRadius + 1);
+                }
+
+                for (int j = 0; j < length; ++j)
+                    values[(size_t) (i * lineStep + j * step)] = line[(size_t) j];
+            }
+        };
+
+        for (auto boxRadius : DropShadowHelpers::getBoxRadii (radius))
+            blur (boxRadius, height, width, width, 1);
+
+        for (auto boxRadius : DropShadowHelpers::getBoxRadii (radius))
+            blur (boxRadius, width, height, 1, width);
+
+        Image result (Image::SingleChannel, width, height, false);
+
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                result.setPixelAt (x, y, Colours::white.withAlpha ((uint8) roundToInt (values[(size_t) (y * width + x)])));
+
+        return result;
+    }
+
+    static Path createTestPath (Random& random, int width, int height)
+    {
+        Path path;
+        path.addEllipse ((float) width * 0.2f, (float) height * 0.25f, (float) width * 0.3f, (float) height * 0.4f);
+        path.addStar ({ (float) width * 0.65f, (float) height * 0.5f }, 5,
+                      (float) height * 0.1f, (float) height * (0.2f + 0.1f * random.nextFloat()));
+        return path;
+    }
+
+    struct Difference
+    {
+        int maximum = 0;
+        double mean = 0;
+    };
+
+    static Difference getDifference (const Image& a, const Image& b, Rectangle<int> area)
+    {
+        Difference result;
+        const Image::BitmapData da (a, Image::BitmapData::readOnly), db (b, Image::BitmapData::readOnly);
+
+        for (int y = area.getY(); y < area.getBottom(); ++y)
+        {
+            for (int x = area.getX(); x < area.getRight(); ++x)
+            {
+                const auto diff = std::abs ((int) *da.getPixelPointer (x, y) - (int) *db.getPixelPointer (x, y));
+                result.maximum = jmax (result.maximum, diff);
+                result.mean += diff;
+            }
+        }
+
+        result.mean /= (double) jmax (1, area.getWidth() * area.getHeight());
+        return result;
+    }
+}
+
+//==============================================================================
+class DropShadowTests  : public UnitTest
+{
+public:
+    DropShadowTests()
+        : UnitTest ("DropShadow", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        using namespace DropShadowTestHelpers;
+
+        beginTest ("Box blur approximates the triplet blur");
+        {
+            auto random = getRandom();
+
+            for (auto radius : { 1, 2, 3, 5, 8, 13, 20 })
+            {
+                for (auto size : { Point<int> (64, 48), Point<int> (203, 117) })
+                {
+                    const auto mask = createMask (size.x, size.y, createTestPath (random, size.x, size.y));
+
+                    auto expected = mask.createCopy();
+                    blurWithTriplets (expected, radius);
+
+                    auto result = mask.createCopy();
+                    DropShadowHelpers::blurSingleChannelImage (result, radius);
+
+                    const auto difference = getDifference (expected, result, result.getBounds());
+                    const auto description = "radius " + String (radius) + ", " + size.toString();
+
+                    // The box widths have to be odd, so at small radii the variance can't
+                    // be matched exactly
+                    expectLessOrEqual (difference.maximum, 20, description);
+                    expectLessThan (difference.mean, 2.0, description);
+                }
+            }
+        }
+
+        beginTest ("Box blur preserves flat regions and symmetry");
+        {
+            for (auto radius : { 1, 4, 12 })
+            {
+                Path path;
+                path.addRectangle (10.0f, 10.0f, 100.0f, 60.0f);
+
+                auto image = createMask (120, 80, path);
+                DropShadowHelpers::blurSingleChannelImage (image, radius);
+
+                const Image::BitmapData bm (image, Image::BitmapData::readOnly);
+
+                expectEquals ((int) *bm.getPixelPointer (60, 40), 255);
+                expectEquals ((int) *bm.getPixelPointer (0, 0), 0);
+
+                for (int y = 0; y < 80; ++y)
+                    for (int x = 0; x < 60; ++x)
+                        expectEquals ((int) *bm.getPixelPointer (x, y), (int) *bm.getPixelPointer (119 - x, y));
+            }
+        }
+
+        beginTest ("Box blur matches a direct evaluation of the box filters");
+        {
+            auto random = getRandom();
+
+            for (auto size : { Point<int> (1, 1), Point<int> (2, 3), Point<int> (7, 5), Point<int> (1, 40), Point<int> (37, 29) })
+            {
+                for (auto radius : { 1, 4, 10 })
+                {
+                    Image image (Image::SingleChannel, size.x, size.y, false);
+
+                    for (int y = 0; y < size.y; ++y)
+                        for (int x = 0; x < size.x; ++x)
+                            image.setPixelAt (x, y, Colours::white.withAlpha ((uint8) random.nextInt (256)));
+
+                    const auto expected = createReferenceBlur (image, radius);
+                    DropShadowHelpers::blurSingleChannelImage (image, radius);
+
+                    // The implementation rounds after each of its six passes
+                    expectLessOrEqual (getDifference (expected, image, image.getBounds()).maximum, 3,
+                                       "radius " + String (radius) + ", " + size.toString());
+                }
+            }
+        }
+
+        beginTest ("Cached path shadows match uncached ones");
+        {
+            auto random = getRandom();
+            const auto path = createTestPath (random, 150, 100);
+            const DropShadow shadow (Colours::black, 6, { 3, 4 });
+
+            const auto draw = [&] (Rectangle<int> clip)
+            {
+                Image image (Image::ARGB, 200, 150, true);
+                Graphics g (image);
+                g.reduceClipRegion (clip);
+                shadow.drawForPath (g, path);
+                return image;
+            };
+
+            const auto fullArea = Rectangle<int> (200, 150);
+            const auto hash = DropShadowHelpers::getShadowHash (path, shadow.radius,
+                                                                (path.getBounds().getSmallestIntegerContainer() + shadow.offset)
+                                                                    .expanded (shadow.radius + 1));
+            ImageCache::releaseUnusedImages();
+
+            const auto first = draw (fullArea);
+            expect (ImageCache::getFromHashCode (hash).isValid());
+
+            const auto second = draw (fullArea);
+            expectEquals (getDifference (first, second, fullArea).maximum, 0);
+
+            // A partly clipped shadow isn't cached, but should look the same where it's drawn
+            const auto clip = Rectangle<int> (40, 30, 50, 40);
+            const auto clipped = draw (clip);
+            expectEquals (getDifference (first, clipped, clip).maximum, 0);
+        }
+
+        beginTest ("Path hashes depend on the path's shape");
+        {
+            Path a, b;
+            a.addRectangle (0.0f, 0.0f, 10.0f, 10.0f);
+            b.addRectangle (0.0f, 0.0f, 10.0f, 10.5f);
+
+            auto c = a;
+            c.setUsingNonZeroWinding (false);
+
+            expect (DropShadowHelpers::getPathHash (a) == DropShadowHelpers::getPathHash (Path (a)));
+            expect (DropShadowHelpers::getPathHash (a) != DropShadowHelpers::getPathHash (b));
+            expect (DropShadowHelpers::getPathHash (a) != DropShadowHelpers::getPathHash (c));
+        }
+    }
+};
+
+static DropShadowTests dropShadowTests;
+
+//==============================================================================
+class DropShadowBenchmarks  : public UnitTest
+{
+public:
+    DropShadowBenchmarks()
+        : UnitTest ("DropShadow throughput", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        using namespace DropShadowTestHelpers;
+
+        beginTest ("Box blur vs triplet blur");
+
+        auto random = getRandom();
+        constexpr int width = 400, height = 300;
+        const auto mask = createMask (width, height, createTestPath (random, width, height));
+
+        for (auto radius : { 2, 8, 32 })
+        {
+            const auto time = [&] (auto&& blur)
+            {
+                constexpr int numRepetitions = 10;
+                auto image = mask.createCopy();
+                const auto start = Time::getHighResolutionTicks();
+
+                for (int i = 0; i < numRepetitions; ++i)
+                    blur (image);
+
+                const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+                return seconds * 1.0e9 / ((double) numRepetitions * width * height);
+            };
+
+            const auto tripletTime = time ([radius] (Image& image) { blurWithTriplets (image, radius); });
+            const auto boxTime     = time ([radius] (Image& image) { DropShadowHelpers::blurSingleChannelImage (image, radius); });
+
+            logMessage ("Radius " + String (radius) + ", ns per pixel: triplets " + String (tripletTime, 3)
+                          + ", box " + String (boxTime, 3)
+                          + " (" + String (tripletTime / boxTime, 2) + "x)");
+
+            expect (tripletTime > 0.0 && boxTime > 0.0);
+        }
+
+        beginTest ("Repeated path shadows");
+        {
+            const auto path = createTestPath (random, width, height);
+            Image image (Image::ARGB, width + 50, height + 50, true);
+            Graphics g (image);
+
+            const auto time = [&] (int numCalls)
+            {
+                const auto start = Time::getHighResolutionTicks();
+
+                for (int i = 0; i < numCalls; ++i)
+                    DropShadow (Colours::black, 8, { 2, 2 }).drawForPath (g, path);
+
+                return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6 / numCalls;
+            };
+
+            ImageCache::releaseUnusedImages();
+            const auto firstTime = time (1);
+            const auto cachedTime = time (50);
+
+            logMessage ("us per drawForPath: first call " + String (firstTime, 1) + ", cached " + String (cachedTime, 1));
+            expect (firstTime > 0.0 && cachedTime > 0.0);
+        }
+    }
+};
+
+static DropShadowBenchmarks dropShadowBenchmarks;
+
+} // namespace juce
@@ -104,6 +104,33 @@
  #define JUCE_USING_COREIMAGE_LOADER 0
 #endif
 
+//==============================================================================
+// The SIMD versions of the pixel span operations. SSE2 and NEON are used whenever the
+// target has them, and the AVX2 versions are chosen at runtime when JUCE_USE_AVX_DISPATCH
+// is set, in the same way as FloatVectorOperations
+#if ! defined (JUCE_GRAPHICS_USE_SSE2) && JUCE_INTEL && ! (JUCE_MINGW && ! defined (__SSE2__))
+ #define JUCE_GRAPHICS_USE_SSE2 1
+#endif
+
+// The AVX kernels are built on the SSE2 ones
+#if JUCE_USE_AVX_DISPATCH && ! JUCE_GRAPHICS_USE_SSE2
+ #undef JUCE_USE_AVX_DISPATCH
+#endif
+
+#if ! defined (JUCE_GRAPHICS_USE_NEON) && (defined (__ARM_NEON__) || defined (__ARM_NEON)) && ! TARGET_IPHONE_SIMULATOR
+ #define JUCE_GRAPHICS_USE_NEON 1
+#endif
+
+#if JUCE_USE_AVX_DISPATCH
+ #include <immintrin.h>
+#elif JUCE_GRAPHICS_USE_SSE2
+ #include <emmintrin.h>
+#endif
+
+#if JUCE_GRAPHICS_USE_NEON
+ #include <arm_neon.h>
+#endif
+
 //==============================================================================
 #include "colour/juce_Colour.cpp"
 #include "colour/juce_ColourGradient.cpp"
@@ -118,6 +145,8 @@
 #include "contexts/juce_GraphicsContext.cpp"
 #include "contexts/juce_LowLevelGraphicsPostScriptRenderer.cpp"
 #include "contexts/juce_LowLevelGraphicsSoftwareRenderer.cpp"
+#include "contexts/juce_LowLevelGraphicsParallelSoftwareRenderer.cpp"
+#include "native/juce_PixelSpanOperations.cpp"
 #include "images/juce_Image.cpp"
 #include "images/juce_ImageCache.cpp"
 #include "images/juce_ImageConvolutionKernel.cpp"
@@ -136,6 +165,9 @@
 
 #if JUCE_UNIT_TESTS
  #include "geometry/juce_Rectangle_test.cpp"
+ #include "contexts/juce_LowLevelGraphicsParallelSoftwareRenderer_test.cpp"
+ #include "native/juce_PixelSpanOperations_test.cpp"
+ #include "effects/juce_DropShadowEffect_test.cpp"
 #endif
 
 #if JUCE_USE_FREETYPE
@@ -0,0 +1,593 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace RenderingHelpers
+{
+
+namespace PixelSpanHelpers
+{
+    // The vector versions treat each pixel as four bytes, with the alpha in the top one
+    static_assert (sizeof (PixelARGB) == 4, "PixelARGB must be packed");
+
+    enum class InstructionSet
+    {
+        scalar,
+        sse2,
+        avx2,
+        neon
+    };
+
+    static InstructionSet getBestInstructionSet() noexcept
+    {
+       #if JUCE_USE_AVX_DISPATCH
+        if (SystemStats::hasAVX2())
+            return InstructionSet::avx2;
+       #endif
+
+       #if JUCE_GRAPHICS_USE_SSE2
+        return InstructionSet::sse2;
+       #elif JUCE_GRAPHICS_USE_NEON
+        return InstructionSet::neon;
+       #else
+        return InstructionSet::scalar;
+       #endif
+    }
+
+    static std::atomic<InstructionSet>& getInstructionSet() noexcept
+    {
+        static std::atomic<InstructionSet> instructionSet { getBestInstructionSet() };
+        return instructionSet;
+    }
+
+    //==============================================================================
+    namespace Scalar
+    {
+        static void blend (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i].blend (colour);
+        }
+
+        static void blend (PixelARGB* dest, const PixelARGB* src, int num) noexcept
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i].blend (src[i]);
+        }
+
+        static void blend (PixelARGB* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i].blend (src[i], extraAlpha);
+        }
+
+        static void lookUpLinearGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                          int position, int increment, int numScaleBits, int num) noexcept
+        {
+            for (int i = 0; i < num; ++i)
+            {
+                const auto value = (int) ((uint32) position + (uint32) i * (uint32) increment);
+                dest[i] = lookupTable[jlimit (0, numEntries, value >> numScaleBits)];
+            }
+        }
+
+        static void lookUpRadialGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                          int x, double centreX, double dySquared, double maxDistSquared,
+                                          double invScale, int num) noexcept
+        {
+            for (int i = 0; i < num; ++i)
+            {
+                auto d = (x + i) - centreX;
+                d *= d;
+                d += dySquared;
+
+                dest[i] = lookupTable[d >= maxDistSquared ? numEntries : roundToInt (std::sqrt (d) * invScale)];
+            }
+        }
+    }
+
+    //==============================================================================
+   #if JUCE_GRAPHICS_USE_SSE2
+    /*  Each pixel's components are widened to 16 bits, which leaves enough room for the
+        products in PixelARGB::blend(), and packing them back to 8 bits with saturation
+        does the same clamping as clampPixelComponents().
+    */
+    namespace SSE2
+    {
+        static forcedinline __m128i getInverseAlpha (__m128i wide) noexcept
+        {
+            const auto alpha = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (wide, _MM_SHUFFLE (3, 3, 3, 3)), _MM_SHUFFLE (3, 3, 3, 3));
+            return _mm_sub_epi16 (_mm_set1_epi16 (0x100), alpha);
+        }
+
+        static forcedinline __m128i blendWide (__m128i dest, __m128i src, __m128i inverseAlpha) noexcept
+        {
+            return _mm_add_epi16 (src, _mm_srli_epi16 (_mm_mullo_epi16 (dest, inverseAlpha), 8));
+        }
+
+        static forcedinline __m128i blendWide (__m128i dest, __m128i src) noexcept
+        {
+            return blendWide (dest, src, getInverseAlpha (src));
+        }
+
+        static void blend (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            const auto zero = _mm_setzero_si128();
+            const auto src = _mm_unpacklo_epi8 (_mm_set1_epi32 ((int) colour.getNativeARGB()), zero);
+            const auto inverseAlpha = getInverseAlpha (src);
+
+            int i = 0;
+
+            for (; i + 4 <= num; i += 4)
+            {
+                auto* d = reinterpret_cast<__m128i*> (dest + i);
+                const auto pixels = _mm_loadu_si128 (d);
+
+                _mm_storeu_si128 (d, _mm_packus_epi16 (blendWide (_mm_unpacklo_epi8 (pixels, zero), src, inverseAlpha),
+                                                       blendWide (_mm_unpackhi_epi8 (pixels, zero), src, inverseAlpha)));
+            }
+
+            Scalar::blend (dest + i, colour, num - i);
+        }
+
+        static void blend (PixelARGB* dest, const PixelARGB* src, int num) noexcept
+        {
+            const auto zero = _mm_setzero_si128();
+            int i = 0;
+
+            for (; i + 4 <= num; i += 4)
+            {
+                auto* d = reinterpret_cast<__m128i*> (dest + i);
+                const auto pixels = _mm_loadu_si128 (d);
+                const auto s = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+
+                _mm_storeu_si128 (d, _mm_packus_epi16 (blendWide (_mm_unpacklo_epi8 (pixels, zero), _mm_unpacklo_epi8 (s, zero)),
+                                                       blendWide (_mm_unpackhi_epi8 (pixels, zero), _mm_unpackhi_epi8 (s, zero))));
+            }
+
+            Scalar::blend (dest + i, src + i, num - i);
+        }
+
+        static void blend (PixelARGB* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            const auto zero = _mm_setzero_si128();
+            const auto alpha = _mm_set1_epi16 ((short) extraAlpha);
+            int i = 0;
+
+            const auto scale = [alpha] (__m128i wide) { return _mm_srli_epi16 (_mm_mullo_epi16 (wide, alpha), 8); };
+
+            for (; i + 4 <= num; i += 4)
+            {
+                auto* d = reinterpret_cast<__m128i*> (dest + i);
+                const auto pixels = _mm_loadu_si128 (d);
+                const auto s = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src + i));
+
+                _mm_storeu_si128 (d, _mm_packus_epi16 (blendWide (_mm_unpacklo_epi8 (pixels, zero), scale (_mm_unpacklo_epi8 (s, zero))),
+                                                       blendWide (_mm_unpackhi_epi8 (pixels, zero), scale (_mm_unpackhi_epi8 (s, zero)))));
+            }
+
+            Scalar::blend (dest + i, src + i, num - i, extraAlpha);
+        }
+
+        static void lookUpLinearGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                          int position, int increment, int numScaleBits, int num) noexcept
+        {
+            const auto step = (uint32) increment;
+            const auto first = (uint32) position;
+
+            auto positions = _mm_setr_epi32 ((int) first, (int) (first + step), (int) (first + 2 * step), (int) (first + 3 * step));
+            const auto positionStep = _mm_set1_epi32 ((int) (4 * step));
+            const auto shift = _mm_cvtsi32_si128 (numScaleBits);
+            const auto maxIndex = _mm_set1_epi32 (numEntries);
+            const auto minusOne = _mm_set1_epi32 (-1);
+
+            int i = 0;
+
+            for (; i + 4 <= num; i += 4)
+            {
+                auto indexes = _mm_sra_epi32 (positions, shift);
+                indexes = _mm_and_si128 (indexes, _mm_cmpgt_epi32 (indexes, minusOne));
+
+                const auto tooHigh = _mm_cmpgt_epi32 (indexes, maxIndex);
+                indexes = _mm_or_si128 (_mm_andnot_si128 (tooHigh, indexes), _mm_and_si128 (tooHigh, maxIndex));
+
+                alignas (16) int32 index[4];
+                _mm_store_si128 (reinterpret_cast<__m128i*> (index), indexes);
+
+                dest[i]     = lookupTable[index[0]];
+                dest[i + 1] = lookupTable[index[1]];
+                dest[i + 2] = lookupTable[index[2]];
+                dest[i + 3] = lookupTable[index[3]];
+
+                positions = _mm_add_epi32 (positions, positionStep);
+            }
+
+            Scalar::lookUpLinearGradient (dest + i, lookupTable, numEntries,
+                                          (int) (first + (uint32) i * step), increment, numScaleBits, num - i);
+        }
+
+        static void lookUpRadialGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                          int x, double centreX, double dySquared, double maxDistSquared,
+                                          double invScale, int num) noexcept
+        {
+            auto xs = _mm_setr_pd ((double) x, (double) (x + 1));
+            const auto two = _mm_set1_pd (2.0);
+            const auto centre = _mm_set1_pd (centreX);
+            const auto dy = _mm_set1_pd (dySquared);
+            const auto maxDist = _mm_set1_pd (maxDistSquared);
+            const auto scale = _mm_set1_pd (invScale);
+
+            int i = 0;
+
+            for (; i + 2 <= num; i += 2)
+            {
+                auto d = _mm_sub_pd (xs, centre);
+                d = _mm_add_pd (_mm_mul_pd (d, d), dy);
+
+                // This rounds to nearest-even, like roundToInt()
+                const auto indexes = _mm_cvtpd_epi32 (_mm_mul_pd (_mm_sqrt_pd (d), scale));
+                const auto outside = _mm_movemask_pd (_mm_cmpge_pd (d, maxDist));
+
+                dest[i]     = lookupTable[(outside & 1) != 0 ? numEntries : _mm_cvtsi128_si32 (indexes)];
+                dest[i + 1] = lookupTable[(outside & 2) != 0 ? numEntries : _mm_cvtsi128_si32 (_mm_srli_si128 (indexes, 4))];
+
+                xs = _mm_add_pd (xs, two);
+            }
+
+            Scalar::lookUpRadialGradient (dest + i, lookupTable, numEntries, x + i, centreX, dySquared, maxDistSquared, invScale, num - i);
+        }
+    }
+   #endif
+
+    //==============================================================================
+   #if JUCE_USE_AVX_DISPATCH
+    /*  These are compiled with a per-function target attribute, so that they can be
+        included in a build that only assumes SSE2, and are only called if SystemStats
+        says that both the CPU and the OS support them. Each one clears the upper halves
+        of the vector registers before handing the last few pixels to the SSE2 version,
+        because running SSE code while they're dirty is very slow.
+    */
+   #if JUCE_GCC
+    #pragma GCC push_options
+    #pragma GCC target ("avx2")
+   #elif JUCE_CLANG
+    #pragma clang attribute push (__attribute__ ((target ("avx2"))), apply_to = function)
+   #endif
+
+    namespace AVX2
+    {
+        // The gather instructions read each pixel as an int
+        static forcedinline const int* getTableAsInts (const PixelARGB* lookupTable) noexcept
+        {
+            const void* table = lookupTable;
+            return static_cast<const int*> (table);
+        }
+
+        static forcedinline __m256i getInverseAlpha (__m256i wide) noexcept
+        {
+            const auto alpha = _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (wide, _MM_SHUFFLE (3, 3, 3, 3)), _MM_SHUFFLE (3, 3, 3, 3));
+            return _mm256_sub_epi16 (_mm256_set1_epi16 (0x100), alpha);
+        }
+
+        static forcedinline __m256i blendWide (__m256i dest, __m256i src, __m256i inverseAlpha) noexcept
+        {
+            return _mm256_add_epi16 (src, _mm256_srli_epi16 (_mm256_mullo_epi16 (dest, inverseAlpha), 8));
+        }
+
+        static forcedinline __m256i blendWide (__m256i dest, __m256i src) noexcept
+        {
+            return blendWide (dest, src, getInverseAlpha (src));
+        }
+
+        static void blend (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            const auto zero = _mm256_setzero_si256();
+            const auto src = _mm256_unpacklo_epi8 (_mm256_set1_epi32 ((int) colour.getNativeARGB()), zero);
+            const auto inverseAlpha = getInverseAlpha (src);
+
+            int i = 0;
+
+            for (; i + 8 <= num; i += 8)
+            {
+                auto* d = reinterpret_cast<__m256i*> (dest + i);
+                const auto pixels = _mm256_loadu_si256 (d);
+
+                _mm256_storeu_si256 (d, _mm256_packus_epi16 (blendWide (_mm256_unpacklo_epi8 (pixels, zero), src, inverseAlpha),
+                                                             blendWide (_mm256_unpackhi_epi8 (pixels, zero), src, inverseAlpha)));
+            }
+
+            _mm256_zeroupper();
+            SSE2::blend (dest + i, colour, num - i);
+        }
+
+        static void blend (PixelARGB* dest, const PixelARGB* src, int num) noexcept
+        {
+            const auto zero = _mm256_setzero_si256();
+            int i = 0;
+
+            for (; i + 8 <= num; i += 8)
+            {
+                auto* d = reinterpret_cast<__m256i*> (dest + i);
+                const auto pixels = _mm256_loadu_si256 (d);
+                const auto s = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (src + i));
+
+                _mm256_storeu_si256 (d, _mm256_packus_epi16 (blendWide (_mm256_unpacklo_epi8 (pixels, zero), _mm256_unpacklo_epi8 (s, zero)),
+                                                             blendWide (_mm256_unpackhi_epi8 (pixels, zero), _mm256_unpackhi_epi8 (s, zero))));
+            }
+
+            _mm256_zeroupper();
+            SSE2::blend (dest + i, src + i, num - i);
+        }
+
+        static void blend (PixelARGB* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            const auto zero = _mm256_setzero_si256();
+            const auto alpha = _mm256_set1_epi16 ((short) extraAlpha);
+            int i = 0;
+
+            const auto scale = [alpha] (__m256i wide) { return _mm256_srli_epi16 (_mm256_mullo_epi16 (wide, alpha), 8); };
+
+            for (; i + 8 <= num; i += 8)
+            {
+                auto* d = reinterpret_cast<__m256i*> (dest + i);
+                const auto pixels = _mm256_loadu_si256 (d);
+                const auto s = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (src + i));
+
+                _mm256_storeu_si256 (d, _mm256_packus_epi16 (blendWide (_mm256_unpacklo_epi8 (pixels, zero), scale (_mm256_unpacklo_epi8 (s, zero))),
+                                                             blendWide (_mm256_unpackhi_epi8 (pixels, zero), scale (_mm256_unpackhi_epi8 (s, zero)))));
+            }
+
+            _mm256_zeroupper();
+            SSE2::blend (dest + i, src + i, num - i, extraAlpha);
+        }
+
+        static void lookUpLinearGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                          int position, int increment, int numScaleBits, int num) noexcept
+        {
+            const auto step = (uint32) increment;
+            const auto first = (uint32) position;
+
+            auto positions = _mm256_add_epi32 (_mm256_set1_epi32 ((int) first),
+                                               _mm256_mullo_epi32 (_mm256_set1_epi32 ((int) step), _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7)));
+            const auto positionStep = _mm256_set1_epi32 ((int) (8 * step));
+            const auto shift = _mm_cvtsi32_si128 (numScaleBits);
+            const auto maxIndex = _mm256_set1_epi32 (numEntries);
+            const auto zero = _mm256_setzero_si256();
+            const auto* table = getTableAsInts (lookupTable);
+
+            int i = 0;
+
+            for (; i + 8 <= num; i += 8)
+            {
+                const auto indexes = _mm256_min_epi32 (_mm256_max_epi32 (_mm256_sra_epi32 (positions, shift), zero), maxIndex);
+                _mm256_storeu_si256 (reinterpret_cast<__m256i*> (dest + i), _mm256_i32gather_epi32 (table, indexes, 4));
+
+                positions = _mm256_add_epi32 (positions, positionStep);
+            }
+
+            _mm256_zeroupper();
+            SSE2::lookUpLinearGradient (dest + i, lookupTable, numEntries,
+                                        (int) (first + (uint32) i * step), increment, numScaleBits, num - i);
+        }
+
+        static void lookUpRadialGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                          int x, double centreX, double dySquared, double maxDistSquared,
+                                          double invScale, int num) noexcept
+        {
+            auto xs = _mm256_add_pd (_mm256_set1_pd ((double) x), _mm256_setr_pd (0.0, 1.0, 2.0, 3.0));
+            const auto four = _mm256_set1_pd (4.0);
+            const auto centre = _mm256_set1_pd (centreX);
+            const auto dy = _mm256_set1_pd (dySquared);
+            const auto maxDist = _mm256_set1_pd (maxDistSquared);
+            const auto scale = _mm256_set1_pd (invScale);
+            const auto lastEntry = _mm_set1_epi32 (numEntries);
+            const auto lowWords = _mm256_setr_epi32 (0, 2, 4, 6, 0, 2, 4, 6);
+            const auto* table = getTableAsInts (lookupTable);
+
+            int i = 0;
+
+            for (; i + 4 <= num; i += 4)
+            {
+                auto d = _mm256_sub_pd (xs, centre);
+                d = _mm256_add_pd (_mm256_mul_pd (d, d), dy);
+
+                const auto indexes = _mm256_cvtpd_epi32 (_mm256_mul_pd (_mm256_sqrt_pd (d), scale));
+                const auto outside = _mm256_castsi256_si128 (_mm256_permutevar8x32_epi32 (_mm256_castpd_si256 (_mm256_cmp_pd (d, maxDist, _CMP_GE_OQ)), lowWords));
+
+                _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i),
+                                  _mm_i32gather_epi32 (table, _mm_blendv_epi8 (indexes, lastEntry, outside), 4));
+
+                xs = _mm256_add_pd (xs, four);
+            }
+
+            _mm256_zeroupper();
+            SSE2::lookUpRadialGradient (dest + i, lookupTable, numEntries, x + i, centreX, dySquared, maxDistSquared, invScale, num - i);
+        }
+    }
+
+   #if JUCE_GCC
+    #pragma GCC pop_options
+   #elif JUCE_CLANG
+    #pragma clang attribute pop
+   #endif
+   #endif
+
+    //==============================================================================
+   #if JUCE_GRAPHICS_USE_NEON
+    /*  The pixels are loaded eight at a time and de-interleaved, so that each component
+        can be widened to 16 bits and blended as in PixelARGB::blend(), and then narrowed
+        again with saturation. The gradient lookups use the scalar versions.
+    */
+    namespace NEON
+    {
+        static forcedinline uint16x8_t getInverseAlpha (uint8x8x4_t src) noexcept
+        {
+            return vsubq_u16 (vdupq_n_u16 (0x100), vmovl_u8 (src.val[PixelARGB::indexA]));
+        }
+
+        static forcedinline uint8x8_t blendComponent (uint8x8_t dest, uint8x8_t src, uint16x8_t inverseAlpha) noexcept
+        {
+            return vqmovn_u16 (vaddq_u16 (vmovl_u8 (src), vshrq_n_u16 (vmulq_u16 (vmovl_u8 (dest), inverseAlpha), 8)));
+        }
+
+        static forcedinline void blendPixels (uint8* dest, uint8x8x4_t src, uint16x8_t inverseAlpha) noexcept
+        {
+            auto pixels = vld4_u8 (dest);
+
+            for (int i = 0; i < 4; ++i)
+                pixels.val[i] = blendComponent (pixels.val[i], src.val[i], inverseAlpha);
+
+            vst4_u8 (dest, pixels);
+        }
+
+        static void blend (PixelARGB* dest, PixelARGB colour, int num) noexcept
+        {
+            const auto* components = reinterpret_cast<const uint8*> (&colour);
+            uint8x8x4_t src;
+
+            for (int i = 0; i < 4; ++i)
+                src.val[i] = vdup_n_u8 (components[i]);
+
+            const auto inverseAlpha = getInverseAlpha (src);
+            int i = 0;
+
+            for (; i + 8 <= num; i += 8)
+                blendPixels (reinterpret_cast<uint8*> (dest + i), src, inverseAlpha);
+
+            Scalar::blend (dest + i, colour, num - i);
+        }
+
+        static void blend (PixelARGB* dest, const PixelARGB* src, int num) noexcept
+        {
+            int i = 0;
+
+            for (; i + 8 <= num; i += 8)
+            {
+                const auto s = vld4_u8 (reinterpret_cast<const uint8*> (src + i));
+                blendPixels (reinterpret_cast<uint8*> (dest + i), s, getInverseAlpha (s));
+            }
+
+            Scalar::blend (dest + i, src + i, num - i);
+        }
+
+        static void blend (PixelARGB* dest, const PixelARGB* src, int num, uint32 extraAlpha) noexcept
+        {
+            const auto alpha = vdupq_n_u16 ((uint16) extraAlpha);
+            int i = 0;
+
+            for (; i + 8 <= num; i += 8)
+            {
+                auto s = vld4_u8 (reinterpret_cast<const uint8*> (src + i));
+
+                for (int c = 0; c < 4; ++c)
+                    s.val[c] = vshrn_n_u16 (vmulq_u16 (vmovl_u8 (s.val[c]), alpha), 8);
+
+                blendPixels (reinterpret_cast<uint8*> (dest + i), s, getInverseAlpha (s));
+            }
+
+            Scalar::blend (dest + i, src + i, num - i, extraAlpha);
+        }
+
+        using Scalar::lookUpLinearGradient;
+        using Scalar::lookUpRadialGradient;
+    }
+   #endif
+}
+
+//==============================================================================
+// Every instruction set gets its own case, so that -Wswitch-enum can spot a missing one.
+// Any that aren't compiled in just use the scalar versions.
+#if JUCE_USE_AVX_DISPATCH
+ #define JUCE_DISPATCH_AVX2_PIXEL_SPAN_OP(call) \
+    case PixelSpanHelpers::InstructionSet::avx2:    return PixelSpanHelpers::AVX2::call;
+#else
+ #define JUCE_DISPATCH_AVX2_PIXEL_SPAN_OP(call) \
+    case PixelSpanHelpers::InstructionSet::avx2:    return PixelSpanHelpers::Scalar::call;
+#endif
+
+#if JUCE_GRAPHICS_USE_SSE2
+ #define JUCE_DISPATCH_SSE2_PIXEL_SPAN_OP(call) \
+    case PixelSpanHelpers::InstructionSet::sse2:    return PixelSpanHelpers::SSE2::call;
+#else
+ #define JUCE_DISPATCH_SSE2_PIXEL_SPAN_OP(call) \
+    case PixelSpanHelpers::InstructionSet::sse2:    return PixelSpanHelpers::Scalar::call;
+#endif
+
+#if JUCE_GRAPHICS_USE_NEON
+ #define JUCE_DISPATCH_NEON_PIXEL_SPAN_OP(call) \
+    case PixelSpanHelpers::InstructionSet::neon:    return PixelSpanHelpers::NEON::call;
+#else
+ #define JUCE_DISPATCH_NEON_PIXEL_SPAN_OP(call) \
+    case PixelSpanHelpers::InstructionSet::neon:    return PixelSpanHelpers::Scalar::call;
+#endif
+
+#define JUCE_DISPATCH_PIXEL_SPAN_OP(call) \
+    switch (PixelSpanHelpers::getInstructionSet().load (std::memory_order_relaxed)) \
+    { \
+        JUCE_DISPATCH_AVX2_PIXEL_SPAN_OP (call) \
+        JUCE_DISPATCH_SSE2_PIXEL_SPAN_OP (call) \
+        JUCE_DISPATCH_NEON_PIXEL_SPAN_OP (call) \
+        case PixelSpanHelpers::InstructionSet::scalar:  break; \
+    } \
+    \
+    return PixelSpanHelpers::Scalar::call;
+
+void PixelSpanOperations::blend (PixelARGB* dest, PixelARGB colour, int numPixels) noexcept
+{
+    JUCE_DISPATCH_PIXEL_SPAN_OP (blend (dest, colour, numPixels))
+}
+
+void PixelSpanOperations::blend (PixelARGB* dest, const PixelARGB* src, int numPixels) noexcept
+{
+    JUCE_DISPATCH_PIXEL_SPAN_OP (blend (dest, src, numPixels))
+}
+
+void PixelSpanOperations::blend (PixelARGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept
+{
+    jassert (extraAlpha <= 0x100);
+    JUCE_DISPATCH_PIXEL_SPAN_OP (blend (dest, src, numPixels, extraAlpha))
+}
+
+void PixelSpanOperations::lookUpLinearGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                                int position, int increment, int numScaleBits, int numPixels) noexcept
+{
+    JUCE_DISPATCH_PIXEL_SPAN_OP (lookUpLinearGradient (dest, lookupTable, numEntries, position, increment, numScaleBits, numPixels))
+}
+
+void PixelSpanOperations::lookUpRadialGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                                int x, double centreX, double dySquared, double maxDistSquared,
+                                                double invScale, int numPixels) noexcept
+{
+    JUCE_DISPATCH_PIXEL_SPAN_OP (lookUpRadialGradient (dest, lookupTable, numEntries, x, centreX, dySquared, maxDistSquared, invScale, numPixels))
+}
+
+#undef JUCE_DISPATCH_PIXEL_SPAN_OP
+#undef JUCE_DISPATCH_AVX2_PIXEL_SPAN_OP
+#undef JUCE_DISPATCH_SSE2_PIXEL_SPAN_OP
+#undef JUCE_DISPATCH_NEON_PIXEL_SPAN_OP
+
+} // namespace RenderingHelpers
+} // namespace juce
@@ -0,0 +1,416 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace RenderingHelpers
+{
+
+namespace PixelSpanTestHelpers
+{
+    using PixelSpanHelpers::InstructionSet;
+
+    static std::vector<InstructionSet> getAvailableInstructionSets()
+    {
+        std::vector<InstructionSet> sets { InstructionSet::scalar };
+
+       #if JUCE_GRAPHICS_USE_SSE2
+        sets.push_back (InstructionSet::sse2);
+       #endif
+
+       #if JUCE_USE_AVX_DISPATCH
+        if (SystemStats::hasAVX2())
+            sets.push_back (InstructionSet::avx2);
+       #endif
+
+       #if JUCE_GRAPHICS_USE_NEON
+        sets.push_back (InstructionSet::neon);
+       #endif
+
+        return sets;
+    }
+
+    static String getInstructionSetName (InstructionSet set)
+    {
+        switch (set)
+        {
+            case InstructionSet::sse2:      return "SSE2";
+            case InstructionSet::avx2:      return "AVX2";
+            case InstructionSet::neon:      return "NEON";
+            case InstructionSet::scalar:    break;
+        }
+
+        return "Scalar";
+    }
+
+    struct ScopedInstructionSet
+    {
+        explicit ScopedInstructionSet (InstructionSet set)
+            : previous (PixelSpanHelpers::getInstructionSet().exchange (set))
+        {
+        }
+
+        ~ScopedInstructionSet()
+        {
+            PixelSpanHelpers::getInstructionSet() = previous;
+        }
+
+        const InstructionSet previous;
+    };
+
+    static PixelARGB randomPixel (Random& random)
+    {
+        return PixelARGB ((uint8) random.nextInt (256), (uint8) random.nextInt (256),
+                          (uint8) random.nextInt (256), (uint8) random.nextInt (256));
+    }
+
+    static Image createSourceImage (Random& random, int width, int height)
+    {
+        Image image (Image::ARGB, width, height, true, SoftwareImageType());
+        Graphics g (image);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            g.setColour (Colour ((uint32) random.nextInt()).withAlpha (random.nextFloat()));
+            g.fillEllipse ((float) random.nextInt (width), (float) random.nextInt (height),
+                           (float) (4 + random.nextInt (width)), (float) (4 + random.nextInt (height)));
+        }
+
+        return image;
+    }
+
+    enum class FillType
+    {
+        solidColour,
+        linearGradient,
+        radialGradient,
+        image,
+        tiledImage,
+        transformedImage
+    };
+
+    static String getFillTypeName (FillType type)
+    {
+        switch (type)
+        {
+            case FillType::solidColour:         return "solid colour";
+            case FillType::linearGradient:      return "linear gradient";
+            case FillType::radialGradient:      return "radial gradient";
+            case FillType::image:               return "image";
+            case FillType::tiledImage:          return "tiled image";
+            case FillType::transformedImage:    break;
+        }
+
+        return "transformed image";
+    }
+
+    static void fill (Graphics& g, FillType type, Rectangle<int> area, const Image& source, float opacity)
+    {
+        const auto centre = area.getCentre().toFloat();
+
+        Graphics::ScopedSaveState saveState (g);
+        g.reduceClipRegion (area);
+
+        switch (type)
+        {
+            case FillType::solidColour:
+                g.setColour (Colours::orange.withAlpha (opacity));
+                g.fillRect (area);
+                break;
+
+            case FillType::linearGradient:
+                g.setGradientFill (ColourGradient (Colours::red.withAlpha (opacity), area.getTopLeft().toFloat(),
+                                                   Colours::blue.withAlpha (0.5f), area.getBottomRight().toFloat(), false));
+                g.fillRect (area);
+                break;
+
+            case FillType::radialGradient:
+                g.setGradientFill (ColourGradient (Colours::yellow.withAlpha (opacity), centre,
+                                                   Colours::green.withAlpha (0.3f), area.getTopLeft().toFloat(), true));
+                g.fillRect (area);
+                break;
+
+            case FillType::image:
+                g.setOpacity (opacity);
+                g.drawImageAt (source, area.getX(), area.getY());
+                break;
+
+            case FillType::tiledImage:
+                g.setTiledImageFill (source, area.getX() + 3, area.getY() + 5, opacity);
+                g.fillRect (area);
+                break;
+
+            case FillType::transformedImage:
+                g.setOpacity (opacity);
+                g.drawImageTransformed (source, AffineTransform::rotation (0.3f).scaled (1.7f).translated (centre));
+                break;
+        }
+    }
+
+    static constexpr FillType allFillTypes[] { FillType::solidColour, FillType::linearGradient, FillType::radialGradient,
+                                               FillType::image, FillType::tiledImage, FillType::transformedImage };
+}
+
+//==============================================================================
+class PixelSpanOperationsTests  : public UnitTest
+{
+public:
+    PixelSpanOperationsTests()
+        : UnitTest ("PixelSpanOperations", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        using namespace PixelSpanTestHelpers;
+
+        for (auto set : getAvailableInstructionSets())
+        {
+            const ScopedInstructionSet scope (set);
+
+            beginTest ("Blending matches PixelARGB (" + getInstructionSetName (set) + ")");
+            testBlending();
+
+            beginTest ("Gradient lookups match the pixel iterators (" + getInstructionSetName (set) + ")");
+            testGradients();
+        }
+
+        beginTest ("Fills are identical with each instruction set");
+        {
+            auto random = getRandom();
+            const auto source = createSourceImage (random, 37, 29);
+
+            const auto render = [&source] (Image::PixelFormat format)
+            {
+                Image image (format, 200, 150, true, SoftwareImageType());
+                Graphics g (image);
+                g.fillAll (Colours::white.withAlpha (0.5f));
+
+                for (auto type : allFillTypes)
+                {
+                    for (auto opacity : { 1.0f, 0.6f })
+                    {
+                        const auto index = (int) type;
+                        fill (g, type, { 5 + index * 30, opacity < 1.0f ? 10 : 70, 53, 61 }, source, opacity);
+                    }
+                }
+
+                Path path;
+                path.addStar ({ 100.0f, 75.0f }, 7, 20.0f, 70.0f);
+                g.setGradientFill (ColourGradient (Colours::black, 0.0f, 0.0f, Colours::cyan.withAlpha (0.4f), 200.0f, 150.0f, false));
+                g.fillPath (path);
+
+                return image;
+            };
+
+            for (auto format : { Image::ARGB, Image::RGB })
+            {
+                const auto expected = [&]
+                {
+                    const ScopedInstructionSet scope (InstructionSet::scalar);
+                    return render (format);
+                }();
+
+                for (auto set : getAvailableInstructionSets())
+                {
+                    const ScopedInstructionSet scope (set);
+                    expect (imagesAreIdentical (render (format), expected), getInstructionSetName (set));
+                }
+            }
+        }
+    }
+
+private:
+    void testBlending()
+    {
+        using namespace PixelSpanTestHelpers;
+
+        auto random = getRandom();
+
+        for (int iteration = 0; iteration < 200; ++iteration)
+        {
+            const auto num = random.nextInt (70);
+            const auto offset = random.nextInt (8);
+
+            std::vector<PixelARGB> dest ((size_t) (num + offset)), src ((size_t) (num + offset));
+
+            for (size_t i = 0; i < dest.size(); ++i)
+            {
+                dest[i] = randomPixel (random);
+                src[i] = randomPixel (random);
+            }
+
+            const auto colour = randomPixel (random);
+            const auto extraAlpha = (uint32) random.nextInt (257);
+
+            auto expectedSolid = dest, expectedSpan = dest, expectedExtra = dest;
+            auto solid = dest, span = dest, extra = dest;
+
+            for (int i = offset; i < offset + num; ++i)
+            {
+                expectedSolid[(size_t) i].blend (colour);
+                expectedSpan[(size_t) i].blend (src[(size_t) i]);
+                expectedExtra[(size_t) i].blend (src[(size_t) i], extraAlpha);
+            }
+
+            PixelSpanOperations::blend (solid.data() + offset, colour, num);
+            PixelSpanOperations::blend (span.data() + offset, src.data() + offset, num);
+            PixelSpanOperations::blend (extra.data() + offset, src.data() + offset, num, extraAlpha);
+
+            expect (pixelsMatch (solid, expectedSolid));
+            expect (pixelsMatch (span, expectedSpan));
+            expect (pixelsMatch (extra, expectedExtra), "extra alpha " + String (extraAlpha));
+        }
+    }
+
+    void testGradients()
+    {
+        auto random = getRandom();
+
+        for (int iteration = 0; iteration < 50; ++iteration)
+        {
+            const auto randomPoint = [&] { return Point<float> (random.nextFloat() * 400.0f - 50.0f, random.nextFloat() * 300.0f - 50.0f); };
+
+            ColourGradient gradient (Colours::red, randomPoint(), Colours::blue.withAlpha (0.5f), randomPoint(), false);
+            gradient.addColour (0.4, Colours::green);
+
+            HeapBlock<PixelARGB> lookupTable;
+            const auto numEntries = gradient.createLookupTable (AffineTransform(), lookupTable);
+
+            const auto x = random.nextInt (300) - 30, y = random.nextInt (300) - 30;
+            const auto num = 1 + random.nextInt (200);
+
+            {
+                GradientPixelIterators::Linear linear (gradient, AffineTransform::rotation (random.nextFloat()), lookupTable, numEntries - 1);
+                linear.setY (y);
+                expect (getPixelsMatches (linear, x, num), "linear");
+            }
+
+            {
+                GradientPixelIterators::Radial radial (gradient, AffineTransform(), lookupTable, numEntries - 1);
+                radial.setY (y);
+                expect (getPixelsMatches (radial, x, num), "radial");
+            }
+
+            {
+                GradientPixelIterators::TransformedRadial radial (gradient, AffineTransform::scale (1.5f, 0.7f), lookupTable, numEntries - 1);
+                radial.setY (y);
+                expect (getPixelsMatches (radial, x, num), "transformed radial");
+            }
+        }
+    }
+
+    template <typename Iterator>
+    static bool getPixelsMatches (const Iterator& iterator, int x, int num)
+    {
+        std::vector<PixelARGB> pixels ((size_t) num);
+        iterator.getPixels (pixels.data(), x, num);
+
+        for (int i = 0; i < num; ++i)
+            if (pixels[(size_t) i].getNativeARGB() != iterator.getPixel (x + i).getNativeARGB())
+                return false;
+
+        return true;
+    }
+
+    static bool pixelsMatch (const std::vector<PixelARGB>& a, const std::vector<PixelARGB>& b)
+    {
+        return std::equal (a.begin(), a.end(), b.begin(), b.end(),
+                           [] (PixelARGB x, PixelARGB y) { return x.getNativeARGB() == y.getNativeARGB(); });
+    }
+
+    static bool imagesAreIdentical (const Image& a, const Image& b)
+    {
+        const Image::BitmapData dataA (a, Image::BitmapData::readOnly), dataB (b, Image::BitmapData::readOnly);
+
+        for (int y = 0; y < dataA.height; ++y)
+            if (memcmp (dataA.getLinePointer (y), dataB.getLinePointer (y), (size_t) (dataA.width * dataA.pixelStride)) != 0)
+                return false;
+
+        return true;
+    }
+};
+
+static PixelSpanOperationsTests pixelSpanOperationsTests;
+
+//==============================================================================
+class PixelSpanOperationsBenchmarks  : public UnitTest
+{
+public:
+    PixelSpanOperationsBenchmarks()
+        : UnitTest ("PixelSpanOperations throughput", UnitTestCategories::benchmarks)
+    {}
+
+    void runTest() override
+    {
+        using namespace PixelSpanTestHelpers;
+
+        beginTest ("Rasterising spans of each fill type");
+
+        auto random = getRandom();
+        const auto source = createSourceImage (random, 1024, 64);
+        Image image (Image::ARGB, 1024, 64, true, SoftwareImageType());
+
+        for (auto type : allFillTypes)
+        {
+            for (auto width : { 4, 16, 64, 256, 1024 })
+            {
+                String message;
+                message << getFillTypeName (type) << ", spans of " << width << " pixels, ns per pixel:";
+
+                const auto numRepeats = jmax (4, 8192 / width);
+                const auto numPixels = (double) numRepeats * width * image.getHeight();
+                double scalarTime = 0.0;
+
+                for (auto set : getAvailableInstructionSets())
+                {
+                    const ScopedInstructionSet scope (set);
+                    Graphics g (image);
+
+                    const auto start = Time::getHighResolutionTicks();
+
+                    for (int i = 0; i < numRepeats; ++i)
+                        fill (g, type, { (i * 13) % (image.getWidth() - width + 1), 0, width, image.getHeight() }, source, 0.7f);
+
+                    const auto time = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e9 / numPixels;
+
+                    if (set == InstructionSet::scalar)
+                        scalarTime = time;
+
+                    message << " " << getInstructionSetName (set) << " " << String (time, 3);
+
+                    if (set != InstructionSet::scalar)
+                        message << " (" << String (scalarTime / time, 2) << "x)";
+                }
+
+                logMessage (message);
+            }
+        }
+    }
+};
+
+static PixelSpanOperationsBenchmarks pixelSpanOperationsBenchmarks;
+
+} // namespace RenderingHelpers
+} // namespace juce
@@ -301,7 +301,8 @@ public:
 
     Font font;
     std::unique_ptr<EdgeTable> edgeTable;
-    int glyph = 0, lastAccessCount = 0;
+    int glyph = 0;
+    std::atomic<int> lastAccessCount { 0 };
     bool snapToIntegerCoordinate = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedGlyphEdgeTable)
@@ -398,6 +399,38 @@ struct FloatRectangleRasterisingInfo
     int topAlpha, leftAlpha, bottomAlpha, rightAlpha; // alpha of each anti-aliased edge
 };
 
+//==============================================================================
+/** Operations on runs of adjacent PixelARGB values, which use SIMD instructions where
+    the CPU supports them.
+
+    The results are identical to doing the same thing one pixel at a time, so the fill
+    types below use these for any spans of 32-bit pixels that are packed together.
+*/
+struct JUCE_API PixelSpanOperations
+{
+    /** Blends a colour onto some pixels, as PixelARGB::blend() does. */
+    static void blend (PixelARGB* dest, PixelARGB colour, int numPixels) noexcept;
+
+    /** Blends some pixels onto others, as PixelARGB::blend() does. */
+    static void blend (PixelARGB* dest, const PixelARGB* src, int numPixels) noexcept;
+
+    /** Blends some pixels onto others with an extra alpha of up to 256, as PixelARGB::blend() does. */
+    static void blend (PixelARGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+
+    /** Fills some pixels from a gradient's lookup table, using the entry at
+        (position + i * increment) >> numScaleBits for pixel i, limited to the range 0 to numEntries.
+    */
+    static void lookUpLinearGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                      int position, int increment, int numScaleBits, int numPixels) noexcept;
+
+    /** Fills some pixels from a radial gradient's lookup table, starting with pixel x of a line
+        whose squared distance from the centre is dySquared, as GradientPixelIterators::Radial does.
+    */
+    static void lookUpRadialGradient (PixelARGB* dest, const PixelARGB* lookupTable, int numEntries,
+                                      int x, double centreX, double dySquared, double maxDistSquared,
+                                      double invScale, int numPixels) noexcept;
+};
+
 //==============================================================================
 /** Contains classes for calculating the colour of pixels within various types of gradient. */
 namespace GradientPixelIterators
@@ -461,6 +494,14 @@ namespace GradientPixelIterators
                             : lookupTable[jlimit (0, numEntries, (x * scale - start) >> (int) numScaleBits)];
         }
 
+        void getPixels (PixelARGB* dest, int x, int num) const noexcept
+        {
+            if (vertical)
+                std::fill (dest, dest + num, linePix);
+            else
+                PixelSpanOperations::lookUpLinearGradient (dest, lookupTable, numEntries, x * scale - start, scale, (int) numScaleBits, num);
+        }
+
         const PixelARGB* const lookupTable;
         const int numEntries;
         PixelARGB linePix;
@@ -505,6 +546,11 @@ namespace GradientPixelIterators
             return lookupTable[x >= maxDist ? numEntries : roundToInt (std::sqrt (x) * invScale)];
         }
 
+        void getPixels (PixelARGB* dest, int x, int num) const noexcept
+        {
+            PixelSpanOperations::lookUpRadialGradient (dest, lookupTable, numEntries, x, gx1, dy, maxDist, invScale, num);
+        }
+
         const PixelARGB* const lookupTable;
         const int numEntries;
         const double gx1, gy1;
@@ -547,6 +593,12 @@ namespace GradientPixelIterators
             return lookupTable[jmin (numEntries, roundToInt (std::sqrt (x) * invScale))];
         }
 
+        void getPixels (PixelARGB* dest, int x, int num) const noexcept
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i] = getPixel (x + i);
+        }
+
     private:
         double tM10, tM00, lineYM01, lineYM11;
         const AffineTransform inverseTransform;
@@ -665,11 +717,20 @@ namespace EdgeTableFillers
             return addBytesToPointer (linePixels, x * destData.pixelStride);
         }
 
-        inline void blendLine (PixelType* dest, PixelARGB colour, int width) const noexcept
+        template <class DestPixelType>
+        inline void blendLine (DestPixelType* dest, PixelARGB colour, int width) const noexcept
         {
             JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
         }
 
+        inline void blendLine (PixelARGB* dest, PixelARGB colour, int width) const noexcept
+        {
+            if ((size_t) destData.pixelStride == sizeof (*dest))
+                PixelSpanOperations::blend (dest, colour, width);
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
+        }
+
         forcedinline void replaceLine (PixelRGB* dest, PixelARGB colour, int width) const noexcept
         {
             if ((size_t) destData.pixelStride == sizeof (*dest) && areRGBComponentsEqual)
@@ -724,18 +785,12 @@ namespace EdgeTableFillers
 
         void handleEdgeTableLine (int x, int width, int alphaLevel) const noexcept
         {
-            auto* dest = getPixel (x);
-
-            if (alphaLevel < 0xff)
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
-            else
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+            blendLine (getPixel (x), x, width, alphaLevel);
         }
 
         void handleEdgeTableLineFull (int x, int width) const noexcept
         {
-            auto* dest = getPixel (x);
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+            blendLine (getPixel (x), x, width, 0xff);
         }
 
         void handleEdgeTableRectangle (int x, int y, int width, int height, int alphaLevel) noexcept
@@ -765,6 +820,42 @@ namespace EdgeTableFillers
             return addBytesToPointer (linePixels, x * destData.pixelStride);
         }
 
+        template <class DestPixelType>
+        void blendLine (DestPixelType* dest, int x, int width, int alphaLevel) const noexcept
+        {
+            if (alphaLevel < 0xff)
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
+            else
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+        }
+
+        void blendLine (PixelARGB* dest, int x, int width, int alphaLevel) const noexcept
+        {
+            if ((size_t) destData.pixelStride != sizeof (*dest))
+            {
+                blendLine<PixelARGB> (dest, x, width, alphaLevel);
+                return;
+            }
+
+            // The colours are looked up in batches, and then blended all at once
+            PixelARGB colours[128];
+
+            while (width > 0)
+            {
+                const auto num = jmin (width, (int) numElementsInArray (colours));
+                GradientType::getPixels (colours, x, num);
+
+                if (alphaLevel < 0xff)
+                    PixelSpanOperations::blend (dest, colours, num, (uint32) alphaLevel);
+                else
+                    PixelSpanOperations::blend (dest, colours, num);
+
+                dest += num;
+                x += num;
+                width -= num;
+            }
+        }
+
         JUCE_DECLARE_NON_COPYABLE (Gradient)
     };
 
@@ -814,7 +905,9 @@ namespace EdgeTableFillers
             alphaLevel = (alphaLevel * extraAlpha) >> 8;
             x -= xOffset;
 
-            if (repeatPattern)
+            if (canBlendSpans())
+                blendSpans (dest, x, width, alphaLevel);
+            else if (repeatPattern)
             {
                 if (alphaLevel < 0xfe)
                     JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) alphaLevel))
@@ -837,7 +930,9 @@ namespace EdgeTableFillers
             auto* dest = getDestPixel (x);
             x -= xOffset;
 
-            if (repeatPattern)
+            if (canBlendSpans())
+                blendSpans (dest, x, width, extraAlpha);
+            else if (repeatPattern)
             {
                 if (extraAlpha < 0xfe)
                     JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) extraAlpha))
@@ -902,6 +997,37 @@ namespace EdgeTableFillers
             return addBytesToPointer (sourceLineStart, x * srcData.pixelStride);
         }
 
+        bool canBlendSpans() const noexcept
+        {
+            return std::is_same<DestPixelType, PixelARGB>::value && std::is_same<SrcPixelType, PixelARGB>::value
+                    && (size_t) destData.pixelStride == sizeof (PixelARGB)
+                    && (size_t) srcData.pixelStride == sizeof (PixelARGB);
+        }
+
+        // Only called when both images are packed PixelARGBs, and x is relative to the source image
+        void blendSpans (DestPixelType* dest, int x, int width, int alphaLevel) const noexcept
+        {
+            while (width > 0)
+            {
+                const auto srcX = repeatPattern ? x % srcData.width : x;
+                const auto num = repeatPattern ? jmin (width, srcData.width - srcX) : width;
+
+                jassert (srcX >= 0 && srcX + num <= srcData.width);
+
+                auto* d = reinterpret_cast<PixelARGB*> (dest);
+                auto* s = reinterpret_cast<const PixelARGB*> (getSrcPixel (srcX));
+
+                if (alphaLevel < 0xfe)
+                    PixelSpanOperations::blend (d, s, num, (uint32) alphaLevel);
+                else
+                    PixelSpanOperations::blend (d, s, num);
+
+                dest += num;
+                x += num;
+                width -= num;
+            }
+        }
+
         forcedinline void copyRow (DestPixelType* dest, SrcPixelType const* src, int width) const noexcept
         {
             auto destStride = destData.pixelStride;
@@ -984,7 +1110,18 @@ namespace EdgeTableFillers
             alphaLevel *= extraAlpha;
             alphaLevel >>= 8;
 
-            if (alphaLevel < 0xfe)
+            if (std::is_same<DestPixelType, PixelARGB>::value && std::is_same<SrcPixelType, PixelARGB>::value
+                 && (size_t) destData.pixelStride == sizeof (PixelARGB))
+            {
+                auto* d = reinterpret_cast<PixelARGB*> (dest);
+                auto* s = reinterpret_cast<const PixelARGB*> (span);
+
+                if (alphaLevel < 0xfe)
+                    PixelSpanOperations::blend (d, s, width, (uint32) alphaLevel);
+                else
+                    PixelSpanOperations::blend (d, s, width);
+            }
+            else if (alphaLevel < 0xfe)
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++, (uint32) alphaLevel))
             else
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++))
@@ -2547,34 +2684,46 @@ public:
                 }
                 else
                 {
-                    pos = transform.transformed (pos);
-
-                    Font f (font);
-                    f.setHeight (font.getHeight() * transform.complexTransform.mat11);
-
-                    auto xScale = transform.complexTransform.mat00 / transform.complexTransform.mat11;
-
-                    if (std::abs (xScale - 1.0f) > 0.01f)
-                        f.setHorizontalScale (xScale);
-
-                    cache.drawGlyph (*this, f, glyphNumber, pos);
+                    cache.drawGlyph (*this, getScaledFontForGlyphCache(), glyphNumber, transform.transformed (pos));
                 }
             }
             else
             {
-                auto fontHeight = font.getHeight();
-
-                auto t = transform.getTransformWith (AffineTransform::scale (fontHeight * font.getHorizontalScale(), fontHeight)
-                                                                     .followedBy (trans));
-
-                std::unique_ptr<EdgeTable> et (font.getTypefacePtr()->getEdgeTableForGlyph (glyphNumber, t, fontHeight));
-
-                if (et != nullptr)
+                if (auto et = createEdgeTableForGlyph (glyphNumber, trans))
                     fillShape (*new EdgeTableRegionType (*et), false);
             }
         }
     }
 
+    /** Returns the font that drawGlyph() looks up in the glyph cache when the transform
+        is scaled but not rotated.
+    */
+    Font getScaledFontForGlyphCache() const
+    {
+        Font f (font);
+        f.setHeight (font.getHeight() * transform.complexTransform.mat11);
+
+        auto xScale = transform.complexTransform.mat00 / transform.complexTransform.mat11;
+
+        if (std::abs (xScale - 1.0f) > 0.01f)
+            f.setHorizontalScale (xScale);
+
+        return f;
+    }
+
+    /** Creates the edge table that drawGlyph() fills for a glyph that can't be drawn
+        from the glyph cache.
+    */
+    std::unique_ptr<EdgeTable> createEdgeTableForGlyph (int glyphNumber, const AffineTransform& trans) const
+    {
+        auto fontHeight = font.getHeight();
+
+        auto t = transform.getTransformWith (AffineTransform::scale (fontHeight * font.getHorizontalScale(), fontHeight)
+                                                             .followedBy (trans));
+
+        return std::unique_ptr<EdgeTable> (font.getTypefacePtr()->getEdgeTableForGlyph (glyphNumber, t, fontHeight));
+    }
+
     Rectangle<int> getMaximumBounds() const     { return image.getBounds(); }
 
     //==============================================================================
@@ -323,6 +323,13 @@ struct Component::ComponentHelpers
         return t;
     }
 
+    // The statistics of the frame that a ComponentPeer is currently painting, if any
+    static ComponentPeer::FrameStatistics*& getFrameStatisticsForCurrentPaint() noexcept
+    {
+        static ComponentPeer::FrameStatistics* statistics = nullptr;
+        return statistics;
+    }
+
     //==============================================================================
     static bool hitTest (Component& comp, Point<float> localPoint)
     {
@@ -907,6 +914,85 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StandardCachedComponentImage)
 };
 
+//==============================================================================
+struct Component::RetainedLayer
+{
+    void paint (Component& owner, Graphics& g)
+    {
+        const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const auto compBounds = owner.getLocalBounds();
+        const auto imageBounds = compBounds * scale;
+
+        if (image.isNull() || image.getBounds() != imageBounds || image.hasAlphaChannel() == owner.isOpaque())
+        {
+            image = Image (owner.isOpaque() ? Image::RGB
+                                            : Image::ARGB,
+                           jmax (1, imageBounds.getWidth()),
+                           jmax (1, imageBounds.getHeight()),
+                           ! owner.isOpaque());
+
+            validArea.clear();
+        }
+
+        auto* statistics = ComponentHelpers::getFrameStatisticsForCurrentPaint();
+
+        if (! validArea.containsRectangle (compBounds))
+        {
+            Graphics imG (image);
+            auto& lg = imG.getInternalContext();
+
+            lg.addTransform (AffineTransform::scale (scale));
+
+            for (auto& i : validArea)
+                lg.excludeClipRectangle (i);
+
+            if (! owner.isOpaque())
+            {
+                lg.setFill (Colours::transparentBlack);
+                lg.fillRect (compBounds, true);
+                lg.setFill (Colours::black);
+            }
+
+            owner.paint (imG);
+            validArea = compBounds;
+
+            if (statistics != nullptr)
+                ++statistics->numLayersRepainted;
+        }
+        else if (statistics != nullptr)
+        {
+            ++statistics->numLayersReused;
+        }
+
+        // Any alpha has already been applied by paintEntireComponent()
+        g.setColour (Colours::black);
+        g.drawImageTransformed (image, AffineTransform::scale ((float) compBounds.getWidth()  / (float) image.getWidth(),
+                                                               (float) compBounds.getHeight() / (float) image.getHeight()), false);
+    }
+
+    void invalidateAll()                            { validArea.clear(); }
+    void invalidate (Rectangle<int> area)           { validArea.subtract (area); }
+
+    Image image;
+    RectangleList<int> validArea;
+};
+
+void Component::setRetainedLayer (bool shouldBeRetainedLayer)
+{
+    if (shouldBeRetainedLayer == isRetainedLayer())
+        return;
+
+    if (shouldBeRetainedLayer)
+        retainedLayer = std::make_unique<RetainedLayer>();
+    else
+        retainedLayer.reset();
+}
+
+bool Component::isRetainedLayer() const noexcept
+{
+    return retainedLayer != nullptr;
+}
+
 void Component::setCachedComponentImage (CachedComponentImage* newCachedImage)
 {
     if (cachedImage.get() != newCachedImage)
@@ -1344,28 +1430,30 @@ void Component::setTransform (const AffineTransform& newTransform)
     // and there will be all sorts of maths errors when converting coordinates.
     jassert (! newTransform.isSingularity());
 
+    // The area is repainted without invalidating a retained layer, which will be
+    // drawn again with the new transform
     if (newTransform.isIdentity())
     {
         if (affineTransform != nullptr)
         {
-            repaint();
+            internalRepaintUnchecked (getLocalBounds(), true);
             affineTransform.reset();
-            repaint();
+            internalRepaintUnchecked (getLocalBounds(), true);
             sendMovedResizedMessages (false, false);
         }
     }
     else if (affineTransform == nullptr)
     {
-        repaint();
+        internalRepaintUnchecked (getLocalBounds(), true);
         affineTransform.reset (new AffineTransform (newTransform));
-        repaint();
+        internalRepaintUnchecked (getLocalBounds(), true);
         sendMovedResizedMessages (false, false);
     }
     else if (*affineTransform != newTransform)
     {
-        repaint();
+        internalRepaintUnchecked (getLocalBounds(), true);
         *affineTransform = newTransform;
-        repaint();
+        internalRepaintUnchecked (getLocalBounds(), true);
         sendMovedResizedMessages (false, false);
     }
 }
@@ -1909,23 +1997,34 @@ void Component::alphaChanged()
     }
     else
     {
-        repaint();
+        // (this doesn't change the content of a retained layer)
+        internalRepaintUnchecked (getLocalBounds(), true);
     }
 }
 
 //==============================================================================
 void Component::repaint()
 {
+    PaintProfiler::repaintRequested (*this, getLocalBounds());
+
+    if (retainedLayer != nullptr)
+        retainedLayer->invalidateAll();
+
     internalRepaintUnchecked (getLocalBounds(), true);
 }
 
 void Component::repaint (int x, int y, int w, int h)
 {
-    internalRepaint ({ x, y, w, h });
+    repaint ({ x, y, w, h });
 }
 
 void Component::repaint (Rectangle<int> area)
 {
+    PaintProfiler::repaintRequested (*this, area);
+
+    if (retainedLayer != nullptr)
+        retainedLayer->invalidate (area);
+
     internalRepaint (area);
 }
 
@@ -2007,16 +2106,26 @@ void Component::paintComponentAndChildren (Graphics& g)
 {
     auto clipBounds = g.getClipBounds();
 
+    const auto paintContent = [this, &g]
+    {
+        const PaintProfiler::ScopedPaintEvent profilerEvent (*this, g, PaintProfiler::EventType::paint);
+
+        if (retainedLayer != nullptr)
+            retainedLayer->paint (*this, g);
+        else
+            paint (g);
+    };
+
     if (flags.dontClipGraphicsFlag && getNumChildComponents() == 0)
     {
-        paint (g);
+        paintContent();
     }
     else
     {
         Graphics::ScopedSaveState ss (g);
 
         if (! (ComponentHelpers::clipObscuredRegions (*this, g, clipBounds, {}) && g.isClipEmpty()))
-            paint (g);
+            paintContent();
     }
 
     for (int i = 0; i < childComponentList.size(); ++i)
@@ -2065,6 +2174,7 @@ void Component::paintComponentAndChildren (Graphics& g)
     }
 
     Graphics::ScopedSaveState ss (g);
+    const PaintProfiler::ScopedPaintEvent profilerEvent (*this, g, PaintProfiler::EventType::paintOverChildren);
     paintOverChildren (g);
 }
 
@@ -1015,6 +1015,8 @@ public:
         If the setBufferedToImage() method has been used to cause this component to use a
         buffer, the repaint() call will invalidate the cached buffer. If setCachedComponentImage()
         has been used to provide a custom image cache, that cache will be invalidated appropriately.
+        If setRetainedLayer() has been used, the component's retained layer will also be
+        invalidated.
 
         To redraw just a subsection of the component rather than the whole thing,
         use the repaint (int, int, int, int) method.
@@ -1068,6 +1070,28 @@ public:
     */
     void setBufferedToImage (bool shouldBeBuffered);
 
+    /** Makes the component keep the output of its paint() method in a retained layer.
+
+        When this is enabled, whatever the component's paint() method draws is kept in
+        an image, and is redrawn from that image until part of it is invalidated. Unlike
+        setBufferedToImage(), the layer only holds the component's own content: its
+        children and paintOverChildren() are still drawn over it as normal, so a child
+        that repaints itself frequently, such as a level meter, won't cause paint() to be
+        called again for a static background behind it.
+
+        The layer is only invalidated by calling repaint() on this component, by resizing
+        it, or when the scale at which it's drawn changes. Moving the component or changing
+        its alpha or transform just draws the layer again, without calling paint().
+
+        @see isRetainedLayer, setBufferedToImage, ComponentPeer::getFrameStatistics
+    */
+    void setRetainedLayer (bool shouldBeRetainedLayer);
+
+    /** Returns true if setRetainedLayer() has been used to give this component a
+        retained layer.
+    */
+    bool isRetainedLayer() const noexcept;
+
     /** Generates a snapshot of part of this component.
 
         This will return a new Image, the size of the rectangle specified,
@@ -2542,6 +2566,9 @@ private:
     ImageEffectFilter* effect = nullptr;
     std::unique_ptr<CachedComponentImage> cachedImage;
 
+    struct RetainedLayer;
+    std::unique_ptr<RetainedLayer> retainedLayer;
+
     class MouseListenerList;
     std::unique_ptr<MouseListenerList> mouseListeners;
     std::unique_ptr<Array<KeyListener*>> keyListeners;
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class ComponentRetainedLayerTests  : public UnitTest
+{
+public:
+    ComponentRetainedLayerTests()
+        : UnitTest ("Component retained layers", UnitTestCategories::gui)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("A layer's paint() isn't called again until the layer is invalidated");
+        {
+            TestComponent parent, child;
+            parent.setBounds (0, 0, 100, 80);
+            child.setBounds (20, 20, 30, 30);
+            parent.addAndMakeVisible (child);
+            parent.setVisible (true);
+            parent.setRetainedLayer (true);
+
+            expect (parent.isRetainedLayer());
+            expect (! child.isRetainedLayer());
+
+            snapshot (parent);
+            snapshot (parent);
+            expectEquals (parent.numPaints, 1);
+            expectEquals (child.numPaints, 2);
+
+            child.repaint();
+            snapshot (parent);
+            expectEquals (parent.numPaints, 1);
+            expectEquals (child.numPaints, 3);
+
+            parent.repaint (10, 10, 20, 20);
+            snapshot (parent);
+            expectEquals (parent.numPaints, 2);
+            expect (parent.lastClipBounds == Rectangle<int> (10, 10, 20, 20));
+
+            parent.repaint();
+            snapshot (parent);
+            expectEquals (parent.numPaints, 3);
+            expect (parent.lastClipBounds == parent.getLocalBounds());
+
+            parent.setRetainedLayer (false);
+            snapshot (parent);
+            snapshot (parent);
+            expectEquals (parent.numPaints, 5);
+        }
+
+        beginTest ("Moving, fading and transforming a layer don't call paint()");
+        {
+            TestComponent parent, child;
+            parent.setBounds (0, 0, 100, 80);
+            child.setBounds (20, 20, 30, 30);
+            parent.addAndMakeVisible (child);
+            parent.setVisible (true);
+            child.setRetainedLayer (true);
+
+            snapshot (parent);
+            expectEquals (child.numPaints, 1);
+
+            child.setTopLeftPosition (30, 25);
+            child.setAlpha (0.5f);
+            child.setTransform (AffineTransform::rotation (0.3f, 40.0f, 40.0f));
+            snapshot (parent);
+            expectEquals (child.numPaints, 1);
+            expectEquals (parent.numPaints, 2);
+
+            child.setSize (40, 40);
+            snapshot (parent);
+            expectEquals (child.numPaints, 2);
+        }
+
+        beginTest ("Layers draw the same pixels as calling paint()");
+        {
+            const auto render = [this] (bool useLayers)
+            {
+                TestComponent parent, child, grandchild;
+                parent.setBounds (0, 0, 120, 90);
+                child.setBounds (10, 15, 60, 50);
+                grandchild.setBounds (5, 5, 30, 20);
+                child.colour = Colours::red.withAlpha (0.6f);
+                grandchild.colour = Colours::green;
+                child.setAlpha (0.7f);
+
+                parent.addAndMakeVisible (child);
+                child.addAndMakeVisible (grandchild);
+                parent.setVisible (true);
+
+                for (auto* c : { &parent, &child, &grandchild })
+                    c->setRetainedLayer (useLayers);
+
+                // The second snapshot is drawn from the layers, if there are any
+                snapshot (parent);
+                grandchild.repaint();
+                return snapshot (parent);
+            };
+
+            const auto expected = render (false);
+            const auto result = render (true);
+
+            int numDifferentPixels = 0;
+
+            for (int y = 0; y < expected.getHeight(); ++y)
+                for (int x = 0; x < expected.getWidth(); ++x)
+                    if (expected.getPixelAt (x, y) != result.getPixelAt (x, y))
+                        ++numDifferentPixels;
+
+            expectEquals (numDifferentPixels, 0);
+        }
+    }
+
+private:
+    struct TestComponent  : public Component
+    {
+        void paint (Graphics& g) override
+        {
+            ++numPaints;
+            lastClipBounds = g.getClipBounds();
+
+            g.fillAll (colour);
+            g.setColour (Colours::white);
+            g.drawEllipse (getLocalBounds().reduced (3).toFloat(), 2.0f);
+        }
+
+        Colour colour { Colours::darkblue };
+        int numPaints = 0;
+        Rectangle<int> lastClipBounds;
+    };
+
+    static Image snapshot (Component& c)
+    {
+        return c.createComponentSnapshot (c.getLocalBounds());
+    }
+};
+
+static ComponentRetainedLayerTests componentRetainedLayerTests;
+
+} // namespace juce
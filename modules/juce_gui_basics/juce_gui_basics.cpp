@@ -47,6 +47,10 @@
 
 #include <cctype>
 
+#if JUCE_GCC || (JUCE_CLANG && ! JUCE_WINDOWS)
+ #include <cxxabi.h>
+#endif
+
 //==============================================================================
 #if JUCE_MAC
  #import <WebKit/WebKit.h>
@@ -247,6 +251,7 @@ namespace juce
 #include "windows/juce_AlertWindow.cpp"
 #include "windows/juce_CallOutBox.cpp"
 #include "windows/juce_ComponentPeer.cpp"
+#include "windows/juce_PaintProfiler.cpp"
 #include "windows/juce_DialogWindow.cpp"
 #include "windows/juce_DocumentWindow.cpp"
 #include "windows/juce_ResizableWindow.cpp"
@@ -423,5 +428,7 @@ bool juce::isWindowOnCurrentVirtualDesktop (void* x)
 #include "mouse/juce_MouseCursor.cpp"
 
 #if JUCE_UNIT_TESTS
+#include "components/juce_Component_test.cpp"
+#include "windows/juce_PaintProfiler_test.cpp"
 #include "native/accessibility/juce_AccessibilityTextHelpers_test.cpp"
 #endif
@@ -272,6 +272,7 @@ namespace juce
 #include "windows/juce_AlertWindow.h"
 #include "windows/juce_CallOutBox.h"
 #include "windows/juce_ComponentPeer.h"
+#include "windows/juce_PaintProfiler.h"
 #include "windows/juce_ResizableWindow.h"
 #include "windows/juce_DocumentWindow.h"
 #include "windows/juce_DialogWindow.h"
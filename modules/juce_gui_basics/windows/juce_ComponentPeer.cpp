@@ -105,6 +105,19 @@ void ComponentPeer::handleMagnifyGesture (MouseInputSource::InputSourceType type
 //==============================================================================
 void ComponentPeer::handlePaint (LowLevelGraphicsContext& contextToPaintTo)
 {
+    const auto startTicks = Time::getHighResolutionTicks();
+
+    frameStatistics.numLayersRepainted = 0;
+    frameStatistics.numLayersReused = 0;
+
+    const ScopedValueSetter<FrameStatistics*> statisticsSetter (Component::ComponentHelpers::getFrameStatisticsForCurrentPaint(),
+                                                               &frameStatistics);
+
+    auto* profiler = PaintProfiler::getActiveProfiler();
+
+    if (profiler != nullptr)
+        profiler->frameStarted (component);
+
     Graphics g (contextToPaintTo);
 
     if (component.isTransformed())
@@ -130,12 +143,32 @@ void ComponentPeer::handlePaint (LowLevelGraphicsContext& contextToPaintTo)
     }
   #endif
 
+    // The profiler's overlay needs the graphics state to be restored after painting
+    if (profiler != nullptr)
+        g.saveState();
+
     JUCE_TRY
     {
         component.paintEntireComponent (g, true);
     }
     JUCE_CATCH_EXCEPTION
 
+    const auto frameTicks = Time::getHighResolutionTicks() - startTicks;
+    const auto frameMilliseconds = Time::highResolutionTicksToSeconds (frameTicks) * 1000.0;
+
+    ++frameStatistics.numFrames;
+    frameStatistics.lastFrameMilliseconds = frameMilliseconds;
+    frameStatistics.averageFrameMilliseconds += (frameMilliseconds - frameStatistics.averageFrameMilliseconds) / frameStatistics.numFrames;
+    frameStatistics.maxFrameMilliseconds = jmax (frameStatistics.maxFrameMilliseconds, frameMilliseconds);
+
+    if (profiler != nullptr)
+    {
+        g.restoreState();
+
+        if (PaintProfiler::getActiveProfiler() == profiler)
+            profiler->frameFinished (g, g.getClipBounds(), startTicks, frameTicks);
+    }
+
   #if JUCE_ENABLE_REPAINT_DEBUGGING
    #ifdef JUCE_IS_REPAINT_DEBUGGING_ACTIVE
     if (JUCE_IS_REPAINT_DEBUGGING_ACTIVE)
@@ -306,6 +306,39 @@ public:
     /** This is called to repaint the component into the given context. */
     void handlePaint (LowLevelGraphicsContext& contextToPaintTo);
 
+    /** Timing information about the frames that a peer has painted.
+        @see getFrameStatistics, Component::setRetainedLayer
+    */
+    struct FrameStatistics
+    {
+        /** The number of frames painted since the statistics were last reset. */
+        int numFrames = 0;
+
+        /** The time taken to paint the most recent frame, in milliseconds. */
+        double lastFrameMilliseconds = 0.0;
+
+        /** The mean time taken to paint a frame, in milliseconds. */
+        double averageFrameMilliseconds = 0.0;
+
+        /** The longest time taken to paint a frame, in milliseconds. */
+        double maxFrameMilliseconds = 0.0;
+
+        /** The number of retained layers whose paint() method was called in the most recent frame. */
+        int numLayersRepainted = 0;
+
+        /** The number of retained layers that were drawn from their cached image in the most recent frame. */
+        int numLayersReused = 0;
+    };
+
+    /** Returns timing information about the frames that have been painted by handlePaint().
+        This only measures the time spent painting the components, and not the time that
+        the OS takes to display the result.
+    */
+    const FrameStatistics& getFrameStatistics() const noexcept      { return frameStatistics; }
+
+    /** Clears the information returned by getFrameStatistics(). */
+    void resetFrameStatistics() noexcept                            { frameStatistics = {}; }
+
     //==============================================================================
     /** Sets this window to either be always-on-top or normal.
         Some kinds of window might not be able to do this, so should return false.
@@ -556,6 +589,7 @@ private:
     TextInputTarget* textInputTarget = nullptr;
     const uint32 uniqueID;
     bool isWindowMinimised = false;
+    FrameStatistics frameStatistics;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ComponentPeer)
@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+static std::atomic<PaintProfiler*> activePaintProfiler { nullptr };
+
+//==============================================================================
+PaintProfiler::PaintProfiler (int maxNumEvents)
+    : fifo (jmax (1, maxNumEvents) + 1),
+      events ((size_t) fifo.getTotalSize()),
+      creationTicks (Time::getHighResolutionTicks())
+{
+}
+
+PaintProfiler::~PaintProfiler()
+{
+    stop();
+}
+
+PaintProfiler* PaintProfiler::getActiveProfiler() noexcept
+{
+    return activePaintProfiler.load (std::memory_order_relaxed);
+}
+
+void PaintProfiler::start()
+{
+    JUCE_ASSERT_MESSAGE_MANAGER_IS_LOCKED
+    activePaintProfiler = this;
+}
+
+void PaintProfiler::stop()
+{
+    auto* expected = this;
+    activePaintProfiler.compare_exchange_strong (expected, nullptr);
+}
+
+void PaintProfiler::setHeatMapOverlayEnabled (bool shouldBeEnabled) noexcept
+{
+    heatMapEnabled = shouldBeEnabled;
+}
+
+//==============================================================================
+String PaintProfiler::getComponentName (const Component& component)
+{
+    const auto& name = component.getName();
+
+    if (name.isNotEmpty())
+        return name;
+
+    const std::type_index type (typeid (component));
+    const auto existing = classNames.find (type);
+
+    if (existing != classNames.end())
+        return existing->second;
+
+    String className (type.name());
+
+   #if JUCE_GCC || (JUCE_CLANG && ! JUCE_WINDOWS)
+    int status = 0;
+
+    if (auto* demangled = abi::__cxa_demangle (type.name(), nullptr, nullptr, &status))
+    {
+        if (status == 0)
+            className = demangled;
+
+        std::free (demangled);
+    }
+   #endif
+
+    return classNames[type] = className;
+}
+
+void PaintProfiler::addEvent (EventType type, const Component& component, Rectangle<int> area,
+                              int64 startTicks, int64 durationTicks, int numRepaints)
+{
+    const auto scope = fifo.write (1);
+
+    if (scope.blockSize1 == 0)
+    {
+        ++numDroppedEvents;
+        return;
+    }
+
+    auto& e = events[(size_t) scope.startIndex1];
+    e.type = type;
+    e.frameNumber = frameNumber;
+    e.startTicks = startTicks;
+    e.durationTicks = durationTicks;
+    e.area = area;
+    e.numRepaintCalls = numRepaints;
+    e.component = &component;
+    e.componentName = getComponentName (component);
+}
+
+void PaintProfiler::readEvents (const std::function<void (const Event&)>& callback)
+{
+    const auto scope = fifo.read (fifo.getNumReady());
+    scope.forEach ([&] (int index) { callback (events[(size_t) index]); });
+}
+
+//==============================================================================
+PaintProfiler::ScopedPaintEvent::ScopedPaintEvent (const Component& c, Graphics& g, EventType t)
+    : profiler (getActiveProfiler()), component (c), type (t)
+{
+    if (profiler != nullptr)
+    {
+        area = g.getClipBounds();
+        startTicks = Time::getHighResolutionTicks();
+    }
+}
+
+PaintProfiler::ScopedPaintEvent::~ScopedPaintEvent()
+{
+    // The profiler may have been stopped by a paint method
+    if (profiler == nullptr || profiler != getActiveProfiler())
+        return;
+
+    const auto durationTicks = Time::getHighResolutionTicks() - startTicks;
+    profiler->addEvent (type, component, area, startTicks, durationTicks);
+
+    if (profiler->heatMapEnabled && profiler->currentFrameComponent != nullptr)
+        profiler->heatMap.push_back ({ profiler->currentFrameComponent->getLocalArea (&component, area), durationTicks });
+}
+
+void PaintProfiler::repaintRequested (const Component& component, Rectangle<int> area)
+{
+    if (auto* profiler = getActiveProfiler())
+    {
+        ++profiler->numRepaintCalls;
+        profiler->addEvent (EventType::repaint, component, area, Time::getHighResolutionTicks(), 0);
+    }
+}
+
+void PaintProfiler::frameStarted (Component& peerComponent)
+{
+    ++frameNumber;
+    currentFrameComponent = &peerComponent;
+    heatMap.clear();
+}
+
+void PaintProfiler::frameFinished (Graphics& g, Rectangle<int> area, int64 startTicks, int64 durationTicks)
+{
+    if (currentFrameComponent == nullptr)
+        return;
+
+    addEvent (EventType::frame, *currentFrameComponent, area, startTicks, durationTicks, std::exchange (numRepaintCalls, 0));
+
+    if (heatMapEnabled)
+        drawHeatMapOverlay (g);
+
+    currentFrameComponent = nullptr;
+}
+
+void PaintProfiler::drawHeatMapOverlay (Graphics& g) const
+{
+    // Paint times of a quarter of a 60Hz frame or more are shown in red
+    const auto slowTicks = Time::secondsToHighResolutionTicks (1.0 / 240.0);
+
+    for (auto& entry : heatMap)
+    {
+        const auto proportion = jlimit (0.0f, 1.0f, (float) entry.durationTicks / (float) slowTicks);
+
+        g.setColour (Colour::fromHSV ((1.0f - proportion) / 3.0f, 1.0f, 1.0f, 0.15f + 0.25f * proportion));
+        g.fillRect (entry.area);
+    }
+}
+
+//==============================================================================
+void PaintProfiler::writeChromeTrace (OutputStream& output)
+{
+    Array<var> traceEvents;
+
+    const auto toMicroseconds = [this] (int64 ticks, bool isTimestamp)
+    {
+        return Time::highResolutionTicksToSeconds (ticks - (isTimestamp ? creationTicks : 0)) * 1.0e6;
+    };
+
+    readEvents ([&] (const Event& e)
+    {
+        auto* traceEvent = new DynamicObject();
+        auto* args = new DynamicObject();
+
+        args->setProperty ("area", e.area.toString());
+        args->setProperty ("frame", e.frameNumber);
+
+        traceEvent->setProperty ("pid", 1);
+        traceEvent->setProperty ("tid", 1);
+        traceEvent->setProperty ("ts", toMicroseconds (e.startTicks, true));
+
+        switch (e.type)
+        {
+            case EventType::frame:
+                traceEvent->setProperty ("name", "Frame " + String (e.frameNumber));
+                traceEvent->setProperty ("cat", "frame");
+                args->setProperty ("component", e.componentName);
+                args->setProperty ("repaintCalls", e.numRepaintCalls);
+                break;
+
+            case EventType::paint:
+            case EventType::paintOverChildren:
+                traceEvent->setProperty ("name", e.componentName);
+                traceEvent->setProperty ("cat", e.type == EventType::paint ? "paint" : "paintOverChildren");
+                break;
+
+            case EventType::repaint:
+                traceEvent->setProperty ("name", "repaint " + e.componentName);
+                traceEvent->setProperty ("cat", "repaint");
+                break;
+        }
+
+        if (e.type == EventType::repaint)
+        {
+            traceEvent->setProperty ("ph", "i");
+            traceEvent->setProperty ("s", "t");
+        }
+        else
+        {
+            traceEvent->setProperty ("ph", "X");
+            traceEvent->setProperty ("dur", toMicroseconds (e.durationTicks, false));
+        }
+
+        traceEvent->setProperty ("args", var (args));
+        traceEvents.add (var (traceEvent));
+    });
+
+    auto* trace = new DynamicObject();
+    trace->setProperty ("traceEvents", traceEvents);
+    trace->setProperty ("displayTimeUnit", "ms");
+
+    JSON::writeToStream (output, var (trace), true);
+}
+
+bool PaintProfiler::writeChromeTrace (const File& file)
+{
+    FileOutputStream output (file);
+
+    if (! output.openedOk())
+        return false;
+
+    output.setPosition (0);
+    output.truncate();
+    writeChromeTrace (output);
+    output.flush();
+
+    return output.getStatus().wasOk();
+}
+
+} // namespace juce
@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Records how long components take to paint, and where and why they're repainted.
+
+    To use it, create a PaintProfiler and call start(). While it's recording, the
+    duration and area of every call to a component's paint() and paintOverChildren()
+    methods, every call to Component::repaint(), and every frame that a ComponentPeer
+    paints are added to a lock-free buffer. The events can then be read back with
+    readEvents(), or saved as a Chrome trace file with writeChromeTrace(), which can be
+    opened in chrome://tracing or Perfetto to find the components that dominate the
+    paint time, or that are repainted far more often than they need to be.
+
+    If the heat-map overlay is enabled, each window will also tint the areas painted by
+    each component, from green to red depending on how long their paint methods took.
+
+    The events are only recorded on the message thread, and the buffer has a fixed size,
+    so if it fills up, new events are dropped until some are read. When no profiler is
+    recording, the only cost to painting is a check of an atomic pointer.
+
+    @code
+    PaintProfiler profiler;
+    profiler.start();
+
+    // ...use the app for a while...
+
+    profiler.stop();
+    profiler.writeChromeTrace (File::getSpecialLocation (File::userDesktopDirectory)
+                                   .getChildFile ("paint-trace.json"));
+    @endcode
+
+    @see ComponentPeer::getFrameStatistics
+    @tags{GUI}
+*/
+class JUCE_API  PaintProfiler
+{
+public:
+    //==============================================================================
+    /** Creates a profiler that can hold up to the given number of unread events. */
+    explicit PaintProfiler (int maxNumEvents = 65536);
+
+    /** Destructor. If this is the active profiler, it will be stopped. */
+    ~PaintProfiler();
+
+    //==============================================================================
+    /** Starts recording. Only one profiler can record at a time, so if another one is
+        active, it will be stopped. This must be called on the message thread.
+    */
+    void start();
+
+    /** Stops recording. This must be called on the message thread. */
+    void stop();
+
+    /** Returns true if this profiler is currently recording. */
+    bool isRecording() const noexcept               { return getActiveProfiler() == this; }
+
+    /** Returns the profiler that is currently recording, or nullptr if there isn't one. */
+    static PaintProfiler* getActiveProfiler() noexcept;
+
+    //==============================================================================
+    /** Enables or disables a heat-map overlay, which is drawn over the areas of each
+        window that have been painted during a frame, while this profiler is recording.
+        This must be called on the message thread.
+    */
+    void setHeatMapOverlayEnabled (bool shouldBeEnabled) noexcept;
+
+    /** Returns true if the heat-map overlay is enabled.
+        @see setHeatMapOverlayEnabled
+    */
+    bool isHeatMapOverlayEnabled() const noexcept   { return heatMapEnabled; }
+
+    //==============================================================================
+    /** The kinds of event that are recorded. */
+    enum class EventType
+    {
+        frame,              /**< A ComponentPeer painted a frame. The area is the region that was painted, relative to the peer's component. */
+        paint,              /**< A component's paint() method was called. The area is its clip region, relative to the component. */
+        paintOverChildren,  /**< A component's paintOverChildren() method was called. The area is its clip region, relative to the component. */
+        repaint             /**< Component::repaint() was called. The area is the region passed to repaint(), relative to the component. */
+    };
+
+    /** A recorded event. */
+    struct Event
+    {
+        /** The kind of event. */
+        EventType type = EventType::paint;
+
+        /** The number of the frame in which this happened, counting from 1. Events that happen
+            between frames, or when painting outside a ComponentPeer (e.g. when creating a
+            snapshot), have the number of the preceding frame.
+        */
+        int frameNumber = 0;
+
+        /** The time at which the event began, in high-resolution ticks.
+            @see Time::getHighResolutionTicks
+        */
+        int64 startTicks = 0;
+
+        /** The event's duration in high-resolution ticks, or 0 for repaint events. */
+        int64 durationTicks = 0;
+
+        /** The area that was painted or repainted. */
+        Rectangle<int> area;
+
+        /** For frames, the number of calls to Component::repaint() since the previous frame. */
+        int numRepaintCalls = 0;
+
+        /** The component that was painted or repainted, or whose peer painted a frame.
+            This is only used to identify the component, and may have been deleted by the
+            time the event is read, so it mustn't be dereferenced.
+        */
+        const Component* component = nullptr;
+
+        /** The component's name, or its class name if it doesn't have one. */
+        String componentName;
+    };
+
+    /** Removes all the unread events from the buffer, passing each one to a callback in
+        the order in which they were recorded.
+
+        This can be called from any thread, but mustn't be called by more than one thread
+        at a time.
+    */
+    void readEvents (const std::function<void (const Event&)>& callback);
+
+    /** Removes all the unread events from the buffer, and writes them to a stream as a
+        JSON trace that can be loaded by chrome://tracing or Perfetto.
+        @see readEvents
+    */
+    void writeChromeTrace (OutputStream& output);
+
+    /** Removes all the unread events from the buffer, and writes them to a file as a
+        JSON trace that can be loaded by chrome://tracing or Perfetto.
+        Returns false if the file couldn't be written.
+        @see readEvents
+    */
+    bool writeChromeTrace (const File& file);
+
+    /** Returns the number of events that have been dropped because the buffer was full. */
+    int getNumDroppedEvents() const noexcept        { return numDroppedEvents.load(); }
+
+    //==============================================================================
+   #ifndef DOXYGEN
+    /** @internal */
+    struct ScopedPaintEvent
+    {
+        ScopedPaintEvent (const Component&, Graphics&, EventType);
+        ~ScopedPaintEvent();
+
+        PaintProfiler* const profiler;
+        const Component& component;
+        const EventType type;
+        Rectangle<int> area;
+        int64 startTicks = 0;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedPaintEvent)
+    };
+
+    /** @internal */
+    static void repaintRequested (const Component&, Rectangle<int> area);
+    /** @internal */
+    void frameStarted (Component& peerComponent);
+    /** @internal */
+    void frameFinished (Graphics&, Rectangle<int> area, int64 startTicks, int64 durationTicks);
+   #endif
+
+private:
+    //==============================================================================
+    struct HeatMapEntry
+    {
+        Rectangle<int> area;
+        int64 durationTicks;
+    };
+
+    void addEvent (EventType, const Component&, Rectangle<int>, int64 startTicks, int64 durationTicks, int numRepaintCalls = 0);
+    String getComponentName (const Component&);
+    void drawHeatMapOverlay (Graphics&) const;
+
+    AbstractFifo fifo;
+    std::vector<Event> events;
+    std::atomic<int> numDroppedEvents { 0 };
+
+    // These are only used on the message thread
+    int frameNumber = 0, numRepaintCalls = 0;
+    Component* currentFrameComponent = nullptr;
+    std::vector<HeatMapEntry> heatMap;
+    std::unordered_map<std::type_index, String> classNames;
+    bool heatMapEnabled = false;
+
+    const int64 creationTicks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PaintProfiler)
+};
+
+} // namespace juce
@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2022 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 7 End-User License
+   Agreement and JUCE Privacy Policy.
+
+   End User License Agreement: www.juce.com/juce-7-licence
+   Privacy Policy: www.juce.com/juce-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class PaintProfilerTests  : public UnitTest
+{
+public:
+    PaintProfilerTests()
+        : UnitTest ("PaintProfiler", UnitTestCategories::gui)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Paint and repaint events are recorded while profiling");
+        {
+            TestComponent parent, child;
+            parent.setName ("Parent");
+            parent.setBounds (0, 0, 100, 80);
+            child.setBounds (20, 10, 30, 40);
+            parent.addAndMakeVisible (child);
+            parent.setVisible (true);
+
+            PaintProfiler profiler;
+            parent.createComponentSnapshot (parent.getLocalBounds());
+            expect (readEvents (profiler).empty());
+
+            profiler.start();
+            expect (profiler.isRecording());
+            expect (PaintProfiler::getActiveProfiler() == &profiler);
+
+            child.repaint (1, 2, 3, 4);
+            parent.createComponentSnapshot (parent.getLocalBounds());
+            profiler.stop();
+
+            expect (! profiler.isRecording());
+            expect (PaintProfiler::getActiveProfiler() == nullptr);
+
+            const auto events = readEvents (profiler);
+            expectEquals ((int) events.size(), 5);
+
+            if (events.size() == 5)
+            {
+                expect (events[0].type == PaintProfiler::EventType::repaint);
+                expect (events[0].component == &child);
+                expect (events[0].area == Rectangle<int> (1, 2, 3, 4));
+
+                expect (events[1].type == PaintProfiler::EventType::paint);
+                expectEquals (events[1].componentName, String ("Parent"));
+                expect (events[1].area == parent.getLocalBounds());
+
+                expect (events[2].type == PaintProfiler::EventType::paint);
+                expect (events[2].component == &child);
+                expect (events[2].componentName.contains ("TestComponent"));
+                expect (events[2].area == child.getLocalBounds());
+
+                expect (events[3].type == PaintProfiler::EventType::paintOverChildren);
+                expect (events[3].component == &child);
+
+                expect (events[4].type == PaintProfiler::EventType::paintOverChildren);
+                expect (events[4].component == &parent);
+
+                for (auto& e : events)
+                    expect (e.durationTicks >= 0);
+            }
+
+            expect (readEvents (profiler).empty());
+        }
+
+        beginTest ("Events are dropped when the buffer is full");
+        {
+            TestComponent c;
+            PaintProfiler profiler (4);
+            profiler.start();
+
+            for (int i = 0; i < 10; ++i)
+                c.repaint();
+
+            profiler.stop();
+
+            expectEquals ((int) readEvents (profiler).size(), 4);
+            expectEquals (profiler.getNumDroppedEvents(), 6);
+        }
+
+        beginTest ("Starting a profiler stops the active one");
+        {
+            PaintProfiler first, second;
+            first.start();
+            second.start();
+
+            expect (! first.isRecording());
+            expect (second.isRecording());
+
+            first.stop();
+            expect (second.isRecording());
+        }
+
+        beginTest ("Frames count repaints and draw the heat-map overlay");
+        {
+            TestComponent c;
+            c.setBounds (0, 0, 50, 40);
+            c.setVisible (true);
+            c.colour = Colours::black;
+
+            PaintProfiler profiler;
+            profiler.setHeatMapOverlayEnabled (true);
+            profiler.start();
+
+            c.repaint();
+            c.repaint (0, 0, 5, 5);
+
+            Image image (Image::ARGB, 50, 40, true);
+            Graphics g (image);
+            const auto startTicks = Time::getHighResolutionTicks();
+
+            profiler.frameStarted (c);
+            c.paintEntireComponent (g, true);
+            profiler.frameFinished (g, c.getLocalBounds(), startTicks, Time::getHighResolutionTicks() - startTicks);
+            profiler.stop();
+
+            expect (image.getPixelAt (25, 20) != Colours::black);
+
+            const auto events = readEvents (profiler);
+            expect (! events.empty() && events.back().type == PaintProfiler::EventType::frame);
+
+            if (! events.empty())
+            {
+                expectEquals (events.back().numRepaintCalls, 2);
+                expectEquals (events.back().frameNumber, 1);
+                expect (events.back().area == c.getLocalBounds());
+            }
+        }
+
+        beginTest ("Events are exported as a Chrome trace");
+        {
+            TestComponent c;
+            c.setName ("Meter");
+            c.setBounds (0, 0, 20, 20);
+            c.setVisible (true);
+
+            PaintProfiler profiler;
+            profiler.start();
+            c.repaint();
+            c.createComponentSnapshot (c.getLocalBounds());
+            profiler.stop();
+
+            MemoryOutputStream output;
+            profiler.writeChromeTrace (output);
+
+            const auto trace = JSON::parse (output.toString());
+            const auto* traceEvents = trace["traceEvents"].getArray();
+            expect (traceEvents != nullptr);
+
+            if (traceEvents != nullptr)
+            {
+                expectEquals (traceEvents->size(), 3);
+
+                for (auto& e : *traceEvents)
+                {
+                    const auto eventCategory = e["cat"].toString();
+                    expect (eventCategory == "repaint" || eventCategory == "paint" || eventCategory == "paintOverChildren");
+                    expectEquals (e["ph"].toString(), String (eventCategory == "repaint" ? "i" : "X"));
+                    expect (e["name"].toString().contains ("Meter"));
+                    expect (e["args"]["area"].toString().isNotEmpty());
+                }
+            }
+
+            // The events have been removed from the buffer
+            expect (readEvents (profiler).empty());
+        }
+    }
+
+private:
+    struct TestComponent  : public Component
+    {
+        void paint (Graphics& g) override
+        {
+            g.fillAll (colour);
+        }
+
+        Colour colour { Colours::darkgrey };
+    };
+
+    static std::vector<PaintProfiler::Event> readEvents (PaintProfiler& profiler)
+    {
+        std::vector<PaintProfiler::Event> events;
+        profiler.readEvents ([&] (const PaintProfiler::Event& e) { events.push_back (e); });
+        return events;
+    }
+};
+
+static PaintProfilerTests paintProfilerTests;
+
+} // namespace juce